@@ -0,0 +1,180 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * image_bench_main.cc
+ * Microbenchmark ('vt_image_bench') for vt_term's image pipeline: scales a
+ * large image (1024x1024 by default) down to typical button sizes
+ */
+
+#include "image_pipeline.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Parameter
+{
+    std::string image_file;  // PNG/JPEG/GIF to scale, else a generated image
+    int  size  = 1024;       // generated image is size x size
+    int  loops = 50;
+};
+
+struct ButtonSize
+{
+    int width;
+    int height;
+};
+
+// Table buttons, menu item images and a large logo zone
+const std::vector<ButtonSize> BUTTON_SIZES = {
+    {64, 64}, {96, 96}, {128, 128}, {150, 100}, {240, 160}, {400, 300}};
+
+/*********************************************************************
+ * PROTOTYPES
+ ********************************************************************/
+vt::RgbaImage GenerateImage(int size);
+template <typename Fn> double TimeLoops(int loops, Fn &&fn);
+Parameter ParseArguments(const int argc, const char* const argv[]);
+void ShowHelp(const std::string &progname);
+
+
+/*********************************************************************
+ * MAIN
+ ********************************************************************/
+int main(int argc, const char* argv[])
+{
+    Parameter param = ParseArguments(argc, argv);
+
+    vt::RgbaImage source;
+    if (param.image_file.empty())
+        source = GenerateImage(param.size);
+    else
+    {
+        const double decode_us = TimeLoops(1, [&]() {
+            vt::DecodeImageFile(param.image_file, source);
+        });
+        if (!source.Valid())
+        {
+            std::cout << "Can't decode '" << param.image_file << "'" << '\n';
+            return 1;
+        }
+        std::cout << "decode " << param.image_file << ": " << std::fixed << std::setprecision(1)
+                  << decode_us / 1000.0 << " ms" << '\n';
+    }
+
+    std::cout << "source " << source.width << "x" << source.height
+              << (source.has_alpha ? " RGBA" : " RGB")
+              << ", backend " << vt::ImagePipelineBackend()
+              << ", " << param.loops << " loops" << '\n'
+              << std::setw(10) << "size" << std::setw(14) << "nearest us"
+              << std::setw(14) << "filtered us" << std::setw(12) << "Mpix/s" << '\n';
+
+    for (const auto& button : BUTTON_SIZES)
+    {
+        const double nearest_us = TimeLoops(param.loops, [&]() {
+            vt::RgbaImage out = vt::ScaleNearest(source, button.width, button.height);
+        });
+        const double filtered_us = TimeLoops(param.loops, [&]() {
+            vt::RgbaImage out = vt::ScaleImage(source, button.width, button.height);
+        });
+        const double source_mpix = static_cast<double>(source.width) * source.height / 1e6;
+
+        std::cout << std::setw(10) << (std::to_string(button.width) + "x" + std::to_string(button.height))
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << nearest_us
+                  << std::setw(14) << filtered_us
+                  << std::setw(12) << source_mpix / (filtered_us / 1e6) << '\n';
+    }
+    return 0;
+}
+
+/****
+ * GenerateImage:  A premultiplied gradient with a soft-edged transparent
+ *  border, so every filter tap does real work.
+ ****/
+vt::RgbaImage GenerateImage(int size)
+{
+    vt::RgbaImage image;
+    image.width = size;
+    image.height = size;
+    image.has_alpha = true;
+    image.pixels.resize(static_cast<size_t>(size) * static_cast<size_t>(size));
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+        {
+            const int edge = std::min(std::min(x, y), std::min(size - 1 - x, size - 1 - y));
+            const uint32_t a = static_cast<uint32_t>(std::min(255, edge * 8));
+            const uint32_t r = static_cast<uint32_t>(x * 255 / size);
+            const uint32_t g = static_cast<uint32_t>(y * 255 / size);
+            const uint32_t b = static_cast<uint32_t>((x ^ y) & 255);
+            image.pixels[static_cast<size_t>(y) * size + x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    vt::Premultiply(image);
+    return image;
+}
+
+// Average microseconds per call
+template <typename Fn>
+double TimeLoops(int loops, Fn &&fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; ++i)
+        fn();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / loops;
+}
+
+Parameter ParseArguments(const int argc, const char* const argv[])
+{
+    Parameter param;
+    for (int idx = 1; idx < argc; idx++)
+    {
+        const std::string arg = argv[idx];
+        if (arg.length() < 2 || arg[0] != '-')
+        {
+            std::cout << "Invalid argument format: '" << arg << "'" << '\n';
+            ShowHelp(argv[0]);
+        }
+
+        const char opt = arg[1];
+        const std::string val = arg.substr(2);
+        if (opt == 'f')
+            param.image_file = val;
+        else if (opt == 's')
+            param.size = std::clamp(atoi(val.c_str()), 16, vt::MAX_DECODE_DIMENSION);
+        else if (opt == 'l')
+            param.loops = std::max(1, atoi(val.c_str()));
+        else
+            ShowHelp(argv[0]);
+    }
+    return param;
+}
+
+void ShowHelp(const std::string &progname)
+{
+    std::cout << '\n'
+              << "Usage:  " << progname << " [OPTIONS]" << '\n'
+              << "  -f<file>    Scale this PNG/JPEG/GIF (e.g. a 1024x1024 menu photo)" << '\n'
+              << "  -s<n>       Without -f, scale a generated n x n image (default 1024)" << '\n'
+              << "  -l<n>       Time each size over n loops (default 50)" << '\n'
+              << "  -h          Show this help screen" << '\n'
+              << '\n';
+    exit(1);
+}
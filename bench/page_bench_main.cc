@@ -0,0 +1,256 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * page_bench_main.cc
+ * Microbenchmark ('vt_page_bench') for ZoneDB's page lookup: replays the
+ * lookups a server makes while taking orders (index page, category, item
+ * pages and the index behind each item page) against a zone database the
+ * size of a full menu, walking the list and through vt::PageIndex
+ */
+
+#include "page_index.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The zone.hh values the replay needs; zone.hh itself pulls in vt_main
+constexpr int PAGE_SYSTEM          = 0;
+constexpr int PAGE_TABLE           = 1;
+constexpr int PAGE_INDEX           = 2;
+constexpr int PAGE_ITEM            = 3;
+constexpr int PAGE_SCRIPTED        = 5;
+constexpr int PAGE_CHECKS          = 12;
+constexpr int PAGE_INDEX_WITH_TABS = 18;
+constexpr int INDEX_ANY            = -1;
+constexpr int SIZE_1024x768        = 6;
+constexpr int SIZE_1440x900        = 10;
+constexpr int SIZE_1920x1080       = 14;
+
+struct BenchPage
+{
+    BenchPage *next = nullptr;
+    int id = 0;
+    int type = 0;
+    int index = 0;
+    int size = 0;
+};
+
+struct Parameter
+{
+    int  menu_pages = 400;   // category and item pages per size
+    int  sizes      = 3;     // screen sizes each page is defined for
+    int  orders     = 2000;  // orders replayed
+};
+
+/*********************************************************************
+ * PROTOTYPES
+ ********************************************************************/
+std::vector<std::unique_ptr<BenchPage>> MenuDatabase(const Parameter &param);
+BenchPage *ListFindByID(BenchPage *head, int id, int max_size);
+BenchPage *ListFindByType(BenchPage *head, int type, int period, int max_size);
+Parameter ParseArguments(const int argc, const char* const argv[]);
+void ShowHelp(const std::string &progname);
+
+
+/*********************************************************************
+ * MAIN
+ ********************************************************************/
+int main(int argc, const char* argv[])
+{
+    Parameter param = ParseArguments(argc, argv);
+
+    std::vector<std::unique_ptr<BenchPage>> pages = MenuDatabase(param);
+    BenchPage *head = pages.front().get();
+    const int term_size = SIZE_1024x768;
+    const int categories = std::max(1, param.menu_pages / 10);
+
+    long lookups = 0;
+    long checksum = 0;
+    auto note = [&](const BenchPage *p) {
+        ++lookups;
+        checksum += p ? p->id : 0;
+    };
+
+    // What Terminal::Jump() and Page::FindZone() ask for over one order:
+    // the meal period's index, then a few category and item pages, each
+    // item page looking up its index page for the tab bar, then the check list
+    auto replay = [&](auto &&find_id, auto &&find_type) {
+        lookups = 0;
+        checksum = 0;
+        for (int order = 0; order < param.orders; ++order)
+        {
+            const int period = order % 6;
+            note(find_type(PAGE_INDEX, period, term_size));
+            for (int step = 0; step < 4; ++step)
+            {
+                const int category = 1 + (order * 7 + step * 3) % categories;
+                note(find_id(category, term_size));
+                const int item = categories + 1 + (order * 13 + step * 5) % (param.menu_pages - categories);
+                note(find_id(item, term_size));
+                for (int zone = 0; zone < 3; ++zone)
+                {
+                    BenchPage *index_page = find_type(PAGE_INDEX, period, term_size);
+                    if (index_page == nullptr)
+                        index_page = find_type(PAGE_INDEX_WITH_TABS, period, term_size);
+                    note(index_page);
+                }
+                note(find_id(-(1 + step), term_size));  // modifier script
+            }
+            note(find_type(PAGE_CHECKS, INDEX_ANY, term_size));
+        }
+    };
+
+    auto time_replay = [&](auto &&find_id, auto &&find_type) {
+        const auto start = std::chrono::steady_clock::now();
+        replay(find_id, find_type);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() /
+               static_cast<double>(std::max(1L, lookups));
+    };
+
+    const double list_ns = time_replay(
+        [head](int id, int size) { return ListFindByID(head, id, size); },
+        [head](int type, int period, int size) { return ListFindByType(head, type, period, size); });
+    const long list_checksum = checksum;
+
+    vt::PageIndex<BenchPage> index;
+    const auto build_start = std::chrono::steady_clock::now();
+    index.Build(head);
+    const double build_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - build_start).count();
+    const double index_ns = time_replay(
+        [&index](int id, int size) { return id == 0 ? nullptr : index.FindByID(id, size); },
+        [&index](int type, int period, int size) { return index.FindByType(type, period, size); });
+
+    std::cout << pages.size() << " pages, " << param.orders << " orders, "
+              << lookups << " lookups" << '\n'
+              << std::fixed << std::setprecision(1)
+              << "list:    " << list_ns << " ns per lookup" << '\n'
+              << "indexed: " << index_ns << " ns per lookup, "
+              << build_us << " us to build" << '\n'
+              << "speedup: " << list_ns / std::max(index_ns, 0.001) << "x"
+              << (checksum == list_checksum ? "" : "  CHECKSUMS DIFFER") << '\n';
+    return checksum == list_checksum ? 0 : 1;
+}
+
+/****
+ * MenuDatabase:  Pages in ZoneDB::Add() order (id ascending, larger sizes
+ *  first): system pages and modifier scripts with negative ids, an index
+ *  page per meal period, then categories and item pages.
+ ****/
+std::vector<std::unique_ptr<BenchPage>> MenuDatabase(const Parameter &param)
+{
+    struct Def { int id, type, index; };
+    std::vector<Def> defs;
+    for (int id = -120; id < 0; ++id)
+        defs.push_back({id, id >= -20 ? PAGE_SCRIPTED : PAGE_SYSTEM, 0});
+    defs.push_back({-121, PAGE_CHECKS, 0});
+    for (int id = 1; id <= param.menu_pages; ++id)
+        defs.push_back({id, PAGE_ITEM, 0});
+    for (int period = 0; period < 6; ++period)
+        defs.push_back({param.menu_pages + 1 + period, PAGE_INDEX, period});
+    for (int table = 0; table < 10; ++table)
+        defs.push_back({param.menu_pages + 100 + table, PAGE_TABLE, 0});
+    std::stable_sort(defs.begin(), defs.end(), [](const Def &a, const Def &b) { return a.id < b.id; });
+
+    // largest first, the terminal's size last
+    static constexpr int sizes[3] = {SIZE_1920x1080, SIZE_1440x900, SIZE_1024x768};
+    std::vector<std::unique_ptr<BenchPage>> pages;
+    for (const Def &def : defs)
+    {
+        for (int s = 3 - param.sizes; s < 3; ++s)
+        {
+            auto page = std::make_unique<BenchPage>();
+            page->id = def.id;
+            page->type = def.type;
+            page->index = def.index;
+            page->size = sizes[s];
+            if (!pages.empty())
+                pages.back()->next = page.get();
+            pages.push_back(std::move(page));
+        }
+    }
+    return pages;
+}
+
+// ZoneDB::FindByID() before vt::PageIndex
+BenchPage *ListFindByID(BenchPage *head, int id, int max_size)
+{
+    if (id == 0)
+        return nullptr;
+    for (BenchPage *p = head; p != nullptr; p = p->next)
+    {
+        if (p->id == id && p->size <= max_size)
+            return p;
+    }
+    return nullptr;
+}
+
+// ZoneDB::FindByType() before vt::PageIndex
+BenchPage *ListFindByType(BenchPage *head, int type, int period, int max_size)
+{
+    for (BenchPage *p = head; p != nullptr; p = p->next)
+    {
+        if (p->type == type && (p->index == period || period == INDEX_ANY) &&
+            p->size <= max_size && p->id != 0)
+            return p;
+    }
+    return nullptr;
+}
+
+Parameter ParseArguments(const int argc, const char* const argv[])
+{
+    Parameter param;
+    for (int idx = 1; idx < argc; idx++)
+    {
+        const std::string arg = argv[idx];
+        if (arg.length() < 2 || arg[0] != '-')
+        {
+            std::cout << "Invalid argument format: '" << arg << "'" << '\n';
+            ShowHelp(argv[0]);
+        }
+
+        const char opt = arg[1];
+        const std::string val = arg.substr(2);
+        if (opt == 'p')
+            param.menu_pages = std::max(20, atoi(val.c_str()));
+        else if (opt == 's')
+            param.sizes = std::clamp(atoi(val.c_str()), 1, 3);
+        else if (opt == 'o')
+            param.orders = std::max(1, atoi(val.c_str()));
+        else
+            ShowHelp(argv[0]);
+    }
+    return param;
+}
+
+void ShowHelp(const std::string &progname)
+{
+    std::cout << '\n'
+              << "Usage:  " << progname << " [OPTIONS]" << '\n'
+              << "  -p<n>       Category and item pages (default 400)" << '\n'
+              << "  -s<n>       Screen sizes each page is defined for, 1-3 (default 3)" << '\n'
+              << "  -o<n>       Orders to replay (default 2000)" << '\n'
+              << "  -h          Show this help screen" << '\n'
+              << '\n';
+    exit(1);
+}
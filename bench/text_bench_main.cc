@@ -0,0 +1,190 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * text_bench_main.cc
+ * Microbenchmark ('vt_text_bench') for vt_term's text cache: lays out the
+ * labels of a menu page (200 buttons by default) the way Layer::ZoneText()
+ * does, with and without vt::TextCache
+ */
+
+#include "soft_canvas.hh"
+#include "text_cache.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Parameter
+{
+    std::string font = "DejaVu Serif:size=18:style=Book:dpi=96";
+    int  buttons = 200;
+    int  loops   = 20;
+    int  width   = 120;  // button label area in pixels
+    int  height  = 70;
+};
+
+/*********************************************************************
+ * PROTOTYPES
+ ********************************************************************/
+std::vector<std::string> MenuLabels(int count);
+Parameter ParseArguments(const int argc, const char* const argv[]);
+void ShowHelp(const std::string &progname);
+
+
+/*********************************************************************
+ * MAIN
+ ********************************************************************/
+int main(int argc, const char* argv[])
+{
+    Parameter param = ParseArguments(argc, argv);
+
+    vt::SoftFont font;
+    if (font.Open(param.font))
+    {
+        std::cout << "Can't open font '" << param.font << "'" << '\n';
+        return 1;
+    }
+
+    long measured = 0;
+    vt::MeasureFn measure = [&font, &measured](const char* str, int len) {
+        ++measured;
+        return len > 0 ? font.TextWidth(str, len) : 0;
+    };
+
+    const std::vector<std::string> labels = MenuLabels(param.buttons);
+    const int max_lines = param.height / std::max(1, font.Height());
+    long checksum = 0;
+
+    // What ZoneText() did before: wrap, then measure each line to align it
+    auto uncached_page = [&]() {
+        for (const std::string &label : labels)
+        {
+            vt::TextLayout layout = vt::WrapText(label.c_str(), param.width, max_lines, measure);
+            for (const vt::TextLine &line : layout.lines)
+                checksum += measure(label.c_str() + line.offset, line.length);
+        }
+    };
+
+    vt::TextCache cache;
+    auto cached_page = [&]() {
+        for (const std::string &label : labels)
+        {
+            const vt::TextLayout &layout = cache.Layout(0, label.c_str(), param.width, max_lines, measure);
+            for (const vt::TextLine &line : layout.lines)
+                checksum += cache.Width(0, label.c_str() + line.offset, line.length, measure);
+        }
+    };
+
+    auto time_pages = [&](auto &&page) {
+        measured = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < param.loops; ++i)
+            page();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(elapsed).count() / param.loops;
+    };
+
+    std::cout << param.buttons << " buttons of " << param.width << "x" << param.height
+              << ", " << param.loops << " redraws, font '" << param.font << "'" << '\n';
+
+    const double uncached_us = time_pages(uncached_page);
+    const long uncached_calls = measured;
+    const double cached_us = time_pages(cached_page);
+    const long cached_calls = measured;
+
+    const vt::TextCache::Stats stats = cache.GetStats();
+    const double lookups = static_cast<double>(stats.width_hits + stats.width_misses +
+                                               stats.layout_hits + stats.layout_misses);
+    std::cout << std::fixed << std::setprecision(1)
+              << "uncached: " << uncached_us << " us per page, "
+              << uncached_calls / param.loops << " measurements per page" << '\n'
+              << "cached:   " << cached_us << " us per page, "
+              << cached_calls << " measurements in all, "
+              << 100.0 * static_cast<double>(stats.width_hits + stats.layout_hits) / lookups
+              << "% hits" << '\n'
+              << "speedup:  " << uncached_us / std::max(cached_us, 0.001) << "x"
+              << " (checksum " << checksum << ")" << '\n';
+    return 0;
+}
+
+/****
+ * MenuLabels:  Button names in the style of a restaurant menu, some with
+ *  forced line breaks, some too long for one line.
+ ****/
+std::vector<std::string> MenuLabels(int count)
+{
+    static const std::vector<std::string> first = {
+        "Grilled", "Smoked", "Crispy", "House", "Spicy", "Classic", "Garden", "Double"};
+    static const std::vector<std::string> second = {
+        "Chicken", "Cheese", "Salmon", "Veggie", "Bacon", "Mushroom", "Pastrami"};
+    static const std::vector<std::string> third = {
+        "Burger", "Wrap", "Salad", "Sandwich\\Combo", "Platter", "Melt"};
+
+    std::vector<std::string> labels;
+    labels.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i)
+    {
+        labels.push_back(first[static_cast<size_t>(i) % first.size()] + " " +
+                         second[static_cast<size_t>(i / 3) % second.size()] + " " +
+                         third[static_cast<size_t>(i / 7) % third.size()]);
+    }
+    return labels;
+}
+
+Parameter ParseArguments(const int argc, const char* const argv[])
+{
+    Parameter param;
+    for (int idx = 1; idx < argc; idx++)
+    {
+        const std::string arg = argv[idx];
+        if (arg.length() < 2 || arg[0] != '-')
+        {
+            std::cout << "Invalid argument format: '" << arg << "'" << '\n';
+            ShowHelp(argv[0]);
+        }
+
+        const char opt = arg[1];
+        const std::string val = arg.substr(2);
+        if (opt == 'F')
+            param.font = val;
+        else if (opt == 'b')
+            param.buttons = std::max(1, atoi(val.c_str()));
+        else if (opt == 'l')
+            param.loops = std::max(1, atoi(val.c_str()));
+        else if (opt == 'w')
+            param.width = std::max(8, atoi(val.c_str()));
+        else
+            ShowHelp(argv[0]);
+    }
+    return param;
+}
+
+void ShowHelp(const std::string &progname)
+{
+    std::cout << '\n'
+              << "Usage:  " << progname << " [OPTIONS]" << '\n'
+              << "  -F<font>    Fontconfig name to measure with (default DejaVu Serif 18)" << '\n'
+              << "  -b<n>       Buttons on the page (default 200)" << '\n'
+              << "  -l<n>       Redraw the page n times (default 20)" << '\n'
+              << "  -w<n>       Label width in pixels (default 120)" << '\n'
+              << "  -h          Show this help screen" << '\n'
+              << '\n';
+    exit(1);
+}
@@ -39,6 +39,7 @@
 #include "manager.hh"
 #include "admission.hh"
 #include "src/utils/vt_logger.hh"
+#include "src/core/content_hash.hh"
 #include "safe_string_utils.hh"
 #include "src/utils/cpp23_utils.hh"
 
@@ -1478,6 +1479,7 @@ int Check::PrintWorkOrder(Terminal *term, Report *report, int printer_id, int re
         {
             StringElapsedToNow(str, 256, chef_time);
             report->TextR(str);
+            report->MarkLive(LIVE_TIMER);
         }
         else
             report->TextR(term->TimeDate(made_time, TD_TIME));
@@ -1590,14 +1592,14 @@ int Check::PrintWorkOrder(Terminal *term, Report *report, int printer_id, int re
                     }
                 }
                 
-                // If order should flash and we're in blink on state, make it flash with high contrast
-                if (should_flash && rzone && rzone->BlinkState() == 1)
-                {
-                    order_color = COLOR_WHITE;
-                }
-                
+                // A flashing order is tagged for ReportZone, which swaps
+                // it to white and back on each blink without a rebuild
                 report->Mode(kitchen_mode);
-                report->TextKV(ordstr, cststr, order_color, COLOR_DEFAULT);
+                report->TextPosL(3, ordstr, order_color);
+                if (should_flash)
+                    report->MarkLive(LIVE_FLASH);
+                report->TextPosR(0, cststr, COLOR_DEFAULT);
+                report->NewLine();
                 report->Mode(0);
 
                 ordstr[0] = '\0';
@@ -2012,6 +2014,64 @@ static int GetModifierColor(int order_color)
     }
 }
 
+namespace {
+
+uint64_t StampTime(const TimeInfo &t)
+{
+    if (!t.IsSet())
+        return 0;
+    return static_cast<uint64_t>(t.get_local_time().time_since_epoch().count());
+}
+
+void StampOrder(vt::ContentHash &h, const Order *order)
+{
+    h.Add(order->item_name.Value()).Add(order->script.Value());
+    h.AddValue(static_cast<uint64_t>(order->status)).AddValue(static_cast<uint64_t>(order->count));
+    h.AddValue(static_cast<uint64_t>(order->qualifier)).AddValue(static_cast<uint64_t>(order->seat));
+    h.AddValue(static_cast<uint64_t>(order->sales_type)).AddValue(order->item_type);
+    h.AddValue(static_cast<uint64_t>(order->cost)).AddValue(static_cast<uint64_t>(order->total_cost));
+    h.AddValue(static_cast<uint64_t>(order->printer_id)).AddValue(static_cast<uint64_t>(order->ignore_split));
+    h.AddValue(static_cast<uint64_t>(order->checknum));
+    for (const Order *mod = order->modifier_list; mod != nullptr; mod = mod->next)
+        StampOrder(h, mod);
+    h.AddValue(0xFFFF);  // end of modifiers
+}
+
+} // namespace
+
+/****
+ * KitchenStamp:  Hashes everything PrintWorkOrder() and MakeReport() read from
+ *   the check, so ReportZone can tell a kitchen video ticket is unchanged and
+ *   just update its timer instead of rebuilding it.  Time based parts (order
+ *   age colors) are the caller's to add.
+ ****/
+uint64_t Check::KitchenStamp()
+{
+    FnTrace("Check::KitchenStamp()");
+    vt::ContentHash h;
+    h.AddValue(static_cast<uint64_t>(serial_number)).AddValue(static_cast<uint64_t>(call_center_id));
+    h.AddValue(static_cast<uint64_t>(flags)).AddValue(static_cast<uint64_t>(type));
+    h.AddValue(static_cast<uint64_t>(check_state)).AddValue(static_cast<uint64_t>(undo));
+    h.AddValue(static_cast<uint64_t>(user_owner)).AddValue(static_cast<uint64_t>(customer_id));
+    h.AddValue(reinterpret_cast<uintptr_t>(customer)).AddValue(static_cast<uint64_t>(guests));
+    h.AddValue(StampTime(time_open)).AddValue(StampTime(chef_time)).AddValue(StampTime(made_time));
+    h.AddValue(StampTime(date));
+    h.AddValue(date.IsSet() && date <= SystemTime);  // takeout and catering "WAIT"
+    h.Add(termname.Value()).Add(label.Value()).Add(comment.Value());
+
+    for (const SubCheck *sc = SubList(); sc != nullptr; sc = sc->next)
+    {
+        h.AddValue(static_cast<uint64_t>(sc->number)).AddValue(static_cast<uint64_t>(sc->status));
+        h.AddValue(static_cast<uint64_t>(sc->total_cost)).AddValue(static_cast<uint64_t>(sc->balance));
+        for (const Order *order = sc->OrderList(); order != nullptr; order = order->next)
+            StampOrder(h, order);
+        for (const Payment *pay = sc->PaymentList(); pay != nullptr; pay = pay->next)
+            h.AddValue(static_cast<uint64_t>(pay->value));
+        h.AddValue(0xFFFFFFFF);  // end of subcheck
+    }
+    return h.Value();
+}
+
 int Check::MakeReport(Terminal *term, Report *report, int show_what, int video_target,
                       ReportZone *rzone)
 {
@@ -2129,6 +2189,7 @@ int Check::MakeReport(Terminal *term, Report *report, int show_what, int video_t
         {
             StringElapsedToNow(str, 256, chef_time);
             report->TextL(str);
+            report->MarkLive(LIVE_TIMER);
         }
         else
             report->TextL(term->TimeDate(made_time, TD_TIME));
@@ -2430,15 +2491,12 @@ int Check::MakeReport(Terminal *term, Report *report, int show_what, int video_t
                     modifier_color = GetModifierColor(order_color);
                 }
 
-                // If order should flash and we're in blink on state, make it flash with high contrast
-                if (should_flash && rzone && rzone->BlinkState() == 1)
-                {
-                    // Instead of hiding text, flash between normal color and white for high visibility
-                    order_color = COLOR_WHITE;
-                    modifier_color = COLOR_WHITE;
-                }
-
+                // A flashing order and its modifiers are tagged for
+                // ReportZone, which swaps them to white and back on each
+                // blink without a rebuild
                 report->TextL(str, order_color);
+                if (should_flash)
+                    report->MarkLive(LIVE_FLASH);
 
                 // BAK->I'm not going to worry about fitting this in with the
                 // "use comma" stuff because the use comma stuff is only for
@@ -2494,18 +2552,24 @@ int Check::MakeReport(Terminal *term, Report *report, int show_what, int video_t
                                 if ((pos + swidth) >= (rzone->Width(term) - 3))
                                 {
                                     report->Text(",", modifier_color, ALIGN_LEFT, pos);
+                                    if (should_flash)
+                                        report->MarkLive(LIVE_FLASH);
                                     report->NewLine();
                                     pos = 0.0;
                                     vt_safe_string::safe_format(str, STRLONG, "    %s", tmpstr);
                                 }
                             }
                             report->Text(str, modifier_color, ALIGN_LEFT, pos);
+                            if (should_flash)
+                                report->MarkLive(LIVE_FLASH);
                             pos += ((Flt) term->TextWidth(str) / (Flt) term->curr_font_width);
                         }
                         else
                         {
                             vt_safe_string::safe_format(str, STRLONG, "    %s", mod->Description(term));
                             report->Text(str, modifier_color, ALIGN_LEFT, pos);
+                            if (should_flash)
+                                report->MarkLive(LIVE_FLASH);
                         }
                         if (show_what & CHECK_DISPLAY_CASH)
                         {
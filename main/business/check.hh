@@ -25,6 +25,7 @@
 #include "list_utility.hh"
 #include "terminal.hh"
 
+#include <cstdint>
 #include <memory>
 
 /**** Module Definitions & Global Data ****/
@@ -485,6 +486,7 @@ public:
     int       ListOrdersForReport(Terminal *term, Report *report);
     int       MakeReport(Terminal *t, Report *r, int show_what = CHECK_DISPLAY_ALL,
                          int video_target = PRINTER_DEFAULT, ReportZone *rzone = nullptr);  // makes report showing all subchecks
+    uint64_t  KitchenStamp();  // changes whenever what a kitchen video ticket shows may have
     int       HasOpenTab();
     [[nodiscard]] int       IsEmpty() const;  // boolean - is check blank?
     [[nodiscard]] int       IsTraining() const;  // boolean - is this a training check?
@@ -48,11 +48,15 @@
 #include "src/utils/cpp23_utils.hh"  // C++23 formatting utilities
 #include "date/date.h"      // helper library to output date strings with std::chrono
 #include "src/core/crash_report.hh"  // Automatic crash reporting
+#include "src/core/event_loop.hh"    // epoll backend for headless operation
+#include "src/core/metrics.hh"       // event loop latency histograms
+#include "src/network/print_spooler.hh" // persistent print job queues
 
 #include <curlpp/cURLpp.hpp>
 #include <curlpp/Easy.hpp>
 #include <curlpp/Options.hpp>
 #include <curlpp/Exception.hpp>
+#include <map>
 #include <memory>
 
                             // Standard C++ libraries
@@ -67,7 +71,6 @@
 #include <sys/utsname.h>    // system name structure
 #include <sys/wait.h>       // declarations for waiting
 #include <X11/Intrinsic.h>  // libXt provides the X Toolkit Intrinsics, an abstract widget library on which ViewTouch is based
-#include <X11/Xft/Xft.h>    // Xft font rendering library
 #include <string>           // Introduces string types, character traits and a set of converting functions
 #include <cctype>           // Declares a set of functions to classify and transform individual characters
 #include <cstring>          // Functions for dealing with C-style strings — null-terminated arrays of characters; is the C++ version of the classic string.h header from C
@@ -154,12 +157,10 @@ const std::array<int, 11> PrinterTypeValue = {PRINTER_KITCHEN1, PRINTER_KITCHEN2
  *************************************************************/
 static XtAppContext App = nullptr;
 static Display     *Dis = nullptr;
+static std::unique_ptr<vt::EventLoop> HeadlessLoop; // set when not using Xt
 static int          ScrNo = 0;
-static std::array<XFontStruct*, 32> FontInfo{};
 static std::array<int, 32>          FontWidth{};
 static std::array<int, 32>          FontHeight{};
-static std::array<int, 32>          FontBaseline{};
-static std::array<XftFont*, 32>     XftFontsArr{};
 int                 LoaderSocket = 0;
 int                 OpenTermPort = 10001;
 int                 OpenTermSocket = -1;
@@ -171,6 +172,11 @@ int                 autoupdate = 0;
 int                 UserCommand  = 2;  // see RunUserCommand() definition
 int                 AllowLogins  = 1;
 int                 UserRestart  = 0;
+volatile sig_atomic_t StatsDump  = 0;  // SIGUSR2 also writes VIEWTOUCH_STATS_FILE
+
+static vt::MetricsServer StatsServer;  // Prometheus text on VIEWTOUCH_STATS_SOCKET
+static unsigned long StatsFlushID = 0; // finishes snapshots StatsServer couldn't send at once
+static constexpr int STATS_FLUSH_TIME = 20;
 
 std::array<genericChar, STRLENGTH> displaystr{};
 std::array<genericChar, STRLENGTH> restart_flag_str{};
@@ -206,7 +212,7 @@ const std::array<FontDataType, 16> FontData =
 
 constexpr int FONT_COUNT = static_cast<int>(FontData.size());
 
-static XtIntervalId UpdateID = 0;   // update callback function id
+static unsigned long UpdateID = 0;  // update callback function id
 static int LastMin  = -1;
 static int LastHour = -1;
 static int LastMeal = -1;
@@ -237,6 +243,8 @@ unsigned long restart_timeout_id = 0; // Timeout for auto restart
 
 #define VIEWTOUCH_COMMAND   VIEWTOUCH_PATH "/bin/.viewtouch_command_file"
 #define VIEWTOUCH_PINGCHECK VIEWTOUCH_PATH "/bin/.ping_check"
+#define VIEWTOUCH_STATS_SOCKET VIEWTOUCH_PATH "/bin/.vt_stats"
+#define VIEWTOUCH_STATS_FILE   VIEWTOUCH_PATH "/bin/.vt_stats.prom"
 
 #define VIEWTOUCH_VTPOS     VIEWTOUCH_PATH "/bin/vtpos"
 #define VIEWTOUCH_RESTART   VIEWTOUCH_PATH "/bin/vtrestart"
@@ -261,6 +269,9 @@ void     Terminate(int signal);
 void     UserSignal1(int signal);
 void     UserSignal2(int signal);
 void     UpdateSystemCB(XtPointer client_data, XtIntervalId *time_id);
+void     StatsSocketCB(XtPointer client_data, int *fid, XtInputId *id);
+void     StatsFlushCB(XtPointer client_data, XtIntervalId *timer_id);
+bool     UseHeadlessLoop();
 int      StartSystem(int my_use_net);
 int      RunUserCommand();
 int      PingCheck();
@@ -922,8 +933,8 @@ void UserSignal1(int /*my_signal*/)
         // Child process - exec vtrestart
         ReportError("UserSignal1: Child process executing vtrestart");
         execl(VIEWTOUCH_RESTART, VIEWTOUCH_RESTART, VIEWTOUCH_PATH, NULL);
-        // If exec fails, exit
-        exit(1);
+        // If exec fails, leave without running the parent's exit handlers
+        _exit(1);
     } else {
         // Parent process - create restart flag and exit
         ReportError("UserSignal1: Parent process creating restart flag");
@@ -962,6 +973,7 @@ void UserSignal2(int /*my_signal*/)
 {
     FnTrace("UserSignal2()");
     UserCommand = 1;
+    StatsDump = 1;
 }
 
 /**
@@ -1111,6 +1123,10 @@ int StartSystem(int my_use_net)
         EndSystem();
     }
 
+    // Print jobs left unsent by the last run go out first
+    sys->FullPath(SPOOL_DATA_DIR, str.data());
+    vt::PrintSpooler::Instance().Open(str.data());
+
     vt_safe_string::safe_format(str.data(), str.size(), "Starting System on %s", GetMachineName());
     printf("Starting system:  %s\n", GetMachineName());
     ReportLoader(str.data());
@@ -1163,87 +1179,44 @@ int StartSystem(int my_use_net)
         settings->Load(str.data());
     }
 
-    XtToolkitInitialize();
-    App = XtCreateApplicationContext();
-
-    // Initialize font arrays (fonts will be loaded lazily)
-    for (i = 0; i < 32; ++i)
+    if (UseHeadlessLoop())
+    {
+        HeadlessLoop = std::make_unique<vt::EventLoop>();
+        if (!HeadlessLoop->Valid())
+        {
+            ReportError("Unable to start epoll event loop, falling back to Xt");
+            HeadlessLoop.reset();
+        }
+    }
+    if (HeadlessLoop == nullptr)
     {
-        FontInfo[i]   = nullptr;
-        FontWidth[i]  = 0;
-        FontHeight[i] = 0;
-        FontBaseline[i] = 0;
-        XftFontsArr[i] = nullptr;
+        XtToolkitInitialize();
+        App = XtCreateApplicationContext();
     }
 
-    // Pre-populate font dimensions from FontData for immediate access
+    // Initialize font arrays.  Text is measured with the glyph advance
+    // tables each vt_term sends (see Terminal::TextWidth()); these
+    // FontData cell sizes are only the fallback, so no fonts are opened here.
+    FontWidth.fill(0);
+    FontHeight.fill(0);
     for (i = 0; i < FONT_COUNT; ++i)
     {
         int f = FontData[i].id;
         FontWidth[f] = FontData[i].width;
         FontHeight[f] = FontData[i].height;
-        FontBaseline[f] = FontHeight[f] * 3 / 4;  // Default baseline
     }
 
     // Set default font properties
     FontWidth[FONT_DEFAULT]  = FontWidth[FONT_TIMES_24];
     FontHeight[FONT_DEFAULT] = FontHeight[FONT_TIMES_24];
-    FontBaseline[FONT_DEFAULT] = FontBaseline[FONT_TIMES_24];
 
     int argc = 0;
     const genericChar* argv[] = {"vt_main"};
-    Dis = XtOpenDisplay(App, displaystr.data(), nullptr, nullptr, nullptr, 0, &argc, (genericChar**)argv);
+    if (App)
+        Dis = XtOpenDisplay(App, displaystr.data(), nullptr, nullptr, nullptr, 0, &argc, (genericChar**)argv);
     if (Dis)
-    {
         ScrNo = DefaultScreen(Dis);
 
-        // Use fixed DPI (96) for consistent font rendering across all displays
-        // This ensures fonts render at the same size regardless of display DPI
-        static std::array<char, 256> font_spec_with_dpi{};
-        for (i = 0; i < FONT_COUNT; ++i)
-        {
-            int f = FontData[i].id;
-            const genericChar* xft_font_name = FontData[i].font;
-
-            // Append :dpi=96 to font specification if not already present
-            if (strstr(xft_font_name, ":dpi=") == nullptr) {
-                vt::cpp23::format_to_buffer(font_spec_with_dpi.data(), font_spec_with_dpi.size(), "{}:dpi=96", xft_font_name);
-                xft_font_name = font_spec_with_dpi.data();
-            }
-
-            printf("Loading font %d: %s\n", f, xft_font_name);
-            XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, xft_font_name);
-            if (XftFontsArr[f] == nullptr) {
-                printf("Failed to load font %d: %s\n", f, xft_font_name);
-                // Try a simple fallback with fixed DPI
-                XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, "DejaVu Serif:size=24:style=Book:dpi=96");
-                if (XftFontsArr[f] != nullptr) {
-                    printf("Successfully loaded fallback font for %d\n", f);
-                } else {
-                    printf("FAILED to load ANY font for %d\n", f);
-                }
-            } else {
-                printf("Successfully loaded font %d: %s\n", f, xft_font_name);
-            }
-
-            // Use font dimensions from FontData array to maintain UI layout compatibility
-            FontWidth[f] = FontData[i].width;
-            FontHeight[f] = FontData[i].height;
-
-            // Calculate baseline from Xft font if available, otherwise use 3/4 of height
-            if (XftFontsArr[f]) {
-                FontBaseline[f] = XftFontsArr[f]->ascent;
-            } else {
-                FontBaseline[f] = FontHeight[f] * 3 / 4;  // Typical baseline position
-            }
-        }
-
-        FontWidth[FONT_DEFAULT]  = FontWidth[FONT_TIMES_24];
-        FontHeight[FONT_DEFAULT] = FontHeight[FONT_TIMES_24];
-        FontBaseline[FONT_DEFAULT] = FontBaseline[FONT_TIMES_24];
-        XftFontsArr[FONT_DEFAULT] = XftFontsArr[FONT_TIMES_24];
-    }
-
     // Terminal & Printer Setup
     MasterControl = new Control();
     KillTask("vt_term");
@@ -1527,8 +1500,7 @@ int StartSystem(int my_use_net)
     sys->InitCurrentDay();
 
     // Start update system timer
-    UpdateID = XtAppAddTimeOut(App, UPDATE_TIME,
-                               (XtTimerCallbackProc) UpdateSystemCB, nullptr);
+    UpdateID = AddTimeOutFn((TimeOutFn) UpdateSystemCB, UPDATE_TIME, nullptr);
 
     // Break connection with loader
     if (LoaderSocket)
@@ -1544,7 +1516,17 @@ int StartSystem(int my_use_net)
     if (my_use_net)
         OpenTermSocket = Listen(OpenTermPort);
 
+    // Live event loop statistics; e.g. socat - UNIX-CONNECT:<socket>
+    if (StatsServer.Listen(VIEWTOUCH_STATS_SOCKET) == 0)
+        AddInputFn((InputFn) StatsSocketCB, StatsServer.Fd(), nullptr);
+
     // Event Loop
+    if (HeadlessLoop)
+    {
+        ReportError("Running headless with epoll event loop");
+        return HeadlessLoop->Run();
+    }
+
     XEvent event;
     int event_count = 0;
     int max_events_per_second = 1000; // Prevent infinite loops
@@ -1637,9 +1619,18 @@ int EndSystem()
     }
     if (UpdateID)
     {
-        XtRemoveTimeOut(UpdateID);
+        RemoveTimeOutFn(UpdateID);
         UpdateID = 0;
     }
+    if (HeadlessLoop)
+        HeadlessLoop->Stop();
+    if (StatsFlushID)
+    {
+        RemoveTimeOutFn(StatsFlushID);
+        StatsFlushID = 0;
+    }
+    StatsServer.Close();
+    vt::PrintSpooler::Instance().Shutdown();  // unsent jobs stay spooled
     ReportError("EndSystem: Timeout removal completed, continuing with shutdown...");
     if (Dis)
     {
@@ -2530,8 +2521,9 @@ int Control::TestPrinters(Terminal *term, int report)
  *   database was modified, you'd have to dump the program (somehow avoiding
  *   any efforts to save off the zones) and restart.  So now the Control object
  *   keeps the master copy and all terminals, including the first, get a copy.
- *   That means we'll always have one more zone database than we use, but
- *   the extra copy gives some added flexibility.
+ *   The copies share the master's zones (ZoneDB::Share()) and only copy
+ *   the pages they use, so a terminal costs its own Page list plus the
+ *   pages it has shown or edited.
  ****/
 ZoneDB *Control::NewZoneDB()
 {
@@ -2539,14 +2531,9 @@ ZoneDB *Control::NewZoneDB()
     if (!zone_db)
         return nullptr;
 
-    ZoneDB *db;
-    if (master_copy)
-    {
-        db = zone_db.get();
-        master_copy = 0;
-    }
-    else
-        db = zone_db->Copy().release();
+    ZoneDB *db = ZoneDB::Share(zone_db).release();
+    if (db == nullptr)
+        return nullptr;
 
     db->Init();
     return db;
@@ -2581,77 +2568,21 @@ int Control::SaveTablePages()
 int ReloadTermFonts()
 {
     FnTrace("ReloadTermFonts()");
-    if (Dis == nullptr)
-        return 1;
-
-    // Close existing Xft fonts
-    for (auto & i : XftFontsArr)
-    {
-        if (i)
-        {
-            XftFontClose(Dis, i);
-            i = nullptr;
-        }
-    }
 
     // Get the desired font family from configuration
     const char* font_family = GetGlobalFontFamily();
 
-    // Reload fonts with compatible font specifications
-    for (auto & i : FontData)
+    // vt_main doesn't render text; the terminals reload their Xft fonts and
+    // send new glyph advance tables.  Keep the FontData cell sizes so the
+    // fallback layout stays compatible.
+    for (auto & fd : FontData)
     {
-        int f = i.id;
-        
-        // Get a compatible font specification that maintains UI layout
-        const char* new_font_spec = GetCompatibleFontSpec(f, font_family);
-        
-        // Append :dpi=96 to font specification if not already present
-        static std::array<char, 256> font_spec_with_dpi{};
-        const char* font_to_load = new_font_spec;
-        if (strstr(new_font_spec, ":dpi=") == nullptr) {
-            vt::cpp23::format_to_buffer(font_spec_with_dpi.data(), font_spec_with_dpi.size(), "{}:dpi=96", new_font_spec);
-            font_to_load = font_spec_with_dpi.data();
-        }
-        
-        printf("Reloading term font %d with compatible spec: %s\n", f, font_to_load);
-        XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, font_to_load);
-        
-        if (XftFontsArr[f] == nullptr) {
-            printf("Failed to reload term font %d: %s\n", f, font_to_load);
-            // Try a simple fallback with fixed DPI
-            XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, "DejaVu Serif:size=24:style=Book:dpi=96");
-            if (XftFontsArr[f] != nullptr) {
-                printf("Successfully loaded fallback font for %d\n", f);
-            } else {
-                printf("FAILED to load ANY font for %d\n", f);
-            }
-        } else {
-            printf("Successfully loaded font %d: %s\n", f, new_font_spec);
-        }
-        
-        // Always use FontData dimensions to maintain UI compatibility
-        for (auto & fd : FontData) {
-            if (fd.id == f) {
-                FontWidth[f] = fd.width;
-                FontHeight[f] = fd.height;
-                break;
-            }
-        }
-        
-        // Calculate baseline from Xft font if available, otherwise use 3/4 of height
-        if (XftFontsArr[f]) {
-            FontBaseline[f] = XftFontsArr[f]->ascent;
-        } else {
-            FontBaseline[f] = FontHeight[f] * 3 / 4;  // Typical baseline position
-        }
+        FontWidth[fd.id] = fd.width;
+        FontHeight[fd.id] = fd.height;
     }
-    
-    // Update default font
     FontWidth[FONT_DEFAULT]  = FontWidth[FONT_TIMES_24];
     FontHeight[FONT_DEFAULT] = FontHeight[FONT_TIMES_24];
-    FontBaseline[FONT_DEFAULT] = FontBaseline[FONT_TIMES_24];
-    XftFontsArr[FONT_DEFAULT] = XftFontsArr[FONT_TIMES_24];
-    
+
     printf("Term font reloading completed with family: %s\n", font_family);
     return 0;
 }
@@ -3328,10 +3259,17 @@ void UpdateSystemCB(XtPointer client_data, XtIntervalId *time_id)
 {
     FnTrace("UpdateSystemCB()");
 
+    static vt::LatencyHistogram &update_cost = vt::Metrics().Histogram(
+        "vt_update_system_seconds", "Time spent in one UpdateSystemCB() pass");
+    static vt::LatencyHistogram &update_gap = vt::Metrics().Histogram(
+        "vt_update_gap_seconds", "Time between UpdateSystemCB() passes");
+    vt::ScopedLatency update_timer(update_cost);
+
     // Detect event-loop stalls to help diagnose rare freezes/lockups
     static auto last_tick = std::chrono::steady_clock::now();
     auto now_tick = std::chrono::steady_clock::now();
     auto loop_gap = std::chrono::duration_cast<std::chrono::milliseconds>(now_tick - last_tick);
+    update_gap.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now_tick - last_tick).count());
     if (loop_gap > std::chrono::milliseconds(3000)) {
         std::array<char, 256> msg{};
         vt::cpp23::format_to_buffer(msg.data(), msg.size(), "UpdateSystemCB lag detected: {} ms since last tick",
@@ -3459,11 +3397,13 @@ void UpdateSystemCB(XtPointer client_data, XtIntervalId *time_id)
     }
 
     // Update Terminals
+    ExpireLostSessions();
     Control *con = MasterControl;
     Terminal  *term = con->TermList();
     while (term)
     {
         Terminal *tnext = term->next;
+        vt::ScopedLatency term_timer(term->UpdateStat());
         if (term->reload_zone_db && term->user == nullptr)
         {
             // Reload zone information if needed
@@ -3491,26 +3431,8 @@ void UpdateSystemCB(XtPointer client_data, XtIntervalId *time_id)
             // if the page contains a ReportZone configured to display a Check
             // on a video target (or with a check display number), treat it like
             // a kitchen/video page so UPDATE_BLINK is sent and timers update.
-            bool page_has_video_report = false;
-            Zone *z = term->page->ZoneList();
-            while (z != nullptr)
-            {
-                if (z->Type() == ZONE_REPORT)
-                {
-                    int *rt = z->ReportType();
-                    if (rt && *rt == REPORT_CHECK)
-                    {
-                        int *vt = z->VideoTarget();
-                        int *cdn = z->CheckDisplayNum();
-                        if ((vt && *vt != PRINTER_DEFAULT) || (cdn && *cdn != 0))
-                        {
-                            page_has_video_report = true;
-                            break;
-                        }
-                    }
-                }
-                z = z->next;
-            }
+            // Page::Subscribe() works that out when the page's zones change.
+            bool page_has_video_report = term->page->HasVideoReport();
 
             if (term->page->IsTable() || term->page->IsKitchen() || page_has_video_report)
                 u |= UPDATE_BLINK;  // half second blink message for table/pages with video reports
@@ -3536,12 +3458,34 @@ void UpdateSystemCB(XtPointer client_data, XtIntervalId *time_id)
     if (UserCommand != 0)
         RunUserCommand();
 
+    if (StatsDump)
+    {
+        StatsDump = 0;
+        if (vt::Metrics().Dump(VIEWTOUCH_STATS_FILE) == 0)
+            ReportError("Statistics written to " VIEWTOUCH_STATS_FILE);
+    }
+
     // Update data persistence manager
     GetDataPersistenceManager().Update();
 
     // restart system timer
-    UpdateID = XtAppAddTimeOut(App, UPDATE_TIME,
-                               (XtTimerCallbackProc) UpdateSystemCB, client_data);
+    UpdateID = AddTimeOutFn((TimeOutFn) UpdateSystemCB, UPDATE_TIME, client_data);
+}
+
+void StatsSocketCB(XtPointer /*client_data*/, int * /*fid*/, XtInputId * /*id*/)
+{
+    FnTrace("StatsSocketCB()");
+    StatsServer.Serve(vt::Metrics());
+    if (StatsServer.Pending() > 0 && StatsFlushID == 0)
+        StatsFlushID = AddTimeOutFn((TimeOutFn) StatsFlushCB, STATS_FLUSH_TIME, nullptr);
+}
+
+void StatsFlushCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
+{
+    FnTrace("StatsFlushCB()");
+    StatsFlushID = 0;  // one-shot; it has already fired
+    if (StatsServer.Flush() > 0)
+        StatsFlushID = AddTimeOutFn((TimeOutFn) StatsFlushCB, STATS_FLUSH_TIME, nullptr);
 }
 
 /****
@@ -3915,8 +3859,7 @@ void ShowRestartDialog()
     sd->Button(GlobalTranslate("Postpone 1 Hour"), "restart_postpone");
     
     // Set 5-minute auto-restart timeout
-    restart_timeout_id = XtAppAddTimeOut(App, 5 * 60 * 1000, 
-                                       (XtTimerCallbackProc) AutoRestartTimeoutCB, nullptr);
+    restart_timeout_id = AddTimeOutFn((TimeOutFn) AutoRestartTimeoutCB, 5 * 60 * 1000, nullptr);
     
     term->OpenDialog(sd);
 }
@@ -3981,36 +3924,188 @@ int GetTextWidth(const char* my_string, int len, int font_id)
     FnTrace("GetTextWidth()");
     if (my_string == nullptr || len <= 0)
         return 0;
-    else if (FontInfo[font_id])
-        return XTextWidth(FontInfo[font_id], my_string, len);
     else
         return FontWidth[font_id] * len;
 }
 
+/****
+ * UseHeadlessLoop:  Returns true if vt_main should dispatch timers, inputs
+ *  and work procs with the epoll event loop instead of Xt.  VT_EVENT_LOOP
+ *  ("epoll" or "xt") in the environment overrides the build default
+ *  (cmake -DVT_HEADLESS=ON).
+ ****/
+bool UseHeadlessLoop()
+{
+    FnTrace("UseHeadlessLoop()");
+    const char* backend = getenv("VT_EVENT_LOOP");
+    if (backend != nullptr && strcmp(backend, "epoll") == 0)
+        return true;
+    if (backend != nullptr && strcmp(backend, "xt") == 0)
+        return false;
+#ifdef VT_HEADLESS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/****
+ * Callback timing:  Every callback registered below goes through a
+ *  trampoline that times it into vt_callback_seconds{type=...}, and
+ *  named work procs also into vt_work_slice_seconds{work=...}.  The
+ *  trampolines own a TimedCallback per registration, freed when Xt (or
+ *  the headless loop) drops the callback.  Callbacks may remove or
+ *  re-add themselves, so the trampolines copy what they need first and
+ *  never touch the TimedCallback after the call.
+ ****/
+namespace
+{
+struct TimedCallback
+{
+    void (*fn)();
+    void *client_data;
+    vt::LatencyHistogram *callback_hist;
+    vt::LatencyHistogram *slice_hist;  // work procs with a stat name
+    unsigned long id;
+};
+
+using TimedMap = std::map<unsigned long, std::unique_ptr<TimedCallback>>;
+TimedMap TimedTimeOuts;
+TimedMap TimedInputs;
+TimedMap TimedWorks;
+
+vt::LatencyHistogram &CallbackHistogram(const char* type)
+{
+    return vt::Metrics().Histogram("vt_callback_seconds",
+                                   "Event loop callback run time by callback type",
+                                   vt::MetricLabel("type", type));
+}
+
+void ForgetTimed(TimedMap &timed, unsigned long id, const TimedCallback *expected)
+{
+    auto it = timed.find(id);
+    if (it != timed.end() && it->second.get() == expected)
+        timed.erase(it);
+}
+
+void TimedTimeOutCB(void *data, unsigned long *id)
+{
+    auto *tc = static_cast<TimedCallback*>(data);
+    // timeouts are one-shot; take ownership back before the callback
+    // can add a new timeout that reuses the id
+    std::unique_ptr<TimedCallback> owned;
+    auto it = TimedTimeOuts.find(tc->id);
+    if (it != TimedTimeOuts.end() && it->second.get() == tc)
+    {
+        owned = std::move(it->second);
+        TimedTimeOuts.erase(it);
+    }
+
+    vt::ScopedLatency timer(*tc->callback_hist);
+    reinterpret_cast<void (*)(void*, unsigned long*)>(tc->fn)(tc->client_data, id);
+}
+
+void TimedInputCB(void *data, int *fd, unsigned long *id)
+{
+    auto *tc = static_cast<TimedCallback*>(data);
+    auto fn = reinterpret_cast<void (*)(void*, int*, unsigned long*)>(tc->fn);
+    void *client_data = tc->client_data;
+
+    vt::ScopedLatency timer(*tc->callback_hist);
+    fn(client_data, fd, id);  // may RemoveInputFn() itself, freeing tc
+}
+
+int TimedWorkCB(void *data)
+{
+    auto *tc = static_cast<TimedCallback*>(data);
+    auto fn = reinterpret_cast<int (*)(void*)>(tc->fn);
+    void *client_data = tc->client_data;
+    vt::LatencyHistogram *slice = tc->slice_hist;
+    unsigned long id = tc->id;
+
+    int64_t start = vt::MetricsNowNs();
+    int done = fn(client_data);
+    int64_t elapsed = vt::MetricsNowNs() - start;
+    static vt::LatencyHistogram &hist = CallbackHistogram("work");
+    hist.Record(elapsed);
+    if (slice)
+        slice->Record(elapsed);
+    if (done)
+        ForgetTimed(TimedWorks, id, tc);
+    return done;
+}
+} // namespace
+
 unsigned long AddTimeOutFn(TimeOutFn fn, int timeint, void *client_data)
 {
     FnTrace("AddTimeOutFn()");
-    return XtAppAddTimeOut(App, timeint, (XtTimerCallbackProc) fn,
-                           (XtPointer) client_data);
+    static vt::LatencyHistogram &hist = CallbackHistogram("timer");
+    auto tc = std::make_unique<TimedCallback>(TimedCallback{fn, client_data, &hist, nullptr, 0});
+
+    unsigned long id;
+    if (HeadlessLoop)
+        id = HeadlessLoop->AddTimeOut(TimedTimeOutCB, timeint, tc.get());
+    else
+        id = XtAppAddTimeOut(App, timeint, (XtTimerCallbackProc) TimedTimeOutCB,
+                             (XtPointer) tc.get());
+    if (id == 0)
+        return 0;
+    tc->id = id;
+    TimedTimeOuts[id] = std::move(tc);
+    return id;
 }
 
 unsigned long AddInputFn(InputFn fn, int device_no, void *client_data)
 {
     FnTrace("AddInputFn()");
-    return XtAppAddInput(App, device_no, (XtPointer) XtInputReadMask,
-                         (XtInputCallbackProc) fn, (XtPointer) client_data);
+    static vt::LatencyHistogram &hist = CallbackHistogram("input");
+    auto tc = std::make_unique<TimedCallback>(TimedCallback{fn, client_data, &hist, nullptr, 0});
+
+    unsigned long id;
+    if (HeadlessLoop)
+        id = HeadlessLoop->AddInput(TimedInputCB, device_no, tc.get());
+    else
+        id = XtAppAddInput(App, device_no, (XtPointer) XtInputReadMask,
+                           (XtInputCallbackProc) TimedInputCB, (XtPointer) tc.get());
+    if (id == 0)
+        return 0;
+    tc->id = id;
+    TimedInputs[id] = std::move(tc);
+    return id;
 }
 
-unsigned long AddWorkFn(WorkFn fn, void *client_data)
+unsigned long AddWorkFn(WorkFn fn, void *client_data, const char* stat_name)
 {
     FnTrace("AddWorkFn()");
-    return XtAppAddWorkProc(App, (XtWorkProc) fn, (XtPointer) client_data);
+    vt::LatencyHistogram *slice = nullptr;
+    if (stat_name)
+    {
+        slice = &vt::Metrics().Histogram("vt_work_slice_seconds",
+                                         "Time per work proc call, by work type",
+                                         vt::MetricLabel("work", stat_name));
+    }
+    auto tc = std::make_unique<TimedCallback>(TimedCallback{(void (*)()) fn, client_data,
+                                                            nullptr, slice, 0});
+
+    unsigned long id;
+    if (HeadlessLoop)
+        id = HeadlessLoop->AddWorkProc(TimedWorkCB, tc.get());
+    else
+        id = XtAppAddWorkProc(App, (XtWorkProc) TimedWorkCB, (XtPointer) tc.get());
+    if (id == 0)
+        return 0;
+    tc->id = id;
+    TimedWorks[id] = std::move(tc);
+    return id;
 }
 
 int RemoveTimeOutFn(unsigned long fn_id)
 {
     FnTrace("RemoveTimeOutFn()");
-    if (fn_id > 0l)
+    TimedTimeOuts.erase(fn_id);
+    if (fn_id > 0l && HeadlessLoop)
+        HeadlessLoop->RemoveTimeOut(fn_id);
+    else if (fn_id > 0l)
         XtRemoveTimeOut(fn_id);
     return 0;
 }
@@ -4018,7 +4113,12 @@ int RemoveTimeOutFn(unsigned long fn_id)
 int RemoveInputFn(unsigned long fn_id)
 {
     FnTrace("RemoveInputFn()");
-    if (fn_id > 0)
+    TimedInputs.erase(fn_id);
+    if (fn_id > 0 && HeadlessLoop)
+    {
+        HeadlessLoop->RemoveInput(fn_id);
+    }
+    else if (fn_id > 0)
     {
         // Check if App context is still valid before removing input
         if (App != nullptr)
@@ -4033,10 +4133,13 @@ int RemoveInputFn(unsigned long fn_id)
     return 0;
 }
 
-int ReportWorkFn(int fn_id)
+int RemoveWorkFn(unsigned long fn_id)
 {
-    FnTrace("ReportWorkFn()");
-    if (fn_id > 0)
+    FnTrace("RemoveWorkFn()");
+    TimedWorks.erase(fn_id);
+    if (fn_id > 0 && HeadlessLoop)
+        HeadlessLoop->RemoveWorkProc(fn_id);
+    else if (fn_id > 0)
         XtRemoveWorkProc(fn_id);
     return 0;
 }
@@ -4044,46 +4147,11 @@ int ReportWorkFn(int fn_id)
 int ReloadFonts()
 {
     FnTrace("ReloadFonts()");
-    
-    // Reload all fonts using the FontData array specifications
+
+    // Update font dimensions from FontData array to maintain UI layout compatibility
     for (int f = 0; f < 32; ++f) {
-        if (XftFontsArr[f]) {
-            XftFontClose(Dis, XftFontsArr[f]);
-            XftFontsArr[f] = nullptr;
-        }
-        
-        // Find the font in FontData array and use its specification directly
-        int found = 0;
-        for (auto & fd : FontData) {
-            if (fd.id == f) {
-                // Use the font specification directly from FontData
-                const char* font_spec = fd.font;
-                
-                // Append :dpi=96 to font specification if not already present
-                static std::array<char, 256> font_spec_with_dpi;
-                const char* font_to_load = font_spec;
-                if (strstr(font_spec, ":dpi=") == nullptr) {
-                    vt::cpp23::format_to_buffer(font_spec_with_dpi.data(), font_spec_with_dpi.size(), "{}:dpi=96", font_spec);
-                    font_to_load = font_spec_with_dpi.data();
-                }
-                
-                // Load the font using the original specification with fixed DPI
-                XftFontsArr[f] = XftFontOpenName(Dis, DefaultScreen(Dis), font_to_load);
-                if (!XftFontsArr[f]) {
-                    printf("Failed to reload font %d: %s\n", f, font_to_load);
-                } else {
-                    printf("Successfully reloaded font %d: %s\n", f, font_to_load);
-                }
-                found = 1;
-                break;
-            }
-        }
-        if (!found) {
-            // Default font if not found, with fixed DPI
-            XftFontsArr[f] = XftFontOpenName(Dis, DefaultScreen(Dis), "DejaVu Serif:pixelsize=24:style=Book:dpi=96");
-        }
-        
-        // Update font dimensions from FontData array to maintain UI layout compatibility
+        FontWidth[f] = 0;
+        FontHeight[f] = 0;
         for (auto & fd : FontData) {
             if (fd.id == f) {
                 FontWidth[f] = fd.width;
@@ -4096,21 +4164,14 @@ int ReloadFonts()
             FontWidth[f] = 12;
             FontHeight[f] = 24;
         }
-        
-        // Calculate baseline from Xft font if available, otherwise use 3/4 of height
-        if (XftFontsArr[f]) {
-            FontBaseline[f] = XftFontsArr[f]->ascent;
-        } else {
-            FontBaseline[f] = FontHeight[f] * 3 / 4;  // Typical baseline position
-        }
     }
-    
+
     // Update default font
     FontWidth[FONT_DEFAULT]  = FontWidth[FONT_TIMES_24];
     FontHeight[FONT_DEFAULT] = FontHeight[FONT_TIMES_24];
-    FontBaseline[FONT_DEFAULT] = FontBaseline[FONT_TIMES_24];
-    XftFontsArr[FONT_DEFAULT] = XftFontsArr[FONT_TIMES_24];
-    
+
+    // The terminals reopen their Xft fonts and answer with new glyph
+    // advance tables (ServerProtocol::SrvFontMetrics)
     // Notify all terminals to reload fonts
     Terminal *term = MasterControl->TermList();
     while (term != nullptr) {
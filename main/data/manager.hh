@@ -53,6 +53,7 @@
 #define LANGUAGE_DATA_DIR    "languages"
 #define PAGEEXPORTS_DIR      "pageexports"
 #define PAGEIMPORTS_DIR      "pageimports"
+#define SPOOL_DATA_DIR       "spool"
 #define STOCK_DATA_DIR       "stock"
 #define TEXT_DATA_DIR        "text"
 #define UPDATES_DATA_DIR     "updates"
@@ -76,7 +77,7 @@ class Control
     DList<Printer>  printer_list;
 
 public:
-    std::unique_ptr<ZoneDB> zone_db; // pointer to most current zone_db
+    std::shared_ptr<ZoneDB> zone_db; // most current zone_db, shared by the terminals' copies
     int     master_copy;      // boolean - is zone_db only pointer to object?
 
     Control();
@@ -171,8 +172,8 @@ int RemoveTimeOutFn(unsigned long fn_id);
 unsigned long AddInputFn(InputFn fn, int device_no, void *client_data);
 int RemoveInputFn(unsigned long fn_id);
 
-// Add/Remove work function
-unsigned long AddWorkFn(WorkFn fn, void *client_data);
+// Add/Remove work function; stat_name labels its vt_work_slice_seconds
+unsigned long AddWorkFn(WorkFn fn, void *client_data, const char* stat_name = nullptr);
 int RemoveWorkFn(unsigned long fn_id);
 
 // looks at local copy of fonts so requests don't go to term programs
@@ -1131,6 +1131,7 @@ PrinterInfo::PrinterInfo()
     model        = 0;
     port         = 0;
     order_margin = 0;
+    coalesce_ms  = 0;
     kitchen_mode = PRINT_LARGE | PRINT_NARROW;
 }
 
@@ -1150,6 +1151,8 @@ int PrinterInfo::Read(InputDataFile &df, int version)
         error += df.Read(kitchen_mode);
     if (version >= 93)
         error += df.Read(order_margin);
+    if (version >= 108)
+        error += df.Read(coalesce_ms);
 
     return error;
 }
@@ -1166,6 +1169,7 @@ int PrinterInfo::Write(OutputDataFile &df, int version)
     error += df.Write(type);
     error += df.Write(kitchen_mode);
     error += df.Write(order_margin);
+    error += df.Write(coalesce_ms);
 
     return error;
 }
@@ -1182,6 +1186,8 @@ int PrinterInfo::OpenPrinter(Control *control_db, int update)
         p->SetType(type);
         p->SetKitchenMode(kitchen_mode);
 	p->order_margin = order_margin;
+        p->SetCoalesce(coalesce_ms);
+        p->RequeueFailed();  // turning a printer back on retries what it missed
         if (update)
             control_db->UpdateAll(UPDATE_PRINTERS, nullptr);
     }
@@ -4352,10 +4358,45 @@ int Settings::PrinterReport(Terminal *t, Report *r)
             r->TextPosL(52, PrinterModelName[idx]);
 
         Printer *p = pi->FindPrinter(t->parent);
-        if (p)
-            r->TextPosL(64, t->Translate("Okay"), COLOR_GREEN);
-        else
+        if (p == nullptr)
             r->TextPosL(64, t->Translate("Turned Off"), COLOR_RED);
+        else
+        {
+            // print spooler queue: jobs waiting, or how long jobs take on
+            // average and how many each printer connection carried
+            vt::PrintQueueStats queue = p->QueueStats();
+            if (queue.depth > 0)
+            {
+                vt_safe_string::safe_format(buffer, STRLENGTH, "%d %s", static_cast<int>(queue.depth),
+                                            t->Translate("Queued"));
+                r->TextPosL(64, buffer, queue.attempts > 0 ? COLOR_RED : COLOR_ORANGE);
+            }
+            else if (queue.held > 0)
+            {
+                // given up on; turning the printer off and on queues them again
+                vt_safe_string::safe_format(buffer, STRLENGTH, "%d %s", static_cast<int>(queue.held),
+                                            t->Translate("Failed"));
+                r->TextPosL(64, buffer, COLOR_RED);
+            }
+            else if (queue.printed > 0 && queue.connections > 0)
+            {
+                vt_safe_string::safe_format(buffer, STRLENGTH, "%s %.1fs %.1f/conn", t->Translate("Okay"),
+                                            static_cast<double>(queue.total_latency_ms) / 1000.0 /
+                                                static_cast<double>(queue.printed),
+                                            static_cast<double>(queue.printed) /
+                                                static_cast<double>(queue.connections));
+                r->TextPosL(64, buffer, COLOR_GREEN);
+            }
+            else if (queue.printed > 0)
+            {
+                vt_safe_string::safe_format(buffer, STRLENGTH, "%s %.1fs", t->Translate("Okay"),
+                                            static_cast<double>(queue.total_latency_ms) / 1000.0 /
+                                                static_cast<double>(queue.printed));
+                r->TextPosL(64, buffer, COLOR_GREEN);
+            }
+            else
+                r->TextPosL(64, t->Translate("Okay"), COLOR_GREEN);
+        }
 
         r->NewLine();
         pi = pi->next;
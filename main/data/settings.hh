@@ -30,7 +30,7 @@
 // NOTE:  WHEN UPDATING SETTINGS DO NOT FORGET that you may also
 // need to update archive.hh and archive.cc for settings which
 // should be maintained historically.
-constexpr int SETTINGS_VERSION = 107;  // READ ABOVE
+constexpr int SETTINGS_VERSION = 108;  // READ ABOVE
 
 
 /**** Definitions & Data ****/
@@ -523,6 +523,7 @@ public:
     int port;
     int kitchen_mode;
     int order_margin;		// blank lines at top of work order
+    int coalesce_ms;		// send tickets this close together as one job
 
     // Constructor
     PrinterInfo();
@@ -26,7 +26,6 @@
 #include "src/utils/vt_logger.hh"
 #include "safe_string_utils.hh"
 #include "src/utils/cpp23_utils.hh"
-#include "src/core/thread_pool.hh"
 
 #include <errno.h>
 #include <iostream>
@@ -44,6 +43,8 @@
 #include <unistd.h>
 #include <cstring>
 #include <cctype>
+#include <fstream>
+#include <iterator>
 
 #ifdef DMALLOC
 #include <dmalloc.h>
@@ -119,8 +120,6 @@ Printer::Printer()
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set("");
     target_type  = TARGET_NONE;
     host_name.Set("");
@@ -144,8 +143,6 @@ Printer::Printer(const genericChar* host, int port, const genericChar* targetstr
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -231,37 +228,32 @@ int Printer::SetTitle(const std::string &title)
 int Printer::Open()
 {
     FnTrace("Printer::Open()");
-    int retval = 0;
-    genericChar filename[STRLENGTH] = "/tmp/viewtouchXXXXXX";
+    job.clear();
+    job_open = true;
+    return 0;
+}
 
-    temp_fd = mkstemp(filename);
-    if (filename[0] != '\0')
-    {
-        temp_name.Set(filename);
-        vt::Logger::debug("Printer opened successfully - temp file: {}", filename);
-    }
-    else
-    {
-        temp_name.Set("");
-        temp_fd = -1;
-        retval = 1;
-        vt::Logger::error("Failed to create temporary file for printer");
-    }
-    return retval;
+/****
+ * Emit:  Adds bytes to the job being built.  Returns len, like the write()
+ *   to the temp file it replaces.
+ ****/
+ssize_t Printer::Emit(const void *data, size_t len)
+{
+    if (!job_open)
+        return -1;
+    job.append(static_cast<const char *>(data), len);
+    return static_cast<ssize_t>(len);
 }
 
 /****
- * Close:  Need to close out the resulting file and send it off to the
- *   destination.
+ * Close:  Need to send the finished job off to the destination.
  ****/
 int Printer::Close()
 {
     FnTrace("Printer::Close()");
 
-    // assume we're going to do something.  But only close if we're pretty
-    // sure we have a valid file handle
-    if (temp_fd > 0)
-        close(temp_fd);
+    if (!job_open)
+        return 0;
     switch (target_type)
     {
     case TARGET_PARALLEL:
@@ -280,145 +272,11 @@ int Printer::Close()
         EmailPrint();
         break;
     }
-    // delete the temp file unless printing to the parallel port might still need it
-    if (target_type != TARGET_PARALLEL)
-        unlink(temp_name.Value());
-    temp_name.Set("");
-    temp_fd = -1;
+    job.clear();
+    job_open = false;
     return 0;
 }
 
-/****
- * CloseAsync:  Non-blocking version of Close() for use when UI responsiveness
- *   is critical.  Spawns the print job to a background thread.
- *   Note: Only works for socket and LPD printing where the temp file can be
- *   safely copied and processed asynchronously.
- ****/
-void Printer::CloseAsync()
-{
-    FnTrace("Printer::CloseAsync()");
-
-    // Close the temp file handle first
-    if (temp_fd > 0)
-        close(temp_fd);
-    temp_fd = -1;
-
-    // For parallel printing, we still use synchronous (it already forks)
-    // For file/email, use sync since they're local operations
-    if (target_type == TARGET_PARALLEL || target_type == TARGET_FILE || 
-        target_type == TARGET_EMAIL)
-    {
-        // Fall back to sync for these
-        switch (target_type)
-        {
-        case TARGET_PARALLEL:
-            ParallelPrint();
-            break;
-        case TARGET_FILE:
-            FilePrint();
-            break;
-        case TARGET_EMAIL:
-            EmailPrint();
-            break;
-        default:
-            break;
-        }
-        unlink(temp_name.Value());
-        temp_name.Set("");
-        return;
-    }
-
-    // For socket and LPD, run async
-    // Capture temp file name for async operation
-    std::string temp_file = temp_name.Value();
-    std::string target_str = target.Value();
-    int port = port_no;
-    int type = target_type;
-
-    temp_name.Set("");  // Clear so printer can be reused
-
-    // Queue the print job to the thread pool
-    vt::ThreadPool::instance().enqueue_detached(
-        [temp_file, target_str, port, type]() {
-            vt::Logger::debug("Async print starting: {} -> {}:{}", temp_file, target_str, port);
-            
-            if (type == TARGET_SOCKET)
-            {
-                // Socket printing logic (duplicated to avoid this pointer issues)
-                ssize_t bytesread;
-                ssize_t byteswritten = 1;
-                char buffer[4096];
-                struct hostent *he;
-                struct sockaddr_in their_addr;
-
-                he = gethostbyname(target_str.c_str());
-                if (he == nullptr)
-                {
-                    vt::Logger::error("Async SocketPrint: Failed to resolve host '{}'", target_str);
-                    unlink(temp_file.c_str());
-                    return;
-                }
-
-                int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-                if (sockfd == -1)
-                {
-                    vt::Logger::error("Async SocketPrint: Failed to create socket");
-                    unlink(temp_file.c_str());
-                    return;
-                }
-
-                their_addr.sin_family = AF_INET;
-                their_addr.sin_port = htons(static_cast<uint16_t>(port));
-                their_addr.sin_addr = *((struct in_addr *)he->h_addr);
-                memset(&(their_addr.sin_zero), '\0', 8);
-
-                if (connect(sockfd, (struct sockaddr *)&their_addr, sizeof(struct sockaddr)) == -1)
-                {
-                    vt::Logger::error("Async SocketPrint: Failed to connect to {}:{}", target_str, port);
-                    close(sockfd);
-                    unlink(temp_file.c_str());
-                    return;
-                }
-
-                int fd = open(temp_file.c_str(), O_RDONLY, 0);
-                if (fd <= 0)
-                {
-                    vt::Logger::error("Async SocketPrint: Failed to open temp file '{}'", temp_file);
-                    close(sockfd);
-                    unlink(temp_file.c_str());
-                    return;
-                }
-
-                bytesread = read(fd, buffer, sizeof(buffer));
-                while (bytesread > 0 && byteswritten > 0)
-                {
-                    byteswritten = write(sockfd, buffer, static_cast<size_t>(bytesread));
-                    bytesread = read(fd, buffer, sizeof(buffer));
-                }
-
-                close(fd);
-                close(sockfd);
-                vt::Logger::info("Async SocketPrint: Successfully printed to {}:{}", target_str, port);
-            }
-            else if (type == TARGET_LPD)
-            {
-                // LPD printing
-                char cmd[512];
-                vt::cpp23::format_to_buffer(cmd, sizeof(cmd), "cat {} | /usr/bin/lpr -P{}", 
-                         temp_file.c_str(), target_str.c_str());
-                int result = system(cmd);
-                if (result != 0)
-                    vt::Logger::error("Async LPDPrint: Command failed with code {}", result);
-                else
-                    vt::Logger::info("Async LPDPrint: Successfully sent to {}", target_str);
-            }
-
-            // Clean up temp file
-            unlink(temp_file.c_str());
-        }
-    );
-}
-
 /****
  * ParallelPrint:  I've been experiencing severe slowdowns with parallel printing.
  *  Apparently, we have to wait until the whole job is done.  So I'm spawning
@@ -433,19 +291,16 @@ int Printer::ParallelPrint()
     pid_t pid;
     genericChar buffer[STRLENGTH];
     int lockfd;
-    int infd;
     int outfd;
     ssize_t bytes;
-    unsigned char buff[STRLENGTH];
+    size_t sent = 0;
     struct timeval timeout;
 
-    vt::cpp23::format_to_buffer(buffer, STRLENGTH, "cat {} >>{}", temp_name.Value(), target.Value());
-
     if (debug_mode)
         printf("Forking for ParallelPrint\n");
     pid = fork();
     if (pid == 0)
-    {  // child process, handle the print job
+    {  // child process, handle the print job from its copy of the buffer
         // Do a loop with a select() call for a brief pause between
         // each write to the parallel port.  On my FreeBSD system,
         // at least, writing to the parallel port seems to lock the
@@ -454,146 +309,105 @@ int Printer::ParallelPrint()
         lockfd = LockDevice(target.Value());
         if (lockfd > 0)
         {
-            infd = open(temp_name.Value(), O_RDONLY);
             outfd = open(target.Value(), O_WRONLY | O_NONBLOCK);
-            if (infd > 0 && outfd > 0)
+            if (outfd > 0)
             {
                 timeout.tv_sec = 0;
                 timeout.tv_usec = 100;
-                bytes = read(infd, buff, STRLENGTH);
-                while (bytes > 0)
+                bytes = 1;
+                while (sent < job.size() && bytes > 0)
                 {
-                    bytes = write(outfd, buff, static_cast<size_t>(bytes));
+                    bytes = write(outfd, job.data() + sent, std::min<size_t>(STRLENGTH, job.size() - sent));
                     select(0, nullptr, nullptr, nullptr, &timeout);
                     if (bytes > 0)
-                        bytes = read(infd, buff, STRLENGTH);
+                        sent += static_cast<size_t>(bytes);
                 }
-                if (infd > 0)
-                    close(infd);
-                if (outfd > 0)
-                    close(outfd);
+                close(outfd);
             }
             else
             {
-                if (infd < 0)
-                {
-                    vt::cpp23::format_to_buffer(buffer, STRLENGTH, "ParallelPrint Error {} opening {} for read",
-                             errno, temp_name.Value());
-                    ReportError(buffer);
-                }
-                if (outfd < 0)
-                {
-                    vt::cpp23::format_to_buffer(buffer, STRLENGTH, "ParallelPrint Error {} opening {} for write",
-                             errno, target.Value());
-                    ReportError(buffer);
-                }
+                vt::cpp23::format_to_buffer(buffer, STRLENGTH, "ParallelPrint Error {} opening {} for write",
+                         errno, target.Value());
+                ReportError(buffer);
             }
             UnlockDevice(lockfd);
         }
         else
-        { // couldn't open one of the files, try cat
-            system(buffer);
+        { // couldn't lock the device, append to it anyway
+            AppendJob(target.Value());
         }
-        unlink(temp_name.Value());
-        exit(0);
+        _exit(0);  // not exit(); the parent's atexit work isn't ours to do
     }
     else if (pid < 0)
-    {  // error, just copy the temp file to the printer without forking
-        system(buffer);
-        unlink(temp_name.Value());
+    {  // error, just copy the job to the printer without forking
+        AppendJob(target.Value());
     }
-    temp_name.Set("");
-    temp_fd = -1;
     return 0;
 }
 
+/****
+ * AppendJob:  Appends the whole job to path, as "cat job >>path" did.
+ ****/
+int Printer::AppendJob(const genericChar* path)
+{
+    FnTrace("Printer::AppendJob()");
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+        return 1;
+    size_t sent = 0;
+    while (sent < job.size())
+    {
+        ssize_t bytes = write(fd, job.data() + sent, job.size() - sent);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes <= 0)
+            break;
+        sent += static_cast<size_t>(bytes);
+    }
+    close(fd);
+    return (sent == job.size()) ? 0 : 1;
+}
+
 int Printer::LPDPrint()
 {
     FnTrace("Printer::LPDPrint()");
-    genericChar buffer[STRLONG];
-
-    vt::cpp23::format_to_buffer(buffer, STRLONG, "cat {} | /usr/bin/lpr -P{}", temp_name.Value(), target.Value());
-    system(buffer);
-    return 0;
+    return SpoolJob();
 }
 
 int Printer::SocketPrint()
 {
     FnTrace("Printer::SocketPrint()");
-    vt::Logger::debug("Starting socket print to {}:{}", target.Value(), port_no);
-
-    ssize_t bytesread;
-    ssize_t byteswritten = 1; // set it to one to ensure one while loop
-    genericChar buffer[STRLENGTH];
-    int sockfd;
-    struct hostent *he;
-    struct sockaddr_in their_addr; // connector's address information
-
-    he = gethostbyname(target.Value());  // get the host info
-    if (he == nullptr)
-    {
-        vt::Logger::error("SocketPrint: Failed to resolve host '{}'", target.Value());
-        perror("gethostbyname");
-        return 1;
-    }
-    
-    sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (sockfd == -1)
-    {
-        vt::Logger::error("SocketPrint: Failed to create socket");
-        perror("socket");
-        return 1;
-    }
-
-    // Set socket timeouts (5 seconds for printer connections)
-    struct timeval timeout;
-    timeout.tv_sec = 5;
-    timeout.tv_usec = 0;
-    setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-    setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-
-    their_addr.sin_family = AF_INET;    // host byte order
-    their_addr.sin_port = htons(port_no);  // short, network byte order
-    their_addr.sin_addr = *((struct in_addr *)he->h_addr);
-    memset(&(their_addr.sin_zero), '\0', 8);  // zero the rest of the struct
+    return SpoolJob();
+}
 
-    if (connect(sockfd, (struct sockaddr *)&their_addr, sizeof(struct sockaddr)) == -1)
-    {
-        vt::Logger::error("SocketPrint: Failed to connect to {}:{}", target.Value(), port_no);
-        perror("connect");
-        fprintf(stderr, "Is vt_print running?\n");
-        close(sockfd);
-        return 1;
-    }
-    
-    temp_fd = open(temp_name.Value(), O_RDONLY, 0);
-    if (temp_fd <= 0)
-    {
-        close(sockfd);
-        vt::Logger::error("SocketPrint: Failed to open temp file '{}' (errno: {})", temp_name.Value(), errno);
-        vt::cpp23::format_to_buffer(buffer, STRLENGTH, "SocketPrint Error {} opening {}",
-                 errno, temp_name.Value());
-        ReportError(buffer);
-        return 1;
-    }
+/****
+ * SpoolTarget:  The print spooler queue this printer's lpd or socket jobs
+ *   go through.
+ ****/
+vt::PrintTarget Printer::SpoolTarget()
+{
+    vt::PrintTarget spool;
+    if (target_type == TARGET_LPD)
+        spool.kind = vt::PrintTarget::Kind::Lpd;
+    spool.host = target.Value();
+    spool.port = port_no;
+    return spool;
+}
 
-    vt::Logger::debug("SocketPrint: Sending data to printer");
-    bytesread = read(temp_fd, buffer, STRLENGTH);
-    while (bytesread > 0 && byteswritten > 0)
+/****
+ * SpoolJob:  Hands the finished job to the print spooler, which sends
+ *   it after this printer's earlier jobs and keeps retrying it while the
+ *   printer is unreachable, so Close() doesn't wait on the network.
+ ****/
+int Printer::SpoolJob()
+{
+    FnTrace("Printer::SpoolJob()");
+    // the buffer moves to the spooler as is; Close() clears what's left
+    if (vt::PrintSpooler::Instance().Submit(SpoolTarget(), std::move(job)) == 0)
     {
-        byteswritten = write(sockfd, buffer, static_cast<size_t>(bytesread));
-        bytesread = read(temp_fd, buffer, STRLENGTH);
-    }
-
-    close(sockfd);
-    close(temp_fd);  // Critical fix: Always close temp_fd before returning
-    
-    if (byteswritten <= 0) {
-        vt::Logger::error("SocketPrint: Failed to write all data to printer");
+        vt::Logger::error("SpoolJob: Print spooler is shut down, job for {} dropped", target.Value());
         return 1;
     }
-
-    vt::Logger::info("SocketPrint: Successfully printed to {}:{}", target.Value(), port_no);
     return 0;
 }
 
@@ -713,19 +527,14 @@ int Printer::IsDirectory(const genericChar* path)
 int Printer::FilePrint()
 {
     FnTrace("Printer::FilePrint()");
-    int retval = 0;
-    int renval = 0;
     genericChar fullpath[STRLENGTH];
-    genericChar command[STRLONG];
 
     GetFilePath(fullpath);
-    vt::cpp23::format_to_buffer(command, STRLONG, "mv {} {}", temp_name.Value(), fullpath);
-    renval = system(command);
-    if (renval < 0)
-        retval = 1;  // return error
-    else
-        chmod(fullpath, 0644);
-    return retval;
+    unlink(fullpath);  // replaced, as the mv from a temp file did
+    if (AppendJob(fullpath))
+        return 1;  // return error
+    chmod(fullpath, 0644);
+    return 0;
 }
 
 int Printer::GetFilePath(char* dest)
@@ -752,13 +561,8 @@ int Printer::GetFilePath(char* dest)
 int Printer::EmailPrint()
 {
     FnTrace("Printer::EmailPrint()");
-    genericChar buffer[STRLONG];
-    int buffidx;
-    ssize_t bytesread;
-    genericChar line[STRLONG];
-    int lineidx;
+    std::string line;
     Email email;
-    int fd;
     int sockfd;
     Settings *settings = MasterControl->TermList()->GetSettings();
 
@@ -771,40 +575,17 @@ int Printer::EmailPrint()
     email.AddFrom(settings->email_replyto.Value());
     email.AddSubject(page_title.c_str());
 
-    // now read in the file and add it to the email
-    fd = open(temp_name.Value(), O_RDONLY);
-    if (fd > 0)
+    // now add the job to the email a line at a time
+    line.clear();
+    for (char c : job)
     {
-        lineidx = 0;
-        bytesread = read(fd, buffer, STRLONG);
-        while (bytesread > 0)
+        if (c == '\n' && !line.empty())
         {
-            buffidx = 0;
-            while (buffidx < bytesread)
-            {
-                if (buffer[buffidx] == '\n' && lineidx > 0)
-                {
-                    line[lineidx] = '\0';
-                    email.AddBody(line);
-                    lineidx = 0;
-                    buffidx += 1;
-                }
-                else
-                {
-                    line[lineidx] = buffer[buffidx];
-                    buffidx += 1;
-                    lineidx += 1;
-                }
-            }
-            bytesread = read(fd, buffer, STRLONG);
+            email.AddBody(line.c_str());
+            line.clear();
         }
-        close(fd);
-    }
-    else if (fd < 0)
-    {
-        vt::cpp23::format_to_buffer(buffer, STRLONG, "EmailPrint Error {} opening {}",
-                 errno, temp_name.Value());
-        ReportError(buffer);
+        else
+            line.push_back(c);
     }
 
     // Email the file
@@ -856,7 +637,7 @@ int Printer::WriteLR(const genericChar* left, const genericChar* right, int flag
     while ((llen + rlen + 1 - pos) > width && pos < llen)
     {
         ssize_t write_len = (pos + width > llen) ? (llen - pos) : width;
-        if (write(temp_fd, &left[pos], write_len) < 0)
+        if (Emit(&left[pos], write_len) < 0)
         {
             vt::Logger::error("Printer::WriteLR failed to write truncated left text");
             return 1;
@@ -865,7 +646,7 @@ int Printer::WriteLR(const genericChar* left, const genericChar* right, int flag
         if (write_len < width)
         {
             memset(str, ' ', width - write_len);
-            if (write(temp_fd, str, width - write_len) < 0)
+            if (Emit(str, width - write_len) < 0)
             {
                 vt::Logger::error("Printer::WriteLR failed to write padding spaces");
                 return 1;
@@ -891,7 +672,7 @@ int Printer::WriteLR(const genericChar* left, const genericChar* right, int flag
         vt_safe_string::safe_copy(&str[width - rlen], 256 - (width - rlen), right);
     }
 
-    write(temp_fd, str, width);
+    Emit(str, width);
     NewLine();
     return 0;
 }
@@ -899,11 +680,11 @@ int Printer::WriteLR(const genericChar* left, const genericChar* right, int flag
 int Printer::Write(const genericChar* my_string, int flags)
 {
     FnTrace("Printer::Write()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     WriteFlags(flags);
-    if (write(temp_fd, my_string, strlen(my_string)) < 0) {
+    if (Emit(my_string, strlen(my_string)) < 0) {
         vt::Logger::error("Printer::Write failed to write string");
         return 1;
     }
@@ -917,7 +698,7 @@ int Printer::Put(const genericChar* my_string, int flags)
     if (WriteFlags(flags))
         return 1;
 
-    if (write(temp_fd, my_string, strlen(my_string)) < 0) {
+    if (Emit(my_string, strlen(my_string)) < 0) {
         vt::Logger::error("Printer::Put failed to write string");
         return 1;
     }
@@ -931,7 +712,7 @@ int Printer::Put(genericChar c, int flags)
         return 1;
 
     genericChar str[] = {c};
-    if (write(temp_fd, str, sizeof(str)) < 0) {
+    if (Emit(str, sizeof(str)) < 0) {
         vt::Logger::error("Printer::Put failed to write character");
         return 1;
     }
@@ -946,7 +727,6 @@ void Printer::DebugPrint(int printall)
     FnTrace("Printer::DebugPrint()");
 
     printf("Printer:\n");
-    printf("    Temp Name:  %s\n", temp_name.Value());
     printf("    Target:  %s\n", target.Value());
     printf("    Host Name:  %s\n", host_name.Value());
     printf("    Page Title:  %s\n", page_title.c_str());
@@ -957,7 +737,7 @@ void Printer::DebugPrint(int printall)
     printf("    Last Large:  %d\n", last_large);
     printf("    Last Narrow:  %d\n", last_narrow);
     printf("    Last Bold:  %d\n", last_bold);
-    printf("    Temp FD:  %d\n", temp_fd);
+    printf("    Job Open:  %d (%zu bytes)\n", job_open, job.size());
     printf("    Target Type:  %d\n", target_type);
     printf("    Port No:  %d\n", port_no);
     printf("    Active Flags:  %d\n", active_flags);
@@ -987,8 +767,6 @@ PrinterIthaca::PrinterIthaca(const genericChar* host, int port, const genericCha
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -1000,7 +778,7 @@ PrinterIthaca::PrinterIthaca(const genericChar* host, int port, const genericCha
 int PrinterIthaca::WriteFlags(int flags)
 {
     FnTrace("PrinterIthaca::WriteFlags()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     active_flags = flags ^ active_flags;
@@ -1011,14 +789,14 @@ int PrinterIthaca::WriteFlags(int flags)
     int mode = 0;
 
     if (flags & PRINT_UNDERLINE)
-		write(temp_fd, underline_start, sizeof(underline_start));
+		Emit(underline_start, sizeof(underline_start));
 	else  //turn underline off (in case it was turned on previously)
-		write(temp_fd, underline_end, sizeof(underline_end));
+		Emit(underline_end, sizeof(underline_end));
 
 	if(flags & PRINT_LARGE)
-		write(temp_fd, quality_high, sizeof(quality_high));
+		Emit(quality_high, sizeof(quality_high));
 	else
-		write(temp_fd, quality_draft, sizeof(quality_draft));
+		Emit(quality_draft, sizeof(quality_draft));
 	last_mode = mode;
 
     return 0;
@@ -1029,7 +807,7 @@ int PrinterIthaca::Start()
     FnTrace("PrinterIthaca::Start()");
 
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
     Init();
     return 0;
@@ -1038,7 +816,7 @@ int PrinterIthaca::Start()
 int PrinterIthaca::End()
 {
     FnTrace("PrinterIthaca::End()");
-	if (temp_fd <= 0)
+	if (!IsOpen())
 		return 1;
 
     FormFeed();
@@ -1061,12 +839,12 @@ int PrinterIthaca::Init()
     //define form feed length as 2 inches
     genericChar formfeed_length[] = { 0x1b, 0x43, FORM_FEED_LEN }; 
     
-    write(temp_fd, init, sizeof(init));
-    write(temp_fd, clear_buffer, sizeof(clear_buffer));
-    write(temp_fd, quality_draft, sizeof(quality_draft));
-    write(temp_fd, justify_left, sizeof(justify_left));
-    write(temp_fd, formfeed_length, sizeof(formfeed_length));
-    write(temp_fd, CR, sizeof(CR));
+    Emit(init, sizeof(init));
+    Emit(clear_buffer, sizeof(clear_buffer));
+    Emit(quality_draft, sizeof(quality_draft));
+    Emit(justify_left, sizeof(justify_left));
+    Emit(formfeed_length, sizeof(formfeed_length));
+    Emit(CR, sizeof(CR));
     last_mode   = 99;
     last_color  = 99;
     last_uni    = 99;
@@ -1088,19 +866,19 @@ int PrinterIthaca::NewLine()
 int PrinterIthaca::LineFeed(int lines)
 {
     FnTrace("PrinterIthaca::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar endline[] = { 0x0a, 0x0d };
     for(int i=0; i < lines; ++i)
-        write(temp_fd, endline, sizeof(endline));
+        Emit(endline, sizeof(endline));
     return 0;
 }
 
 int PrinterIthaca::FormFeed()
 {
     FnTrace("PrinterIthaca::FormFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     LineFeed(8);
@@ -1135,16 +913,16 @@ int PrinterIthaca::OpenDrawer(int drawer)
 {
     FnTrace("PrinterIthaca::OpenDrawer()");
     int close_when_done = 0;
-    if (temp_fd <= 0)
+    if (!IsOpen())
     {
         Open();
         close_when_done = 1;
     }
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x1b, 0x78, '1' };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     if (close_when_done)
         Close();
     return 0;
@@ -1153,11 +931,11 @@ int PrinterIthaca::OpenDrawer(int drawer)
 int PrinterIthaca::CutPaper(int partial_only)
 {
     FnTrace("PrinterIthaca::CutPaper()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x0c, 0x1b, 0x76 };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
@@ -1179,8 +957,6 @@ PrinterStar::PrinterStar(const genericChar* host, int port, const genericChar* t
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -1204,7 +980,7 @@ int PrinterStar::WriteFlags(int flags)
         genericChar str[] = { 0x1b, 0x2d, 0x30 };
         if (uline)
             str[2] = 0x31;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
 
     if (large != last_large)
@@ -1213,12 +989,12 @@ int PrinterStar::WriteFlags(int flags)
         if (large)
         {
             genericChar str[] = { 0x0e, 0x1b, 0x68, 0x01, 0x1b, 0x55, 0x01 };
-            write(temp_fd, str, sizeof(str));
+            Emit(str, sizeof(str));
         }
         else
         {
             genericChar str[] = { 0x14, 0x1b, 0x68, 0x00, 0x1b, 0x55, 0x00 };
-            write(temp_fd, str, sizeof(str));
+            Emit(str, sizeof(str));
         }
     }
 
@@ -1228,7 +1004,7 @@ int PrinterStar::WriteFlags(int flags)
         genericChar str[] = { 0x1b, 0x50 };
         if (narrow)
             str[1] = 0x4d;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
 
     if (bold != last_bold)
@@ -1237,7 +1013,7 @@ int PrinterStar::WriteFlags(int flags)
         genericChar str[] = { 0x1b, 0x46 };
         if (bold)
             str[1] = 0x45;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
     return 0;
 }
@@ -1246,7 +1022,7 @@ int PrinterStar::Start()
 {
     FnTrace("PrinterStar::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
@@ -1257,7 +1033,7 @@ int PrinterStar::Start()
 int PrinterStar::End()
 {
     FnTrace("PrinterStar::End()");
-	if (temp_fd <= 0)
+	if (!IsOpen())
 		return 1;
 
     LineFeed(END_PAGE);
@@ -1271,11 +1047,11 @@ int PrinterStar::End()
 int PrinterStar::Init()
 {
     FnTrace("PrinterStar::Init()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x1b, 0x40 };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     last_mode  = 0;
     last_color = 0;
     last_uni = 0;
@@ -1291,32 +1067,32 @@ int PrinterStar::NewLine()
     FnTrace("PrinterStar::NewLine()");
 
     genericChar str[] = { 0x0a };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
 int PrinterStar::LineFeed(int lines)
 {
     FnTrace("PrinterStar::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     if (lines <= 0)
         return 0;
 
     for (int i = 0; i < lines; ++i)
-        write(temp_fd, "\n", 1);
+        Emit("\n", 1);
     return 0;
 }
 
 int PrinterStar::FormFeed()
 {
     FnTrace("PrinterStar::FormFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x0c };
-    write(temp_fd, str, 1);
+    Emit(str, 1);
     return 0;
 }
 
@@ -1355,12 +1131,12 @@ int PrinterStar::OpenDrawer(int drawer)
     int close_when_done = 0;
     int d;
 
-    if (temp_fd <= 0)
+    if (!IsOpen())
     {
         Open();
         close_when_done = 1;
     }
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     if (pulse >= 0)
@@ -1371,7 +1147,7 @@ int PrinterStar::OpenDrawer(int drawer)
     genericChar str[] = {0x1c};
     if (d == 1)
         str[0] = 0x1a;
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
 
     if (close_when_done)
         Close();
@@ -1382,13 +1158,13 @@ int PrinterStar::OpenDrawer(int drawer)
 int PrinterStar::CutPaper(int partial_only)
 {
     FnTrace("PrinterStar::CutPaper()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x1b, 0x64, 0x0 };
     if (partial_only)
         str[2] = 0x01;
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
@@ -1410,8 +1186,6 @@ PrinterEpson::PrinterEpson(const genericChar* host, int port, const genericChar*
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -1447,21 +1221,21 @@ int PrinterEpson::WriteFlags(int flags)
     {
         unsigned char str[] = { 0x1b, 0x21, (unsigned char)mode };
         last_mode = mode;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
 
     if (color != last_color)
     {
         unsigned char str[] = { 0x1b, 0x72, (unsigned char)color };
         last_color = color;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
 
     if (uni != last_uni)
     {
         unsigned char str[] = { 0x1b, 0x55, (unsigned char)uni };
         last_uni = uni;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
 
     return 0;
@@ -1471,20 +1245,20 @@ int PrinterEpson::Start()
 {
     FnTrace("PrinterEpson::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
     // reset printer head
     genericChar str[] = { 0x1b, 0x3c };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
 int PrinterEpson::End()
 {
     FnTrace("PrinterEpson::End()");
-	if (temp_fd <= 0)
+	if (!IsOpen())
 		return 1;
 
     LineFeed(END_PAGE);
@@ -1498,11 +1272,11 @@ int PrinterEpson::End()
 int PrinterEpson::Init()
 {
     FnTrace("PrinterEpson::Init()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x1b, 0x40, 0x1b, 0x21, 0 };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     last_mode  = 99;
     last_color = 99;
     last_uni = 99;
@@ -1517,28 +1291,28 @@ int PrinterEpson::NewLine()
 {
     FnTrace("PrinterEpson::NewLine()");
     genericChar str[] = { 0x0a };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
 int PrinterEpson::LineFeed(int lines)
 {
     FnTrace("PrinterEpson::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     if (lines <= 0)
         return 0;
 
     genericChar str[] = { 0x1b, 0x64, (genericChar) (lines & 255) };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
 int PrinterEpson::FormFeed()
 {
     FnTrace("PrinterEpson::FormFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     LineFeed(2);
@@ -1579,12 +1353,12 @@ int PrinterEpson::OpenDrawer(int drawer)
 {
     FnTrace("PrinterEpson::OpenDrawer()");
     int close_when_done = 0;
-    if (temp_fd <= 0)
+    if (!IsOpen())
     {
         Open();
         close_when_done = 1;
     }
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar d = 0;
@@ -1593,7 +1367,7 @@ int PrinterEpson::OpenDrawer(int drawer)
     else
         d = static_cast<genericChar>(drawer % 2);
     unsigned char str[] = { 0x1b, 0x70, (unsigned char)d, 100, 255 };
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     if (close_when_done)
         Close();
     return 0;
@@ -1602,13 +1376,13 @@ int PrinterEpson::OpenDrawer(int drawer)
 int PrinterEpson::CutPaper(int partial_only)
 {
     FnTrace("PrinterEpson::CutPaper()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = { 0x1b, 0x69 };
     if (partial_only)
         str[1] = 0x6d;
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
     return 0;
 }
 
@@ -1631,8 +1405,6 @@ PrinterHP::PrinterHP(const genericChar* host, int port, const genericChar* targe
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -1654,12 +1426,12 @@ int PrinterHP::WriteFlags(int flags)
         if (uline)
         {
             genericChar str[] = { 0x1b, 0x26, 0x64, 0x33, 0x44 };
-            write(temp_fd, str, sizeof(str));
+            Emit(str, sizeof(str));
         }
         else
         {
             genericChar str[] = { 0x1b, 0x26, 0x64, 0x40 };
-            write(temp_fd, str, sizeof(str));
+            Emit(str, sizeof(str));
         }
     }
 
@@ -1669,7 +1441,7 @@ int PrinterHP::WriteFlags(int flags)
         genericChar str[] = { 0x1b, 0x28, 0x73, 0x30, 0x42 };
         if (bold)
             str[3] = 0x33;
-        write(temp_fd, str, sizeof(str));
+        Emit(str, sizeof(str));
     }
     return 0;
 }
@@ -1678,7 +1450,7 @@ int PrinterHP::Start()
 {
     FnTrace("PrinterHP::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
@@ -1688,7 +1460,7 @@ int PrinterHP::Start()
 int PrinterHP::End()
 {
     FnTrace("PrinterHP::End()");
-	if (temp_fd <= 0)
+	if (!IsOpen())
 		return 1;
 
     FormFeed();
@@ -1701,13 +1473,13 @@ int PrinterHP::End()
 int PrinterHP::Init()
 {
     FnTrace("PrinterHP::Init()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar str[] = {
         0x1b, 0x45, 27, 40, 115, '6', 't', '1', '2', 'v', '1', '2', 'H',
         27, 38, 97, '1', '2', 'L', 27, 38, 107, 49, 71};
-    write(temp_fd, str, sizeof(str));
+    Emit(str, sizeof(str));
 
     last_mode  = 99;
     last_color = 99;
@@ -1728,14 +1500,14 @@ int PrinterHP::NewLine()
 int PrinterHP::LineFeed(int lines)
 {
     FnTrace("PrinterHP::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     if (lines <= 0)
         return 0;
 
     for (int i = 0; i < lines; ++i)
-        write(temp_fd, "\r\n", 2);
+        Emit("\r\n", 2);
     return 0;
 }
 
@@ -1779,7 +1551,7 @@ int PrinterHP::OpenDrawer(int drawer)
 int PrinterHP::CutPaper(int partial_only)
 {
     FnTrace("PrinterHP::CutPaper()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     // eject paper (no cut available)
@@ -1808,8 +1580,6 @@ PrinterHTML::PrinterHTML(const genericChar* host, int port, const genericChar* t
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -1869,7 +1639,7 @@ int PrinterHTML::WriteFlags(int flags)
             vt_safe_string::safe_concat(flagstr, STRLENGTH, "</font>");
     }
     if (flagstr[0] != '\0')
-        write(temp_fd, flagstr, strlen(flagstr));
+        Emit(flagstr, strlen(flagstr));
     last_large = large;
     last_red = red;
     last_blue = blue;
@@ -1882,7 +1652,7 @@ int PrinterHTML::Start()
 {
     FnTrace("PrinterHTML::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
@@ -1892,7 +1662,7 @@ int PrinterHTML::Start()
 int PrinterHTML::End()
 {
     FnTrace("PrinterHTML::End()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Write("</pre>\n</body>\n</html>");
@@ -1921,14 +1691,14 @@ int PrinterHTML::Init()
 int PrinterHTML::LineFeed(int lines)
 {
     FnTrace("PrinterHTML::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar linefeed[] = "\n";
 
     while (lines > 0)
     {
-        if (write(temp_fd, linefeed, strlen(linefeed)) < 0)
+        if (Emit(linefeed, strlen(linefeed)) < 0)
             break;
         lines -= 1;
     }
@@ -1956,8 +1726,6 @@ PrinterPostScript::PrinterPostScript()
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set("");
     target_type  = TARGET_NONE;
     host_name.Set("");
@@ -1982,8 +1750,6 @@ PrinterPostScript::PrinterPostScript(const genericChar* host, int port, const ge
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -2019,7 +1785,7 @@ int PrinterPostScript::WriteFlags(int flags)
     }
 
     if (flagstr[0] != '\0')
-        write(temp_fd, flagstr, strlen(flagstr));
+        Emit(flagstr, strlen(flagstr));
 
     last_large = large;
     last_red = red;
@@ -2032,7 +1798,7 @@ int PrinterPostScript::Start()
 {
     FnTrace("PrinterPostScript::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
@@ -2042,11 +1808,11 @@ int PrinterPostScript::Start()
 int PrinterPostScript::End()
 {
     FnTrace("PrinterPostScript::End()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar showstring[] = "showpage";
-    write(temp_fd, showstring, strlen(showstring));
+    Emit(showstring, strlen(showstring));
 
     Close();
     have_title = false;
@@ -2107,40 +1873,40 @@ int PrinterPostScript::Init()
             nullptr
             };
     
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     while (lines[idx] != nullptr)
     {
-        if (write(temp_fd, lines[idx], strlen(lines[idx])) < 0)
+        if (Emit(lines[idx], strlen(lines[idx])) < 0)
             break;
         idx += 1;
     }
     if (!have_title)
         page_title = GENERIC_TITLE;
     vt::cpp23::format_to_buffer(buffer, STRLENGTH, "({}) ShowTitleText\n", page_title.c_str());
-    write(temp_fd, buffer, strlen(buffer));
+    Emit(buffer, strlen(buffer));
     return 0;
 }
 
 int PrinterPostScript::NewLine()
 {
     FnTrace("PrinterPostScript::NewLine()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     const genericChar* newlinestr = "\n";
 
     if (putbuffer[0] != '\0')
         Put('\0', -1);
-    write(temp_fd, newlinestr, strlen(newlinestr));
+    Emit(newlinestr, strlen(newlinestr));
     return 0;
 }
 
 int PrinterPostScript::LineFeed(int lines)
 {
     FnTrace("PrinterPostScript::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     while ( lines > 0 )
@@ -2157,8 +1923,8 @@ int PrinterPostScript::FormFeed()
     genericChar showpage[] = "showpage\n";
     genericChar newpage[] = "NewPage\n";
 
-    write(temp_fd, showpage, strlen(showpage));
-    write(temp_fd, newpage, strlen(newpage));
+    Emit(showpage, strlen(showpage));
+    Emit(newpage, strlen(newpage));
     return 0;
 }
 
@@ -2214,7 +1980,7 @@ int PrinterPostScript::WriteLR(const genericChar* left, const genericChar* right
     while ((llen + rlen + 1 - pos) > width && pos < llen)
     {
         ssize_t write_len = (pos + width > llen) ? (llen - pos) : width;
-        if (write(temp_fd, &left[pos], write_len) < 0)
+        if (Emit(&left[pos], write_len) < 0)
         {
             vt::Logger::error("PrinterPostScript::WriteLR failed to write truncated left text");
             return 1;
@@ -2223,7 +1989,7 @@ int PrinterPostScript::WriteLR(const genericChar* left, const genericChar* right
         if (write_len < width)
         {
             memset(str, ' ', width - write_len);
-            if (write(temp_fd, str, width - write_len) < 0)
+            if (Emit(str, width - write_len) < 0)
             {
                 vt::Logger::error("PrinterPostScript::WriteLR failed to write padding spaces");
                 return 1;
@@ -2249,7 +2015,7 @@ int PrinterPostScript::WriteLR(const genericChar* left, const genericChar* right
         vt_safe_string::safe_copy(&str[width - rlen], 256 - (width - rlen), right);
     }
 
-    write(temp_fd, str, width);
+    Emit(str, width);
     NewLine();
     return 0;
 }
@@ -2262,7 +2028,7 @@ int PrinterPostScript::Write(const genericChar* my_string, int flags)
     int idx = 0;
     int buffidx = 0;
     int len = strlen(my_string);
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     while (idx < len)
@@ -2278,7 +2044,7 @@ int PrinterPostScript::Write(const genericChar* my_string, int flags)
     }
     WriteFlags(flags);
     vt_safe_string::safe_format(outstr, STRLONG, "(%s) ShowText", buffer);
-    if (write(temp_fd, outstr, strlen(outstr)) < 0) {
+    if (Emit(outstr, strlen(outstr)) < 0) {
         vt::Logger::error("PrinterPostScript::Write failed to write PostScript text");
         return 1;
     }
@@ -2294,7 +2060,7 @@ int PrinterPostScript::Put(const genericChar* my_string, int flags)
     int idx = 0;
     int buffidx = 0;
     int len = strlen(my_string);
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     while (idx < len)
@@ -2311,7 +2077,7 @@ int PrinterPostScript::Put(const genericChar* my_string, int flags)
     buffer[buffidx] = '\0';
     WriteFlags(flags);
     vt_safe_string::safe_format(outstr, STRLONG, "(%s) ShowText", buffer);
-    if (write(temp_fd, outstr, strlen(outstr)) < 0) {
+    if (Emit(outstr, strlen(outstr)) < 0) {
         vt::Logger::error("PrinterPostScript::Put failed to write PostScript text");
         return 1;
     }
@@ -2360,8 +2126,6 @@ PrinterPDF::PrinterPDF()
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set("");
     target_type  = TARGET_NONE;
     host_name.Set("");
@@ -2384,8 +2148,6 @@ PrinterPDF::PrinterPDF(const genericChar* host, int port, const genericChar* tar
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -2397,26 +2159,30 @@ PrinterPDF::PrinterPDF(const genericChar* host, int port, const genericChar* tar
 int PrinterPDF::Close()
 {
     FnTrace("PrinterPDF::Close()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar filename[STRLONG];
     genericChar pdffullpath[STRLONG];
     genericChar command[STRLONG];
 
-    close(temp_fd);
-
-    // create the PDF filename and convert the temp file
+    // create the PDF filename and convert the PostScript job into it
     MakeFileName(filename, nullptr, ".pdf", STRLONG);
     vt_safe_string::safe_format(pdffullpath, STRLONG, "/tmp/%s", filename);
-    vt_safe_string::safe_format(command, STRLONG, "ps2pdf %s %s", temp_name.Value(), pdffullpath);
-    system(command);
+    vt_safe_string::safe_format(command, STRLONG, "ps2pdf - %s", pdffullpath);
+    FILE *ps2pdf = popen(command, "w");
+    if (ps2pdf != nullptr)
+    {
+        fwrite(job.data(), 1, job.size(), ps2pdf);
+        pclose(ps2pdf);
+    }
 
-    // now get rid of the temp file set the temp_name to the PDF file
-    // for future operations
-    unlink(temp_name.Value());
-    temp_name.Set(pdffullpath);
-    temp_fd = 0;
+    // the PDF replaces the PostScript as the job for the final processing
+    {
+        std::ifstream pdf(pdffullpath, std::ios::binary);
+        job.assign(std::istreambuf_iterator<char>(pdf), std::istreambuf_iterator<char>());
+    }
+    unlink(pdffullpath);
 
     // and do final processing
     PrinterPostScript::Close();
@@ -2444,8 +2210,6 @@ PrinterReceiptText::PrinterReceiptText()
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set("");
     target_type  = 0;
     host_name.Set("");
@@ -2468,8 +2232,6 @@ PrinterReceiptText::PrinterReceiptText(const genericChar* host, int port, const
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -2482,7 +2244,7 @@ int PrinterReceiptText::Start()
 {
     FnTrace("PrinterReceiptText::Start()");
     Open();
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Init();
@@ -2492,7 +2254,7 @@ int PrinterReceiptText::Start()
 int PrinterReceiptText::End()
 {
     FnTrace("PrinterReceiptText::End()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     Close();
@@ -2514,14 +2276,14 @@ int PrinterReceiptText::Init()
 int PrinterReceiptText::LineFeed(int lines)
 {
     FnTrace("PrinterReceiptText::LineFeed()");
-    if (temp_fd <= 0)
+    if (!IsOpen())
         return 1;
 
     genericChar linefeed[] = "\n";
 
     while (lines > 0)
     {
-        if (write(temp_fd, linefeed, strlen(linefeed)) < 0)
+        if (Emit(linefeed, strlen(linefeed)) < 0)
             break;
         lines -= 1;
     }
@@ -2550,8 +2312,6 @@ PrinterReportText::PrinterReportText(const genericChar* host, int port, const ge
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -2804,8 +2564,6 @@ PrinterQuickBooksCSV::PrinterQuickBooksCSV(const genericChar* host, int port, co
     last_bold    = 0;
     port_no      = 0;
     active_flags = 0;
-    temp_fd      = -1;
-    temp_name.Set("");
     target.Set(targetstr);
     target_type  = type;
     host_name.Set(host);
@@ -2835,11 +2593,11 @@ int PrinterQuickBooksCSV::Init()
 int PrinterQuickBooksCSV::LineFeed(int lines)
 {
     FnTrace("PrinterQuickBooksCSV::LineFeed()");
-    if (temp_fd > 0)
+    if (IsOpen())
     {
         for (int i = 0; i < lines; ++i)
         {
-            write(temp_fd, "\n", 1);
+            Emit("\n", 1);
         }
     }
     return 0;
@@ -2848,10 +2606,10 @@ int PrinterQuickBooksCSV::LineFeed(int lines)
 int PrinterQuickBooksCSV::WriteCSVHeader()
 {
     FnTrace("PrinterQuickBooksCSV::WriteCSVHeader()");
-    if (temp_fd > 0)
+    if (IsOpen())
     {
         const char* header = "Date,Type,Account,Description,Amount,Tax\n";
-        write(temp_fd, header, strlen(header));
+        Emit(header, strlen(header));
     }
     return 0;
 }
@@ -2861,7 +2619,7 @@ int PrinterQuickBooksCSV::WriteCSVLine(const char* date, const char* type,
                                        int amount, int tax)
 {
     FnTrace("PrinterQuickBooksCSV::WriteCSVLine()");
-    if (temp_fd > 0)
+    if (IsOpen())
     {
         char line[STRLONG];
         float amount_f = (float)amount / 100.0;
@@ -2869,7 +2627,7 @@ int PrinterQuickBooksCSV::WriteCSVLine(const char* date, const char* type,
         
         vt::cpp23::format_to_buffer(line, STRLONG, "{},{},{},{},{:.2f},{:.2f}\n",
                  date, type, account, description, amount_f, tax_f);
-        write(temp_fd, line, strlen(line));
+        Emit(line, strlen(line));
     }
     return 0;
 }
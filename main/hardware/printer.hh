@@ -22,8 +22,10 @@
 #define PRINTER_HH
 
 #include "utility.hh"
+#include "src/network/print_spooler.hh"
 
 #include <string>
+#include <sys/types.h>
 
 /**** Definitions ****/
 // Printer style flags (converted from macros to enum constants)
@@ -119,8 +121,8 @@ protected:
     int last_large;
     int last_narrow;
     int last_bold;
-    int temp_fd;          // descriptor for temp file
-    Str temp_name;        // name of temp file
+    std::string job;      // output between Open() and Close(), sent from memory
+    bool job_open = false;
     Str target;           // host where printer is located
     int target_type;
     Str host_name;
@@ -132,6 +134,8 @@ protected:
     int kitchen_mode;
 
     virtual int WriteFlags(int flags) = 0;
+    ssize_t Emit(const void *data, size_t len);  // adds to job
+    int AppendJob(const genericChar* path);
     int MakeFileName(genericChar* buffer, const genericChar* source, const genericChar* ext, int max_len);
     int ValidChar(genericChar c);
     int IsDirectory(const genericChar* path);
@@ -156,11 +160,16 @@ public:
     virtual int IsType(int type);
     virtual int SetTitle(const std::string &title);
     virtual int Open();
+    [[nodiscard]] bool IsOpen() const { return job_open; }
     virtual int Close();
-    virtual void CloseAsync();  // Non-blocking version - fire and forget
     virtual int ParallelPrint();
     virtual int LPDPrint();
     virtual int SocketPrint();                           // print to TCP socket
+    int SpoolJob();                                      // queue temp file with the print spooler
+    vt::PrintTarget SpoolTarget();
+    vt::PrintQueueStats QueueStats() { return vt::PrintSpooler::Instance().Stats(SpoolTarget()); }
+    int RequeueFailed() { return vt::PrintSpooler::Instance().RequeueFailed(SpoolTarget()); }
+    void SetCoalesce(int ms) { vt::PrintSpooler::Instance().SetCoalesce(SpoolTarget(), std::chrono::milliseconds(ms)); }
     virtual int FilePrint();                             // print to local file
     virtual int GetFilePath(char* dest);
     virtual int EmailPrint();                            // mail printout to specified address
@@ -181,8 +190,8 @@ public:
     virtual int MaxLines() = 0;                          // max lines per page (-1 for continuous)
     virtual int Width(int flags = 0) = 0;                // returns width based on flags
     virtual int StopPrint() = 0;                         // Stops printing imediately
-    virtual int Start() = 0;                             // Resets printer head position (opens temp file)
-    virtual int End() = 0;                               // line feeds & cuts (prints temp file)
+    virtual int Start() = 0;                             // Resets printer head position (opens a job)
+    virtual int End() = 0;                               // line feeds & cuts (prints the job)
     virtual int OpenDrawer(int drawer) = 0;              // Sends pulse to cash drawer
     virtual int CutPaper(int partial_only = 0) = 0;      // Cuts receipt
     virtual void DebugPrint(int printall = 0);
@@ -35,9 +35,11 @@
 #include "labor.hh"
 #include "locale.hh"
 #include "license_hash.hh"
+#include "content_hash.hh"
 #include "manager.hh"
 #include "printer.hh"
 #include "remote_link.hh"
+#include "resume_session.hh"
 #include "src/utils/vt_enum_utils.hh"
 #include "report.hh"
 #include "sales.hh"
@@ -51,6 +53,7 @@
 #include "src/utils/cpp23_utils.hh"
 #include "safe_string_utils.hh"
 #include "zone.hh"
+#include "zone_script.hh"
 #include "version/vt_version_info.hh"
 #include "../term/term_view.hh"
 
@@ -58,6 +61,7 @@
 #include <errno.h>
 #include <sys/file.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -67,8 +71,10 @@
 #include <X11/keysym.h>
 #include <X11/Intrinsic.h>
 
+#include <chrono>
 #include <string>
 #include <map>
+#include <memory>
 #include <array>
 #include <algorithm>
 
@@ -182,6 +188,32 @@ enum window_buttons {
 #define GRAB_EDGE        16  // number of pixels for move/resize edge
 
 #define SOCKET_FILE "/tmp/vt_term"
+#define RESUME_SOCKET_FILE "/tmp/vt_term_resume"
+#define RESUME_GRACE_SEC   30  // how long a lost vt_term has to come back
+
+static vt::SessionTable<Terminal> TermSessions;
+static int ResumeSocket = -1;  // listens on RESUME_SOCKET_FILE
+
+/****
+ * KillDisconnectedTerm:  Removes a terminal whose vt_term is gone for good,
+ *  along with its printer.
+ ****/
+static void KillDisconnectedTerm(Terminal *term)
+{
+    FnTrace("KillDisconnectedTerm()");
+    Control *db = term->parent;
+    if (db)
+    {
+        Printer *p = db->FindPrinter(term->printer_host.Value(),
+                                     term->printer_port);
+        db->KillPrinter(p, 1);
+        db->KillTerm(term);
+    }
+    else
+    {
+        term->kill_me = 1; // best that can be done without parent pointer
+    }
+}
 
 /**** Calback Functions ****/
 void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
@@ -219,8 +251,16 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
         if (errterm->failure < 8)
             return;
 
+        // A terminal with a session keeps its state for a while in case
+        // vt_term comes back (clones would miss what it replays)
+        if (errterm == term && term->CloneList() == nullptr &&
+            TermSessions.Has(term))
+        {
+            term->LoseSession();
+            return;
+        }
+
         // And now get rid of the terminal.
-        Control *db = term->parent;
         if (errterm->socket_no > 0)
         {
             // close socket here instead of letting the destructor do it
@@ -234,16 +274,9 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
             term->RemoveClone(errterm);
             delete(errterm);
         }
-        else if (db)
-        {
-            Printer *p = db->FindPrinter(term->printer_host.Value(),
-                                         term->printer_port);
-            db->KillPrinter(p, 1);
-            db->KillTerm(term);
-        }
         else
         {
-            term->kill_me = 1; // best that can be done without parent pointer
+            KillDisconnectedTerm(term);
         }
 
         return;
@@ -277,6 +310,12 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
             term->height = term->RInt16();
             term->depth  = term->RInt16();
 
+            // A vt_term without an asset cache gets the full tables
+            if (term->asset_handshake == 0)
+                term->SendTranslations(FamilyName);
+            if (*fid == term->socket_no)
+                term->StartSession();
+
             // Send initial settings
             term->WInt8(TERM_BLANKTIME);
             if (*fid == term->socket_no &&
@@ -346,8 +385,10 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
                 {
                     if (term->record_activity)
                         term->RecordTouch(x, y);
+                    vt::InputSpanScope span(term->input_trace, vt::InputSpan::Touch);
                     term->Touch(x, y);
                 }
+                term->EndInputTrace();
             }
             break;
 
@@ -373,12 +414,14 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
             {
                 if (term->record_activity && (my_code & MOUSE_PRESS))
                     term->RecordMouse(my_code, x, y);
+                vt::InputSpanScope span(term->input_trace, vt::InputSpan::Touch);
                 term->MouseInput(my_code, x, y);
             }
             else if (my_id == WIN_TOOLBAR)
             {
                 term->MouseToolbar(my_code, x, y);
             }
+            term->EndInputTrace();
         }
         break;
 
@@ -563,12 +606,219 @@ void TermCB(XtPointer client_data, int *fid, XtInputId * /*id*/)
         case ServerProtocol::SrvCcSafClearFailed:
             term->cc_processing = 0;
             term->eod_failed = 1;
+            break;
+        case ServerProtocol::SrvFontMetrics:
+            term->ReadFontMetrics();
+            break;
+        case ServerProtocol::SrvAssetHashes:
+            term->ReadAssetHashes();
+            break;
+        case ServerProtocol::SrvInputStamp:
+            term->ReadInputStamp();
+            break;
+        case ServerProtocol::SrvInputSpans:
+            term->ReadInputSpans();
+            break;
+        case ServerProtocol::SrvPressShown:
+            term->ReadPressShown();
+            break;
+        case ServerProtocol::SrvResume:
+            // only valid as the first frame on the resume socket, which
+            // ResumeHelloCB() reads; here it's dropped with its token
+            term->RStr();
+            ReportError("TermCB: Ignoring SrvResume on a session connection");
             break;
 		} //end switch
         last_code = code;
 	} //end while
 }
 
+/****
+ * ResumeHello:  A resume connection until its first frame, which names the
+ *  session it picks up, is in.  The frame is collected over as many input
+ *  callbacks as it takes, so a slow or stalled client never holds up the
+ *  event loop.  Anything else, or no hello within RESUME_HELLO_MS, is hung
+ *  up on.
+ ****/
+static constexpr int RESUME_HELLO_MS  = 2000;
+static constexpr int RESUME_HELLO_MAX = 1024;  // payload bytes a hello may have
+
+struct ResumeHello
+{
+    int           fd = -1;
+    unsigned long input_id = 0;
+    unsigned long timeout_id = 0;
+    Uchar         header[4]{};
+    int           header_have = 0;
+    int           todo = -1;  // payload bytes still to come, once the header is in
+    CharQueue     frame{RESUME_HELLO_MAX};
+};
+static std::map<int, std::unique_ptr<ResumeHello>> ResumeHellos;  // by fd
+
+// Stops watching the connection and forgets it; rh is gone afterwards
+static void EndResumeHello(ResumeHello *rh, bool hang_up)
+{
+    FnTrace("EndResumeHello()");
+    if (rh->input_id)
+        RemoveInputFn(rh->input_id);
+    if (rh->timeout_id)
+        RemoveTimeOutFn(rh->timeout_id);
+    const int fd = rh->fd;
+    if (hang_up)
+        close(fd);
+    ResumeHellos.erase(fd);
+}
+
+/****
+ * ReadResumeHello:  Reads what has arrived of the hello, and nothing past
+ *  it, since the rest belongs to the resumed session.  Returns 1 once the
+ *  frame is in, 0 if more is to come, -1 on a hangup or bad frame.
+ ****/
+static int ReadResumeHello(ResumeHello *rh)
+{
+    FnTrace("ReadResumeHello()");
+    auto got = [](ssize_t n) {
+        if (n > 0)
+            return 1;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            return 0;
+        return -1;
+    };
+
+    while (rh->header_have < 4)
+    {
+        const ssize_t n = recv(rh->fd, rh->header + rh->header_have,
+                               static_cast<size_t>(4 - rh->header_have), MSG_DONTWAIT);
+        if (got(n) <= 0)
+            return got(n);
+        rh->header_have += static_cast<int>(n);
+    }
+    if (rh->todo < 0)
+    {
+        rh->todo = rh->header[0] | (rh->header[1] << 8) | (rh->header[2] << 16) | (rh->header[3] << 24);
+        if (rh->todo <= 0 || rh->todo > RESUME_HELLO_MAX)
+            return -1;
+    }
+
+    Uchar buffer[RESUME_HELLO_MAX];
+    while (rh->todo > 0)
+    {
+        const ssize_t n = recv(rh->fd, buffer, static_cast<size_t>(rh->todo), MSG_DONTWAIT);
+        if (got(n) <= 0)
+            return got(n);
+        rh->frame.Append(buffer, static_cast<int>(n));
+        rh->todo -= static_cast<int>(n);
+    }
+    return 1;
+}
+
+void ResumeHelloCB(XtPointer client_data, int * /*fid*/, XtInputId * /*id*/)
+{
+    FnTrace("ResumeHelloCB()");
+    auto *rh = static_cast<ResumeHello *>(client_data);
+    const int state = ReadResumeHello(rh);
+    if (state == 0)
+        return;  // wait for the rest
+
+    Terminal *term = nullptr;
+    if (state > 0 && rh->frame.Get8() == ToInt(ServerProtocol::SrvResume))
+    {
+        char token[STRLENGTH] = "";
+        rh->frame.GetString(token, sizeof(token));
+        term = TermSessions.Find(token);
+    }
+    const int fd = rh->fd;
+    EndResumeHello(rh, false);
+    if (term == nullptr || term->Resume(fd))
+        close(fd);
+}
+
+void ResumeHelloTimeoutCB(XtPointer client_data, XtIntervalId * /*id*/)
+{
+    FnTrace("ResumeHelloTimeoutCB()");
+    auto *rh = static_cast<ResumeHello *>(client_data);
+    rh->timeout_id = 0;  // fired; its id may already be reused
+    EndResumeHello(rh, true);
+}
+
+void ResumeAcceptCB(XtPointer /*client_data*/, int *fid, XtInputId * /*id*/)
+{
+    FnTrace("ResumeAcceptCB()");
+    int fd = accept(*fid, nullptr, nullptr);
+    if (fd < 0)
+        return;
+    auto rh = std::make_unique<ResumeHello>();
+    rh->fd = fd;
+    rh->input_id = AddInputFn((InputFn) ResumeHelloCB, fd, rh.get());
+    if (rh->input_id == 0)
+    {
+        close(fd);
+        return;
+    }
+    rh->timeout_id = AddTimeOutFn((TimeOutFn) ResumeHelloTimeoutCB, RESUME_HELLO_MS, rh.get());
+    ResumeHello *pending = rh.get();
+    ResumeHellos[fd] = std::move(rh);
+    if (pending->timeout_id == 0)
+        EndResumeHello(pending, true);  // it could never be timed out
+}
+
+/****
+ * StartResumeListener:  Opens RESUME_SOCKET_FILE the first time a session
+ *  is handed out.  Returns 0 if vt_term can reconnect there.
+ ****/
+static int StartResumeListener()
+{
+    FnTrace("StartResumeListener()");
+    if (ResumeSocket >= 0)
+        return 0;
+
+    struct sockaddr_un server_adr{};
+    server_adr.sun_family = AF_UNIX;
+    strncpy(server_adr.sun_path, RESUME_SOCKET_FILE, sizeof(server_adr.sun_path) - 1);
+    unlink(RESUME_SOCKET_FILE);
+
+    genericChar str[256];
+    int dev = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (dev < 0 ||
+        bind(dev, (struct sockaddr *) &server_adr, SUN_LEN(&server_adr)) < 0 ||
+        listen(dev, 8) < 0 ||
+        AddInputFn((InputFn) ResumeAcceptCB, dev, nullptr) == 0)
+    {
+        vt::cpp23::format_to_buffer(str, sizeof(str), "Failed to open resume socket '{}'",
+                                    RESUME_SOCKET_FILE);
+        ReportError(str);
+        if (dev >= 0)
+            close(dev);
+        return 1;
+    }
+    // Only this user's vt_term processes may resume a session
+    chmod(RESUME_SOCKET_FILE, 0600);
+    ResumeSocket = dev;
+    return 0;
+}
+
+/****
+ * ExpireLostSessions:  Terminals whose vt_term didn't come back within
+ *  RESUME_GRACE_SEC are removed as if the connection had just failed.
+ *  Called from UpdateSystemCB() before it walks the terminal list.
+ ****/
+int ExpireLostSessions()
+{
+    FnTrace("ExpireLostSessions()");
+    auto expired = TermSessions.Expired(std::chrono::steady_clock::now(),
+                                        std::chrono::seconds(RESUME_GRACE_SEC));
+    for (Terminal *term : expired)
+    {
+        genericChar str[256];
+        vt::cpp23::format_to_buffer(str, sizeof(str), "Terminal '{}' did not reconnect",
+                                    term->name.Value());
+        ReportError(str);
+        TermSessions.Remove(term);
+        KillDisconnectedTerm(term);
+    }
+    return static_cast<int>(expired.size());
+}
+
 void RedrawZoneCB(XtPointer client_data, XtIntervalId * /*timer_id*/)
 {
     FnTrace("RedrawZoneCB()");
@@ -620,6 +870,7 @@ Terminal::Terminal()
     record_fd       = -1;
     credit          = nullptr;
     allow_blanking  = 1;
+    asset_handshake = 0;
     for (int i=0; i<4; i++)
     	tax_inclusive[i] = -1;
 
@@ -736,6 +987,9 @@ Terminal::~Terminal()
         drawer = drawer->next;
     }
 
+	TermSessions.Remove(this);
+	ForgetStats();
+
 	if (input_id)
 		RemoveInputFn(input_id);
 
@@ -806,7 +1060,7 @@ int Terminal::Initialize()
     if (settings == nullptr)
         return retval;  // Can't initialize without settings
 
-    SendTranslations(FamilyName);
+    // Translations wait for the terminal's SrvAssetHashes (or SrvTermInfo)
     SetCCTimeout(settings->cc_connect_timeout);
     SetIconify(settings->allow_iconify);
     SetEmbossedText(settings->use_embossed_text);
@@ -869,13 +1123,355 @@ int Terminal::SendTranslations(const char* *name_list)
     return retval;
 }
 
+/****
+ * TranslationsHash:  Hash of the table SendTranslations() would send, in
+ *  the form vt_term computes for the table it has (see SetTranslations()
+ *  in term_view.cc).
+ ****/
+std::string Terminal::TranslationsHash(const char* *name_list)
+{
+    FnTrace("Terminal::TranslationsHash()");
+
+    vt::ContentHash hash;
+    for (int idx = 0; name_list[idx] != nullptr; idx += 1)
+        hash.Add(name_list[idx]).Add(MasterLocale->Translate(name_list[idx]));
+    return hash.Hex();
+}
+
+/****
+ * ReadAssetHashes:  vt_term names what it kept from its last run, each
+ *  as <name, content hash>.  Anything it already has isn't sent again.
+ ****/
+int Terminal::ReadAssetHashes()
+{
+    FnTrace("Terminal::ReadAssetHashes()");
+
+    std::string translations;
+    int count = RInt8();
+    for (int i = 0; i < count; ++i)
+    {
+        std::string name = RStr();
+        std::string hash = RStr();
+        if (name == "translations")
+            translations = hash;
+    }
+
+    asset_handshake = 1;
+    if (translations != TranslationsHash(FamilyName))
+        SendTranslations(FamilyName);
+    return 0;
+}
+
+/****
+ * ReadInputStamp:  vt_term numbered the touch or click that follows and
+ *  says when it happened; spans are timed until EndInputTrace().
+ ****/
+int Terminal::ReadInputStamp()
+{
+    FnTrace("Terminal::ReadInputStamp()");
+    uint32_t seq = static_cast<uint32_t>(RInt32());
+    int64_t input_ns = RLLong();
+    input_trace.Begin(seq, input_ns, vt::MetricsNowNs());
+    return 0;
+}
+
+/****
+ * StatsLabel:  The terminal label for this terminal's metrics, fixed when
+ *  the first of them is made so ForgetStats() finds them after a rename.
+ ****/
+const std::string &Terminal::StatsLabel()
+{
+    if (stats_label.empty())
+        stats_label = vt::MetricLabel("terminal", name.Value());
+    return stats_label;
+}
+
+/****
+ * ForgetStats:  Removes this terminal's series from the registry so a
+ *  site that adds and deletes terminals doesn't keep them all forever.
+ *  They are left alone while another terminal has the same name, since
+ *  it records into the same series.
+ ****/
+int Terminal::ForgetStats()
+{
+    FnTrace("Terminal::ForgetStats()");
+    if (stats_label.empty())
+        return 1;  // never made any
+
+    bytes_sent_stat = nullptr;
+    update_stat = nullptr;
+    input_span_stat.fill(nullptr);
+    input_latency_stat = nullptr;
+    press_shown_stat.fill(nullptr);
+
+    Terminal *term = parent ? parent->TermList() : nullptr;
+    while (term != nullptr && (term == this || term->stats_label != stats_label))
+        term = term->next;
+    if (term == nullptr)
+        vt::Metrics().Remove(stats_label);
+    stats_label.clear();
+    return 0;
+}
+
+// vt_update_terminal_seconds for this terminal, looked up once
+vt::LatencyHistogram &Terminal::UpdateStat()
+{
+    if (update_stat == nullptr)
+    {
+        update_stat = &vt::Metrics().Histogram(
+            "vt_update_terminal_seconds", "UpdateSystemCB() time spent on each terminal",
+            StatsLabel());
+    }
+    return *update_stat;
+}
+
+// vt_input_span_seconds for this terminal and span, looked up once
+vt::LatencyHistogram &Terminal::InputSpanStat(vt::InputSpan span)
+{
+    vt::LatencyHistogram *&stat = input_span_stat[static_cast<size_t>(span)];
+    if (stat == nullptr)
+    {
+        stat = &vt::Metrics().Histogram(
+            "vt_input_span_seconds", "Time spent in each stage of a traced touch",
+            StatsLabel() + "," +
+            vt::MetricLabel("span", vt::InputSpanName(span)));
+    }
+    return *stat;
+}
+
+/****
+ * EndInputTrace:  The input has been handled.  Marks the end of its
+ *  drawing for vt_term, then records the server's spans in
+ *  vt_input_span_seconds.
+ ****/
+int Terminal::EndInputTrace()
+{
+    FnTrace("Terminal::EndInputTrace()");
+    if (!input_trace.Active())
+        return 1;
+
+    WInt8(TERM_INPUT_DONE);
+    WInt32(static_cast<int>(input_trace.Seq()));
+    SendNow();
+    input_trace.End(vt::MetricsNowNs());
+
+    for (vt::InputSpan span : {vt::InputSpan::Queue, vt::InputSpan::Touch, vt::InputSpan::Signal,
+                               vt::InputSpan::Render, vt::InputSpan::Write})
+    {
+        InputSpanStat(span).Record(input_trace.SpanNs(span));
+    }
+    return 0;
+}
+
+/****
+ * ReadInputSpans:  vt_term reports when it read the frame ending in
+ *  TERM_INPUT_DONE, decoded the marker, and flushed the frame to X.  That
+ *  completes the trace: vt_input_latency_seconds gets the touch to pixel
+ *  time.
+ ****/
+int Terminal::ReadInputSpans()
+{
+    FnTrace("Terminal::ReadInputSpans()");
+    uint32_t seq = static_cast<uint32_t>(RInt32());
+    int64_t read_ns = RLLong();
+    int64_t decoded_ns = RLLong();
+    int64_t blitted_ns = RLLong();
+
+    int64_t total = input_trace.Complete(seq, read_ns, decoded_ns, blitted_ns);
+    if (total < 0)
+        return 1;  // a later input replaced it
+
+    for (vt::InputSpan span : {vt::InputSpan::Transit, vt::InputSpan::Decode, vt::InputSpan::Blit})
+    {
+        InputSpanStat(span).Record(input_trace.SpanNs(span));
+    }
+    if (input_latency_stat == nullptr)
+    {
+        input_latency_stat = &vt::Metrics().Histogram(
+            "vt_input_latency_seconds", "Touch in vt_term to its result on screen",
+            StatsLabel());
+    }
+    input_latency_stat->Record(total);
+    return 0;
+}
+
+/****
+ * SendPressLooks:  Lists the buttons vt_term may draw with their selected
+ *  look as soon as they are touched, before the touch gets here.  Every
+ *  zone Page::FindZone() could return goes in, in the order it searches
+ *  them, so vt_term picks the zone this side will; only plain
+ *  BEHAVE_BLINK and BEHAVE_SELECT buttons get a look.  With a dialog
+ *  open, in edit mode or during end of day the list is empty.
+ ****/
+int Terminal::SendPressLooks()
+{
+    FnTrace("Terminal::SendPressLooks()");
+    std::vector<Zone *> zones;
+    if (page && dialog == nullptr && edit == 0 && system_data->eod_term == nullptr)
+    {
+        // FindZone() searches the parent pages first
+        std::vector<Page *> pages;
+        for (Page *p = page; p != nullptr && pages.size() < 16; p = p->parent_page)
+            pages.push_back(p);
+        for (auto it = pages.rbegin(); it != pages.rend(); ++it)
+        {
+            for (Zone *z = (*it)->ZoneList(); z != nullptr; z = z->next)
+            {
+                if (z->behave != BEHAVE_MISS && z->active)
+                    zones.push_back(z);
+            }
+        }
+    }
+
+    WInt8(TERM_PRESSLOOKS);
+    WInt16(static_cast<int>(zones.size()));
+    for (Zone *z : zones)
+    {
+        WInt16(z->x);
+        WInt16(z->y);
+        WInt16(z->w);
+        WInt16(z->h);
+
+        // Drawn as Zone::RenderZone() would draw state 1
+        const genericChar* text = nullptr;
+        if (z->ZoneStates() > 1 && (z->behave == BEHAVE_BLINK || z->behave == BEHAVE_SELECT))
+            text = z->PressText(this);
+        int zf = text ? FrameID(z->frame[1], 1) : ZF_HIDDEN;
+        int zt = text ? TextureID(z->texture[1], 1) : IMAGE_CLEAR;
+        if (zf == ZF_NONE && zt == IMAGE_CLEAR)
+            zf = ZF_HIDDEN;
+        WInt8(zf);
+        if (zf == ZF_HIDDEN)
+            continue;
+
+        int bx = Max(z->border - 2, 0);
+        int by = Max(z->border - 4, 0);
+        int c = z->color[1];
+        if (c == COLOR_PAGE_DEFAULT || c == COLOR_DEFAULT)
+            c = page->default_color[1];
+        c = ColorID(c);
+        const genericChar* label = (c == COLOR_CLEAR) ? nullptr : ReplaceSymbols(text);
+
+        WInt8(zt);
+        WInt8(z->shape);
+        WInt16(z->x + bx);
+        WInt16(z->y + by + z->header);
+        WInt16(z->w - (bx * 2));
+        WInt16(z->h - (by * 2) - z->header - z->footer);
+        WInt8(c);
+        WInt8(FontID(z->font));
+        WStr(label ? label : "");
+    }
+    return Send();
+}
+
+/****
+ * ReadPressShown:  How long a touched button took to look pressed, drawn
+ *  by vt_term itself or by the answer from here.  Comparing the two
+ *  vt_press_shown_seconds series shows what local feedback saves.
+ ****/
+int Terminal::ReadPressShown()
+{
+    FnTrace("Terminal::ReadPressShown()");
+    int64_t ns = RLLong();
+    int local = RInt8() ? 1 : 0;
+
+    vt::LatencyHistogram *&stat = press_shown_stat[static_cast<size_t>(local)];
+    if (stat == nullptr)
+    {
+        stat = &vt::Metrics().Histogram(
+            "vt_press_shown_seconds", "Touch in vt_term to the button looking pressed",
+            StatsLabel() + "," +
+            vt::MetricLabel("drawn_by", local ? "vt_term" : "vt_main"));
+    }
+    stat->Record(ns);
+    return 0;
+}
+
+/****
+ * StartSession:  Hands vt_term a token it can present on RESUME_SOCKET_FILE
+ *  if its connection drops.  The caller is responsible for SendNow().
+ ****/
+int Terminal::StartSession()
+{
+    FnTrace("Terminal::StartSession()");
+    if (StartResumeListener())
+        return 1;
+
+    std::string token = TermSessions.Issue(this);
+    WInt8(TERM_SESSION);
+    WStr(token);
+    WStr(RESUME_SOCKET_FILE);
+    return 0;
+}
+
+/****
+ * LoseSession:  vt_term stopped answering.  The page, user and check stay
+ *  as they are, and whatever is drawn meanwhile collects in buffer_out
+ *  (SendNow() has no socket to write to) until Resume() or
+ *  ExpireLostSessions().
+ ****/
+int Terminal::LoseSession()
+{
+    FnTrace("Terminal::LoseSession()");
+    if (input_id)
+    {
+        RemoveInputFn(input_id);
+        input_id = 0;
+    }
+    if (socket_no > 0)
+        close(socket_no);
+    socket_no = -1;
+    failure = 0;
+    buffer_in->Clear();
+    TermSessions.Lost(this, std::chrono::steady_clock::now());
+
+    genericChar str[256];
+    vt::cpp23::format_to_buffer(str, sizeof(str), "Terminal '{}' lost, holding for {} seconds",
+                                name.Value(), RESUME_GRACE_SEC);
+    ReportError(str);
+    return 0;
+}
+
+/****
+ * Resume:  vt_term reconnected with its token.  The drawing queued
+ *  since the link dropped is replayed, then the page is redrawn, since
+ *  whatever went into the dead socket never reached vt_term.
+ ****/
+int Terminal::Resume(int new_socket)
+{
+    FnTrace("Terminal::Resume()");
+    // The old link may not have been noticed as dead yet
+    if (input_id)
+        RemoveInputFn(input_id);
+    if (socket_no > 0 && socket_no != new_socket)
+        close(socket_no);
+
+    socket_no = new_socket;
+    failure = 0;
+    buffer_in->Clear();
+    input_id = AddInputFn((InputFn) TermCB, socket_no, this);
+    TermSessions.Resumed(this);
+
+    // vt_term takes the first frame as the sign its resume was accepted
+    if (buffer_out->Overflowed())
+        buffer_out->Clear();
+    Draw(RENDER_NEW);
+    if (page == nullptr)
+        UpdateAll();
+    SendNow();
+    return 0;
+}
+
 int Terminal::Draw(int update_flag)
 {
     FnTrace("Terminal::Draw()");
+    vt::InputSpanScope trace_span(input_trace, vt::InputSpan::Render);
     if (page)
     {
         RenderBlankPage();
         page->Render(this, update_flag);
+        SendPressLooks();
         UpdateAll();
     }
     return 0;
@@ -884,6 +1480,7 @@ int Terminal::Draw(int update_flag)
 int Terminal::Draw(int update_flag, int x, int y, int w, int h)
 {
     FnTrace("Terminal::Draw(x,y,w,h)");
+    vt::InputSpanScope trace_span(input_trace, vt::InputSpan::Render);
     if (page)
     {
         SetClip(x, y, w, h);
@@ -1020,17 +1617,20 @@ int Terminal::JumpToIndex(int idx)
 int Terminal::RunScript(const genericChar* script, int jump_type, int jump_id)
 {
     FnTrace("Terminal::RunScript()");
-    // FIX - parsing script (hack -- should redo)
-    Settings *s = GetSettings();
-    int j[16];
-    int jump_count = 0;
-    if (script == nullptr)
-        jump_count = 0;
-    else
-        jump_count = sscanf(script, "%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d",
-                            &j[ 0], &j[ 1], &j[ 2], &j[ 3], &j[ 4], &j[ 5], &j[ 6], &j[ 7],
-                            &j[ 8], &j[ 9], &j[10], &j[11], &j[12], &j[13], &j[14], &j[15]);
+    vt::PageScript compiled;
+    compiled.Compile(script ? script : "");
+    return RunScript(compiled, jump_type, jump_id);
+}
 
+/****
+ * RunScript:  Follows a modifier script, pushing its pages so that each
+ *  JUMP_RETURN goes to the next one and the last returns to where
+ *  jump_type and jump_id say.  With no pages it is just a Jump().
+ ****/
+int Terminal::RunScript(const vt::PageScript &script, int jump_type, int jump_id)
+{
+    FnTrace("Terminal::RunScript(PageScript)");
+    const int jump_count = script.count;
     if (jump_count > 0)
     {
         switch (jump_type)
@@ -1061,7 +1661,7 @@ int Terminal::RunScript(const genericChar* script, int jump_type, int jump_id)
         }
 
         for (int i = jump_count - 1; i >= 0; --i)
-            PushPage(j[i]);
+            PushPage(script.pages[static_cast<size_t>(i)]);
 
         Jump(JUMP_RETURN);
     }
@@ -1430,6 +2030,7 @@ SignalResult Terminal::Signal(const genericChar* message, int group_id)
             SignalGuard(int& d) : depth(d) {}
             ~SignalGuard() { depth--; }
         } guard(signal_depth);
+        vt::InputSpanScope trace_span(input_trace, vt::InputSpan::Signal);
     
     SimpleDialog *sd = nullptr;
     char msg[STRLONG] = "";
@@ -1649,10 +2250,10 @@ SignalResult Terminal::Signal(const genericChar* message, int group_id)
         // Handle immediate restart
         KillDialog();  // Close the restart dialog
         extern int restart_dialog_shown;
-        extern XtIntervalId restart_timeout_id;
+        extern unsigned long restart_timeout_id;
         restart_dialog_shown = 0;
         if (restart_timeout_id != 0) {
-            XtRemoveTimeOut(restart_timeout_id);
+            RemoveTimeOutFn(restart_timeout_id);
             restart_timeout_id = 0;
         }
         ExecuteRestart();
@@ -1662,11 +2263,11 @@ SignalResult Terminal::Signal(const genericChar* message, int group_id)
         // Handle postpone for 1 hour
         KillDialog();  // Close the restart dialog
         extern int restart_dialog_shown;
-        extern XtIntervalId restart_timeout_id;
+        extern unsigned long restart_timeout_id;
         extern int restart_postponed_until;
         restart_dialog_shown = 0;
         if (restart_timeout_id != 0) {
-            XtRemoveTimeOut(restart_timeout_id);
+            RemoveTimeOutFn(restart_timeout_id);
             restart_timeout_id = 0;
         }
         // Set postpone time to current time + 1 hour
@@ -2849,6 +3450,7 @@ int Terminal::OpenDialog(Zone *currZone)
 	r.h += currZone->shadow;
 
 	dialog = currZone;
+	SendPressLooks();  // the dialog takes every touch now
 	Draw(0, r.x, r.y, r.w, r.h);
 
 	return 0;
@@ -3297,6 +3899,8 @@ int Terminal::UpdateZoneDB(Control *con)
     FnTrace("Terminal::UpdateZoneDB()");
     if (con == nullptr)
         return 1;
+    vt::ScopedLatency timer(vt::Metrics().Histogram(
+        "vt_zone_db_update_seconds", "Time to give a terminal a new ZoneDB"));
 
     parent = con;
     if (user && zone_db && !org_page_id)
@@ -3635,9 +4239,51 @@ int Terminal::TextWidth(const genericChar* my_string, int len, int font_id)
     if (len < 0)
         len = strlen(my_string);
 
+    // Prefer the advances measured by vt_term with the fonts it draws with
+    int width = font_metrics.TextWidth(font_id, my_string, len);
+    if (width >= 0)
+        return width;
     return GetTextWidth(my_string, len, font_id);
 }
 
+/****
+ * ReadFontMetrics:  Reads the glyph advance tables vt_term sends at connect
+ *  and after reloading its fonts.  Format per font:
+ *  <I1 font_id, I2 height, I2 default_advance, I1 ranges,
+ *   ranges x <I4 first_codepoint, I2 count, count x I1 advance>>
+ ****/
+int Terminal::ReadFontMetrics()
+{
+    FnTrace("Terminal::ReadFontMetrics()");
+
+    int had_metrics = font_metrics.Count() > 0;
+    int fonts = RInt8();
+    for (int i = 0; i < fonts; ++i)
+    {
+        int font_id = RInt8();
+        vt::GlyphAdvanceTable discard;
+        vt::GlyphAdvanceTable *table = font_metrics.Reset(font_id);
+        if (table == nullptr)
+            table = &discard;  // still consume the data for unknown ids
+
+        table->height = RInt16();
+        table->default_advance = RInt16();
+        int ranges = RInt8();
+        for (int r = 0; r < ranges; ++r)
+        {
+            uint32_t first = static_cast<uint32_t>(RInt32());
+            int count = RInt16();
+            for (int g = 0; g < count; ++g)
+                table->SetAdvance(first + g, RInt8());
+        }
+    }
+
+    // widths changed under an already drawn page (font family reload)
+    if (had_metrics && page)
+        Draw(RENDER_NEW);
+    return 0;
+}
+
 int Terminal::IsUserOnline(Employee *e)
 {
     FnTrace("Terminal::IsUserOnline()");
@@ -4826,9 +5472,24 @@ int Terminal::Send()
     if (buffer_out->size <= buffer_out->send_size)
         return 0;
 
+    CountBytesSent(1);
     return buffer_out->Write(socket_no);
 }
 
+// Adds the pending frame (4 byte header + payload) written to copies sockets
+void Terminal::CountBytesSent(int copies)
+{
+    if (buffer_out->size <= 0)
+        return;
+    if (bytes_sent_stat == nullptr)
+    {
+        bytes_sent_stat = &vt::Metrics().Counter(
+            "vt_terminal_bytes_sent_total", "Bytes queued to each terminal's socket",
+            StatsLabel());
+    }
+    bytes_sent_stat->Add(static_cast<uint64_t>(buffer_out->size + 4) * copies);
+}
+
 /****
  * SendNow:  Returns the result of a final write(), so -1 on error,
  *  number of bytes written otherwise.
@@ -4836,8 +5497,10 @@ int Terminal::Send()
 int Terminal::SendNow()
 {
     FnTrace("Terminal::SendNow()");
+    vt::InputSpanScope trace_span(input_trace, vt::InputSpan::Write);
     Terminal *currterm = clone_list.Head();
 
+    CountBytesSent(1 + clone_list.Count());
     while (currterm != nullptr)
     {
         buffer_out->Write(currterm->socket_no, 0);
@@ -6213,6 +6876,7 @@ int Terminal::ReadPage()
     currPage->default_shadow = RInt16();
     currPage->parent_id = RInt32();
     currPage->index = RInt8();
+    zone_db->PagesChanged();  // size, type and index may have changed
 
     if (my_id == 0 || (my_id < 0 && !CanEditSystem())) {
    	//TerminalError("Invalid page number");
@@ -26,7 +26,11 @@
 #include "customer.hh"
 #include "locale.hh"
 #include "utility.hh"
+#include "font_metrics.hh"
+#include "metrics.hh"
+#include "input_trace.hh"
 
+#include <array>
 #include <string>
 #include <memory>
 #include <mutex>
@@ -144,6 +148,7 @@ constexpr int UPDATE_PRINTERS     = (1<<22); // printer has been started/killed
 constexpr int UPDATE_AUTHORIZE    = (1<<23); // credit authorization done
 constexpr int UPDATE_SERVER       = (1<<24); // terminal viewed server changed
 constexpr int UPDATE_REPORT       = (1<<25); // requested report is done
+constexpr int UPDATE_ANY          = ~0;      // Zone::UpdateMask() of zones that look at every message
 
 // Colors
 constexpr int COLOR_DEFAULT      = 255; // color determined by zone
@@ -279,6 +284,7 @@ class SubCheck;
 class Printer;
 class Drawer;
 class Order;
+namespace vt { class PageScript; }
 class Stock;
 class Control;
 class Printer;
@@ -346,9 +352,11 @@ public:
 
     int       curr_font_id;   // hack for Aldridge's Kitchen Video
     int       curr_font_width;
+    vt::FontMetrics font_metrics; // glyph advances measured by vt_term
     int       mouse_x;        // current mouse position
     int       mouse_y;
     int       allow_blanking;
+    int       asset_handshake; // vt_term reported its cache (SrvAssetHashes)
 
     // POS Data
     Archive      *archive;          // Current archive being viewed
@@ -403,6 +411,13 @@ public:
     // Network info
     CharQueue *buffer_in;
     CharQueue *buffer_out;
+    std::string stats_label;                    // terminal="..." the stats below were made with
+    vt::StatCounter *bytes_sent_stat = nullptr; // vt_terminal_bytes_sent_total
+    vt::LatencyHistogram *update_stat = nullptr; // vt_update_terminal_seconds
+    vt::InputTrace input_trace;                 // the touch being timed, if any
+    std::array<vt::LatencyHistogram*, vt::INPUT_SPAN_COUNT> input_span_stat{};
+    vt::LatencyHistogram *input_latency_stat = nullptr;
+    std::array<vt::LatencyHistogram*, 2> press_shown_stat{};  // drawn by vt_main, by vt_term
     int socket_no;
     unsigned long input_id = 0;
     unsigned long redraw_id = 0;
@@ -473,6 +488,20 @@ public:
     int AllowBlanking(int allow = 1);
     int TerminalError(const char* message);         // method for reporting page errors
     int SendTranslations(const char* *name_list);   // send translations for term_dialog
+    std::string TranslationsHash(const char* *name_list);
+    int ReadAssetHashes();
+    int StartSession();                       // gives vt_term a resume token
+    int LoseSession();                        // holds state while vt_term reconnects
+    int Resume(int new_socket);               // vt_term is back on new_socket
+    int ReadInputStamp();                     // starts timing the next input
+    int EndInputTrace();                      // its drawing is queued
+    int ReadInputSpans();                     // vt_term's half of the timing
+    const std::string &StatsLabel();          // names this terminal's metrics
+    vt::LatencyHistogram &InputSpanStat(vt::InputSpan span);
+    vt::LatencyHistogram &UpdateStat();
+    int ForgetStats();                        // drops its series from the metrics
+    int SendPressLooks();                     // buttons vt_term may draw pressed
+    int ReadPressShown();
     int ChangePage(Page *p);                  // Changes current page
     int ClearPageStack();                     // clears stack
     int Draw(int update_flag);
@@ -484,6 +513,7 @@ public:
     int PriorTablePage();
     int PushPage(int page_id);      // puts page id on stack
     int RunScript(const char* script, int jump_type, int jump_id);
+    int RunScript(const vt::PageScript &script, int jump_type, int jump_id);
     int FastStartLogin();
     int OpenTab(int phase = TABOPEN_START, const char* message = nullptr);
     int ContinueTab(int serial_number = -1);
@@ -542,6 +572,7 @@ public:
     int TextureTextColor(int appear); // nice default text color for appearence
     int FontSize(int font_id, int &w, int &h);
     int TextWidth(const char* string, int len = -1, int font_id = -1);
+    int ReadFontMetrics();
     int IsUserOnline(Employee *e);
     int FinalizeOrders();
     bool CanEditSystem();
@@ -660,6 +691,7 @@ public:
     genericChar* RStr(Str *s);
     int   Send();
     int   SendNow();
+    void  CountBytesSent(int copies);
 
     Settings *GetSettings();
 
@@ -705,5 +737,6 @@ int OpenTerminalSocket(const char* hostname, int hardware_type = 0, int isserver
                        int width = -1, int height = -1);
 Terminal *NewTerminal(const char* host_name, int hardware_type = 0, int isserver = 0);
 int CloneTerminal(Terminal *term, const char* dest, const char* name);
+int ExpireLostSessions();
 
 #endif
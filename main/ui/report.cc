@@ -30,6 +30,7 @@
 #include "utility.hh"
 #include "safe_string_utils.hh"
 #include "src/utils/cpp23_utils.hh"
+#include <algorithm>
 #include <cstring>
 #include <errno.h>
 #include <vector>
@@ -209,16 +210,61 @@ int Report::Add(const ReportEntry &re)
     return 0;
 }
 
+int Report::MarkLive(int kind)
+{
+    FnTrace("Report::MarkLive()");
+    const bool header = (add_where == 1);
+    std::vector<ReportEntry> &list = header ? header_list : body_list;
+    if (list.empty())
+        return 1;
+    live_list.push_back({kind, header, list.size() - 1, list.back().color});
+    return 0;
+}
+
+int Report::SetLiveText(int kind, const std::string &text)
+{
+    FnTrace("Report::SetLiveText()");
+    for (const LiveEntry &le : live_list)
+    {
+        if (le.kind == kind)
+            LiveText(le).text = text;
+    }
+    return 0;
+}
+
+/****
+ * SetLiveBlink:  Shows the entries tagged kind in blink_color while on,
+ *  and in the color they were added with otherwise.
+ ****/
+int Report::SetLiveBlink(int kind, int on, int blink_color)
+{
+    FnTrace("Report::SetLiveBlink()");
+    for (const LiveEntry &le : live_list)
+    {
+        if (le.kind == kind)
+            LiveText(le).color = static_cast<Uchar>(on ? blink_color : le.color);
+    }
+    return 0;
+}
+
+int Report::LiveCount(int kind) const
+{
+    return static_cast<int>(std::count_if(live_list.begin(), live_list.end(),
+        [kind](const LiveEntry &le) { return le.kind == kind; }));
+}
+
 int Report::Purge()
 {
     body_list.clear();
     header_list.clear();
+    live_list.clear();
     return 0;
 }
 
 int Report::PurgeHeader()
 {
     header_list.clear();
+    std::erase_if(live_list, [](const LiveEntry &le) { return le.header; });
     return 0;
 }
 
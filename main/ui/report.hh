@@ -67,6 +67,10 @@
 // Print Modes come from printer.hh
 #include "printer.hh"
 
+// Live Entries (kitchen video text changed without rebuilding the report)
+#define LIVE_TIMER          1  // a ticket's age, "m:ss"
+#define LIVE_FLASH          2  // an order flashing between its color and white
+
 // Other
 #define MAX_REPORT_COLUMNS  16
 
@@ -100,11 +104,23 @@ public:
 
 class Report
 {
+    struct LiveEntry
+    {
+        int    kind;
+        bool   header;
+        size_t index;
+        int    color;  // the entry's own color, for LIVE_FLASH
+    };
+
     std::vector<ReportEntry> header_list;
     std::vector<ReportEntry> body_list;
+    std::vector<LiveEntry> live_list;
     std::string report_title;
     int have_title;
 
+    ReportEntry &LiveText(const LiveEntry &le)
+    { return le.header ? header_list[le.index] : body_list[le.index]; }
+
 public:
     int   destination;
     int   update_flag;
@@ -152,6 +168,13 @@ public:
     int  Purge();                     // Deletes all entries
     int  PurgeHeader();               // Deletes report header only
     int  Add(const ReportEntry &re);        // Adds entry to report
+    int  MarkLive(int kind);                // Tags the entry last added
+    int  SetLiveText(int kind, const std::string &text);
+    int  SetLiveBlink(int kind, int on, int blink_color = COLOR_WHITE);
+    // Sets the text, or swaps the color, of every entry tagged kind
+    [[nodiscard]] int LiveCount(int kind) const;
+    [[nodiscard]] const std::vector<ReportEntry> &HeaderEntries() const { return header_list; }
+    [[nodiscard]] const std::vector<ReportEntry> &BodyEntries() const { return body_list; }
     int  Append(const Report &r);           // Adds report to end of this one
     int  Render(Terminal *t, LayoutZone *lz, Flt header_size, Flt footer_size,
                 int page, int print, Flt spacing = 1.0);
@@ -1899,7 +1899,7 @@ int System::BalanceReport(Terminal *term, TimeInfo &start_time, TimeInfo &end_ti
     report->TextC(str, COLOR_DK_BLUE);
     report->NewLine(3);
 
-    AddWorkFn((WorkFn) BalanceReportWorkFn, brdata);
+    AddWorkFn((WorkFn) BalanceReportWorkFn, brdata, "balance");
 
     return 0;
 }
@@ -2971,7 +2971,7 @@ int System::ClosedCheckReport(Terminal *term, TimeInfo &start_time, TimeInfo &en
     thisReport->NewLine();
     thisReport->Divider('-');
 
-    AddWorkFn((WorkFn) ClosedCheckReportWorkFn, ccrdata);
+    AddWorkFn((WorkFn) ClosedCheckReportWorkFn, ccrdata, "closed_check");
     return 0;
 }
 
@@ -4368,7 +4368,7 @@ int System::RoyaltyReport(Terminal *term, TimeInfo &start_time, TimeInfo &end_ti
     }
 
     report->is_complete = 0;
-    AddWorkFn((WorkFn) RoyaltyReportWorkFn, rdata);
+    AddWorkFn((WorkFn) RoyaltyReportWorkFn, rdata, "royalty");
     return 0;
 }
 
@@ -5015,7 +5015,7 @@ int System::AuditingReport(Terminal *term, TimeInfo &start_time, TimeInfo &end_t
     adata->archive = FindByTime(start_time);
 
     report->is_complete = 0;
-    AddWorkFn((WorkFn) AuditingReportWorkFn, adata);
+    AddWorkFn((WorkFn) AuditingReportWorkFn, adata, "auditing");
 
     return 0;
 }
@@ -5229,7 +5229,7 @@ int System::CreditCardReport(Terminal *term, TimeInfo &start_time, TimeInfo &end
         ccdata->report_zone = rzone;
 
         report->is_complete = 0;
-        AddWorkFn((WorkFn) CreditCardReportWorkFn, ccdata);
+        AddWorkFn((WorkFn) CreditCardReportWorkFn, ccdata, "credit_card");
         retval = 0;
     }
     else if (cc_report_type == CC_REPORT_BATCH)
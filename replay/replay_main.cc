@@ -0,0 +1,450 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * replay_main.cc
+ * Replays a terminal protocol recording ('vt_replay') to benchmark
+ * vt_term rendering or the protocol decoder on its own
+ */
+
+#include "protocol_recorder.hh"
+#include "remote_link.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/sockios.h>
+#endif
+
+struct Parameter
+{
+    std::string recording;     // file written with VT_PROTOCOL_RECORD
+    std::string socket_file;   // serve vt_term on this socket, else decode only
+    std::string term_path;     // optional vt_term binary to launch
+    bool max_speed = false;    // ignore the recorded timing
+    int  loops     = 1;
+    bool verbose   = false;
+};
+
+struct ReplayResult
+{
+    vt::TermDecodeStats stats;
+    long long elapsed_ns = 0;
+};
+
+/*********************************************************************
+ * PROTOTYPES
+ ********************************************************************/
+int  LoadRecording(const std::string &path, std::vector<vt::RecordedFrame> &frames);
+int  DecodeReplay(const std::vector<vt::RecordedFrame> &frames, const Parameter &param,
+                  ReplayResult &result);
+int  ServeReplay(const std::vector<vt::RecordedFrame> &frames, const Parameter &param,
+                 ReplayResult &result);
+void PrintReport(const ReplayResult &result, const Parameter &param);
+Parameter ParseArguments(const int argc, const char* const argv[]);
+void ShowHelp(const std::string &progname);
+
+
+/*********************************************************************
+ * MAIN
+ ********************************************************************/
+int main(int argc, const char* argv[])
+{
+    // a vt_term that goes away mid-replay shouldn't kill us
+    signal(SIGPIPE, SIG_IGN);
+
+    Parameter param = ParseArguments(argc, argv);
+
+    std::vector<vt::RecordedFrame> frames;
+    if (LoadRecording(param.recording, frames))
+        return 1;
+    if (param.verbose)
+        std::cout << "Loaded " << frames.size() << " terminal frames from "
+                  << param.recording << '\n';
+
+    ReplayResult result;
+    int error = param.socket_file.empty()
+        ? DecodeReplay(frames, param, result)
+        : ServeReplay(frames, param, result);
+    if (error)
+        return 1;
+
+    PrintReport(result, param);
+    return 0;
+}
+
+
+/*********************************************************************
+ * SUBROUTINES
+ ********************************************************************/
+namespace {
+
+int64_t NowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Sleeps until the frame's offset in the recording, relative to replay start
+void PaceFrame(const vt::RecordedFrame &frame, int64_t first_ns, int64_t start_ns)
+{
+    int64_t due = start_ns + (frame.timestamp_ns - first_ns);
+    int64_t wait = due - NowNs();
+    if (wait > 0)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+}
+
+// TERM_DIE would end the session before the last loop
+bool IsDieFrame(const vt::RecordedFrame &frame)
+{
+    return frame.payload.size() >= 2 && frame.payload[0] == 1 &&
+           frame.payload[1] == TerminalProtocol::DIE;
+}
+
+// Discards whatever vt_term sends so it never blocks writing to us
+int DrainInput(int fd)
+{
+    std::vector<char> scratch(8192);
+    for (;;)
+    {
+        ssize_t got = recv(fd, scratch.data(), scratch.size(), MSG_DONTWAIT);
+        if (got > 0)
+            continue;
+        if (got == 0)
+            return -1;  // terminal closed the connection
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+}
+
+// Writes one size-prefixed frame, draining input whenever the socket is full
+int SendFrame(int fd, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> data(4 + payload.size());
+    auto size = static_cast<uint32_t>(payload.size());
+    for (int i = 0; i < 4; ++i)
+        data[i] = static_cast<uint8_t>((size >> (8 * i)) & 255);
+    std::copy(payload.begin(), payload.end(), data.begin() + 4);
+
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        struct pollfd pfd{fd, POLLIN | POLLOUT, 0};
+        if (poll(&pfd, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        if ((pfd.revents & POLLIN) && DrainInput(fd))
+            return -1;
+        if (pfd.revents & (POLLERR | POLLHUP))
+            return -1;
+        if (pfd.revents & POLLOUT)
+        {
+            ssize_t w = send(fd, data.data() + sent, data.size() - sent, MSG_DONTWAIT);
+            if (w > 0)
+                sent += static_cast<size_t>(w);
+            else if (w < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+// Waits until vt_term has read everything we queued (Linux only)
+void WaitForReader(int fd)
+{
+#ifdef SIOCOUTQ
+    int64_t give_up = NowNs() + 10000000000LL;
+    int pending = 0;
+    while (ioctl(fd, SIOCOUTQ, &pending) == 0 && pending > 0 && NowNs() < give_up)
+    {
+        if (DrainInput(fd))
+            return;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+#endif
+}
+
+int ListenUnix(const std::string &path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    struct sockaddr_un adr{};
+    adr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(adr.sun_path))
+    {
+        close(fd);
+        return -1;
+    }
+    strncpy(adr.sun_path, path.c_str(), sizeof(adr.sun_path) - 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&adr), SUN_LEN(&adr)) < 0 ||
+        listen(fd, 1) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+pid_t LaunchTerm(const Parameter &param)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        const char* display = getenv("DISPLAY");
+        if (display == nullptr)
+            display = ":0";
+        execl(param.term_path.c_str(), param.term_path.c_str(),
+              param.socket_file.c_str(), "0", display, static_cast<char*>(nullptr));
+        perror("vt_replay: exec vt_term");
+        _exit(1);
+    }
+    return pid;
+}
+
+} // namespace
+
+/****
+ * LoadRecording:  reads the server-to-terminal frames into memory so
+ *   file I/O isn't part of the measurement.
+ ****/
+int LoadRecording(const std::string &path, std::vector<vt::RecordedFrame> &frames)
+{
+    vt::ProtocolReader reader;
+    if (reader.Open(path))
+    {
+        std::cerr << "Can't read recording '" << path << "'" << '\n';
+        return 1;
+    }
+
+    vt::RecordedFrame frame;
+    while (reader.Next(frame))
+    {
+        if (frame.direction == vt::RecordDirection::ToTerminal)
+            frames.push_back(frame);
+    }
+    if (frames.empty())
+    {
+        std::cerr << "No terminal frames in '" << path << "'" << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+/****
+ * DecodeReplay:  headless benchmark; walks every frame with the protocol
+ *   decoder but draws nothing.
+ ****/
+int DecodeReplay(const std::vector<vt::RecordedFrame> &frames, const Parameter &param,
+                 ReplayResult &result)
+{
+    int64_t start = NowNs();
+    for (int loop = 0; loop < param.loops; ++loop)
+    {
+        int64_t loop_start = NowNs();
+        for (const auto &frame : frames)
+        {
+            if (!param.max_speed)
+                PaceFrame(frame, frames.front().timestamp_ns, loop_start);
+            vt::DecodeTermFrame(frame.payload.data(), static_cast<int>(frame.payload.size()),
+                                result.stats);
+        }
+    }
+    result.elapsed_ns = NowNs() - start;
+    return 0;
+}
+
+/****
+ * ServeReplay:  stands in for vt_main.  vt_term connects to the socket and
+ *   renders the recorded frames through its normal SocketInputCB() path.
+ ****/
+int ServeReplay(const std::vector<vt::RecordedFrame> &frames, const Parameter &param,
+                ReplayResult &result)
+{
+    int listener = ListenUnix(param.socket_file);
+    if (listener < 0)
+    {
+        perror("vt_replay: can't listen");
+        return 1;
+    }
+
+    pid_t term = -1;
+    if (!param.term_path.empty())
+        term = LaunchTerm(param);
+    else
+        std::cout << "Waiting for: vt_term " << param.socket_file << " 0 <display>" << '\n';
+
+    int conn = accept(listener, nullptr, nullptr);
+    close(listener);
+    if (conn < 0)
+    {
+        perror("vt_replay: accept failed");
+        return 1;
+    }
+
+    int error = 0;
+    int64_t start = NowNs();
+    for (int loop = 0; loop < param.loops && !error; ++loop)
+    {
+        bool last_loop = (loop == param.loops - 1);
+        int64_t loop_start = NowNs();
+        for (const auto &frame : frames)
+        {
+            if (!last_loop && IsDieFrame(frame))
+                continue;
+            if (!param.max_speed)
+                PaceFrame(frame, frames.front().timestamp_ns, loop_start);
+            if (SendFrame(conn, frame.payload))
+            {
+                std::cerr << "vt_term closed the connection" << '\n';
+                error = 1;
+                break;
+            }
+            vt::DecodeTermFrame(frame.payload.data(), static_cast<int>(frame.payload.size()),
+                                result.stats);
+        }
+    }
+    // vt_term has rendered everything but (at most) the last frame once it
+    // has read all of it
+    WaitForReader(conn);
+    result.elapsed_ns = NowNs() - start;
+
+    close(conn);
+    unlink(param.socket_file.c_str());
+    if (term > 0)
+    {
+        kill(term, SIGTERM);
+        waitpid(term, nullptr, 0);
+    }
+    return error;
+}
+
+/****
+ * PrintReport:
+ ****/
+void PrintReport(const ReplayResult &result, const Parameter &param)
+{
+    const auto &stats = result.stats;
+    double seconds = static_cast<double>(result.elapsed_ns) / 1e9;
+    if (seconds <= 0.0)
+        seconds = 1e-9;
+
+    std::cout << (param.socket_file.empty() ? "decode" : "vt_term")
+              << (param.max_speed ? " (max speed)" : " (recorded timing)") << '\n'
+              << "  frames:      " << stats.frames << "  ("
+              << static_cast<long>(stats.frames / seconds) << " frames/sec)" << '\n'
+              << "  commands:    " << stats.commands << "  ("
+              << static_cast<long>(stats.commands / seconds) << " commands/sec)" << '\n'
+              << "  bytes:       " << stats.bytes << "  ("
+              << static_cast<long>(stats.bytes / seconds / 1024.0) << " KiB/sec)" << '\n'
+              << "  elapsed:     " << seconds << " sec" << '\n';
+    if (stats.undecoded_bytes > 0 || stats.type_errors > 0)
+        std::cout << "  undecoded:   " << stats.undecoded_bytes << " bytes, "
+                  << stats.type_errors << " type errors" << '\n';
+
+    if (param.verbose)
+    {
+        std::cout << "  per command code:" << '\n';
+        for (size_t code = 0; code < stats.per_code.size(); ++code)
+        {
+            if (stats.per_code[code] > 0)
+                std::cout << "    " << code << ": " << stats.per_code[code] << '\n';
+        }
+    }
+}
+
+/****
+ * ShowHelp:
+ ****/
+void ShowHelp(const std::string &progname)
+{
+    std::cout << '\n'
+              << "Usage:  " << progname << " -f<recording> [OPTIONS]" << '\n'
+              << "  -f<file>    Recording made with VT_PROTOCOL_RECORD=<file> vt_term ..." << '\n'
+              << "  -s<socket>  Serve the recording to vt_term on this socket" << '\n'
+              << "              (without -s the frames are only decoded)" << '\n'
+              << "  -e<vt_term> Launch this vt_term binary against the socket" << '\n'
+              << "  -m          Replay at maximum speed instead of recorded timing" << '\n'
+              << "  -l<n>       Replay the recording n times" << '\n'
+              << "  -v          Verbose mode (per-command counts)" << '\n'
+              << "  -h          Show this help screen" << '\n'
+              << '\n';
+    exit(1);
+}
+
+/****
+ * ParseArguments: Walk through the arguments setting parameters
+ *   as necessary.
+ ****/
+Parameter ParseArguments(const int argc, const char* const argv[])
+{
+    Parameter param;
+    for (int idx = 1; idx < argc; idx++)
+    {
+        const std::string arg = argv[idx];
+        if (arg.length() < 2 || arg[0] != '-')
+        {
+            std::cout << "Invalid argument format: '" << arg << "'" << '\n';
+            ShowHelp(argv[0]);
+        }
+
+        const char opt = arg[1];
+        const std::string val = arg.substr(2);
+        if (opt == 'f')
+            param.recording = val;
+        else if (opt == 's')
+            param.socket_file = val;
+        else if (opt == 'e')
+            param.term_path = val;
+        else if (opt == 'm')
+            param.max_speed = true;
+        else if (opt == 'l')
+            param.loops = std::max(1, atoi(val.c_str()));
+        else if (opt == 'v')
+            param.verbose = true;
+        else
+            ShowHelp(argv[0]);
+    }
+
+    if (param.recording.empty())
+    {
+        std::cout << "No recording specified" << '\n';
+        ShowHelp(argv[0]);
+    }
+    if (!param.term_path.empty() && param.socket_file.empty())
+    {
+        std::cout << "-e needs a socket (-s)" << '\n';
+        ShowHelp(argv[0]);
+    }
+    return param;
+}
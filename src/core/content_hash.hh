@@ -0,0 +1,76 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * content_hash.hh - 64 bit FNV-1a hash of a sequence of fields
+ * Shared by vt_main and vt_term so both sides name cached assets alike
+ */
+
+#ifndef VT_CONTENT_HASH_HH
+#define VT_CONTENT_HASH_HH
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace vt {
+
+/**
+ * @brief Hashes fields in order; each is prefixed with its length, so
+ *  ("ab", "c") and ("a", "bc") hash differently.
+ *
+ * Not cryptographic: it names cache entries, it doesn't protect them.
+ */
+class ContentHash {
+public:
+    ContentHash &Add(std::string_view field) noexcept
+    {
+        AddValue(field.size());
+        for (char c : field)
+            Mix(static_cast<uint8_t>(c));
+        return *this;
+    }
+
+    ContentHash &AddValue(uint64_t value) noexcept
+    {
+        for (int i = 0; i < 8; ++i)
+            Mix(static_cast<uint8_t>(value >> (i * 8)));
+        return *this;
+    }
+
+    [[nodiscard]] uint64_t Value() const noexcept { return hash; }
+
+    [[nodiscard]] std::string Hex() const
+    {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string out(16, '0');
+        for (int i = 15; i >= 0; --i)
+            out[static_cast<size_t>(15 - i)] = digits[(hash >> (i * 4)) & 0xF];
+        return out;
+    }
+
+private:
+    void Mix(uint8_t byte) noexcept
+    {
+        hash ^= byte;
+        hash *= 0x100000001b3ULL;
+    }
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+};
+
+} // namespace vt
+
+#endif // VT_CONTENT_HASH_HH
@@ -21,6 +21,7 @@
 
 #include "data_file.hh"
 #include "cpp23_utils.hh"
+#include "src/core/metrics.hh"
 
 #include <algorithm>
 #include <array>
@@ -176,7 +177,7 @@ int InputDataFile::Open(const std::string &name, int &version)
     }
 
     std::array<char, 256> token{};
-    if (GetToken(token.data(), static_cast<int>(token.size())) != 0)
+    if (ReadToken(token.data(), static_cast<int>(token.size())) != 0)
     {
         Close();
         ReportError("Unknown file format for file: '" + name + "'");
@@ -197,13 +198,13 @@ int InputDataFile::Open(const std::string &name, int &version)
     }
     else if (std::strncmp(token.data(), "vtpos", 5) == 0)
     {
-        if (GetToken(token.data(), static_cast<int>(token.size())) != 0)
+        if (ReadToken(token.data(), static_cast<int>(token.size())) != 0)
         {
             Close();
             ReportError("Incomplete file header for file: '" + name + "'");
             return 1;
         }
-        if (GetToken(token.data(), static_cast<int>(token.size())) != 0)
+        if (ReadToken(token.data(), static_cast<int>(token.size())) != 0)
         {
             Close();
             ReportError("Missing version header for file: '" + name + "'");
@@ -230,6 +231,16 @@ int InputDataFile::Open(const std::string &name, int &version)
     return 0;
 }
 
+int InputDataFile::Open(const vt::DataTape &tape, int &version)
+{
+    FnTrace("InputDataFile::Open(DataTape)");
+    Close();
+    replay = &tape;
+    version = tape.version;
+    end_of_file = (tape.eof_at == 0);
+    return 0;
+}
+
 int InputDataFile::Close() noexcept
 {
     FnTrace("InputDataFile::Close()");
@@ -240,12 +251,58 @@ int InputDataFile::Close() noexcept
     }
     old_format = false;
     end_of_file = false;
+    record = nullptr;
+    replay = nullptr;
+    replay_pos = 0;
+    replay_failed = false;
     return 0;
 }
 
+uint32_t InputDataFile::TapePosition() const noexcept
+{
+    if (replay != nullptr)
+        return replay_pos;
+    return (record != nullptr) ? record->Count() : 0;
+}
+
+// Notes where end_of_file went up, so a replay raises it at the same value
+void InputDataFile::Recorded()
+{
+    if (end_of_file && record->eof_at == vt::DataTape::NoEof)
+        record->eof_at = record->Count();
+}
+
+// Steps past the next value on the tape if it is of the kind asked for
+bool InputDataFile::ReplayNext(vt::DataTape::Kind kind)
+{
+    if (replay_failed || replay_pos >= replay->Count() || replay->KindAt(replay_pos) != kind)
+    {
+        replay_failed = true;
+        end_of_file = true;
+        return false;
+    }
+    ++replay_pos;
+    if (replay_pos >= replay->eof_at)
+        end_of_file = true;
+    return true;
+}
+
 int InputDataFile::GetToken(char* buffer, int max_len)
 {
     FnTrace("InputDataFile::GetToken()");
+    // tokens are only recorded as the values Read() makes of them
+    if (replay != nullptr)
+    {
+        replay_failed = true;
+        return 1;
+    }
+    if (record != nullptr)
+        record->Spoil();
+    return ReadToken(buffer, max_len);
+}
+
+int InputDataFile::ReadToken(char* buffer, int max_len)
+{
     if (fp == nullptr || buffer == nullptr || max_len <= 0)
     {
         return 1;
@@ -287,6 +344,20 @@ int InputDataFile::GetToken(char* buffer, int max_len)
 uint64_t InputDataFile::GetValue()
 {
     FnTrace("InputDataFile::GetValue()");
+    if (replay != nullptr)
+        return ReplayNext(vt::DataTape::Kind::Value) ? replay->ValueAt(replay_pos - 1) : 0;
+
+    const uint64_t value = ParseValue();
+    if (record != nullptr)
+    {
+        record->PutValue(value);
+        Recorded();
+    }
+    return value;
+}
+
+uint64_t InputDataFile::ParseValue()
+{
     uint64_t value = 0;
 
     if (fp == nullptr)
@@ -338,9 +409,19 @@ uint64_t InputDataFile::GetValue()
 int InputDataFile::Read(Flt &val)
 {
     FnTrace("InputDataFile::Read(Flt &)");
+    if (replay != nullptr)
+    {
+        if (!ReplayNext(vt::DataTape::Kind::Flt))
+            return 1;
+        val = static_cast<Flt>(replay->FltAt(replay_pos - 1));
+        return 0;
+    }
+
     std::array<char, 256> token{};
-    if (GetToken(token.data(), static_cast<int>(token.size())) != 0)
+    if (ReadToken(token.data(), static_cast<int>(token.size())) != 0)
     {
+        if (record != nullptr)
+            record->Spoil();
         return 1;
     }
 
@@ -349,19 +430,40 @@ int InputDataFile::Read(Flt &val)
     const double parsed = std::strtod(token.data(), &end);
     if (token.data() == end || errno == ERANGE)
     {
+        if (record != nullptr)
+            record->Spoil();
         return 1;
     }
 
     val = static_cast<Flt>(parsed);
+    if (record != nullptr)
+    {
+        record->PutFlt(parsed);
+        Recorded();
+    }
     return 0;
 }
 
 int InputDataFile::Read(Str &s)
 {
     FnTrace("InputDataFile::Read(Str &)");
+    if (replay != nullptr)
+    {
+        if (!ReplayNext(vt::DataTape::Kind::Str))
+            return 1;
+        const std::string &value = replay->StrAt(replay_pos - 1);
+        if (value.empty())
+            s.Clear();
+        else
+            s.Set(value);
+        return 0;
+    }
+
     std::array<char, STRLONG> token{};
-    if (GetToken(token.data(), static_cast<int>(token.size())) != 0)
+    if (ReadToken(token.data(), static_cast<int>(token.size())) != 0)
     {
+        if (record != nullptr)
+            record->Spoil();
         return 1;
     }
 
@@ -374,6 +476,11 @@ int InputDataFile::Read(Str &s)
         s.Set(token.data());
         s.ChangeAtoB('_', ' ');
     }
+    if (record != nullptr)
+    {
+        record->PutStr(s.str());
+        Recorded();
+    }
     return 0;
 }
 
@@ -426,6 +533,11 @@ int InputDataFile::Read(Str *val)
 int InputDataFile::PeekTokens()
 {
     FnTrace("InputDataFile::PeekTokens()");
+    // the count depends on the file's layout, which a tape doesn't keep
+    if (replay != nullptr)
+        replay_failed = true;
+    if (record != nullptr)
+        record->Spoil();
     if (fp == nullptr)
     {
         return 0;
@@ -558,12 +670,14 @@ int OutputDataFile::Open(const std::string &filepath, int version, int use_compr
 
     const std::string header = "vtpos 0 " + std::to_string(version) + "\n";
     write_raw(gz_fp, file_fp, compress, header.c_str(), header.size());
+    open_ns = vt::MetricsNowNs();
     return 0;
 }
 
 int OutputDataFile::Close() noexcept
 {
     FnTrace("OutputDataFile::Close()");
+    const bool was_open = (gz_fp != nullptr || file_fp != nullptr);
     if (gz_fp != nullptr)
     {
         gzclose(gz_fp);
@@ -574,6 +688,18 @@ int OutputDataFile::Close() noexcept
         std::fclose(file_fp);
         file_fp = nullptr;
     }
+    if (was_open && open_ns > 0)
+    {
+        // Open() to Close(), i.e. serializing plus writing the whole file
+        static vt::LatencyHistogram &plain = vt::Metrics().Histogram(
+            "vt_file_save_seconds", "Time to write a data file, Open() to Close()",
+            vt::MetricLabel("compressed", "0"));
+        static vt::LatencyHistogram &compressed = vt::Metrics().Histogram(
+            "vt_file_save_seconds", "Time to write a data file, Open() to Close()",
+            vt::MetricLabel("compressed", "1"));
+        (compress ? compressed : plain).Record(vt::MetricsNowNs() - open_ns);
+        open_ns = 0;
+    }
     return 0;
 }
 
@@ -23,6 +23,7 @@
 #define DATA_FILE_HH
 
 #include "utility.hh"
+#include "src/core/data_tape.hh"
 
 #include <zlib.h>
 
@@ -42,6 +43,15 @@ class InputDataFile
     gzFile fp{nullptr};
     bool old_format{false};
     std::string filename;
+    vt::DataTape *record{nullptr};        // gets every value parsed
+    const vt::DataTape *replay{nullptr};  // gives the values instead of fp
+    uint32_t replay_pos{0};
+    bool replay_failed{false};
+
+    int ReadToken(char* buffer, int max_len);
+    uint64_t ParseValue();
+    void Recorded();
+    bool ReplayNext(vt::DataTape::Kind kind);
 
 public:
     bool end_of_file{false};
@@ -49,11 +59,22 @@ public:
     InputDataFile() = default;
     ~InputDataFile();
 
-    [[nodiscard]] bool is_open() const noexcept { return fp != nullptr; }
+    [[nodiscard]] bool is_open() const noexcept { return fp != nullptr || replay != nullptr; }
 
     int Open(const std::string &filename, int &version);
+    // Reads back the values of a tape Record() filled in; the tape must
+    // outlive the reads
+    int Open(const vt::DataTape &tape, int &version);
     int Close() noexcept;
 
+    // Adds every value read from here on to tape (spoiling it if the
+    // file is read in a way a replay can't repeat)
+    void Record(vt::DataTape *tape) noexcept { record = tape; }
+    // A replay read a different kind of value or ran off the end of the tape
+    [[nodiscard]] bool ReplayFailed() const noexcept { return replay_failed; }
+    // Values read so far from the tape being recorded or replayed
+    [[nodiscard]] uint32_t TapePosition() const noexcept;
+
     int GetToken(char* buffer, int max_len);
     [[nodiscard]] uint64_t GetValue();
 
@@ -95,6 +116,7 @@ class OutputDataFile
     std::FILE* file_fp{nullptr};
     bool compress{false};
     std::string filename;
+    int64_t open_ns{0};  // for vt_file_save_seconds
 
 public:
     OutputDataFile() = default;
@@ -0,0 +1,324 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * data_tape.cc - Binary record of the values read from an InputDataFile
+ */
+
+#include "data_tape.hh"
+#include "content_hash.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+
+void PutFixed(std::string &out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+void PutVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Negative ints reach GetValue() sign extended, so zigzag keeps them short
+uint64_t ZigZag(uint64_t value)
+{
+    return (value << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+uint64_t UnZigZag(uint64_t value)
+{
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+// Bounds checked reads; any overrun leaves ok false
+struct Reader {
+    const std::string &data;
+    size_t pos = 0;
+    size_t end = 0;
+    bool ok = true;
+
+    uint64_t Fixed(int bytes)
+    {
+        if (!ok || end - pos < static_cast<size_t>(bytes))
+        {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i)
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (i * 8);
+        return value;
+    }
+
+    uint64_t Varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; ok && shift < 64; shift += 7)
+        {
+            if (pos >= end)
+                break;
+            const auto byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    // A count of things at least min_bytes long each, so a corrupt
+    // count can't ask for more memory than the file could describe
+    uint64_t Count(size_t min_bytes)
+    {
+        const uint64_t count = Varint();
+        if (ok && count > (end - pos) / min_bytes)
+            ok = false;
+        return ok ? count : 0;
+    }
+};
+
+} // namespace
+
+void DataTape::Clear()
+{
+    kinds.clear();
+    values.clear();
+    strings.clear();
+    string_index.clear();
+    pages.clear();
+    spoiled = false;
+    version = 0;
+    key = 0;
+    eof_at = NoEof;
+}
+
+void DataTape::PutValue(uint64_t value)
+{
+    kinds.push_back(static_cast<uint8_t>(Kind::Value));
+    values.push_back(value);
+}
+
+void DataTape::PutFlt(double value)
+{
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    kinds.push_back(static_cast<uint8_t>(Kind::Flt));
+    values.push_back(bits);
+}
+
+void DataTape::PutStr(const std::string &value)
+{
+    auto [it, added] = string_index.try_emplace(value, strings.size());
+    if (added)
+        strings.push_back(value);
+    kinds.push_back(static_cast<uint8_t>(Kind::Str));
+    values.push_back(it->second);
+}
+
+void DataTape::AddPage(int id, int size, uint32_t first, uint32_t end)
+{
+    pages.push_back({id, size, first, end});
+}
+
+double DataTape::FltAt(uint32_t pos) const noexcept
+{
+    double value = 0;
+    std::memcpy(&value, &values[pos], sizeof(value));
+    return value;
+}
+
+std::string DataTape::Pack() const
+{
+    std::string out(MAGIC, sizeof(MAGIC));
+    PutFixed(out, key, 8);
+    PutFixed(out, static_cast<uint32_t>(version), 4);
+    PutVarint(out, eof_at);
+
+    PutVarint(out, strings.size());
+    for (const std::string &s : strings)
+    {
+        PutVarint(out, s.size());
+        out.append(s);
+    }
+
+    PutVarint(out, pages.size());
+    for (const PageSpan &span : pages)
+    {
+        PutVarint(out, ZigZag(static_cast<uint64_t>(static_cast<int64_t>(span.id))));
+        PutVarint(out, ZigZag(static_cast<uint64_t>(static_cast<int64_t>(span.size))));
+        PutVarint(out, span.first);
+        PutVarint(out, span.end);
+    }
+
+    PutVarint(out, kinds.size());
+    for (size_t i = 0; i < kinds.size(); ++i)
+    {
+        out.push_back(static_cast<char>(kinds[i]));
+        if (static_cast<Kind>(kinds[i]) == Kind::Flt)
+            PutFixed(out, values[i], 8);
+        else if (static_cast<Kind>(kinds[i]) == Kind::Str)
+            PutVarint(out, values[i]);
+        else
+            PutVarint(out, ZigZag(values[i]));
+    }
+
+    PutFixed(out, ContentHash().Add(out).Value(), 8);
+    return out;
+}
+
+int DataTape::Unpack(const std::string &data, uint64_t expected_key)
+{
+    Clear();
+    if (data.size() < sizeof(MAGIC) + 8 + 4 + 8 ||
+        std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+        return 1;
+
+    const size_t body = data.size() - 8;
+    Reader in{data, body, data.size()};
+    const uint64_t checksum = in.Fixed(8);
+    if (ContentHash().Add(std::string_view(data.data(), body)).Value() != checksum)
+        return 1;
+
+    in.pos = sizeof(MAGIC);
+    in.end = body;
+    key = in.Fixed(8);
+    if (key != expected_key)
+    {
+        Clear();
+        return 1;
+    }
+    version = static_cast<int32_t>(static_cast<uint32_t>(in.Fixed(4)));
+    const uint64_t eof = in.Varint();
+
+    const uint64_t string_count = in.Count(1);
+    strings.reserve(string_count);
+    for (uint64_t i = 0; in.ok && i < string_count; ++i)
+    {
+        const uint64_t len = in.Varint();
+        if (!in.ok || len > in.end - in.pos)
+        {
+            in.ok = false;
+            break;
+        }
+        strings.emplace_back(data, in.pos, len);
+        in.pos += len;
+    }
+
+    const uint64_t page_count = in.Count(4);
+    pages.reserve(page_count);
+    for (uint64_t i = 0; in.ok && i < page_count; ++i)
+    {
+        PageSpan span;
+        span.id    = static_cast<int32_t>(static_cast<int64_t>(UnZigZag(in.Varint())));
+        span.size  = static_cast<int32_t>(static_cast<int64_t>(UnZigZag(in.Varint())));
+        span.first = static_cast<uint32_t>(in.Varint());
+        span.end   = static_cast<uint32_t>(in.Varint());
+        pages.push_back(span);
+    }
+
+    const uint64_t value_count = in.Count(2);
+    kinds.reserve(value_count);
+    values.reserve(value_count);
+    for (uint64_t i = 0; in.ok && i < value_count; ++i)
+    {
+        const auto kind = static_cast<Kind>(in.Fixed(1));
+        uint64_t value = 0;
+        if (kind == Kind::Flt)
+            value = in.Fixed(8);
+        else if (kind == Kind::Str)
+            value = in.Varint();
+        else if (kind == Kind::Value)
+            value = UnZigZag(in.Varint());
+        else
+            in.ok = false;
+        if (kind == Kind::Str && value >= strings.size())
+            in.ok = false;
+        kinds.push_back(static_cast<uint8_t>(kind));
+        values.push_back(value);
+    }
+
+    if (in.ok && in.pos == in.end && (eof == NoEof || eof <= kinds.size()))
+    {
+        eof_at = static_cast<uint32_t>(eof);
+        for (const PageSpan &span : pages)
+        {
+            if (span.first > span.end || span.end > kinds.size())
+                in.ok = false;
+        }
+    }
+    else
+        in.ok = false;
+
+    if (!in.ok)
+    {
+        Clear();
+        return 1;
+    }
+    return 0;
+}
+
+int DataTape::Save(const std::string &path) const
+{
+    const std::string data = Pack();
+    const std::string tmp = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return 1;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out.flush())
+        {
+            out.close();
+            std::remove(tmp.c_str());
+            return 1;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int DataTape::Load(const std::string &path, uint64_t expected_key)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        Clear();
+        return 1;
+    }
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return Unpack(data, expected_key);
+}
+
+} // namespace vt
@@ -0,0 +1,106 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * data_tape.hh - Binary record of the values read from an InputDataFile
+ * Lets ZoneDB::Load() replay a zone database without parsing the text file
+ */
+
+#ifndef VT_DATA_TAPE_HH
+#define VT_DATA_TAPE_HH
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief Every value a reader took from an InputDataFile, in order, plus
+ *  where each page's values start and end.
+ *
+ * InputDataFile::Record() fills one in while the text file is parsed;
+ * InputDataFile::Open(tape) hands the same values back to the same Read()
+ * calls.  Strings are stored once in a string table.  A value the text
+ * parser couldn't read spoils the tape, since the replay couldn't fail the
+ * same way.
+ *
+ * File layout (little-endian): 8 byte magic, I8 key, I4 file version,
+ * varint eof_at, then varint counts and entries for the string table, the page table
+ * <id, size, first, end> and the values (a kind byte each, then a zigzag
+ * varint, 8 raw bytes for a Flt or a string index), and an I8 ContentHash
+ * of everything before it.
+ */
+class DataTape {
+public:
+    enum class Kind : uint8_t {
+        Value = 0,  // GetValue(): every integer Read()
+        Flt   = 1,
+        Str   = 2
+    };
+
+    struct PageSpan {
+        int32_t  id = 0;
+        int32_t  size = 0;
+        uint32_t first = 0;  // index of the page's first value
+        uint32_t end = 0;    // one past its last value
+    };
+
+    static constexpr char MAGIC[8] = {'V', 'T', 'T', 'A', 'P', 'E', '0', '1'};
+    static constexpr uint32_t NoEof = 0xFFFFFFFFu;
+
+    void Clear();
+
+    void PutValue(uint64_t value);
+    void PutFlt(double value);
+    void PutStr(const std::string &value);
+    void Spoil() noexcept { spoiled = true; }
+    void AddPage(int id, int size, uint32_t first, uint32_t end);
+
+    [[nodiscard]] bool Spoiled() const noexcept { return spoiled; }
+    [[nodiscard]] uint32_t Count() const noexcept { return static_cast<uint32_t>(kinds.size()); }
+    [[nodiscard]] Kind KindAt(uint32_t pos) const noexcept { return static_cast<Kind>(kinds[pos]); }
+    [[nodiscard]] uint64_t ValueAt(uint32_t pos) const noexcept { return values[pos]; }
+    [[nodiscard]] double FltAt(uint32_t pos) const noexcept;
+    [[nodiscard]] const std::string &StrAt(uint32_t pos) const noexcept { return strings[values[pos]]; }
+    [[nodiscard]] const std::vector<PageSpan> &Pages() const noexcept { return pages; }
+
+    // What the tape was recorded from: the file's version header and a
+    // key naming its contents and the code that read it
+    int      version = 0;
+    uint64_t key = 0;
+    // Values read before the reader's end_of_file went up, or NoEof
+    uint32_t eof_at = NoEof;
+
+    [[nodiscard]] std::string Pack() const;
+    // Fails on a bad magic, checksum or layout, or a key other than expected
+    int Unpack(const std::string &data, uint64_t expected_key);
+
+    int Save(const std::string &path) const;  // via a temp file and rename
+    int Load(const std::string &path, uint64_t expected_key);
+
+private:
+    std::vector<uint8_t>     kinds;
+    std::vector<uint64_t>    values;   // value, Flt bits or string index
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint64_t> string_index;
+    std::vector<PageSpan>    pages;
+    bool spoiled = false;
+};
+
+} // namespace vt
+
+#endif // VT_DATA_TAPE_HH
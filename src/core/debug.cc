@@ -216,7 +216,7 @@ void PrintTermCode( int code ) noexcept
     }
 }
 
-constexpr std::array<const char*, 24> server_codes = {
+constexpr std::array<const char*, 45> server_codes = {
     "",
     "SrvError",
     "SrvTermInfo",
@@ -239,7 +239,29 @@ constexpr std::array<const char*, 24> server_codes = {
     "",
     "SrvPrinterDone",
     "SrvBadFile",
-    "SrvDefPage"
+    "SrvDefPage",
+    "",
+    "",
+    "",
+    "",
+    "",
+    "",
+    "",
+    "SrvCcProcessed",
+    "SrvCcSettled",
+    "SrvCcInit",
+    "SrvCcTotals",
+    "SrvCcDetails",
+    "SrvCcSafCleared",
+    "SrvCcSafDetails",
+    "SrvCcSettleFailed",
+    "SrvCcSafClearFailed",
+    "SrvFontMetrics",
+    "SrvAssetHashes",
+    "SrvResume",
+    "SrvInputStamp",
+    "SrvInputSpans",
+    "SrvPressShown"
 };
 constexpr int num_server_codes = static_cast<int>(server_codes.size());
 void PrintServerCode( int code ) noexcept
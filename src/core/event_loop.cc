@@ -0,0 +1,287 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * event_loop.cc - epoll/timerfd/eventfd event loop
+ */
+
+#include "event_loop.hh"
+#include "src/utils/vt_logger.hh"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+// epoll_event.data tags for the internal descriptors; inputs use their id
+constexpr uint64_t TIMER_TAG = UINT64_MAX;
+constexpr uint64_t WAKE_TAG  = UINT64_MAX - 1;
+constexpr int MAX_EVENTS = 64;
+}
+
+int64_t EventLoop::NowNs() noexcept
+{
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+EventLoop::EventLoop()
+{
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wake_fd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!Valid())
+    {
+        vt::Logger::error("EventLoop: unable to create descriptors: {}", strerror(errno));
+        return;
+    }
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = TIMER_TAG;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+    ev.data.u64 = WAKE_TAG;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+}
+
+EventLoop::~EventLoop()
+{
+    for (int fd : {epoll_fd, timer_fd, wake_fd})
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+bool EventLoop::Valid() const noexcept
+{
+    return epoll_fd >= 0 && timer_fd >= 0 && wake_fd >= 0;
+}
+
+unsigned long EventLoop::AddTimeOut(TimerProc fn, int msec, void *client_data)
+{
+    if (fn == nullptr || !Valid())
+        return 0;
+    if (msec < 0)
+        msec = 0;
+
+    unsigned long id = next_id++;
+    int64_t deadline = NowNs() + static_cast<int64_t>(msec) * 1000000LL;
+    timers[id] = Timer{fn, client_data, deadline};
+    deadlines.emplace(deadline, id);
+    ArmTimerFd();
+    return id;
+}
+
+int EventLoop::RemoveTimeOut(unsigned long id)
+{
+    auto it = timers.find(id);
+    if (it == timers.end())
+        return 1;
+    deadlines.erase({it->second.deadline, id});
+    timers.erase(it);
+    ArmTimerFd();
+    return 0;
+}
+
+unsigned long EventLoop::AddInput(InputProc fn, int fd, void *client_data)
+{
+    if (fn == nullptr || fd < 0 || !Valid())
+        return 0;
+
+    unsigned long id = next_id++;
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        vt::Logger::error("EventLoop: can't watch fd {}: {}", fd, strerror(errno));
+        return 0;
+    }
+    inputs[id] = Input{fn, client_data, fd};
+    return id;
+}
+
+int EventLoop::RemoveInput(unsigned long id)
+{
+    auto it = inputs.find(id);
+    if (it == inputs.end())
+        return 1;
+    // the fd may already be closed, in which case the kernel dropped it
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    inputs.erase(it);
+    return 0;
+}
+
+unsigned long EventLoop::AddWorkProc(WorkProc fn, void *client_data)
+{
+    if (fn == nullptr)
+        return 0;
+
+    unsigned long id = next_id++;
+    works[id] = Work{fn, client_data};
+    return id;
+}
+
+int EventLoop::RemoveWorkProc(unsigned long id)
+{
+    return works.erase(id) ? 0 : 1;
+}
+
+int EventLoop::ArmTimerFd()
+{
+    int64_t next = deadlines.empty() ? 0 : deadlines.begin()->first;
+    if (next == armed_deadline)
+        return 0;
+
+    // it_value of zero disarms the timer
+    struct itimerspec spec{};
+    spec.it_value.tv_sec  = static_cast<time_t>(next / 1000000000LL);
+    spec.it_value.tv_nsec = static_cast<long>(next % 1000000000LL);
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0)
+    {
+        vt::Logger::error("EventLoop: timerfd_settime failed: {}", strerror(errno));
+        return 1;
+    }
+    armed_deadline = next;
+    return 0;
+}
+
+int EventLoop::DispatchTimers()
+{
+    uint64_t expirations = 0;
+    while (read(timer_fd, &expirations, sizeof(expirations)) > 0)
+        ;
+    armed_deadline = 0;
+
+    // Timers added by the callbacks get a later deadline than 'now' so
+    // a callback re-adding itself with 0 ms can't starve the loop
+    int dispatched = 0;
+    int64_t now = NowNs();
+    while (!deadlines.empty() && deadlines.begin()->first <= now)
+    {
+        unsigned long id = deadlines.begin()->second;
+        deadlines.erase(deadlines.begin());
+        auto it = timers.find(id);
+        if (it == timers.end())
+            continue;
+        Timer timer = it->second;
+        timers.erase(it);
+        timer.fn(timer.client_data, &id);
+        ++dispatched;
+    }
+    ArmTimerFd();
+    return dispatched;
+}
+
+int EventLoop::DispatchWork()
+{
+    if (works.empty())
+        return 0;
+
+    // round robin so one long report can't hold off the others
+    auto it = works.upper_bound(last_work);
+    if (it == works.end())
+        it = works.begin();
+    unsigned long id = it->first;
+    Work work = it->second;
+    last_work = id;
+    if (work.fn(work.client_data))
+        works.erase(id);
+    return 1;
+}
+
+int EventLoop::RunOnce(int max_wait_ms)
+{
+    if (!Valid())
+        return -1;
+
+    std::array<struct epoll_event, MAX_EVENTS> events{};
+    int timeout = works.empty() ? max_wait_ms : 0;
+    int n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, timeout);
+    if (n < 0)
+    {
+        if (errno == EINTR)
+            return 0;
+        vt::Logger::error("EventLoop: epoll_wait failed: {}", strerror(errno));
+        return -1;
+    }
+    if (n == 0)
+        return DispatchWork();
+
+    int dispatched = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        uint64_t tag = events[i].data.u64;
+        if (tag == TIMER_TAG)
+        {
+            dispatched += DispatchTimers();
+        }
+        else if (tag == WAKE_TAG)
+        {
+            uint64_t count = 0;
+            while (read(wake_fd, &count, sizeof(count)) > 0)
+                ;
+        }
+        else
+        {
+            // an earlier callback in this batch may have removed the input
+            unsigned long id = static_cast<unsigned long>(tag);
+            auto it = inputs.find(id);
+            if (it == inputs.end())
+                continue;
+            Input input = it->second;
+            input.fn(input.client_data, &input.fd, &id);
+            ++dispatched;
+        }
+    }
+    return dispatched;
+}
+
+int EventLoop::Run()
+{
+    stop_requested = false;
+    while (!stop_requested)
+    {
+        if (RunOnce(-1) < 0)
+            return 1;
+    }
+    return 0;
+}
+
+void EventLoop::Stop() noexcept
+{
+    stop_requested = true;
+    Wakeup();
+}
+
+void EventLoop::Wakeup() noexcept
+{
+    if (wake_fd < 0)
+        return;
+    uint64_t one = 1;
+    ssize_t result = write(wake_fd, &one, sizeof(one));
+    (void)result;
+}
+
+} // namespace vt
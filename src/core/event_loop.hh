@@ -0,0 +1,127 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * event_loop.hh - epoll/timerfd/eventfd event loop
+ * Drop-in replacement for the Xt timer, input and work proc
+ * dispatching used by vt_main when running without an X server
+ */
+
+#ifndef VT_EVENT_LOOP_HH
+#define VT_EVENT_LOOP_HH
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace vt {
+
+/**
+ * @brief Single threaded event loop built on epoll, timerfd and eventfd.
+ *
+ * Callbacks use the same argument order as their Xt counterparts so the
+ * functions registered through AddTimeOutFn()/AddInputFn()/AddWorkFn() can
+ * be dispatched by either backend:
+ * - timers are one-shot, like XtAppAddTimeOut()
+ * - inputs fire while the descriptor is readable, like XtAppAddInput()
+ * - work procs run when no events are pending and are removed once they
+ *   return nonzero, like XtAppAddWorkProc()
+ *
+ * All timers share one timerfd armed for the earliest deadline.  The
+ * eventfd lets Stop()/Wakeup() interrupt epoll_wait() from other threads
+ * or signal handlers.
+ */
+class EventLoop {
+public:
+    using TimerProc = void (*)(void *client_data, unsigned long *id);
+    using InputProc = void (*)(void *client_data, int *fd, unsigned long *id);
+    using WorkProc  = int (*)(void *client_data);
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // false if the epoll/timerfd/eventfd descriptors could not be created
+    [[nodiscard]] bool Valid() const noexcept;
+
+    // All Add functions return 0 on failure, otherwise a nonzero id
+    unsigned long AddTimeOut(TimerProc fn, int msec, void *client_data);
+    int RemoveTimeOut(unsigned long id);
+    unsigned long AddInput(InputProc fn, int fd, void *client_data);
+    int RemoveInput(unsigned long id);
+    unsigned long AddWorkProc(WorkProc fn, void *client_data);
+    int RemoveWorkProc(unsigned long id);
+
+    /**
+     * @brief Waits for and dispatches one batch of events
+     * @param max_wait_ms longest time to block, -1 waits forever
+     * @return number of callbacks dispatched, -1 on error
+     */
+    int RunOnce(int max_wait_ms = -1);
+    // Dispatches events until Stop() is called
+    int Run();
+    // Async-signal-safe; makes Run() return after the current batch
+    void Stop() noexcept;
+    // Async-signal-safe; interrupts a blocking RunOnce()
+    void Wakeup() noexcept;
+
+    [[nodiscard]] size_t TimerCount() const noexcept { return timers.size(); }
+    [[nodiscard]] size_t InputCount() const noexcept { return inputs.size(); }
+    [[nodiscard]] size_t WorkCount() const noexcept { return works.size(); }
+
+    // CLOCK_MONOTONIC in nanoseconds
+    static int64_t NowNs() noexcept;
+
+private:
+    struct Timer {
+        TimerProc fn;
+        void *client_data;
+        int64_t deadline;
+    };
+    struct Input {
+        InputProc fn;
+        void *client_data;
+        int fd;
+    };
+    struct Work {
+        WorkProc fn;
+        void *client_data;
+    };
+
+    int ArmTimerFd();
+    int DispatchTimers();
+    int DispatchWork();
+
+    int epoll_fd = -1;
+    int timer_fd = -1;
+    int wake_fd = -1;
+    int64_t armed_deadline = 0;
+    unsigned long next_id = 1;
+    unsigned long last_work = 0;
+    std::atomic<bool> stop_requested{false};
+
+    std::map<unsigned long, Timer> timers;
+    std::set<std::pair<int64_t, unsigned long>> deadlines;
+    std::map<unsigned long, Input> inputs;
+    std::map<unsigned long, Work> works;
+};
+
+} // namespace vt
+
+#endif // VT_EVENT_LOOP_HH
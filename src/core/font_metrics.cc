@@ -0,0 +1,171 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * font_metrics.cc - Glyph advance tables measured by vt_term
+ */
+
+#include "font_metrics.hh"
+
+#include <algorithm>
+
+namespace vt {
+
+uint32_t DecodeUtf8(const char* str, int len, int &pos) noexcept
+{
+    auto byte = [&](int i) { return static_cast<unsigned char>(str[i]); };
+
+    unsigned char c = byte(pos);
+    int extra = 0;
+    uint32_t cp = 0;
+    if (c < 0x80)
+    {
+        ++pos;
+        return c;
+    }
+    else if ((c & 0xE0) == 0xC0 && c >= 0xC2)
+    {
+        extra = 1;
+        cp = c & 0x1F;
+    }
+    else if ((c & 0xF0) == 0xE0)
+    {
+        extra = 2;
+        cp = c & 0x0F;
+    }
+    else if ((c & 0xF8) == 0xF0 && c <= 0xF4)
+    {
+        extra = 3;
+        cp = c & 0x07;
+    }
+    else
+    {
+        ++pos;
+        return c;  // stray continuation or invalid lead byte: Latin-1
+    }
+
+    if (pos + extra >= len)
+    {
+        ++pos;
+        return c;  // truncated sequence
+    }
+    for (int i = 1; i <= extra; ++i)
+    {
+        unsigned char cc = byte(pos + i);
+        if ((cc & 0xC0) != 0x80)
+        {
+            ++pos;
+            return c;
+        }
+        cp = (cp << 6) | (cc & 0x3F);
+    }
+    pos += extra + 1;
+    return cp;
+}
+
+void GlyphAdvanceTable::Clear() noexcept
+{
+    ascii.fill(-1);
+    extended.clear();
+    height = 0;
+    default_advance = 0;
+}
+
+void GlyphAdvanceTable::SetAdvance(uint32_t codepoint, int advance)
+{
+    auto value = static_cast<int16_t>(std::clamp(advance, 0, 0x7FFF));
+    if (codepoint < ascii.size())
+        ascii[codepoint] = value;
+    else
+        extended[codepoint] = value;
+}
+
+int GlyphAdvanceTable::Advance(uint32_t codepoint) const noexcept
+{
+    if (codepoint < ascii.size())
+        return ascii[codepoint] >= 0 ? ascii[codepoint] : default_advance;
+
+    auto it = extended.find(codepoint);
+    return it != extended.end() ? it->second : default_advance;
+}
+
+int GlyphAdvanceTable::TextWidth(const char* str, int len) const noexcept
+{
+    if (str == nullptr || len <= 0)
+        return 0;
+
+    int width = 0;
+    int pos = 0;
+    while (pos < len)
+    {
+        auto c = static_cast<unsigned char>(str[pos]);
+        if (c < 0x80)
+        {
+            // ASCII fast path - no decoding or hashing
+            width += ascii[c] >= 0 ? ascii[c] : default_advance;
+            ++pos;
+        }
+        else
+        {
+            width += Advance(DecodeUtf8(str, len, pos));
+        }
+    }
+    return width;
+}
+
+GlyphAdvanceTable *FontMetrics::Reset(int font_id) noexcept
+{
+    if (font_id < 0 || font_id >= MAX_FONTS)
+        return nullptr;
+    tables[font_id].Clear();
+    loaded[font_id] = true;
+    return &tables[font_id];
+}
+
+void FontMetrics::Clear() noexcept
+{
+    for (int i = 0; i < MAX_FONTS; ++i)
+    {
+        if (loaded[i])
+            tables[i].Clear();
+    }
+    loaded.fill(false);
+}
+
+bool FontMetrics::Has(int font_id) const noexcept
+{
+    return font_id >= 0 && font_id < MAX_FONTS && loaded[font_id];
+}
+
+int FontMetrics::Count() const noexcept
+{
+    return static_cast<int>(std::count(loaded.begin(), loaded.end(), true));
+}
+
+int FontMetrics::TextWidth(int font_id, const char* str, int len) const noexcept
+{
+    if (!Has(font_id))
+        return -1;
+    return tables[font_id].TextWidth(str, len);
+}
+
+int FontMetrics::Height(int font_id) const noexcept
+{
+    if (!Has(font_id))
+        return -1;
+    return tables[font_id].height;
+}
+
+} // namespace vt
@@ -0,0 +1,101 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * font_metrics.hh - Glyph advance tables measured by vt_term
+ * Lets vt_main lay out text with the widths the terminal really draws
+ */
+
+#ifndef VT_FONT_METRICS_HH
+#define VT_FONT_METRICS_HH
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace vt {
+
+// Code point ranges vt_term measures for every font: printable ASCII,
+// Latin-1 and the punctuation/currency symbols used in the translations.
+// Anything else is measured with the table's default advance.
+struct GlyphRange {
+    uint32_t first;
+    uint16_t count;
+};
+
+inline constexpr std::array<GlyphRange, 5> GLYPH_RANGES = {{
+    {0x0020, 95},   // printable ASCII
+    {0x00A0, 96},   // Latin-1 supplement
+    {0x2013, 2},    // en/em dash
+    {0x2018, 16},   // quotes, bullets, ellipsis
+    {0x20AC, 1}     // euro sign
+}};
+
+/**
+ * @brief Decodes the UTF-8 sequence at str[pos] and advances pos past it.
+ *
+ * Bytes that don't start a valid sequence are returned as their Latin-1
+ * value and consume one byte, so legacy 8-bit strings still measure.
+ */
+uint32_t DecodeUtf8(const char* str, int len, int &pos) noexcept;
+
+/**
+ * @brief Horizontal advances for one font, indexed by code point.
+ *
+ * ASCII lives in a flat array so TextWidth() can sum plain strings without
+ * decoding; other code points fall back to a hash lookup.
+ */
+class GlyphAdvanceTable {
+public:
+    GlyphAdvanceTable() noexcept { Clear(); }
+
+    void Clear() noexcept;
+    void SetAdvance(uint32_t codepoint, int advance);
+    [[nodiscard]] int Advance(uint32_t codepoint) const noexcept;
+    [[nodiscard]] int TextWidth(const char* str, int len) const noexcept;
+
+    int height = 0;           // ascent + descent
+    int default_advance = 0;  // width used for unmeasured code points
+
+private:
+    std::array<int16_t, 128> ascii{};   // -1 = not measured
+    std::unordered_map<uint32_t, int16_t> extended;
+};
+
+/**
+ * @brief Per-terminal set of glyph advance tables, one per font id.
+ */
+class FontMetrics {
+public:
+    static constexpr int MAX_FONTS = 32;
+
+    // Returns the (cleared) table to fill for font_id, nullptr if out of range
+    GlyphAdvanceTable *Reset(int font_id) noexcept;
+    void Clear() noexcept;
+
+    [[nodiscard]] bool Has(int font_id) const noexcept;
+    [[nodiscard]] int Count() const noexcept;
+    // Returns -1 if no table has been received for font_id
+    [[nodiscard]] int TextWidth(int font_id, const char* str, int len) const noexcept;
+    [[nodiscard]] int Height(int font_id) const noexcept;
+
+private:
+    std::array<GlyphAdvanceTable, MAX_FONTS> tables;
+    std::array<bool, MAX_FONTS> loaded{};
+};
+
+} // namespace vt
+
+#endif // VT_FONT_METRICS_HH
@@ -0,0 +1,108 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * input_trace.cc - Where the time goes between a touch and its pixels
+ */
+
+#include "input_trace.hh"
+#include "metrics.hh"
+
+namespace vt {
+
+const char* InputSpanName(InputSpan span) noexcept
+{
+    switch (span)
+    {
+    case InputSpan::Queue:   return "queue";
+    case InputSpan::Touch:   return "touch";
+    case InputSpan::Signal:  return "signal";
+    case InputSpan::Render:  return "render";
+    case InputSpan::Write:   return "write";
+    case InputSpan::Transit: return "transit";
+    case InputSpan::Decode:  return "decode";
+    case InputSpan::Blit:    return "blit";
+    case InputSpan::Count:   break;
+    }
+    return "unknown";
+}
+
+void InputTrace::Begin(uint32_t new_seq, int64_t new_input_ns, int64_t now_ns) noexcept
+{
+    spans = {};
+    seq = new_seq;
+    input_ns = new_input_ns;
+    end_ns = 0;
+    active = true;
+    waiting = false;
+    spans[static_cast<size_t>(InputSpan::Queue)].total = now_ns - new_input_ns;
+}
+
+void InputTrace::Enter(InputSpan span, int64_t now_ns) noexcept
+{
+    Span &s = spans[static_cast<size_t>(span)];
+    if (s.depth++ == 0)
+        s.entered = now_ns;
+}
+
+void InputTrace::Leave(InputSpan span, int64_t now_ns) noexcept
+{
+    Span &s = spans[static_cast<size_t>(span)];
+    if (s.depth > 0 && --s.depth == 0)
+        s.total += now_ns - s.entered;
+}
+
+void InputTrace::End(int64_t now_ns) noexcept
+{
+    if (!active)
+        return;
+    // Anything still open (End() from inside a span) is cut off here
+    for (auto &s : spans)
+    {
+        if (s.depth > 0)
+            s.total += now_ns - s.entered;
+        s.depth = 0;
+    }
+    end_ns = now_ns;
+    active = false;
+    waiting = true;
+}
+
+int64_t InputTrace::Complete(uint32_t reply_seq, int64_t read_ns, int64_t decoded_ns,
+                             int64_t blitted_ns) noexcept
+{
+    if (!waiting || reply_seq != seq)
+        return -1;
+    waiting = false;
+    spans[static_cast<size_t>(InputSpan::Transit)].total = read_ns - end_ns;
+    spans[static_cast<size_t>(InputSpan::Decode)].total = decoded_ns - read_ns;
+    spans[static_cast<size_t>(InputSpan::Blit)].total = blitted_ns - decoded_ns;
+    return blitted_ns - input_ns;
+}
+
+InputSpanScope::InputSpanScope(InputTrace &t, InputSpan s) noexcept
+    : trace(t.Active() ? &t : nullptr), span(s)
+{
+    if (trace)
+        trace->Enter(span, MetricsNowNs());
+}
+
+InputSpanScope::~InputSpanScope()
+{
+    if (trace)
+        trace->Leave(span, MetricsNowNs());
+}
+
+} // namespace vt
@@ -0,0 +1,110 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * input_trace.hh - Where the time goes between a touch and its pixels
+ * Times are MetricsNowNs(); vt_term runs on vt_main's host, so its
+ * stamps are on the same clock
+ */
+
+#ifndef VT_INPUT_TRACE_HH
+#define VT_INPUT_TRACE_HH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace vt {
+
+enum class InputSpan : uint8_t {
+    Queue,    // vt_term saw the input -> vt_main read it
+    Touch,    // Terminal::Touch() or MouseInput(), including what follows
+    Signal,   // Terminal::Signal()
+    Render,   // Terminal::Draw() and Zone::Draw()
+    Write,    // Terminal::SendNow()
+    Transit,  // last write -> vt_term read the frame
+    Decode,   // vt_term read the frame -> reached TERM_INPUT_DONE
+    Blit,     // TERM_INPUT_DONE -> next frame flushed to X
+    Count
+};
+
+inline constexpr size_t INPUT_SPAN_COUNT = static_cast<size_t>(InputSpan::Count);
+
+const char* InputSpanName(InputSpan span) noexcept;
+
+/**
+ * @brief One traced input at a time, from vt_term's stamp to its reply.
+ *
+ * Spans on the server nest (Touch holds Signal holds Render), so each
+ * records the time spent inside it, counted once however deep it
+ * recurses.  A new Begin() abandons a trace vt_term hasn't answered.
+ */
+class InputTrace {
+public:
+    void Begin(uint32_t seq, int64_t input_ns, int64_t now_ns) noexcept;
+    // Between Begin() and End(): spans are being measured
+    [[nodiscard]] bool Active() const noexcept { return active; }
+    void Enter(InputSpan span, int64_t now_ns) noexcept;
+    void Leave(InputSpan span, int64_t now_ns) noexcept;
+    void End(int64_t now_ns) noexcept;
+
+    /**
+     * @brief vt_term's half: when it read the frame, decoded the end
+     *  marker and flushed the result.  Returns the input to pixel time,
+     *  or -1 if seq isn't the trace waiting for an answer.
+     */
+    int64_t Complete(uint32_t seq, int64_t read_ns, int64_t decoded_ns,
+                     int64_t blitted_ns) noexcept;
+
+    [[nodiscard]] uint32_t Seq() const noexcept { return seq; }
+    [[nodiscard]] int64_t SpanNs(InputSpan span) const noexcept
+    {
+        return spans[static_cast<size_t>(span)].total;
+    }
+
+private:
+    struct Span {
+        int depth = 0;
+        int64_t entered = 0;
+        int64_t total = 0;
+    };
+
+    std::array<Span, INPUT_SPAN_COUNT> spans{};
+    uint32_t seq = 0;
+    int64_t input_ns = 0;
+    int64_t end_ns = 0;
+    bool active = false;
+    bool waiting = false;  // End() was called, Complete() wasn't
+};
+
+/**
+ * @brief Measures a span for the life of the object if a trace is active.
+ */
+class InputSpanScope {
+public:
+    InputSpanScope(InputTrace &trace, InputSpan span) noexcept;
+    ~InputSpanScope();
+
+    InputSpanScope(const InputSpanScope&) = delete;
+    InputSpanScope& operator=(const InputSpanScope&) = delete;
+
+private:
+    InputTrace *trace;
+    InputSpan span;
+};
+
+} // namespace vt
+
+#endif // VT_INPUT_TRACE_HH
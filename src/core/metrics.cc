@@ -0,0 +1,384 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * metrics.cc - Always-on latency histograms and counters
+ */
+
+#include "metrics.hh"
+#include "src/utils/vt_logger.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+
+void AppendSeconds(std::string &out, int64_t ns)
+{
+    std::array<char, 32> buffer{};
+    snprintf(buffer.data(), buffer.size(), "%.9g", static_cast<double>(ns) / 1e9);
+    out += buffer.data();
+}
+
+// name{labels,extra} or name{extra} or name
+void AppendSeries(std::string &out, std::string_view name, std::string_view suffix,
+                  std::string_view labels, std::string_view extra = {})
+{
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra.empty())
+    {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra.empty())
+            out += ',';
+        out += extra;
+        out += '}';
+    }
+    out += ' ';
+}
+
+// True if label is one of the comma separated pairs in labels
+bool HasLabel(std::string_view labels, std::string_view label)
+{
+    size_t pos = 0;
+    while ((pos = labels.find(label, pos)) != std::string_view::npos)
+    {
+        size_t end = pos + label.size();
+        if ((pos == 0 || labels[pos - 1] == ',') &&
+            (end == labels.size() || labels[end] == ','))
+            return true;
+        pos = end;
+    }
+    return false;
+}
+
+// Erases the entries of a series map whose labels include label
+template <typename Map>
+int EraseLabeled(Map &series, std::string_view label)
+{
+    int removed = 0;
+    for (auto it = series.begin(); it != series.end(); )
+    {
+        if (HasLabel(it->first, label))
+        {
+            it = series.erase(it);
+            ++removed;
+        }
+        else
+            ++it;
+    }
+    return removed;
+}
+
+} // namespace
+
+/**** LatencyHistogram ****/
+void LatencyHistogram::Record(int64_t ns) noexcept
+{
+    if (ns < 0)
+        ns = 0;
+    size_t i = 0;
+    while (i < BOUNDS_NS.size() && ns > BOUNDS_NS[i])
+        ++i;
+    buckets[i].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
+/**** MetricsRegistry ****/
+MetricsRegistry::Family &MetricsRegistry::GetFamily(std::string_view name, std::string_view help,
+                                                    bool histogram)
+{
+    auto it = families.find(name);
+    if (it == families.end())
+    {
+        it = families.emplace(std::string(name), Family{}).first;
+        it->second.help = help;
+        it->second.histogram = histogram;
+    }
+    return it->second;
+}
+
+LatencyHistogram &MetricsRegistry::Histogram(std::string_view name, std::string_view help,
+                                             std::string_view labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Family &family = GetFamily(name, help, true);
+    auto it = family.histograms.find(labels);
+    if (it == family.histograms.end())
+        it = family.histograms.emplace(std::string(labels), std::make_unique<LatencyHistogram>()).first;
+    return *it->second;
+}
+
+StatCounter &MetricsRegistry::Counter(std::string_view name, std::string_view help,
+                                      std::string_view labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Family &family = GetFamily(name, help, false);
+    auto it = family.counters.find(labels);
+    if (it == family.counters.end())
+        it = family.counters.emplace(std::string(labels), std::make_unique<StatCounter>()).first;
+    return *it->second;
+}
+
+int MetricsRegistry::Remove(std::string_view label)
+{
+    if (label.empty())
+        return 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    int removed = 0;
+    for (auto it = families.begin(); it != families.end(); )
+    {
+        Family &family = it->second;
+        removed += EraseLabeled(family.histograms, label) + EraseLabeled(family.counters, label);
+        if (family.histograms.empty() && family.counters.empty())
+            it = families.erase(it);
+        else
+            ++it;
+    }
+    return removed;
+}
+
+std::string MetricsRegistry::RenderPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    out.reserve(4096);
+
+    for (const auto& [name, family] : families)
+    {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += family.help;
+        out += "\n# TYPE ";
+        out += name;
+        out += family.histogram ? " histogram\n" : " counter\n";
+
+        for (const auto& [labels, counter] : family.counters)
+        {
+            AppendSeries(out, name, "", labels);
+            out += std::to_string(counter->Value());
+            out += '\n';
+        }
+
+        for (const auto& [labels, hist] : family.histograms)
+        {
+            // Buckets are cumulative in the exposition format
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i <= LatencyHistogram::BOUNDS_NS.size(); ++i)
+            {
+                cumulative += hist->Bucket(i);
+                std::string le = "le=\"";
+                if (i < LatencyHistogram::BOUNDS_NS.size())
+                    AppendSeconds(le, LatencyHistogram::BOUNDS_NS[i]);
+                else
+                    le += "+Inf";
+                le += '"';
+                AppendSeries(out, name, "_bucket", labels, le);
+                out += std::to_string(cumulative);
+                out += '\n';
+            }
+            AppendSeries(out, name, "_sum", labels);
+            AppendSeconds(out, hist->SumNs());
+            out += '\n';
+            AppendSeries(out, name, "_count", labels);
+            out += std::to_string(hist->Count());
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+int MetricsRegistry::Dump(const std::string &path) const
+{
+    std::string text = RenderPrometheus();
+    std::string temp = path + ".tmp";
+    FILE *fp = fopen(temp.c_str(), "w");
+    if (fp == nullptr)
+    {
+        vt::Logger::error("Metrics: can't write '{}': {}", temp, strerror(errno));
+        return 1;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), fp) == text.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0)
+    {
+        vt::Logger::error("Metrics: can't write '{}'", path);
+        unlink(temp.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+MetricsRegistry &Metrics()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::string MetricLabel(std::string_view key, std::string_view value)
+{
+    std::string out(key);
+    out += "=\"";
+    for (char c : value)
+    {
+        if (c == '\\' || c == '"')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (c == '\n')
+            out += "\\n";
+        else
+            out += c;
+    }
+    out += '"';
+    return out;
+}
+
+int64_t MetricsNowNs() noexcept
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+/**** MetricsServer ****/
+MetricsServer::~MetricsServer()
+{
+    Close();
+}
+
+int MetricsServer::Listen(const std::string &path)
+{
+    Close();
+
+    struct sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return 1;
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return 1;
+
+    unlink(path.c_str());  // stale socket from an earlier run
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, 4) < 0)
+    {
+        vt::Logger::error("Metrics: can't listen on '{}': {}", path, strerror(errno));
+        close(fd);
+        return 1;
+    }
+    chmod(path.c_str(), 0660);
+    listen_fd = fd;
+    socket_path = path;
+    return 0;
+}
+
+void MetricsServer::Close() noexcept
+{
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+        listen_fd = -1;
+    }
+    for (Client &client : clients)
+        close(client.fd);
+    clients.clear();
+}
+
+/****
+ * Send:  Writes what the client's socket will take without blocking.
+ *  Returns 1 when the whole snapshot is out, 0 if there is more to
+ *  send, -1 if the client went away.
+ ****/
+int MetricsServer::Send(Client &client)
+{
+    while (client.sent < client.text.size())
+    {
+        ssize_t n = send(client.fd, client.text.data() + client.sent,
+                         client.text.size() - client.sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        if (n <= 0)
+            return -1;
+        client.sent += static_cast<size_t>(n);
+    }
+    return 1;
+}
+
+int MetricsServer::Serve(const MetricsRegistry &registry)
+{
+    if (listen_fd < 0)
+        return 1;
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0)
+        return 1;
+    if (Pending() >= MAX_CLIENTS)
+    {
+        close(fd);
+        return 1;
+    }
+
+    // Never block the event loop on a slow reader; what doesn't fit in
+    // the socket buffer now is sent by Flush()
+    Client client{fd, registry.RenderPrometheus(), 0, MetricsNowNs() + CLIENT_TIMEOUT_NS};
+    int result = Send(client);
+    if (result == 0)
+    {
+        clients.push_back(std::move(client));
+        return 0;
+    }
+    close(fd);
+    return result > 0 ? 0 : 1;
+}
+
+int MetricsServer::Flush()
+{
+    int64_t now = MetricsNowNs();
+    for (auto it = clients.begin(); it != clients.end(); )
+    {
+        int result = Send(*it);
+        if (result == 0 && now < it->deadline_ns)
+        {
+            ++it;
+            continue;
+        }
+        if (result == 0)
+            vt::Logger::warn("Metrics: dropped a stats reader after {} of {} bytes",
+                             it->sent, it->text.size());
+        close(it->fd);
+        it = clients.erase(it);
+    }
+    return Pending();
+}
+
+} // namespace vt
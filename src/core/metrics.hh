@@ -0,0 +1,188 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * metrics.hh - Always-on latency histograms and counters
+ * Rendered in the Prometheus text format for the stats socket and dumps
+ */
+
+#ifndef VT_METRICS_HH
+#define VT_METRICS_HH
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief Fixed-bucket latency histogram.
+ *
+ * Recording is a handful of relaxed atomic adds so it is cheap enough to
+ * leave on around every event loop callback.
+ */
+class LatencyHistogram {
+public:
+    // Upper bounds in nanoseconds, 50us to 10s; anything slower is +Inf
+    static constexpr std::array<int64_t, 17> BOUNDS_NS = {
+        50'000, 100'000, 250'000, 500'000,
+        1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000,
+        100'000'000, 250'000'000, 500'000'000,
+        1'000'000'000, 2'500'000'000, 5'000'000'000, 10'000'000'000};
+
+    void Record(int64_t ns) noexcept;
+
+    [[nodiscard]] uint64_t Count() const noexcept { return count.load(std::memory_order_relaxed); }
+    [[nodiscard]] int64_t SumNs() const noexcept { return sum_ns.load(std::memory_order_relaxed); }
+    // Samples in bucket i alone (not cumulative); i == BOUNDS_NS.size() is +Inf
+    [[nodiscard]] uint64_t Bucket(size_t i) const noexcept
+    {
+        return buckets[i].load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BOUNDS_NS.size() + 1> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> sum_ns{0};
+};
+
+class StatCounter {
+public:
+    void Add(uint64_t n) noexcept { value.fetch_add(n, std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Value() const noexcept { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/**
+ * @brief Named histograms and counters, created on first use.
+ *
+ * Metrics are identified by name plus a label string as built by
+ * MetricLabel(), e.g. terminal="Bar 1".  The returned references stay
+ * valid until Remove() drops their series, so hot paths can look them up
+ * once.
+ */
+class MetricsRegistry {
+public:
+    LatencyHistogram &Histogram(std::string_view name, std::string_view help,
+                                std::string_view labels = {});
+    StatCounter &Counter(std::string_view name, std::string_view help,
+                         std::string_view labels = {});
+    // Drops every series with the label pair (one MetricLabel()) among its
+    // labels, and families left empty; returns how many series went
+    int Remove(std::string_view label);
+
+    // Text exposition format 0.0.4
+    [[nodiscard]] std::string RenderPrometheus() const;
+    // Writes RenderPrometheus() to path (via a temp file and rename)
+    int Dump(const std::string &path) const;
+
+private:
+    struct Family {
+        std::string help;
+        bool histogram = false;
+        std::map<std::string, std::unique_ptr<LatencyHistogram>, std::less<>> histograms;
+        std::map<std::string, std::unique_ptr<StatCounter>, std::less<>> counters;
+    };
+
+    Family &GetFamily(std::string_view name, std::string_view help, bool histogram);
+
+    mutable std::mutex mutex;
+    std::map<std::string, Family, std::less<>> families;
+};
+
+// The process-wide registry
+MetricsRegistry &Metrics();
+
+// key="value" with the value escaped for the exposition format
+std::string MetricLabel(std::string_view key, std::string_view value);
+
+// CLOCK_MONOTONIC in nanoseconds
+int64_t MetricsNowNs() noexcept;
+
+/**
+ * @brief Records the lifetime of the object into a histogram.
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram &h) noexcept
+        : histogram(h), start(MetricsNowNs()) {}
+    ~ScopedLatency() { histogram.Record(MetricsNowNs() - start); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram &histogram;
+    int64_t start;
+};
+
+/**
+ * @brief Serves RenderPrometheus() on a local UNIX stream socket.
+ *
+ * Each client that connects gets one snapshot and the connection is
+ * closed, so `socat - UNIX-CONNECT:<path>` or a textfile collector can
+ * scrape it.  Fd() is meant to be registered with the event loop and
+ * Serve() called when it is readable.  A snapshot bigger than the socket
+ * buffer is never cut short; the rest is held until Flush() gets it out,
+ * which the event loop calls on a timer while Pending() is nonzero.
+ */
+class MetricsServer {
+public:
+    MetricsServer() = default;
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    int Listen(const std::string &path);
+    void Close() noexcept;
+    [[nodiscard]] int Fd() const noexcept { return listen_fd; }
+    // Accepts one pending client and writes as much of the snapshot as
+    // its socket takes; whatever is left waits for Flush()
+    int Serve(const MetricsRegistry &registry);
+    // Writes more to the clients Serve() couldn't finish; returns how many are left
+    int Flush();
+    [[nodiscard]] int Pending() const noexcept { return static_cast<int>(clients.size()); }
+
+    static constexpr int MAX_CLIENTS = 8;
+    // A reader that takes longer than this for one snapshot is dropped
+    static constexpr int64_t CLIENT_TIMEOUT_NS = 10'000'000'000;
+
+private:
+    struct Client {
+        int fd = -1;
+        std::string text;
+        size_t sent = 0;
+        int64_t deadline_ns = 0;
+    };
+
+    static int Send(Client &client);
+
+    int listen_fd = -1;
+    std::string socket_path;
+    std::vector<Client> clients;
+};
+
+} // namespace vt
+
+#endif // VT_METRICS_HH
@@ -0,0 +1,696 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * print_spooler.cc - Persistent, per-printer ordered queues of print jobs
+ */
+
+#include "print_spooler.hh"
+#include "src/core/metrics.hh"
+#include "src/utils/vt_logger.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char *SPOOL_MAGIC = "VTSPOOL1";
+constexpr const char *SPOOL_EXT   = ".job";
+constexpr const char *FAILED_EXT  = ".failed";
+
+const char *KindName(PrintTarget::Kind kind)
+{
+    return kind == PrintTarget::Kind::Lpd ? "lpd" : "socket";
+}
+
+std::string ErrnoText(const char *what)
+{
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+// <dir>/<id, zero padded so names sort in submit order>.job
+std::string JobPath(const std::string &dir, uint64_t id)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llu%s", static_cast<unsigned long long>(id), SPOOL_EXT);
+    return dir + "/" + name;
+}
+
+// The same job's name with another extension: .job or .failed
+std::string RenamePath(const std::string &path, const char *ext)
+{
+    return std::filesystem::path(path).replace_extension(ext).string();
+}
+
+// "VTSPOOL1 <kind> <port> <host>\n" and then the job's bytes
+int WriteJobFile(const std::string &path, const PrintTarget &target, const std::string &data)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return 1;
+        out << SPOOL_MAGIC << ' ' << static_cast<int>(target.kind) << ' ' << target.port
+            << ' ' << target.host << '\n';
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out.flush())
+        {
+            out.close();
+            std::remove(tmp.c_str());
+            return 1;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int ReadJobFile(const std::string &path, PrintTarget &target, std::string &data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return 1;
+    const std::string file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t eol = file.find('\n');
+    if (eol == std::string::npos)
+        return 1;
+
+    std::istringstream header(file.substr(0, eol));
+    std::string magic;
+    int kind = -1;
+    if (!(header >> magic >> kind >> target.port))
+        return 1;
+    header.get();  // the space before the host
+    target.host.clear();
+    std::getline(header, target.host);
+    if (magic != SPOOL_MAGIC || kind < 0 || kind > static_cast<int>(PrintTarget::Kind::Lpd))
+        return 1;
+    target.kind = static_cast<PrintTarget::Kind>(kind);
+    data = file.substr(eol + 1);
+    return 0;
+}
+
+// Sends everything or fails; MSG_NOSIGNAL since a printer can hang up
+int SendAll(int fd, const std::string &data, std::string &error)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            error = ErrnoText("send");
+            return 1;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return 0;
+}
+
+// A kept connection the printer has closed reads as end of file; anything
+// it sent back (status bytes) is read and dropped
+bool ConnectionAlive(int fd)
+{
+    char buffer[256];
+    for (;;)
+    {
+        pollfd pfd{fd, POLLIN | POLLRDHUP, 0};
+        const int ready = poll(&pfd, 1, 0);
+        if (ready == 0)
+            return true;
+        if (ready < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLRDHUP | POLLNVAL)))
+            return false;
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n == 0)
+            return false;
+        if (n < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+int ConnectWithTimeout(const sockaddr_storage &addr, socklen_t len,
+                       std::chrono::milliseconds timeout, std::string &error)
+{
+    const int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        error = ErrnoText("socket");
+        return -1;
+    }
+    const int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    int result = connect(fd, reinterpret_cast<const sockaddr *>(&addr), len);
+    if (result < 0 && errno == EINPROGRESS)
+    {
+        pollfd pfd{fd, POLLOUT, 0};
+        result = poll(&pfd, 1, static_cast<int>(timeout.count()));
+        if (result == 0)
+        {
+            errno = ETIMEDOUT;
+            result = -1;
+        }
+        else if (result > 0)
+        {
+            int so_error = 0;
+            socklen_t so_len = sizeof(so_error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &so_len);
+            errno = so_error;
+            result = (so_error == 0) ? 0 : -1;
+        }
+    }
+    if (result < 0)
+    {
+        error = ErrnoText("connect");
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, flags);
+    return fd;
+}
+
+} // namespace
+
+std::string PrintTarget::Key() const
+{
+    if (kind == Kind::Lpd)
+        return std::string("lpd:") + host;
+    return "socket:" + host + ":" + std::to_string(port);
+}
+
+struct PrintSpooler::Job {
+    uint64_t          id = 0;
+    std::string       data;
+    std::string       path;  // spool file, or empty
+    Clock::time_point queued;
+};
+
+struct PrintSpooler::Queue {
+    PrintTarget             target;
+    std::deque<Job>         jobs;      // guarded by PrintSpooler::mutex
+    std::deque<Job>         held;      // likewise; given up on, not yet requeued
+    PrintQueueStats         stats;     // likewise
+    std::chrono::milliseconds coalesce{0};  // likewise
+    std::condition_variable cv;
+    std::thread             worker;
+
+    // Only the worker touches these
+    int fd = -1;
+    std::vector<std::pair<sockaddr_storage, socklen_t>> addrs;
+    Clock::time_point resolved_at;
+    uint64_t connects = 0;
+
+    void Disconnect()
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
+    int Resolve(const Options &options, std::string &error)
+    {
+        if (!addrs.empty() && Clock::now() - resolved_at < options.resolve_ttl)
+            return 0;
+        addrs.clear();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        const std::string port = std::to_string(target.port);
+        const int rc = getaddrinfo(target.host.c_str(), port.c_str(), &hints, &found);
+        if (rc != 0)
+        {
+            error = std::string("resolve: ") + gai_strerror(rc);
+            return 1;
+        }
+        for (addrinfo *ai = found; ai != nullptr; ai = ai->ai_next)
+        {
+            sockaddr_storage addr{};
+            std::memcpy(&addr, ai->ai_addr, ai->ai_addrlen);
+            addrs.emplace_back(addr, ai->ai_addrlen);
+        }
+        freeaddrinfo(found);
+        resolved_at = Clock::now();
+        return addrs.empty() ? 1 : 0;
+    }
+
+    int Connect(const Options &options, std::string &error)
+    {
+        if (Resolve(options, error))
+            return 1;
+        for (const auto &[addr, len] : addrs)
+        {
+            fd = ConnectWithTimeout(addr, len, options.connect_timeout, error);
+            if (fd < 0)
+                continue;
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+#ifdef TCP_KEEPIDLE
+            int idle = 30;
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+#endif
+            timeval tv{};
+            tv.tv_sec  = static_cast<time_t>(options.send_timeout.count() / 1000);
+            tv.tv_usec = static_cast<suseconds_t>((options.send_timeout.count() % 1000) * 1000);
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            ++connects;
+            return 0;
+        }
+        // the address may have moved; look it up again next time
+        addrs.clear();
+        return 1;
+    }
+
+    int SendSocket(const Options &options, const std::string &data, std::string &error)
+    {
+        const bool reused = (fd >= 0);
+        if (reused && !ConnectionAlive(fd))
+            Disconnect();
+        if (fd < 0 && Connect(options, error))
+            return 1;
+        if (SendAll(fd, data, error) == 0)
+            return 0;
+        Disconnect();
+        if (!reused)
+        {
+            addrs.clear();
+            return 1;
+        }
+        // a kept connection can die unnoticed; one fresh try before
+        // counting it as a failure
+        if (Connect(options, error) || SendAll(fd, data, error))
+        {
+            Disconnect();
+            addrs.clear();
+            return 1;
+        }
+        return 0;
+    }
+
+    int SendLpd(const std::string &data, std::string &error) const
+    {
+        const std::string command = "/usr/bin/lpr -P" + target.host;
+        FILE *pipe = popen(command.c_str(), "w");
+        if (pipe == nullptr)
+        {
+            error = ErrnoText("popen lpr");
+            return 1;
+        }
+        const size_t written = fwrite(data.data(), 1, data.size(), pipe);
+        const int status = pclose(pipe);
+        if (written != data.size() || status == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            error = "lpr failed (status " + std::to_string(status) + ")";
+            return 1;
+        }
+        return 0;
+    }
+
+    int Send(const Options &options, const std::string &data, std::string &error)
+    {
+        if (target.kind == PrintTarget::Kind::Lpd)
+            return SendLpd(data, error);
+        return SendSocket(options, data, error);
+    }
+};
+
+PrintSpooler::PrintSpooler()
+    : PrintSpooler(Options{})
+{
+}
+
+PrintSpooler::PrintSpooler(Options opts)
+    : options(opts)
+{
+}
+
+PrintSpooler::~PrintSpooler()
+{
+    Shutdown();
+}
+
+PrintSpooler &PrintSpooler::Instance()
+{
+    static PrintSpooler *spooler = new PrintSpooler();
+    return *spooler;
+}
+
+int PrintSpooler::Open(const std::string &dir)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (!fs::is_directory(dir, ec))
+    {
+        vt::Logger::error("PrintSpooler: can't create spool directory '{}'", dir);
+        return -1;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> found;
+    for (const fs::directory_entry &entry : fs::directory_iterator(dir, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if (entry.path().extension() != SPOOL_EXT && entry.path().extension() != FAILED_EXT)
+        {
+            if (name.ends_with(".tmp"))
+                fs::remove(entry.path(), ec);  // a write cut short
+            continue;
+        }
+        const uint64_t id = std::strtoull(name.c_str(), nullptr, 10);
+        if (id > 0)
+            found.emplace_back(id, entry.path().string());
+    }
+    std::sort(found.begin(), found.end());
+
+    int requeued = 0;
+    int held = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    spool_dir = dir;
+    for (const auto &[id, path] : found)
+    {
+        next_id = std::max(next_id, id + 1);
+        Job job;
+        PrintTarget target;
+        if (ReadJobFile(path, target, job.data))
+        {
+            vt::Logger::error("PrintSpooler: dropping unreadable spool file '{}'", path);
+            fs::remove(path, ec);
+            continue;
+        }
+        job.id = id;
+        job.path = path;
+        job.queued = Clock::now();
+        if (path.ends_with(FAILED_EXT))
+        {
+            Queue &queue = GetQueue(target);
+            queue.held.push_back(std::move(job));
+            queue.stats.failed += 1;
+            ++held;
+            continue;
+        }
+        Enqueue(GetQueue(target), std::move(job));
+        ++requeued;
+    }
+    if (requeued > 0)
+        vt::Logger::info("PrintSpooler: {} unsent print jobs queued again from '{}'", requeued, dir);
+    if (held > 0)
+        vt::Logger::warn("PrintSpooler: {} failed print jobs held in '{}'", held, dir);
+    return requeued;
+}
+
+uint64_t PrintSpooler::Submit(const PrintTarget &target, std::string data)
+{
+    Job job;
+    std::string dir;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping)
+            return 0;
+        job.id = next_id++;
+        dir = spool_dir;
+    }
+    job.data = std::move(data);
+    job.queued = Clock::now();
+
+    // the file is written unlocked so other submits and the workers don't
+    // wait on the disk
+    if (!dir.empty())
+    {
+        job.path = JobPath(dir, job.id);
+        if (WriteJobFile(job.path, target, job.data))
+        {
+            vt::Logger::error("PrintSpooler: can't spool job {} to '{}', printing it unspooled",
+                              job.id, job.path);
+            job.path.clear();
+        }
+    }
+
+    const uint64_t id = job.id;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopping)
+    {
+        // Shutdown() came in meanwhile; a spooled job waits for the next Open()
+        return job.path.empty() ? 0 : id;
+    }
+    Enqueue(GetQueue(target), std::move(job));
+    return id;
+}
+
+void PrintSpooler::SetCoalesce(const PrintTarget &target, std::chrono::milliseconds window)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    GetQueue(target).coalesce = std::max(window, std::chrono::milliseconds::zero());
+}
+
+int PrintSpooler::RequeueFailed(const PrintTarget &target)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = queues.find(target.Key());
+    if (it == queues.end() || stopping)
+        return 0;
+    Queue &queue = *it->second;
+    int requeued = 0;
+    while (!queue.held.empty())
+    {
+        Job job = std::move(queue.held.front());
+        queue.held.pop_front();
+        if (!job.path.empty())
+        {
+            const std::string path = RenamePath(job.path, SPOOL_EXT);
+            if (std::rename(job.path.c_str(), path.c_str()) == 0)
+                job.path = path;
+        }
+        job.queued = Clock::now();
+        Enqueue(queue, std::move(job));
+        ++requeued;
+    }
+    if (requeued > 0)
+        vt::Logger::info("PrintSpooler: {} failed jobs for {} queued again", requeued, it->first);
+    return requeued;
+}
+
+PrintQueueStats PrintSpooler::Stats(const PrintTarget &target) const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = queues.find(target.Key());
+    if (it == queues.end())
+        return {};
+    PrintQueueStats stats = it->second->stats;
+    stats.depth = it->second->jobs.size();
+    stats.held = it->second->held.size();
+    return stats;
+}
+
+bool PrintSpooler::WaitIdle(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return idle_cv.wait_for(lock, timeout, [this]() {
+        return std::all_of(queues.begin(), queues.end(),
+                           [](const auto &entry) { return entry.second->jobs.empty(); });
+    });
+}
+
+void PrintSpooler::Shutdown()
+{
+    std::vector<std::thread> workers;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        for (auto &[key, queue] : queues)
+        {
+            queue->cv.notify_all();
+            if (queue->worker.joinable())
+                workers.push_back(std::move(queue->worker));
+        }
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+// With mutex held
+PrintSpooler::Queue &PrintSpooler::GetQueue(const PrintTarget &target)
+{
+    std::unique_ptr<Queue> &queue = queues[target.Key()];
+    if (queue == nullptr)
+    {
+        queue = std::make_unique<Queue>();
+        queue->target = target;
+    }
+    return *queue;
+}
+
+// With mutex held
+void PrintSpooler::Enqueue(Queue &queue, Job job)
+{
+    queue.jobs.push_back(std::move(job));
+    if (!queue.worker.joinable() && !stopping)
+        queue.worker = std::thread(&PrintSpooler::Work, this, std::ref(queue));
+    queue.cv.notify_one();
+}
+
+void PrintSpooler::Work(Queue &queue)
+{
+    LatencyHistogram &latency = Metrics().Histogram(
+        "vt_print_job_seconds", "Time from a print job's submit to its delivery",
+        MetricLabel("kind", KindName(queue.target.kind)));
+    static StatCounter &retries = Metrics().Counter(
+        "vt_print_job_retries_total", "Print job sends that failed and were retried");
+    static StatCounter &dropped = Metrics().Counter(
+        "vt_print_jobs_failed_total", "Print jobs given up on after every retry failed");
+    static StatCounter &connections = Metrics().Counter(
+        "vt_print_connections_total", "Connections opened to socket printers");
+    static StatCounter &transmissions = Metrics().Counter(
+        "vt_print_transmissions_total", "Sends to a printer that got through, each one or more jobs");
+
+    const std::string key = queue.target.Key();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        if (queue.jobs.empty())
+        {
+            idle_cv.notify_all();
+            auto wake = [this, &queue]() { return stopping || !queue.jobs.empty(); };
+            if (queue.fd >= 0)
+            {
+                if (!queue.cv.wait_for(lock, options.idle_close, wake))
+                    queue.Disconnect();
+            }
+            else
+                queue.cv.wait(lock, wake);
+            continue;
+        }
+
+        // A fresh job waits out the coalescing window for others to join
+        // it; one being retried has waited already
+        if (queue.coalesce.count() > 0 && queue.stats.attempts == 0)
+        {
+            queue.cv.wait_until(lock, queue.jobs.front().queued + queue.coalesce, [this, &queue]() {
+                return stopping || queue.jobs.size() >= options.coalesce_max_jobs;
+            });
+            if (stopping)
+                break;
+        }
+
+        // Only this thread pops, and deque::push_back() leaves references to
+        // the jobs already queued valid, so the batch stays put while unlocked
+        const size_t count = (queue.coalesce.count() > 0)
+            ? std::min(queue.jobs.size(), std::max<size_t>(options.coalesce_max_jobs, 1)) : 1;
+        const Job &job = queue.jobs.front();
+        std::vector<const std::string *> batch;
+        for (size_t i = 0; i < count; ++i)
+            batch.push_back(&queue.jobs[i].data);
+        lock.unlock();
+        std::string joined;
+        if (count > 1)
+        {
+            for (const std::string *data : batch)
+                joined += *data;
+        }
+        std::string error;
+        const uint64_t connects = queue.connects;
+        const int failed = queue.Send(options, count > 1 ? joined : job.data, error);
+        connections.Add(queue.connects - connects);
+        lock.lock();
+        queue.stats.connections = queue.connects;
+
+        if (failed == 0)
+        {
+            const Clock::time_point now = Clock::now();
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Job &sent = queue.jobs.front();
+                const auto waited = now - sent.queued;
+                const int64_t waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(waited).count();
+                latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+                queue.stats.last_latency_ms = waited_ms;
+                queue.stats.total_latency_ms += waited_ms;
+                if (!sent.path.empty())
+                    std::remove(sent.path.c_str());
+                queue.jobs.pop_front();
+            }
+            transmissions.Add(1);
+            queue.stats.transmissions += 1;
+            queue.stats.printed += count;
+            queue.stats.attempts = 0;
+            queue.stats.last_error.clear();
+            continue;
+        }
+
+        queue.stats.attempts += 1;
+        queue.stats.last_error = error;
+        if (queue.stats.attempts >= options.max_attempts)
+        {
+            vt::Logger::error("PrintSpooler: holding {} job(s) from {} for {} after {} tries: {}",
+                              count, job.id, key, queue.stats.attempts, error);
+            dropped.Add(count);
+            queue.stats.failed += count;
+            queue.stats.attempts = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                Job failed_job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                if (!failed_job.path.empty())
+                {
+                    const std::string path = RenamePath(failed_job.path, FAILED_EXT);
+                    if (std::rename(failed_job.path.c_str(), path.c_str()) == 0)
+                        failed_job.path = path;
+                }
+                queue.held.push_back(std::move(failed_job));
+            }
+            continue;
+        }
+
+        retries.Add(1);
+        auto delay = options.retry_base;
+        for (int i = 1; i < queue.stats.attempts && delay < options.retry_max; ++i)
+            delay *= 2;
+        delay = std::min(delay, options.retry_max);
+        vt::Logger::warn("PrintSpooler: job {} for {} failed ({}), retry {} in {} ms",
+                         job.id, key, error, queue.stats.attempts, delay.count());
+        queue.cv.wait_for(lock, delay, [this]() { return stopping; });
+    }
+    queue.Disconnect();
+    idle_cv.notify_all();
+}
+
+} // namespace vt
@@ -0,0 +1,150 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * print_spooler.hh - Persistent, per-printer ordered queues of print jobs
+ * Printer::Close() hands socket and lpd jobs here instead of sending them
+ */
+
+#ifndef VT_PRINT_SPOOLER_HH
+#define VT_PRINT_SPOOLER_HH
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace vt {
+
+/**
+ * @brief Where a job goes: a raw TCP printer, or an lpd queue name.
+ */
+struct PrintTarget {
+    enum class Kind : uint8_t {
+        Socket = 0,
+        Lpd    = 1
+    };
+
+    Kind        kind = Kind::Socket;
+    std::string host;  // host name or address, or the lpd queue
+    int         port = 0;
+
+    // "socket:host:port" or "lpd:queue"; jobs with the same key print in order
+    [[nodiscard]] std::string Key() const;
+};
+
+struct PrintQueueStats {
+    size_t      depth = 0;             // jobs waiting, including one being sent
+    uint64_t    printed = 0;
+    uint64_t    failed = 0;            // jobs given up on after max_attempts
+    size_t      held = 0;              // of those, kept until RequeueFailed()
+    int         attempts = 0;          // failed tries of the job at the head
+    int64_t     last_latency_ms = -1;  // submit to delivered, for the last job
+    int64_t     total_latency_ms = 0;  // the same, summed over every job printed
+    uint64_t    connections = 0;       // socket connections opened
+    uint64_t    transmissions = 0;     // sends that got through, batched or not
+    std::string last_error;            // cleared when a job gets through
+};
+
+/**
+ * @brief Print jobs queued per target, each queue sent in order by its own
+ *  worker thread.
+ *
+ * A socket queue keeps its connection open between jobs (with TCP
+ * keepalive), closing it after idle_close or on any error, and caches the
+ * printer's resolved address for resolve_ttl.  A job that fails is retried
+ * with doubling waits from retry_base up to retry_max; the queue behind it
+ * waits too, so a printer never gets its jobs out of order.
+ *
+ * A queue given a coalescing window holds its first job for that long and
+ * then sends it together with whatever arrived meanwhile (up to
+ * coalesce_max_jobs) as one transmission.  Jobs are joined as they are;
+ * each ticket already ends with its own cut.
+ *
+ * Once Open() has a spool directory each job is written there before
+ * Submit() returns and removed once delivered, so jobs a shutdown or crash
+ * left behind are queued again by the next Open().  A job delivered just
+ * before a crash may therefore print twice; one is never lost.
+ *
+ * A job still failing after max_attempts (about 20 minutes with the
+ * defaults) stops holding up the queue but isn't thrown away: it is held,
+ * its spool file renamed to <id>.failed so it outlasts a restart too, until
+ * RequeueFailed() queues it again.
+ */
+class PrintSpooler {
+public:
+    struct Options {
+        std::chrono::milliseconds retry_base{500};
+        std::chrono::milliseconds retry_max{30000};
+        int max_attempts = 40;
+        std::chrono::seconds resolve_ttl{300};
+        std::chrono::seconds idle_close{5};
+        std::chrono::milliseconds connect_timeout{3000};
+        std::chrono::milliseconds send_timeout{10000};
+        size_t coalesce_max_jobs = 16;
+    };
+
+    PrintSpooler();
+    explicit PrintSpooler(Options options);
+    ~PrintSpooler();
+
+    PrintSpooler(const PrintSpooler&) = delete;
+    PrintSpooler& operator=(const PrintSpooler&) = delete;
+
+    // The one Printer::Close() uses.  It is never destroyed, so a forked
+    // child's exit() can't wait on workers that only exist in the parent;
+    // EndSystem() calls Shutdown() instead
+    static PrintSpooler &Instance();
+
+    // Spools jobs to dir from now on, queues any left there and holds any
+    // .failed ones; returns the number queued again, or -1 if dir can't be
+    // created
+    int Open(const std::string &dir);
+    // Returns the job's id, or 0 once Shutdown() has been called
+    uint64_t Submit(const PrintTarget &target, std::string data);
+    // Jobs for target arriving within window of the first are sent as one;
+    // zero (the default) sends each job as soon as it's queued
+    void SetCoalesce(const PrintTarget &target, std::chrono::milliseconds window);
+    // Queues target's held jobs again, behind any waiting; returns how many
+    int RequeueFailed(const PrintTarget &target);
+    [[nodiscard]] PrintQueueStats Stats(const PrintTarget &target) const;
+    // Waits for every queue to empty; false on timeout
+    bool WaitIdle(std::chrono::milliseconds timeout);
+    // Stops the workers; jobs not yet sent stay in the spool directory
+    void Shutdown();
+
+private:
+    struct Job;
+    struct Queue;
+
+    Queue &GetQueue(const PrintTarget &target);
+    void Enqueue(Queue &queue, Job job);
+    void Work(Queue &queue);
+
+    Options options;
+    mutable std::mutex mutex;
+    std::condition_variable idle_cv;
+    std::map<std::string, std::unique_ptr<Queue>> queues;
+    std::string spool_dir;
+    uint64_t next_id = 1;
+    bool stopping = false;
+};
+
+} // namespace vt
+
+#endif // VT_PRINT_SPOOLER_HH
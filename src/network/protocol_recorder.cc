@@ -0,0 +1,372 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * protocol_recorder.cc - Records and decodes terminal protocol traffic
+ */
+
+#include "protocol_recorder.hh"
+#include "remote_link.hh"
+#include "src/utils/vt_logger.hh"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+
+int64_t MonotonicNs() noexcept
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void PutLE(uint8_t* out, uint64_t value, int bytes) noexcept
+{
+    for (int i = 0; i < bytes; ++i)
+        out[i] = static_cast<uint8_t>((value >> (8 * i)) & 255);
+}
+
+uint64_t GetLE(const uint8_t* in, int bytes) noexcept
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// CharQueue type tags (see remote_link.cc)
+constexpr uint8_t TYPE_INT8   = 1;
+constexpr uint8_t TYPE_INT16  = 2;
+constexpr uint8_t TYPE_INT32  = 3;
+constexpr uint8_t TYPE_LONG   = 4;
+constexpr uint8_t TYPE_LLONG  = 5;
+constexpr uint8_t TYPE_STRING = 6;
+
+// Argument signatures read by SocketInputCB() for each command:
+// '1' = I1, '2' = I2, '4' = I4, 's' = string, 'T' = translation table.
+// nullptr marks commands whose payload isn't self-delimiting.
+// Keep in sync with term_view.cc when the protocol changes.
+constexpr std::array<const char*, 256> MakeSignatures()
+{
+    std::array<const char*, 256> sig{};
+    using namespace TerminalProtocol;
+    sig[UPDATEALL]       = "";
+    sig[UPDATEAREA]      = "2222";
+    sig[SETCLIP]         = "2222";
+    sig[BLANKPAGE]       = "111121ss";
+    sig[BACKGROUND]      = "";
+    sig[TITLEBAR]        = "s";
+    sig[ZONE]            = "2222111";
+    sig[TEXTL]           = "s22112";
+    sig[TEXTC]           = "s22112";
+    sig[TEXTR]           = "s22112";
+    sig[ZONETEXTL]       = "s222211";
+    sig[ZONETEXTC]       = "s222211";
+    sig[ZONETEXTR]       = "s222211";
+    sig[SHADOW]          = "222211";
+    sig[RECTANGLE]       = "22221";
+    sig[HLINE]           = "22211";
+    sig[VLINE]           = "22211";
+    sig[FRAME]           = "222211";
+    sig[FILLEDFRAME]     = "2222111";
+    sig[STATUSBAR]       = "22221s11";
+    sig[EDITCURSOR]      = "2222";
+    sig[CURSOR]          = "2";
+    sig[SOLID_RECTANGLE] = "22222";
+    sig[PIXMAP]          = "2222s";
+    sig[FLUSH]           = "";
+    sig[FLUSH_TS]        = "";
+    sig[CALIBRATE_TS]    = "";
+    sig[USERINPUT]       = "";
+    sig[BLANKSCREEN]     = "";
+    sig[SETMESSAGE]      = "s";
+    sig[CLEARMESSAGE]    = "";
+    sig[BLANKTIME]       = "2";
+    sig[STORENAME]       = "s";
+    sig[SELECTOFF]       = "";
+    sig[SELECTUPDATE]    = "22";
+    sig[NEWWINDOW]       = "222221s";
+    sig[SHOWWINDOW]      = "2";
+    sig[KILLWINDOW]      = "2";
+    sig[TARGETWINDOW]    = "2";
+    sig[PUSHBUTTON]      = "22222s111";
+    sig[ICONIFY]         = "";
+    sig[BELL]            = "2";
+    sig[DIE]             = "";
+    sig[TRANSLATIONS]    = "T";
+    sig[CONNTIMEOUT]     = "2";
+    sig[SET_ICONIFY]     = "1";
+    sig[SET_EMBOSSED]    = "1";
+    sig[SET_ANTIALIAS]   = "1";
+    sig[SET_DROP_SHADOW] = "1";
+    sig[SET_SHADOW_OFFSET] = "22";
+    sig[SET_SHADOW_BLUR] = "1";
+    sig[0xA5]            = "";  // TERM_RELOAD_FONTS
+    return sig;
+}
+
+constexpr auto SIGNATURES = MakeSignatures();
+
+// Walks CharQueue's typed encoding without decoding values
+class FrameCursor {
+public:
+    FrameCursor(const uint8_t* d, int l) noexcept : data(d), len(l) {}
+
+    [[nodiscard]] int Pos() const noexcept { return pos; }
+    [[nodiscard]] bool AtEnd() const noexcept { return pos >= len; }
+
+    // Returns the value of an I1 or -1 if the next value isn't one
+    int Int8() noexcept
+    {
+        if (pos + 2 > len || data[pos] != TYPE_INT8)
+            return -1;
+        int v = data[pos + 1];
+        pos += 2;
+        return v;
+    }
+
+    // Skips one value; returns its type tag or -1 if the frame is short
+    int Skip() noexcept
+    {
+        if (pos >= len)
+            return -1;
+        int type = data[pos];
+        int need = 0;
+        switch (type)
+        {
+        case TYPE_INT8:  need = 1; break;
+        case TYPE_INT16: need = 2; break;
+        case TYPE_INT32: need = 4; break;
+        case TYPE_LONG:  need = 8; break;
+        case TYPE_LLONG: need = 8; break;
+        case TYPE_STRING:
+            // the length is itself an I2
+            if (pos + 4 > len || data[pos + 1] != TYPE_INT16)
+                return -1;
+            need = 3 + static_cast<int>(GetLE(data + pos + 2, 2));
+            break;
+        default:
+            return -1;
+        }
+        if (pos + 1 + need > len)
+            return -1;
+        pos += 1 + need;
+        return type;
+    }
+
+private:
+    const uint8_t* data;
+    int len;
+    int pos = 0;
+};
+
+int ExpectedType(char c) noexcept
+{
+    switch (c)
+    {
+    case '1': return TYPE_INT8;
+    case '2': return TYPE_INT16;
+    case '4': return TYPE_INT32;
+    case 's': return TYPE_STRING;
+    default:  return -1;
+    }
+}
+
+} // namespace
+
+/**** ProtocolRecorder ****/
+ProtocolRecorder::~ProtocolRecorder()
+{
+    Close();
+}
+
+int ProtocolRecorder::Open(const std::string &path)
+{
+    Close();
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        vt::Logger::error("ProtocolRecorder: can't open '{}': {}", path, strerror(errno));
+        return 1;
+    }
+    if (fwrite(MAGIC.data(), 1, MAGIC.size(), file) != MAGIC.size())
+    {
+        Close();
+        return 1;
+    }
+    fflush(file);
+    start_ns = MonotonicNs();
+    frames = 0;
+    bytes = 0;
+    return 0;
+}
+
+void ProtocolRecorder::Close() noexcept
+{
+    if (file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+int ProtocolRecorder::Record(RecordDirection direction, const uint8_t* data, int len)
+{
+    if (file == nullptr || data == nullptr || len <= 0)
+        return 1;
+
+    std::array<uint8_t, FRAME_HEADER_SIZE> header{};
+    header[0] = static_cast<uint8_t>(direction);
+    PutLE(header.data() + 4, static_cast<uint64_t>(len), 4);
+    PutLE(header.data() + 8, static_cast<uint64_t>(MonotonicNs() - start_ns), 8);
+
+    if (fwrite(header.data(), 1, header.size(), file) != header.size() ||
+        fwrite(data, 1, static_cast<size_t>(len), file) != static_cast<size_t>(len))
+    {
+        vt::Logger::error("ProtocolRecorder: write failed, recording stopped");
+        Close();
+        return 1;
+    }
+    fflush(file);
+    ++frames;
+    bytes += len;
+    return 0;
+}
+
+std::shared_ptr<ProtocolRecorder> ProtocolRecorder::FromEnvironment()
+{
+    const char* env = getenv("VT_PROTOCOL_RECORD");
+    if (env == nullptr || env[0] == '\0')
+        return nullptr;
+
+    std::string path = env;
+    auto p = path.find("%p");
+    if (p != std::string::npos)
+        path.replace(p, 2, std::to_string(getpid()));
+
+    auto recorder = std::make_shared<ProtocolRecorder>();
+    if (recorder->Open(path))
+        return nullptr;
+    vt::Logger::info("Recording terminal protocol to {}", path);
+    return recorder;
+}
+
+/**** ProtocolReader ****/
+ProtocolReader::~ProtocolReader()
+{
+    Close();
+}
+
+int ProtocolReader::Open(const std::string &path)
+{
+    Close();
+    file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return 1;
+
+    std::array<char, 8> magic{};
+    if (fread(magic.data(), 1, magic.size(), file) != magic.size() ||
+        magic != ProtocolRecorder::MAGIC)
+    {
+        Close();
+        return 1;
+    }
+    return 0;
+}
+
+void ProtocolReader::Close() noexcept
+{
+    if (file)
+    {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool ProtocolReader::Next(RecordedFrame &frame)
+{
+    if (file == nullptr)
+        return false;
+
+    std::array<uint8_t, ProtocolRecorder::FRAME_HEADER_SIZE> header{};
+    if (fread(header.data(), 1, header.size(), file) != header.size())
+        return false;
+
+    auto len = static_cast<size_t>(GetLE(header.data() + 4, 4));
+    if (len > QUEUE_SIZE)
+        return false;
+    frame.direction = header[0] ? RecordDirection::ToServer : RecordDirection::ToTerminal;
+    frame.timestamp_ns = static_cast<int64_t>(GetLE(header.data() + 8, 8));
+    frame.payload.resize(len);
+    return fread(frame.payload.data(), 1, len, file) == len;
+}
+
+/**** Decoder ****/
+int DecodeTermFrame(const uint8_t* data, int len, TermDecodeStats &stats)
+{
+    FrameCursor cursor(data, len);
+    int decoded = 0;
+
+    ++stats.frames;
+    stats.bytes += len;
+    while (!cursor.AtEnd())
+    {
+        int start = cursor.Pos();
+        int code = cursor.Int8();
+        const char* sig = (code >= 0) ? SIGNATURES[code] : nullptr;
+        if (sig == nullptr)
+        {
+            stats.undecoded_bytes += len - start;
+            break;
+        }
+
+        bool ok = true;
+        if (sig[0] == 'T')
+        {
+            int count = cursor.Int8();
+            for (int i = 0; ok && i < count * 2; ++i)
+                ok = cursor.Skip() == TYPE_STRING;
+            ok = ok && count >= 0;
+        }
+        else
+        {
+            for (const char* c = sig; ok && *c; ++c)
+            {
+                int type = cursor.Skip();
+                if (type < 0)
+                    ok = false;
+                else if (type != ExpectedType(*c))
+                    ++stats.type_errors;
+            }
+        }
+        if (!ok)
+        {
+            stats.undecoded_bytes += len - start;
+            break;
+        }
+
+        ++stats.per_code[code];
+        ++stats.commands;
+        ++decoded;
+    }
+    return decoded;
+}
+
+} // namespace vt
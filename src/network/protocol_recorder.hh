@@ -0,0 +1,125 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * protocol_recorder.hh - Records and decodes terminal protocol traffic
+ * Used by vt_term (VT_PROTOCOL_RECORD) and the vt_replay benchmark
+ */
+
+#ifndef VT_PROTOCOL_RECORDER_HH
+#define VT_PROTOCOL_RECORDER_HH
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+// Which way a frame travelled, independent of which side recorded it
+enum class RecordDirection : uint8_t {
+    ToTerminal = 0,
+    ToServer   = 1
+};
+
+struct RecordedFrame {
+    RecordDirection direction = RecordDirection::ToTerminal;
+    int64_t timestamp_ns = 0;      // since the recording was opened
+    std::vector<uint8_t> payload;  // frame contents without the size header
+};
+
+/**
+ * @brief Tees CharQueue frames to a file with monotonic timestamps.
+ *
+ * File layout: 8 byte magic, then per frame a 16 byte little-endian
+ * header <I1 direction, 3 pad, I4 size, I8 timestamp_ns> and the payload.
+ * Every frame is flushed so a killed terminal still leaves a usable file.
+ */
+class ProtocolRecorder {
+public:
+    static constexpr std::array<char, 8> MAGIC = {'V', 'T', 'R', 'E', 'C', '0', '0', '1'};
+    static constexpr int FRAME_HEADER_SIZE = 16;
+
+    ProtocolRecorder() = default;
+    ~ProtocolRecorder();
+    ProtocolRecorder(const ProtocolRecorder&) = delete;
+    ProtocolRecorder& operator=(const ProtocolRecorder&) = delete;
+
+    int Open(const std::string &path);
+    void Close() noexcept;
+    [[nodiscard]] bool IsOpen() const noexcept { return file != nullptr; }
+
+    int Record(RecordDirection direction, const uint8_t* data, int len);
+
+    [[nodiscard]] long Frames() const noexcept { return frames; }
+    [[nodiscard]] long long Bytes() const noexcept { return bytes; }
+
+    // Opens the file named by VT_PROTOCOL_RECORD ("%p" becomes the pid);
+    // returns nullptr when the variable is unset or the file can't be opened
+    static std::shared_ptr<ProtocolRecorder> FromEnvironment();
+
+private:
+    FILE *file = nullptr;
+    int64_t start_ns = 0;
+    long frames = 0;
+    long long bytes = 0;
+};
+
+/**
+ * @brief Reads frames back from a ProtocolRecorder file.
+ */
+class ProtocolReader {
+public:
+    ProtocolReader() = default;
+    ~ProtocolReader();
+    ProtocolReader(const ProtocolReader&) = delete;
+    ProtocolReader& operator=(const ProtocolReader&) = delete;
+
+    int Open(const std::string &path);
+    void Close() noexcept;
+    // Returns false at end of file or on a truncated frame
+    bool Next(RecordedFrame &frame);
+
+private:
+    FILE *file = nullptr;
+};
+
+/**
+ * @brief Counters collected while walking server-to-terminal frames.
+ */
+struct TermDecodeStats {
+    long frames = 0;
+    long commands = 0;
+    long long bytes = 0;
+    long long undecoded_bytes = 0;   // frame tails after an unknown command
+    long type_errors = 0;            // argument type tags that didn't match
+    std::array<long, 256> per_code{};
+};
+
+/**
+ * @brief Walks one server-to-terminal frame the way SocketInputCB() does,
+ * without drawing, and adds what it found to stats.
+ *
+ * Commands with dialog or credit card payloads (EDITPAGE, LIST*, CC_*)
+ * aren't self-delimiting; decoding stops there and the rest of the frame
+ * is counted in undecoded_bytes.  Returns the number of commands decoded.
+ */
+int DecodeTermFrame(const uint8_t* data, int len, TermDecodeStats &stats);
+
+} // namespace vt
+
+#endif // VT_PROTOCOL_RECORDER_HH
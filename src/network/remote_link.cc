@@ -82,6 +82,7 @@ int CharQueue::Send8(int val)
         if (reported == 0)
             fprintf(stderr, "CharQueue::Put8() failed! - buffer full\n");
         reported = 1;
+        overflow = true;
         return 1;
     }
 
@@ -420,9 +421,33 @@ int CharQueue::Read(int device_no)
             return -1;
         }
     }
+
+    // Read() starts from a cleared queue so the payload is contiguous
+    if (recorder)
+        recorder->Record(record_direction, buffer.data(), s);
     return s;
 }
 
+/****
+ * Append:  Adds frame payload that was read some other way, such as a
+ *  frame collected over several input callbacks.  Returns -1 if it
+ *  doesn't fit.
+ ****/
+int CharQueue::Append(const Uchar *data, int len)
+{
+    FnTrace("CharQueue::Append()");
+    if (len < 0 || size + len > buffer_size)
+        return -1;
+    for (int i = 0; i < len; ++i)
+    {
+        buffer[end] = data[i];
+        if (++end >= buffer_size)
+            end = 0;
+    }
+    size += len;
+    return len;
+}
+
 /****
  * CharQueue::Write:  writes out the buffer to the device.
  *   Returns number of bytes written.
@@ -495,12 +520,16 @@ int CharQueue::Write(int device_no, int do_clear)
         val = write_all(temp_buffer.data(), s);
         if (val != s)
             return -1;
+        if (recorder)
+            recorder->Record(record_direction, temp_buffer.data(), s);
     }
     else
     {
         val = write_all(buffer.data() + start, payload_size);
         if (val != payload_size)
             return -1;
+        if (recorder)
+            recorder->Record(record_direction, buffer.data() + start, payload_size);
     }
 
     if (do_clear)
@@ -22,9 +22,11 @@
 #define REMOTE_LINK_HH
 
 #include "basic.hh"
+#include "protocol_recorder.hh"
 
 #include <array>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -39,7 +41,10 @@ class CharQueue
     int start{0};
     int end{0};
     int code{0};
+    bool overflow{false};  // Send8() dropped bytes since the last Clear()
     std::string name;
+    std::shared_ptr<vt::ProtocolRecorder> recorder;
+    vt::RecordDirection record_direction{vt::RecordDirection::ToTerminal};
 
     void ReadError(int wanted, int got);
     int Send8(int val);
@@ -68,7 +73,15 @@ public:
         code = new_code;
     }
     
-    void Clear() noexcept { size = 0; start = 0; end = 0; }
+    void Clear() noexcept { size = 0; start = 0; end = 0; overflow = false; }
+
+    // Tees every frame read or written to the recorder (nullptr stops it)
+    void SetRecorder(std::shared_ptr<vt::ProtocolRecorder> rec,
+                     vt::RecordDirection direction) noexcept
+    {
+        recorder = std::move(rec);
+        record_direction = direction;
+    }
 
     int Put8(int val);
     int Get8();
@@ -90,10 +103,12 @@ public:
 
     int Read(int device_no);
     int Write(int device_no, int do_clear = 1);
+    int Append(const Uchar *data, int len);  // payload bytes Read() didn't get
 
     [[nodiscard]] int BuffSize() const noexcept { return buffer_size; }
     [[nodiscard]] int SendSize() const noexcept { return send_size; }
     [[nodiscard]] int CurrSize() const noexcept { return size; }
+    [[nodiscard]] bool Overflowed() const noexcept { return overflow; }
 };
 
 
@@ -190,6 +205,9 @@ namespace TerminalProtocol {
     inline constexpr int BELL            = 72;  // <I2:volume -100 to 100>
     inline constexpr int DIE             = 99;  // no args - kills terminal
     inline constexpr int TRANSLATIONS    = 100; // see Terminal::SendTranslations()
+    inline constexpr int SESSION         = 101; // <str token, str path> - see Terminal::StartSession()
+    inline constexpr int INPUT_DONE      = 102; // <I4 seq> - drawing for traced input seq ends here
+    inline constexpr int PRESSLOOKS      = 103; // see Terminal::SendPressLooks()
     
     inline constexpr int CC_AUTH_CMD     = 150;
     inline constexpr int CC_PREAUTH_CMD  = 151;
@@ -273,6 +291,9 @@ namespace TerminalProtocol {
 #define TERM_BELL             TerminalProtocol::BELL
 #define TERM_DIE              TerminalProtocol::DIE
 #define TERM_TRANSLATIONS     TerminalProtocol::TRANSLATIONS
+#define TERM_SESSION          TerminalProtocol::SESSION
+#define TERM_INPUT_DONE       TerminalProtocol::INPUT_DONE
+#define TERM_PRESSLOOKS       TerminalProtocol::PRESSLOOKS
 // Note: TERM_CC_* macros maintained for protocol constants
 // (credit.hh defines different CC_* constants for dialog fields - those are separate!)
 #define TERM_CC_AUTH          TerminalProtocol::CC_AUTH_CMD
@@ -331,7 +352,14 @@ enum class ServerProtocol : int {
     SrvCcSafCleared    = 35,
     SrvCcSafDetails    = 36,
     SrvCcSettleFailed  = 37,
-    SrvCcSafClearFailed = 38
+    SrvCcSafClearFailed = 38,
+
+    SrvFontMetrics     = 39, // <I1 n, n x font> - glyph advances, see SendFontMetrics()
+    SrvAssetHashes     = 40, // <I1 n, n x <str name, str hash>> - what vt_term has cached
+    SrvResume          = 41, // <str token> - first frame on the resume socket
+    SrvInputStamp      = 42, // <I4 seq, LL ns> - when the touch or click that follows happened
+    SrvInputSpans      = 43, // <I4 seq, LL read, LL decoded, LL blitted> - see Terminal::ReadInputSpans()
+    SrvPressShown      = 44  // <LL ns, I1 local> - touch to highlight time, see Terminal::ReadPressShown()
 };
 
 inline constexpr int ToInt(ServerProtocol code) {
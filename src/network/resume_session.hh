@@ -0,0 +1,158 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * resume_session.hh - Tokens that let vt_term pick up where it left off
+ * No socket code; terminal.cc owns the listener and the connections
+ */
+
+#ifndef VT_RESUME_SESSION_HH
+#define VT_RESUME_SESSION_HH
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+// 32 hex digits from std::random_device; unguessable by other local users
+inline std::string NewSessionToken()
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::random_device rd;
+    std::string token;
+    token.reserve(32);
+    for (int word = 0; word < 4; ++word)
+    {
+        uint32_t bits = rd();
+        for (int i = 0; i < 8; ++i, bits >>= 4)
+            token.push_back(digits[bits & 0xF]);
+    }
+    return token;
+}
+
+/**
+ * @brief Which owner each session token belongs to, and which owners have
+ *  lost their connection and since when.
+ *
+ * An owner has at most one token; issuing again replaces it.  Expired()
+ * only reports, the caller decides what losing the session means.
+ */
+template <typename Owner>
+class SessionTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    std::string Issue(Owner *owner)
+    {
+        Remove(owner);
+        std::string token = NewSessionToken();
+        sessions[token] = Entry{owner, false, {}};
+        return token;
+    }
+
+    [[nodiscard]] Owner *Find(const std::string &token) const
+    {
+        auto it = sessions.find(token);
+        return it == sessions.end() ? nullptr : it->second.owner;
+    }
+
+    [[nodiscard]] bool Has(const Owner *owner) const
+    {
+        return FindOwner(owner) != sessions.end();
+    }
+
+    void Remove(const Owner *owner)
+    {
+        auto it = FindOwner(owner);
+        if (it != sessions.end())
+            sessions.erase(it);
+    }
+
+    // The connection dropped; the clock starts on the first call only
+    void Lost(const Owner *owner, Clock::time_point now)
+    {
+        auto it = FindOwner(owner);
+        if (it != sessions.end() && !it->second.lost)
+        {
+            it->second.lost = true;
+            it->second.lost_at = now;
+        }
+    }
+
+    void Resumed(const Owner *owner)
+    {
+        auto it = FindOwner(owner);
+        if (it != sessions.end())
+            it->second.lost = false;
+    }
+
+    [[nodiscard]] bool IsLost(const Owner *owner) const
+    {
+        auto it = FindOwner(owner);
+        return it != sessions.end() && it->second.lost;
+    }
+
+    // Owners lost for longer than grace
+    [[nodiscard]] std::vector<Owner *> Expired(Clock::time_point now,
+                                               Clock::duration grace) const
+    {
+        std::vector<Owner *> expired;
+        for (const auto& [token, entry] : sessions)
+        {
+            if (entry.lost && now - entry.lost_at > grace)
+                expired.push_back(entry.owner);
+        }
+        return expired;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept { return sessions.size(); }
+
+private:
+    struct Entry {
+        Owner *owner;
+        bool lost;
+        Clock::time_point lost_at;
+    };
+    using Map = std::map<std::string, Entry>;
+
+    typename Map::const_iterator FindOwner(const Owner *owner) const
+    {
+        for (auto it = sessions.begin(); it != sessions.end(); ++it)
+        {
+            if (it->second.owner == owner)
+                return it;
+        }
+        return sessions.end();
+    }
+    typename Map::iterator FindOwner(const Owner *owner)
+    {
+        for (auto it = sessions.begin(); it != sessions.end(); ++it)
+        {
+            if (it->second.owner == owner)
+                return it;
+        }
+        return sessions.end();
+    }
+
+    Map sessions;
+};
+
+} // namespace vt
+
+#endif // VT_RESUME_SESSION_HH
@@ -671,7 +671,7 @@ int SMTP(int fd, Email *email)
         if (response > 399)
         {
             fprintf(stderr, "SMTP Error:  %s\n", responsestr);
-            exit(1);
+            _exit(1);
         }
         
         // write the from address
@@ -682,7 +682,7 @@ int SMTP(int fd, Email *email)
         if (response > 299)
         {
             fprintf(stderr, "SMTP Error:  %s\n", responsestr);
-            exit(1);
+            _exit(1);
         }
         // add from address to message body
         vt::cpp23::format_to_buffer(outgoing, STRLONG, "From: {}\n", buffer);
@@ -705,7 +705,7 @@ int SMTP(int fd, Email *email)
         if (response > 399)
         {
             fprintf(stderr, "SMTP Error:  %s\n", responsestr);
-            exit(1);
+            _exit(1);
         }
         // write the headers (From, To, Subject)
         write(fd, body, strlen(body));
@@ -730,9 +730,9 @@ int SMTP(int fd, Email *email)
         if (response > 299)
         {
             fprintf(stderr, "SMTP Error:  %s\n", responsestr);
-            exit(1);
+            _exit(1);
         }
-        exit(0);
+        _exit(0);
     }
     else if (pid > 0)
     {
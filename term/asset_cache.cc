@@ -0,0 +1,132 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * asset_cache.cc - On-disk store for what vt_term keeps between runs
+ */
+
+#include "asset_cache.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+namespace vt {
+
+std::string CacheHome()
+{
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (xdg && *xdg)
+        return std::string(xdg) + "/viewtouch";
+    if (home && *home)
+        return std::string(home) + "/.cache/viewtouch";
+    return "/tmp/viewtouch";
+}
+
+std::string CacheHostName()
+{
+    char host[256] = "localhost";
+    if (gethostname(host, sizeof(host) - 1) != 0)
+        std::snprintf(host, sizeof(host), "localhost");
+    host[sizeof(host) - 1] = '\0';
+    return host;
+}
+
+bool AssetCache::ValidName(const std::string &name) const
+{
+    return !directory.empty() && !name.empty() && name[0] != '.' &&
+           name.find('/') == std::string::npos;
+}
+
+int AssetCache::Load(const std::string &name, std::string &data) const
+{
+    if (!ValidName(name))
+        return 1;
+    std::ifstream in(directory + "/" + name, std::ios::binary);
+    if (!in)
+        return 1;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return in.bad() ? 1 : 0;
+}
+
+int AssetCache::Store(const std::string &name, const std::string &data) const
+{
+    if (!ValidName(name))
+        return 1;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    // Unique per process, so terminals sharing the directory don't collide
+    const std::string path = directory + "/" + name;
+    const std::string tmp = directory + "/." + name + "." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return 1;
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out.flush())
+        {
+            std::remove(tmp.c_str());
+            return 1;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+std::string AssetCache::DefaultDirectory()
+{
+    return CacheHome() + "/assets-" + CacheHostName();
+}
+
+std::string PackTranslations(const TranslationList &list)
+{
+    std::string data;
+    for (const auto& [key, value] : list)
+    {
+        data.append(key).push_back('\0');
+        data.append(value).push_back('\0');
+    }
+    return data;
+}
+
+int UnpackTranslations(const std::string &data, TranslationList &list)
+{
+    list.clear();
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        const size_t key_end = data.find('\0', pos);
+        if (key_end == std::string::npos)
+            return 1;
+        const size_t value_end = data.find('\0', key_end + 1);
+        if (value_end == std::string::npos)
+            return 1;
+        list.emplace_back(data.substr(pos, key_end - pos),
+                          data.substr(key_end + 1, value_end - key_end - 1));
+        pos = value_end + 1;
+    }
+    return 0;
+}
+
+} // namespace vt
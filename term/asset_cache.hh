@@ -0,0 +1,71 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * asset_cache.hh - On-disk store for what vt_term keeps between runs
+ * No X dependencies; term_view.cc decides what goes in it
+ */
+
+#ifndef VT_ASSET_CACHE_HH
+#define VT_ASSET_CACHE_HH
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vt {
+
+// $XDG_CACHE_HOME/viewtouch (or ~/.cache/viewtouch, /tmp/viewtouch)
+std::string CacheHome();
+// This machine's host name, for naming per-host cache files
+std::string CacheHostName();
+
+/**
+ * @brief A directory of named blobs, each replaced atomically.
+ *
+ * Several vt_term processes on one host share the directory, so entries
+ * are written to a temporary file and renamed into place.  Names must be
+ * plain file names.  With no directory set nothing is stored or found.
+ */
+class AssetCache {
+public:
+    AssetCache() = default;
+    explicit AssetCache(std::string dir) : directory(std::move(dir)) {}
+
+    void SetDirectory(std::string dir) { directory = std::move(dir); }
+    [[nodiscard]] const std::string &Directory() const noexcept { return directory; }
+
+    // 0 on success
+    int Load(const std::string &name, std::string &data) const;
+    int Store(const std::string &name, const std::string &data) const;
+
+    // CacheHome()/assets-<host>
+    static std::string DefaultDirectory();
+
+private:
+    [[nodiscard]] bool ValidName(const std::string &name) const;
+
+    std::string directory;
+};
+
+using TranslationList = std::vector<std::pair<std::string, std::string>>;
+
+// The TERM_TRANSLATIONS table as stored in the cache: key\0value\0...
+std::string PackTranslations(const TranslationList &list);
+int UnpackTranslations(const std::string &data, TranslationList &list);
+
+} // namespace vt
+
+#endif // VT_ASSET_CACHE_HH
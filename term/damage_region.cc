@@ -0,0 +1,141 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * damage_region.cc - Rectangle lists of a Layer's pending window updates
+ */
+
+#include "damage_region.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace vt {
+
+DamageRect Union(const DamageRect &a, const DamageRect &b) noexcept
+{
+    if (a.Empty())
+        return b;
+    if (b.Empty())
+        return a;
+    const int x1 = std::min(a.x, b.x);
+    const int y1 = std::min(a.y, b.y);
+    const int x2 = std::max(a.x + a.w, b.x + b.w);
+    const int y2 = std::max(a.y + a.h, b.y + b.h);
+    return DamageRect{x1, y1, x2 - x1, y2 - y1};
+}
+
+DamageRect Intersection(const DamageRect &a, const DamageRect &b) noexcept
+{
+    const int x1 = std::max(a.x, b.x);
+    const int y1 = std::max(a.y, b.y);
+    const int x2 = std::min(a.x + a.w, b.x + b.w);
+    const int y2 = std::min(a.y + a.h, b.y + b.h);
+    if (x2 <= x1 || y2 <= y1)
+        return DamageRect{};
+    return DamageRect{x1, y1, x2 - x1, y2 - y1};
+}
+
+namespace {
+
+// Pixels the bounding box of a and b would copy that neither needs
+int64_t MergeWaste(const DamageRect &a, const DamageRect &b) noexcept
+{
+    const int64_t covered = a.Area() + b.Area() - Intersection(a, b).Area();
+    return Union(a, b).Area() - covered;
+}
+
+bool ShouldMerge(const DamageRect &a, const DamageRect &b) noexcept
+{
+    const int64_t waste = MergeWaste(a, b);
+    return waste <= DamageRegion::SMALL_WASTE || waste * 4 <= Union(a, b).Area();
+}
+
+} // namespace
+
+void DamageRegion::Add(const DamageRect &rect)
+{
+    if (rect.Empty())
+        return;
+    for (const DamageRect &r : rects)
+        if (r.Contains(rect))
+            return;
+
+    rects.push_back(rect);
+    MergeInto(rects.size() - 1);
+    while (rects.size() > static_cast<size_t>(MAX_RECTS))
+        MergeCheapestPair();
+}
+
+int64_t DamageRegion::Area() const noexcept
+{
+    int64_t area = 0;
+    for (const DamageRect &r : rects)
+        area += r.Area();
+    return area;
+}
+
+std::vector<DamageRect> DamageRegion::Take() noexcept
+{
+    std::vector<DamageRect> out;
+    out.swap(rects);
+    return out;
+}
+
+// Grows rects[idx] by every rectangle worth merging with it, repeating
+// because each merge can make further neighbours worth merging
+void DamageRegion::MergeInto(size_t idx)
+{
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t j = 0; j < rects.size(); ++j)
+        {
+            if (j == idx || !ShouldMerge(rects[idx], rects[j]))
+                continue;
+            rects[idx] = Union(rects[idx], rects[j]);
+            rects.erase(rects.begin() + static_cast<std::ptrdiff_t>(j));
+            if (j < idx)
+                --idx;
+            merged = true;
+            break;
+        }
+    }
+}
+
+void DamageRegion::MergeCheapestPair()
+{
+    size_t best_i = 0;
+    size_t best_j = 1;
+    int64_t best_waste = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < rects.size(); ++i)
+        for (size_t j = i + 1; j < rects.size(); ++j)
+        {
+            const int64_t waste = MergeWaste(rects[i], rects[j]);
+            if (waste < best_waste)
+            {
+                best_waste = waste;
+                best_i = i;
+                best_j = j;
+            }
+        }
+
+    rects[best_i] = Union(rects[best_i], rects[best_j]);
+    rects.erase(rects.begin() + static_cast<std::ptrdiff_t>(best_j));
+    MergeInto(best_i);
+}
+
+} // namespace vt
@@ -0,0 +1,102 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * damage_region.hh - Rectangle lists of a Layer's pending window updates
+ * No X dependencies; LayerList::FlushDamage() turns them into blits
+ */
+
+#ifndef VT_DAMAGE_REGION_HH
+#define VT_DAMAGE_REGION_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vt {
+
+struct DamageRect {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+
+    [[nodiscard]] bool Empty() const noexcept { return w <= 0 || h <= 0; }
+    [[nodiscard]] int64_t Area() const noexcept
+    {
+        return Empty() ? 0 : static_cast<int64_t>(w) * h;
+    }
+    [[nodiscard]] bool Contains(const DamageRect &r) const noexcept
+    {
+        return r.x >= x && r.y >= y && r.x + r.w <= x + w && r.y + r.h <= y + h;
+    }
+    bool operator==(const DamageRect &other) const noexcept
+    {
+        return x == other.x && y == other.y && w == other.w && h == other.h;
+    }
+};
+
+[[nodiscard]] DamageRect Union(const DamageRect &a, const DamageRect &b) noexcept;
+[[nodiscard]] DamageRect Intersection(const DamageRect &a, const DamageRect &b) noexcept;
+
+/**
+ * @brief Accumulates damaged rectangles until the next flush.
+ *
+ * Two rectangles are merged when their bounding box wastes no more than a
+ * quarter of its area (or a few hundred pixels), so a row of buttons becomes
+ * one strip while opposite corners of the screen stay separate.  Past
+ * MAX_RECTS the cheapest pair is merged regardless, which bounds the number
+ * of blits per flush.
+ */
+class DamageRegion {
+public:
+    static constexpr int MAX_RECTS = 16;
+    // Bounding boxes wasting this many pixels or fewer are always merged
+    static constexpr int64_t SMALL_WASTE = 512;
+
+    // Empty rectangles are ignored
+    void Add(const DamageRect &rect);
+    void Add(int x, int y, int w, int h) { Add(DamageRect{x, y, w, h}); }
+    void Clear() noexcept { rects.clear(); }
+
+    [[nodiscard]] bool Empty() const noexcept { return rects.empty(); }
+    [[nodiscard]] const std::vector<DamageRect> &Rects() const noexcept { return rects; }
+    // Sum of the rectangles' areas, i.e. the pixels a flush will copy
+    [[nodiscard]] int64_t Area() const noexcept;
+    // Hands the rectangles over and leaves the region empty
+    std::vector<DamageRect> Take() noexcept;
+
+private:
+    std::vector<DamageRect> rects;  // may overlap, but none contains another
+
+    void MergeInto(size_t idx);
+    void MergeCheapestPair();
+};
+
+/**
+ * @brief Counters for the window update path, so flicker on slow terminals
+ * can be related to how many blits each frame really takes.
+ */
+struct FrameStats {
+    uint64_t damage_rects = 0;  // update requests that went into a region
+    uint64_t frames = 0;        // flushes that drew something
+    uint64_t blits = 0;         // XCopyArea()/XPutImage() calls to the window
+    uint64_t frame_blits = 0;   // the part of blits drawn by frame flushes
+    uint64_t blit_pixels = 0;
+};
+
+} // namespace vt
+
+#endif // VT_DAMAGE_REGION_HH
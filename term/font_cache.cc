@@ -0,0 +1,209 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * font_cache.cc - Per-host file of resolved font patterns and their metrics
+ */
+
+#include "font_cache.hh"
+#include "asset_cache.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vt {
+
+namespace {
+
+// File layout: a header line, then one line per font with the fields
+//   spec, file, mtime, ascent, descent, default advance, advances (hex), pattern
+// separated by tabs.  The pattern goes last; it is the longest field.
+constexpr const char* HEADER = "vt_font_cache";
+
+bool Storable(const std::string &str)
+{
+    return str.find_first_of("\t\n") == std::string::npos;
+}
+
+std::string ToHex(const std::vector<uint8_t> &bytes)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (uint8_t b : bytes)
+    {
+        out.push_back(digits[b >> 4]);
+        out.push_back(digits[b & 0xF]);
+    }
+    return out;
+}
+
+int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+bool FromHex(const std::string &str, std::vector<uint8_t> &bytes)
+{
+    if (str.size() % 2 != 0)
+        return false;
+    bytes.resize(str.size() / 2);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        const int hi = HexDigit(str[i * 2]);
+        const int lo = HexDigit(str[i * 2 + 1]);
+        if (hi < 0 || lo < 0)
+            return false;
+        bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+std::vector<std::string> SplitTabs(const std::string &line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;)
+    {
+        const size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab - start));
+        if (tab == std::string::npos)
+            break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+} // namespace
+
+int FontCache::Load(const std::string &path)
+{
+    fonts.clear();
+    dirty = false;
+
+    std::ifstream in(path);
+    if (!in)
+        return 1;
+    std::string line;
+    if (!std::getline(in, line) || line != std::string(HEADER) + " " + std::to_string(VERSION))
+        return 1;
+
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> fields = SplitTabs(line);
+        if (fields.size() != 8)
+            continue;
+
+        ResolvedFont font;
+        font.file = fields[1];
+        font.pattern = fields[7];
+        font.file_mtime = std::strtoll(fields[2].c_str(), nullptr, 10);
+        font.ascent = std::atoi(fields[3].c_str());
+        font.descent = std::atoi(fields[4].c_str());
+        font.default_advance = std::atoi(fields[5].c_str());
+        if (!FromHex(fields[6], font.advances) || font.pattern.empty())
+            continue;
+
+        // The font package was upgraded or removed: match it again
+        if (font.file_mtime == 0 || FileTime(font.file) != font.file_mtime)
+        {
+            dirty = true;
+            continue;
+        }
+        fonts[fields[0]] = std::move(font);
+    }
+    return 0;
+}
+
+int FontCache::Save(const std::string &path)
+{
+    std::error_code ec;
+    const std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path(), ec);
+
+    // per process: vt_terms on one host share the cache file
+    const std::string tmp = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out)
+            return 1;
+        out << HEADER << ' ' << VERSION << '\n';
+        for (const auto& [spec, font] : fonts)
+        {
+            out << spec << '\t' << font.file << '\t' << font.file_mtime << '\t'
+                << font.ascent << '\t' << font.descent << '\t' << font.default_advance << '\t'
+                << ToHex(font.advances) << '\t' << font.pattern << '\n';
+        }
+        if (!out.flush())
+        {
+            std::remove(tmp.c_str());
+            return 1;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return 1;
+    }
+    dirty = false;
+    return 0;
+}
+
+const ResolvedFont *FontCache::Find(const std::string &spec) const
+{
+    auto it = fonts.find(spec);
+    return it == fonts.end() ? nullptr : &it->second;
+}
+
+void FontCache::Store(const std::string &spec, ResolvedFont font)
+{
+    // Nothing the line format can't hold back
+    if (!Storable(spec) || !Storable(font.file) || !Storable(font.pattern) || font.pattern.empty())
+        return;
+    fonts[spec] = std::move(font);
+    dirty = true;
+}
+
+void FontCache::Clear() noexcept
+{
+    if (!fonts.empty())
+        dirty = true;
+    fonts.clear();
+}
+
+int64_t FontCache::FileTime(const std::string &path)
+{
+    struct stat sb;
+    if (path.empty() || stat(path.c_str(), &sb) != 0)
+        return 0;
+    return static_cast<int64_t>(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+}
+
+std::string FontCache::DefaultPath()
+{
+    return CacheHome() + "/fonts-" + CacheHostName() + ".cache";
+}
+
+} // namespace vt
@@ -0,0 +1,83 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * font_cache.hh - Per-host file of resolved font patterns and their metrics
+ * No X dependencies; term_view.cc does the fontconfig matching
+ */
+
+#ifndef VT_FONT_CACHE_HH
+#define VT_FONT_CACHE_HH
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief What fontconfig resolved one font specification to.
+ *
+ * pattern is the FcNameUnparse() form of the matched pattern, which
+ * XftFontOpenPattern() accepts without matching again.  The metrics are
+ * the ones SendFontMetrics() reports, so vt_main can be told the widths
+ * of a font before vt_term has opened it.
+ */
+struct ResolvedFont {
+    std::string pattern;
+    std::string file;               // font file the pattern names
+    int64_t file_mtime = 0;         // of file when it was resolved
+    int ascent = 0;
+    int descent = 0;
+    int default_advance = 0;
+    std::vector<uint8_t> advances;  // over vt::GLYPH_RANGES, in order
+};
+
+/**
+ * @brief Resolved fonts keyed by their FontData specification.
+ *
+ * Loading drops any entry whose font file has gone or changed since it
+ * was resolved, so an upgraded font package is matched again.
+ */
+class FontCache {
+public:
+    static constexpr int VERSION = 1;
+
+    // 0 on success; a missing, foreign or older file leaves the cache empty
+    int Load(const std::string &path);
+    // Writes through a temporary file; 0 on success
+    int Save(const std::string &path);
+
+    [[nodiscard]] const ResolvedFont *Find(const std::string &spec) const;
+    void Store(const std::string &spec, ResolvedFont font);
+    void Clear() noexcept;
+
+    [[nodiscard]] bool Dirty() const noexcept { return dirty; }
+    [[nodiscard]] size_t Size() const noexcept { return fonts.size(); }
+
+    // Modification time of path in nanoseconds, 0 if it can't be read
+    static int64_t FileTime(const std::string &path);
+    // $XDG_CACHE_HOME (or ~/.cache)/viewtouch/fonts-<host>.cache
+    static std::string DefaultPath();
+
+private:
+    std::unordered_map<std::string, ResolvedFont> fonts;
+    bool dirty = false;
+};
+
+} // namespace vt
+
+#endif // VT_FONT_CACHE_HH
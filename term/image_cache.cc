@@ -0,0 +1,141 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * image_cache.cc - LRU cache of decoded, pre-scaled images for Layer::DrawPixmap
+ */
+
+#include "image_cache.hh"
+
+namespace vt {
+
+size_t ImageKeyHash::operator()(const ImageKey &key) const noexcept
+{
+    size_t h = std::hash<std::string>{}(key.path);
+    auto mix = [&h](uint64_t v) { h ^= std::hash<uint64_t>{}(v) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    mix(static_cast<uint64_t>(key.mtime_ns));
+    mix((static_cast<uint64_t>(static_cast<uint32_t>(key.width)) << 32) |
+        static_cast<uint32_t>(key.height));
+    return h;
+}
+
+ImageCache::ImageCache(size_t max, ReleaseFn release)
+    : max_bytes(max), release_fn(std::move(release))
+{
+}
+
+ImageCache::~ImageCache()
+{
+    Clear();
+}
+
+void ImageCache::SetMaxBytes(size_t max)
+{
+    max_bytes = max;
+    EvictToCap(nullptr);
+}
+
+const CachedImage *ImageCache::Find(const ImageKey &key)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    lru.splice(lru.begin(), lru, it->second);
+    return &it->second->second;
+}
+
+const CachedImage &ImageCache::Insert(const ImageKey &key, CachedImage image)
+{
+    auto found = index.find(key);
+    if (found != index.end())
+        Erase(found->second);
+
+    // A changed file invalidates every size cached from the old version
+    for (auto it = lru.begin(); it != lru.end();)
+    {
+        auto next = std::next(it);
+        if (it->first.path == key.path && it->first.mtime_ns != key.mtime_ns)
+            Erase(it);
+        it = next;
+    }
+
+    bytes += image.bytes;
+    lru.emplace_front(key, std::move(image));
+    index[key] = lru.begin();
+    EvictToCap(&key);
+    return lru.front().second;
+}
+
+void ImageCache::Clear()
+{
+    while (!lru.empty())
+        Erase(std::prev(lru.end()));
+    resolved.clear();
+}
+
+const std::string *ImageCache::Resolved(const std::string &name) const
+{
+    auto it = resolved.find(name);
+    return it == resolved.end() ? nullptr : &it->second;
+}
+
+void ImageCache::RememberResolved(const std::string &name, const std::string &path)
+{
+    resolved[name] = path;
+}
+
+void ImageCache::ForgetResolved(const std::string &name)
+{
+    resolved.erase(name);
+}
+
+ImageCache::Stats ImageCache::GetStats() const noexcept
+{
+    Stats stats;
+    stats.hits      = hits;
+    stats.misses    = misses;
+    stats.evictions = evictions;
+    stats.entries   = lru.size();
+    stats.bytes     = bytes;
+    stats.max_bytes = max_bytes;
+    return stats;
+}
+
+void ImageCache::Erase(std::list<Entry>::iterator it)
+{
+    if (release_fn)
+        release_fn(it->second);
+    bytes -= it->second.bytes;
+    index.erase(it->first);
+    lru.erase(it);
+}
+
+void ImageCache::EvictToCap(const ImageKey *keep)
+{
+    while (bytes > max_bytes && !lru.empty())
+    {
+        auto victim = std::prev(lru.end());
+        if (keep && victim->first == *keep)
+            break;  // only the new entry is left
+        Erase(victim);
+        ++evictions;
+    }
+}
+
+} // namespace vt
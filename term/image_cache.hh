@@ -0,0 +1,139 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * image_cache.hh - LRU cache of decoded, pre-scaled images for Layer::DrawPixmap
+ * No X dependencies: the owner frees server resources through a release hook
+ */
+
+#ifndef VT_IMAGE_CACHE_HH
+#define VT_IMAGE_CACHE_HH
+
+#include "soft_canvas.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace vt {
+
+/**
+ * @brief Identifies one rendition of an image file.
+ *
+ * mtime_ns makes a replaced file miss instead of showing the stale copy.
+ * width/height are the drawn size; 0 x 0 is the image at its own size.
+ */
+struct ImageKey {
+    std::string path;
+    int64_t mtime_ns = 0;
+    int width = 0;
+    int height = 0;
+
+    bool operator==(const ImageKey &other) const noexcept
+    {
+        return width == other.width && height == other.height &&
+               mtime_ns == other.mtime_ns && path == other.path;
+    }
+};
+
+struct ImageKeyHash {
+    size_t operator()(const ImageKey &key) const noexcept;
+};
+
+/**
+ * @brief One cached rendition.  pixmap/mask are X Pixmap IDs (0 if unused),
+ * soft is set instead in software rendering mode.
+ */
+struct CachedImage {
+    unsigned long pixmap = 0;
+    unsigned long mask = 0;
+    int width = 0;
+    int height = 0;
+    std::shared_ptr<const SoftImage> soft;
+    size_t bytes = 0;  // charged against the cache's memory cap
+};
+
+/**
+ * @brief Least recently used cache of CachedImage with a byte cap.
+ *
+ * Also remembers where each requested file name resolved to, so a hit
+ * costs one stat() of the resolved path instead of probing the image
+ * directories and decoding the file again.
+ */
+class ImageCache {
+public:
+    static constexpr size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+    // Called for every entry that leaves the cache
+    using ReleaseFn = std::function<void(CachedImage &)>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t max_bytes = 0;
+    };
+
+    explicit ImageCache(size_t max_bytes = DEFAULT_MAX_BYTES, ReleaseFn release = {});
+    ~ImageCache();
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    void SetRelease(ReleaseFn release) { release_fn = std::move(release); }
+    // Evicts down to the new cap right away
+    void SetMaxBytes(size_t max_bytes);
+    [[nodiscard]] size_t MaxBytes() const noexcept { return max_bytes; }
+
+    // Counts a hit or miss; a hit becomes the most recently used entry
+    const CachedImage *Find(const ImageKey &key);
+    // Takes ownership of image.  Older versions of the same path are dropped
+    // and the least recently used entries are evicted to stay under the cap.
+    // An entry bigger than the cap on its own is still kept until the next insert.
+    const CachedImage &Insert(const ImageKey &key, CachedImage image);
+    void Clear();
+
+    // File name -> path it was found at; nullptr if unknown
+    const std::string *Resolved(const std::string &name) const;
+    void RememberResolved(const std::string &name, const std::string &path);
+    void ForgetResolved(const std::string &name);
+
+    [[nodiscard]] Stats GetStats() const noexcept;
+
+private:
+    using Entry = std::pair<ImageKey, CachedImage>;
+
+    size_t max_bytes;
+    size_t bytes = 0;
+    ReleaseFn release_fn;
+    std::list<Entry> lru;  // front is most recently used
+    std::unordered_map<ImageKey, std::list<Entry>::iterator, ImageKeyHash> index;
+    std::unordered_map<std::string, std::string> resolved;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    void Erase(std::list<Entry>::iterator it);
+    void EvictToCap(const ImageKey *keep);
+};
+
+} // namespace vt
+
+#endif // VT_IMAGE_CACHE_HH
@@ -0,0 +1,882 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * image_pipeline.cc - Raw RGBA decode, scaling and keying for vt_term images
+ */
+
+#include "image_pipeline.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#ifdef HAVE_PNG
+#include <png.h>
+#endif
+#ifdef HAVE_JPEG
+#include <jpeglib.h>
+#endif
+#ifdef HAVE_GIF
+#include <gif_lib.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define VT_IMAGE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_neon.h>
+#define VT_IMAGE_NEON 1
+#endif
+
+namespace vt {
+
+namespace {
+
+constexpr int WEIGHT_BITS = 14;
+constexpr int WEIGHT_ONE  = 1 << WEIGHT_BITS;
+
+inline uint32_t MulDiv255(uint32_t c, uint32_t a) noexcept
+{
+    uint32_t t = c * a + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t PremultiplyPixel(uint32_t p) noexcept
+{
+    uint32_t a = p >> 24;
+    if (a == 255)
+        return p;
+    if (a == 0)
+        return 0;
+    return (a << 24) |
+           (MulDiv255((p >> 16) & 255, a) << 16) |
+           (MulDiv255((p >> 8) & 255, a) << 8) |
+           MulDiv255(p & 255, a);
+}
+
+/**
+ * Filter:  For each output pixel, taps consecutive source pixels from
+ *  start[i] with weights summing to WEIGHT_ONE.  Unused taps weigh 0.
+ */
+struct Filter {
+    int taps = 1;
+    std::vector<int> start;
+    std::vector<int16_t> weights;  // start.size() * taps
+};
+
+Filter MakeFilter(int src, int dst)
+{
+    Filter f;
+    f.start.resize(static_cast<size_t>(dst));
+    std::vector<double> w;
+
+    if (dst >= src)
+    {
+        // Bilinear between the two nearest source pixel centres
+        f.taps = (src > 1) ? 2 : 1;
+        w.resize(static_cast<size_t>(dst) * f.taps);
+        const double scale = static_cast<double>(src) / dst;
+        for (int i = 0; i < dst; ++i)
+        {
+            if (f.taps == 1)
+            {
+                f.start[i] = 0;
+                w[i] = 1.0;
+                continue;
+            }
+            double centre = std::max(0.0, (i + 0.5) * scale - 0.5);
+            int j = static_cast<int>(centre);
+            double frac = centre - j;
+            if (j >= src - 1)
+            {
+                j = src - 2;
+                frac = 1.0;
+            }
+            f.start[i] = j;
+            w[i * 2]     = 1.0 - frac;
+            w[i * 2 + 1] = frac;
+        }
+    }
+    else
+    {
+        // Box filter: each source pixel weighs by how much of it the output covers
+        const double scale = static_cast<double>(src) / dst;
+        f.taps = std::min(src, static_cast<int>(std::ceil(scale)) + 1);
+        w.resize(static_cast<size_t>(dst) * f.taps);
+        for (int i = 0; i < dst; ++i)
+        {
+            const double lo = i * scale;
+            const double hi = lo + scale;
+            const int first = std::min(static_cast<int>(lo), src - f.taps);
+            f.start[i] = first;
+            for (int t = 0; t < f.taps; ++t)
+            {
+                const int j = first + t;
+                const double overlap = std::min(hi, j + 1.0) - std::max(lo, static_cast<double>(j));
+                w[i * f.taps + t] = overlap > 0.0 ? overlap / scale : 0.0;
+            }
+        }
+    }
+
+    // Round to fixed point so every output's weights sum to exactly one;
+    // otherwise opaque pixels could come out with alpha 254
+    f.weights.resize(w.size());
+    for (int i = 0; i < dst; ++i)
+    {
+        int sum = 0;
+        int largest = 0;
+        for (int t = 0; t < f.taps; ++t)
+        {
+            int q = static_cast<int>(std::lround(w[i * f.taps + t] * WEIGHT_ONE));
+            f.weights[i * f.taps + t] = static_cast<int16_t>(q);
+            sum += q;
+            if (q > f.weights[i * f.taps + largest])
+                largest = t;
+        }
+        f.weights[i * f.taps + largest] =
+            static_cast<int16_t>(f.weights[i * f.taps + largest] + (WEIGHT_ONE - sum));
+    }
+    return f;
+}
+
+#if defined(VT_IMAGE_SSE2)
+
+inline __m128i Expand(uint32_t p) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p)), zero), zero);
+}
+
+inline __m128i Narrow(__m128i a, __m128i b) noexcept
+{
+    a = _mm_srai_epi32(a, WEIGHT_BITS);
+    b = _mm_srai_epi32(b, WEIGHT_BITS);
+    return _mm_packs_epi32(a, b);
+}
+
+void HorizontalRow(const uint32_t *src, uint32_t *dst, int dw, const Filter &f)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (WEIGHT_BITS - 1));
+    for (int x = 0; x < dw; ++x)
+    {
+        const uint32_t *s = src + f.start[x];
+        const int16_t *w = &f.weights[static_cast<size_t>(x) * f.taps];
+        __m128i acc = round;
+        int t = 0;
+        // Two taps per madd: channels interleaved as (c0, c1) against (w0, w1)
+        for (; t + 2 <= f.taps; t += 2)
+        {
+            const __m128i v  = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + t)), zero);
+            const __m128i c  = _mm_unpacklo_epi16(v, _mm_unpackhi_epi64(v, v));
+            const __m128i wv = _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(w[t + 1])) << 16) |
+                                                               static_cast<uint16_t>(w[t])));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(c, wv));
+        }
+        if (t < f.taps)
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(Expand(s[t]), _mm_set1_epi32(w[t])));
+        __m128i packed = Narrow(acc, acc);
+        dst[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+    }
+}
+
+void VerticalRow(const uint32_t *const *rows, const int16_t *w, int taps, uint32_t *dst, int dw)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (WEIGHT_BITS - 1));
+    int x = 0;
+    for (; x + 4 <= dw; x += 4)
+    {
+        __m128i a0 = round, a1 = round, a2 = round, a3 = round;
+        for (int t = 0; t < taps; ++t)
+        {
+            const __m128i wv = _mm_set1_epi32(w[t]);
+            const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[t] + x));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            a0 = _mm_add_epi32(a0, _mm_madd_epi16(_mm_unpacklo_epi16(lo, zero), wv));
+            a1 = _mm_add_epi32(a1, _mm_madd_epi16(_mm_unpackhi_epi16(lo, zero), wv));
+            a2 = _mm_add_epi32(a2, _mm_madd_epi16(_mm_unpacklo_epi16(hi, zero), wv));
+            a3 = _mm_add_epi32(a3, _mm_madd_epi16(_mm_unpackhi_epi16(hi, zero), wv));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_packus_epi16(Narrow(a0, a1), Narrow(a2, a3)));
+    }
+    for (; x < dw; ++x)
+    {
+        __m128i acc = round;
+        for (int t = 0; t < taps; ++t)
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(Expand(rows[t][x]), _mm_set1_epi32(w[t])));
+        __m128i packed = Narrow(acc, acc);
+        dst[x] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+    }
+}
+
+#elif defined(VT_IMAGE_NEON)
+
+inline uint32_t NarrowPixel(uint32x4_t acc) noexcept
+{
+    uint16x4_t n = vshrn_n_u32(acc, WEIGHT_BITS);
+    uint8x8_t b = vqmovn_u16(vcombine_u16(n, n));
+    return vget_lane_u32(vreinterpret_u32_u8(b), 0);
+}
+
+inline uint16x4_t ExpandPixel(uint32_t p) noexcept
+{
+    return vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(p))));
+}
+
+void HorizontalRow(const uint32_t *src, uint32_t *dst, int dw, const Filter &f)
+{
+    for (int x = 0; x < dw; ++x)
+    {
+        const uint32_t *s = src + f.start[x];
+        const int16_t *w = &f.weights[static_cast<size_t>(x) * f.taps];
+        uint32x4_t acc = vdupq_n_u32(1u << (WEIGHT_BITS - 1));
+        for (int t = 0; t < f.taps; ++t)
+            acc = vmlal_n_u16(acc, ExpandPixel(s[t]), static_cast<uint16_t>(w[t]));
+        dst[x] = NarrowPixel(acc);
+    }
+}
+
+void VerticalRow(const uint32_t *const *rows, const int16_t *w, int taps, uint32_t *dst, int dw)
+{
+    int x = 0;
+    for (; x + 4 <= dw; x += 4)
+    {
+        uint32x4_t a0 = vdupq_n_u32(1u << (WEIGHT_BITS - 1));
+        uint32x4_t a1 = a0, a2 = a0, a3 = a0;
+        for (int t = 0; t < taps; ++t)
+        {
+            const uint16_t wt = static_cast<uint16_t>(w[t]);
+            const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(rows[t] + x));
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+            const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+            a0 = vmlal_n_u16(a0, vget_low_u16(lo), wt);
+            a1 = vmlal_n_u16(a1, vget_high_u16(lo), wt);
+            a2 = vmlal_n_u16(a2, vget_low_u16(hi), wt);
+            a3 = vmlal_n_u16(a3, vget_high_u16(hi), wt);
+        }
+        const uint16x8_t n01 = vcombine_u16(vshrn_n_u32(a0, WEIGHT_BITS), vshrn_n_u32(a1, WEIGHT_BITS));
+        const uint16x8_t n23 = vcombine_u16(vshrn_n_u32(a2, WEIGHT_BITS), vshrn_n_u32(a3, WEIGHT_BITS));
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + x), vcombine_u8(vqmovn_u16(n01), vqmovn_u16(n23)));
+    }
+    for (; x < dw; ++x)
+    {
+        uint32x4_t acc = vdupq_n_u32(1u << (WEIGHT_BITS - 1));
+        for (int t = 0; t < taps; ++t)
+            acc = vmlal_n_u16(acc, ExpandPixel(rows[t][x]), static_cast<uint16_t>(w[t]));
+        dst[x] = NarrowPixel(acc);
+    }
+}
+
+#else
+
+inline uint32_t WeighPixel(const uint32_t *const *src, const int16_t *w, int taps, int x) noexcept
+{
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int32_t acc = 1 << (WEIGHT_BITS - 1);
+        for (int t = 0; t < taps; ++t)
+            acc += static_cast<int32_t>((src[t][x] >> shift) & 255) * w[t];
+        out |= static_cast<uint32_t>(std::min(255, acc >> WEIGHT_BITS)) << shift;
+    }
+    return out;
+}
+
+void HorizontalRow(const uint32_t *src, uint32_t *dst, int dw, const Filter &f)
+{
+    std::vector<const uint32_t*> taps(static_cast<size_t>(f.taps));
+    for (int x = 0; x < dw; ++x)
+    {
+        for (int t = 0; t < f.taps; ++t)
+            taps[t] = src + f.start[x] + t;
+        dst[x] = WeighPixel(taps.data(), &f.weights[static_cast<size_t>(x) * f.taps], f.taps, 0);
+    }
+}
+
+void VerticalRow(const uint32_t *const *rows, const int16_t *w, int taps, uint32_t *dst, int dw)
+{
+    for (int x = 0; x < dw; ++x)
+        dst[x] = WeighPixel(rows, w, taps, x);
+}
+
+#endif
+
+// Lightness and colour spread tests shared by detection and keying.
+// sum is r+g+b, so "average >= 180" is sum >= 540 without dividing.
+inline void Channels(uint32_t p, int &r, int &g, int &b, int &sum, int &variance) noexcept
+{
+    r = (p >> 16) & 255;
+    g = (p >> 8) & 255;
+    b = p & 255;
+    sum = r + g + b;
+    variance = std::abs(r - g) + std::abs(g - b) + std::abs(r - b);
+}
+
+inline bool IsBackgroundPixel(uint32_t p) noexcept
+{
+    int r, g, b, sum, variance;
+    Channels(p, r, g, b, sum, variance);
+    if (r >= 240 && g >= 240 && b >= 240)
+        return true;  // white squares (#FFFFFF, #FEFEFE, ...)
+    return sum >= 540 && sum <= 737 && variance < 45;  // light grey squares
+}
+
+// Counts the pixels that look like a light checker square; see
+// KeyCheckeredBackground() for the thresholds
+int CountLightPixels(const RgbaImage &image)
+{
+    int count = 0;
+    for (uint32_t p : image.pixels)
+    {
+        int r, g, b, sum, variance;
+        Channels(p, r, g, b, sum, variance);
+        const bool light = sum >= 720 || (sum >= 570 && sum <= 692);
+        count += (light && variance < 30) ? 1 : 0;
+    }
+    return count;
+}
+
+// Samples pairs of pixels half a checker apart for two light, clearly
+// different colours; true as soon as one checker size shows the pattern
+bool HasCheckerPattern(const RgbaImage &image)
+{
+    constexpr int COLOR_THRESHOLD = 40;
+    constexpr int MIN_SUM = 540;  // average lightness 180
+    const int width = image.width;
+    const int height = image.height;
+    const uint32_t *pixels = image.pixels.data();
+
+    for (int size = 4; size <= 32; size *= 2)
+    {
+        const int half = size / 2;
+        for (int oy = 0; oy < size && oy < height; ++oy)
+            for (int ox = 0; ox < size && ox < width; ++ox)
+                for (int y = oy; y < height - size; y += size * 2)
+                    for (int x = ox; x < width - size; x += size * 2)
+                    {
+                        int r1, g1, b1, s1, v1, r2, g2, b2, s2, v2;
+                        Channels(pixels[y * width + x], r1, g1, b1, s1, v1);
+                        Channels(pixels[(y + half) * width + x + half], r2, g2, b2, s2, v2);
+                        if (s1 >= MIN_SUM && s2 >= MIN_SUM &&
+                            std::abs(r1 - r2) + std::abs(g1 - g2) + std::abs(b1 - b2) > COLOR_THRESHOLD)
+                            return true;
+                    }
+    }
+    return false;
+}
+
+#if defined(VT_IMAGE_SSE2)
+inline __m128i Abs32(__m128i v) noexcept
+{
+    const __m128i sign = _mm_srai_epi32(v, 31);
+    return _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+}
+#endif
+
+} // namespace
+
+const char* ImagePipelineBackend() noexcept
+{
+#if defined(VT_IMAGE_SSE2)
+    return "sse2";
+#elif defined(VT_IMAGE_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+void PackRGBRow(const uint8_t *src, uint32_t *dst, int count) noexcept
+{
+    for (int x = 0; x < count; ++x, src += 3)
+        dst[x] = 0xFF000000u | (static_cast<uint32_t>(src[0]) << 16) |
+                 (static_cast<uint32_t>(src[1]) << 8) | src[2];
+}
+
+void PackRGBARow(const uint8_t *src, uint32_t *dst, int count) noexcept
+{
+    for (int x = 0; x < count; ++x, src += 4)
+        dst[x] = (static_cast<uint32_t>(src[3]) << 24) | (static_cast<uint32_t>(src[0]) << 16) |
+                 (static_cast<uint32_t>(src[1]) << 8) | src[2];
+}
+
+void Premultiply(RgbaImage &image) noexcept
+{
+    if (!image.has_alpha)
+        return;
+    uint32_t *p = image.pixels.data();
+    size_t n = image.pixels.size();
+    size_t i = 0;
+#if defined(VT_IMAGE_SSE2)
+    // Two pixels per step in 16 bit lanes; alpha is byte 3 of each word
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i half  = _mm_set1_epi16(128);
+    const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + i)), zero);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xFF), 0xFF);
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(v, a), half);
+        t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        t = _mm_or_si128(_mm_and_si128(alpha_lanes, v), _mm_andnot_si128(alpha_lanes, t));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p + i), _mm_packus_epi16(t, t));
+    }
+#endif
+    for (; i < n; ++i)
+        p[i] = PremultiplyPixel(p[i]);
+}
+
+uint32_t Unpremultiply(uint32_t pixel) noexcept
+{
+    const uint32_t a = pixel >> 24;
+    if (a == 255 || a == 0)
+        return pixel;
+    auto channel = [a](uint32_t c) { return std::min<uint32_t>(255, (c * 255 + a / 2) / a); };
+    return (a << 24) | (channel((pixel >> 16) & 255) << 16) |
+           (channel((pixel >> 8) & 255) << 8) | channel(pixel & 255);
+}
+
+/****
+ * KeyCheckeredBackground:  Images cut out in an editor are sometimes saved
+ *  with the editor's grey/white "transparent" checkerboard baked in.  If
+ *  the image shows that pattern (or is more than 10% light grey/white),
+ *  every light, uncoloured pixel is made transparent.
+ ****/
+int KeyCheckeredBackground(RgbaImage &image)
+{
+    if (!image.Valid())
+        return 0;
+
+    const int total = image.width * image.height;
+    if (!HasCheckerPattern(image) && CountLightPixels(image) * 100 / total <= 10)
+        return 0;
+
+    uint32_t *p = image.pixels.data();
+    const size_t n = image.pixels.size();
+    size_t i = 0;
+    int keyed = 0;
+#if defined(VT_IMAGE_SSE2)
+    // Same tests as IsBackgroundPixel(), four pixels at a time in 32 bit lanes
+    const __m128i byte = _mm_set1_epi32(255);
+    const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128i c239 = _mm_set1_epi32(239);
+    const __m128i c539 = _mm_set1_epi32(539);
+    const __m128i c738 = _mm_set1_epi32(738);
+    const __m128i c45  = _mm_set1_epi32(45);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), byte);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 8), byte);
+        const __m128i b = _mm_and_si128(v, byte);
+        const __m128i a = _mm_srli_epi32(v, 24);
+        const __m128i sum = _mm_add_epi32(_mm_add_epi32(r, g), b);
+        const __m128i variance = _mm_add_epi32(_mm_add_epi32(Abs32(_mm_sub_epi32(r, g)),
+                                                             Abs32(_mm_sub_epi32(g, b))),
+                                               Abs32(_mm_sub_epi32(r, b)));
+        const __m128i white = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(r, c239),
+                                                          _mm_cmpgt_epi32(g, c239)),
+                                            _mm_cmpgt_epi32(b, c239));
+        const __m128i grey = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(sum, c539),
+                                                         _mm_cmplt_epi32(sum, c738)),
+                                           _mm_cmplt_epi32(variance, c45));
+        const __m128i visible = _mm_cmpgt_epi32(a, zero);
+        const __m128i key = _mm_and_si128(_mm_or_si128(white, grey), visible);
+        keyed += __builtin_popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(key))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i),
+                         _mm_andnot_si128(_mm_and_si128(key, alpha_mask), v));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if ((p[i] >> 24) != 0 && IsBackgroundPixel(p[i]))
+        {
+            p[i] &= 0x00FFFFFFu;
+            ++keyed;
+        }
+    }
+    if (keyed > 0)
+        image.has_alpha = true;
+    return keyed;
+}
+
+RgbaImage ScaleImage(const RgbaImage &src, int dw, int dh)
+{
+    RgbaImage out;
+    if (!src.Valid() || dw <= 0 || dh <= 0)
+        return out;
+    out.width = dw;
+    out.height = dh;
+    out.has_alpha = src.has_alpha;
+    if (dw == src.width && dh == src.height)
+    {
+        out.pixels = src.pixels;
+        return out;
+    }
+    out.pixels.resize(static_cast<size_t>(dw) * static_cast<size_t>(dh));
+
+    // Horizontal pass into tmp (dw x src.height), unless the width is unchanged
+    const uint32_t *rows = src.pixels.data();
+    std::vector<uint32_t> tmp;
+    if (dw != src.width)
+    {
+        const Filter fx = MakeFilter(src.width, dw);
+        tmp.resize(static_cast<size_t>(dw) * static_cast<size_t>(src.height));
+        for (int y = 0; y < src.height; ++y)
+            HorizontalRow(src.pixels.data() + static_cast<size_t>(y) * src.width,
+                          tmp.data() + static_cast<size_t>(y) * dw, dw, fx);
+        rows = tmp.data();
+    }
+
+    const Filter fy = MakeFilter(src.height, dh);
+    std::vector<const uint32_t*> taps(static_cast<size_t>(fy.taps));
+    for (int y = 0; y < dh; ++y)
+    {
+        for (int t = 0; t < fy.taps; ++t)
+            taps[t] = rows + static_cast<size_t>(fy.start[y] + t) * dw;
+        VerticalRow(taps.data(), &fy.weights[static_cast<size_t>(y) * fy.taps], fy.taps,
+                    out.pixels.data() + static_cast<size_t>(y) * dw, dw);
+    }
+    return out;
+}
+
+RgbaImage ScaleNearest(const RgbaImage &src, int dw, int dh)
+{
+    RgbaImage out;
+    if (!src.Valid() || dw <= 0 || dh <= 0)
+        return out;
+    out.width = dw;
+    out.height = dh;
+    out.has_alpha = src.has_alpha;
+    out.pixels.resize(static_cast<size_t>(dw) * static_cast<size_t>(dh));
+    const double inv_x = static_cast<double>(src.width) / dw;
+    const double inv_y = static_cast<double>(src.height) / dh;
+    for (int y = 0; y < dh; ++y)
+    {
+        const int sy = std::min(static_cast<int>(y * inv_y), src.height - 1);
+        for (int x = 0; x < dw; ++x)
+        {
+            const int sx = std::min(static_cast<int>(x * inv_x), src.width - 1);
+            out.pixels[static_cast<size_t>(y) * dw + x] = src.pixels[static_cast<size_t>(sy) * src.width + sx];
+        }
+    }
+    return out;
+}
+
+SoftImage ToSoftImage(const RgbaImage &image)
+{
+    SoftImage soft;
+    if (!image.Valid())
+        return soft;
+    soft.width = image.width;
+    soft.height = image.height;
+    soft.pixels.resize(image.pixels.size());
+    if (image.has_alpha)
+        soft.mask.resize(image.pixels.size());
+    for (size_t i = 0; i < image.pixels.size(); ++i)
+    {
+        const uint32_t p = image.pixels[i];
+        soft.pixels[i] = Unpremultiply(p) & 0xFFFFFF;
+        if (image.has_alpha)
+            soft.mask[i] = (p >> 24) >= 128 ? 255 : 0;
+    }
+    return soft;
+}
+
+namespace {
+
+enum class ImageFormat { OTHER, PNG, JPEG, GIF };
+
+ImageFormat FormatOf(const std::string &path)
+{
+    std::string lowered = path;
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), ::tolower);
+
+    if (lowered.find(".png") != std::string::npos)
+        return ImageFormat::PNG;
+    if (lowered.find(".jpg") != std::string::npos || lowered.find(".jpeg") != std::string::npos)
+        return ImageFormat::JPEG;
+    if (lowered.find(".gif") != std::string::npos)
+        return ImageFormat::GIF;
+    return ImageFormat::OTHER;
+}
+
+} // namespace
+
+bool HasRgbaDecoder(const std::string &path)
+{
+    return FormatOf(path) != ImageFormat::OTHER;
+}
+
+int DecodeImageFile(const std::string &path, RgbaImage &image)
+{
+    switch (FormatOf(path))
+    {
+    case ImageFormat::PNG:
+        return DecodePNG(path.c_str(), image);
+    case ImageFormat::JPEG:
+        return DecodeJPEG(path.c_str(), image);
+    case ImageFormat::GIF:
+        return DecodeGIF(path.c_str(), image);
+    default:
+        return 1;
+    }
+}
+
+/****
+ * DecodePNG:  Any PNG (palette, grey, 16 bit, tRNS) to premultiplied RGBA,
+ *  with baked-in checkered backgrounds keyed out.
+ ****/
+int DecodePNG(const char* file_name, RgbaImage &image)
+{
+#ifdef HAVE_PNG
+    if (file_name == nullptr)
+        return 1;
+
+    FILE *fp = fopen(file_name, "rb");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "DecodePNG: Cannot open file %s\n", file_name);
+        return 1;
+    }
+
+    png_byte header[8];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) ||
+        png_sig_cmp(header, 0, sizeof(header)))
+    {
+        fprintf(stderr, "DecodePNG: File %s is not a valid PNG\n", file_name);
+        fclose(fp);
+        return 1;
+    }
+
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info_ptr = png_ptr ? png_create_info_struct(png_ptr) : nullptr;
+    if (info_ptr == nullptr)
+    {
+        fprintf(stderr, "DecodePNG: Cannot create PNG read structs\n");
+        png_destroy_read_struct(&png_ptr, nullptr, nullptr);
+        fclose(fp);
+        return 1;
+    }
+
+    // Heap allocated before setjmp: locals changed after it are
+    // indeterminate once libpng longjmps back
+    struct Rows {
+        std::vector<png_byte> data;
+        std::vector<png_bytep> pointers;
+    };
+    auto buffers = std::make_unique<Rows>();
+    if (setjmp(png_jmpbuf(png_ptr)))
+    {
+        fprintf(stderr, "DecodePNG: PNG read error in %s\n", file_name);
+        png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+        fclose(fp);
+        return 1;
+    }
+
+    png_init_io(png_ptr, fp);
+    png_set_sig_bytes(png_ptr, 8);
+    png_read_info(png_ptr, info_ptr);
+
+    const int width = static_cast<int>(png_get_image_width(png_ptr, info_ptr));
+    const int height = static_cast<int>(png_get_image_height(png_ptr, info_ptr));
+    const png_byte color_type = png_get_color_type(png_ptr, info_ptr);
+    const png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    if (width <= 0 || height <= 0 || width > MAX_DECODE_DIMENSION || height > MAX_DECODE_DIMENSION)
+    {
+        fprintf(stderr, "DecodePNG: %s is %dx%d, too large\n", file_name, width, height);
+        png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+        fclose(fp);
+        return 1;
+    }
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png_ptr);
+    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png_ptr);
+    if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+        png_set_tRNS_to_alpha(png_ptr);
+    if (bit_depth == 16)
+        png_set_strip_16(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+
+    const int channels = png_get_channels(png_ptr, info_ptr);
+    const size_t rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    buffers->data.resize(rowbytes * static_cast<size_t>(height));
+    buffers->pointers.resize(static_cast<size_t>(height));
+    for (int y = 0; y < height; ++y)
+        buffers->pointers[y] = buffers->data.data() + rowbytes * static_cast<size_t>(y);
+    png_read_image(png_ptr, buffers->pointers.data());
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+    fclose(fp);
+
+    if (channels != 3 && channels != 4)
+    {
+        fprintf(stderr, "DecodePNG: %s has %d channels after expansion\n", file_name, channels);
+        return 1;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.has_alpha = (channels == 4);
+    image.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    for (int y = 0; y < height; ++y)
+    {
+        uint32_t *dst = image.pixels.data() + static_cast<size_t>(y) * width;
+        if (channels == 4)
+            PackRGBARow(buffers->pointers[y], dst, width);
+        else
+            PackRGBRow(buffers->pointers[y], dst, width);
+    }
+
+    const int keyed = KeyCheckeredBackground(image);
+    if (keyed > 0)
+        fprintf(stderr, "DecodePNG: Removed checkered background from %s (%d pixels)\n",
+                file_name, keyed);
+    Premultiply(image);
+    return 0;
+#else
+    fprintf(stderr, "PNG support not available - please install libpng-dev (%s)\n",
+            file_name ? file_name : "");
+    (void)image;
+    return 1;
+#endif
+}
+
+int DecodeJPEG(const char* file_name, RgbaImage &image)
+{
+#ifdef HAVE_JPEG
+    if (file_name == nullptr)
+        return 1;
+    FILE *fp = fopen(file_name, "rb");
+    if (fp == nullptr)
+        return 1;
+
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, fp);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;  // libjpeg converts greyscale for us
+    jpeg_start_decompress(&cinfo);
+
+    const int width = static_cast<int>(cinfo.output_width);
+    const int height = static_cast<int>(cinfo.output_height);
+    int result = 1;
+    if (cinfo.output_components == 3 && width > 0 && height > 0 &&
+        width <= MAX_DECODE_DIMENSION && height <= MAX_DECODE_DIMENSION)
+    {
+        image.width = width;
+        image.height = height;
+        image.has_alpha = false;
+        image.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+        std::vector<JSAMPLE> row(static_cast<size_t>(width) * 3);
+        JSAMPROW row_ptr = row.data();
+        while (cinfo.output_scanline < cinfo.output_height)
+        {
+            const int y = static_cast<int>(cinfo.output_scanline);
+            jpeg_read_scanlines(&cinfo, &row_ptr, 1);
+            PackRGBRow(row.data(), image.pixels.data() + static_cast<size_t>(y) * width, width);
+        }
+        result = 0;
+    }
+    else
+    {
+        fprintf(stderr, "DecodeJPEG: Unsupported JPEG %s (%dx%d, %d components)\n",
+                file_name, width, height, cinfo.output_components);
+        jpeg_abort_decompress(&cinfo);
+    }
+
+    if (result == 0)
+        jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(fp);
+    return result;
+#else
+    fprintf(stderr, "JPEG support not available - please install libjpeg-dev (%s)\n",
+            file_name ? file_name : "");
+    (void)image;
+    return 1;
+#endif
+}
+
+int DecodeGIF(const char* file_name, RgbaImage &image)
+{
+#ifdef HAVE_GIF
+    if (file_name == nullptr)
+        return 1;
+
+    // Only the first frame is used
+    GifFileType *gif = DGifOpenFileName(file_name, nullptr);
+    if (gif == nullptr)
+        return 1;
+    if (DGifSlurp(gif) != GIF_OK || gif->ImageCount == 0)
+    {
+        DGifCloseFile(gif, nullptr);
+        return 1;
+    }
+
+    SavedImage *frame = &gif->SavedImages[0];
+    const GifImageDesc *desc = &frame->ImageDesc;
+    const ColorMapObject *color_map = desc->ColorMap ? desc->ColorMap : gif->SColorMap;
+    const int width = desc->Width;
+    const int height = desc->Height;
+    if (color_map == nullptr || width <= 0 || height <= 0 ||
+        width > MAX_DECODE_DIMENSION || height > MAX_DECODE_DIMENSION)
+    {
+        DGifCloseFile(gif, nullptr);
+        return 1;
+    }
+
+    // Indexed lookup through a packed palette
+    std::vector<uint32_t> palette(256, 0xFF000000u);
+    for (int i = 0; i < color_map->ColorCount && i < 256; ++i)
+    {
+        const GifColorType &c = color_map->Colors[i];
+        palette[i] = 0xFF000000u | (static_cast<uint32_t>(c.Red) << 16) |
+                     (static_cast<uint32_t>(c.Green) << 8) | c.Blue;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.has_alpha = false;
+    image.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    const GifPixelType *raster = frame->RasterBits;
+    for (size_t i = 0; i < image.pixels.size(); ++i)
+        image.pixels[i] = palette[raster[i]];
+
+    DGifCloseFile(gif, nullptr);
+    return 0;
+#else
+    fprintf(stderr, "GIF support not available - please install libgif-dev (%s)\n",
+            file_name ? file_name : "");
+    (void)image;
+    return 1;
+#endif
+}
+
+} // namespace vt
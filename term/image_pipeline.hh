@@ -0,0 +1,100 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * image_pipeline.hh - Raw RGBA decode, scaling and keying for vt_term images
+ * No X dependencies; term_view.cc uploads the result with one XPutImage()
+ */
+
+#ifndef VT_IMAGE_PIPELINE_HH
+#define VT_IMAGE_PIPELINE_HH
+
+#include "soft_canvas.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief A decoded image as 0xAARRGGBB words.
+ *
+ * Decoders return premultiplied alpha, which is what ScaleImage() expects:
+ * filtering premultiplied pixels keeps transparent neighbours from bleeding
+ * their (meaningless) colour into the edges.
+ */
+struct RgbaImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+    bool has_alpha = false;  // some pixel may be less than fully opaque
+
+    [[nodiscard]] bool Valid() const noexcept
+    {
+        return width > 0 && height > 0 &&
+               pixels.size() == static_cast<size_t>(width) * static_cast<size_t>(height);
+    }
+};
+
+// Larger files are refused rather than allocated
+constexpr int MAX_DECODE_DIMENSION = 8192;
+
+// "sse2", "neon" or "scalar": the kernels this build uses
+const char* ImagePipelineBackend() noexcept;
+
+// Straight 8 bit RGB/RGBA bytes to straight 0xAARRGGBB
+void PackRGBRow(const uint8_t *src, uint32_t *dst, int count) noexcept;
+void PackRGBARow(const uint8_t *src, uint32_t *dst, int count) noexcept;
+
+void Premultiply(RgbaImage &image) noexcept;
+[[nodiscard]] uint32_t Unpremultiply(uint32_t pixel) noexcept;
+
+/**
+ * @brief Makes the light grey/white squares of a "transparent" checkerboard
+ * that was baked into an image transparent.
+ *
+ * Works on straight (not premultiplied) alpha.  Returns the number of pixels
+ * keyed out, 0 if no checkered background was detected.
+ */
+int KeyCheckeredBackground(RgbaImage &image);
+
+/**
+ * @brief Resamples a premultiplied image to dw x dh.
+ *
+ * Shrinking averages the covered source area (box filter); enlarging is
+ * bilinear.  Separable, 14 bit fixed point, with SSE2/NEON kernels where
+ * available.
+ */
+RgbaImage ScaleImage(const RgbaImage &src, int dw, int dh);
+// The old per-pixel nearest-neighbour scaler, kept as a benchmark baseline
+RgbaImage ScaleNearest(const RgbaImage &src, int dw, int dh);
+
+// Unpremultiplied 0x00RRGGBB plus a mask where alpha >= 128 (no mask if opaque)
+SoftImage ToSoftImage(const RgbaImage &image);
+
+// True for the extensions DecodeImageFile() handles (even if this build
+// lacks the library, so the caller reports it rather than trying libXpm)
+[[nodiscard]] bool HasRgbaDecoder(const std::string &path);
+// Decode by file extension (.png, .jpg/.jpeg, .gif); 0 on success.
+// Returns 1 for other extensions and for formats this build lacks.
+int DecodeImageFile(const std::string &path, RgbaImage &image);
+int DecodePNG(const char* file_name, RgbaImage &image);
+int DecodeJPEG(const char* file_name, RgbaImage &image);
+int DecodeGIF(const char* file_name, RgbaImage &image);
+
+} // namespace vt
+
+#endif // VT_IMAGE_PIPELINE_HH
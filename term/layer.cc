@@ -12,6 +12,9 @@
 #include <cstring>
 #include <string>
 #include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <numeric>
 #include <vector>
 #include <unistd.h>
 
@@ -25,6 +28,54 @@
 #include <dmalloc.h>
 #endif
 
+namespace
+{
+int IsRectShape(int shape) noexcept
+{
+    return shape < SHAPE_DIAMOND || shape > SHAPE_TRIANGLE;
+}
+
+// The sand/parchment texture Layer::DrawZone() puts between two frames
+int ZoneEdgeTexture(int zone_frame) noexcept
+{
+    switch (zone_frame)
+    {
+    case ZF_SAND_BORDER:
+    case ZF_DOUBLE_BORDER:      return IMAGE_SAND;
+    case ZF_LIT_SAND_BORDER:
+    case ZF_LIT_DOUBLE_BORDER:  return IMAGE_LIT_SAND;
+    case ZF_INSET_BORDER:       return IMAGE_DARK_SAND;
+    case ZF_PARCHMENT_BORDER:   return IMAGE_PARCHMENT;
+    default:                    return -1;
+    }
+}
+
+/****
+ * AddTexturePhase:  Appends where (lx, ly) falls within the texture tiles
+ *  to a ZoneCache look, so a cached zone is only reused where its
+ *  textures would line up the same way.  Negative ids are skipped.
+ ****/
+void AddTexturePhase(std::string &look, int lx, int ly, std::initializer_list<int> textures)
+{
+    int period_x = 1;
+    int period_y = 1;
+    for (int texture : textures)
+    {
+        if (texture < 0 || texture == IMAGE_CLEAR)
+            continue;
+        if (texture >= IMAGE_COUNT)
+            texture = IMAGE_DARK_SAND;  // what GetTexture() falls back to
+        int tw = 0, th = 0;
+        if (sscanf(ImageData[texture][0], "%d %d", &tw, &th) != 2 || tw <= 0 || th <= 0)
+            continue;
+        period_x = std::lcm(period_x, tw);
+        period_y = std::lcm(period_y, th);
+    }
+    look += "@" + std::to_string(((lx % period_x) + period_x) % period_x) +
+            "," + std::to_string(((ly % period_y) + period_y) % period_y);
+}
+} // namespace
+
 /**** Layer Class ****/
 // Constructor
 Layer::Layer(Display *d, GC g, Window draw_win, int lw, int lh)
@@ -58,9 +109,12 @@ Layer::Layer(Display *d, GC g, Window draw_win, int lw, int lh)
     title_mode   = 0;
     bg_texture   = IMAGE_DARK_SAND;
     use_clip = 0;
+    mask_pass = 0;
     cursor = CURSOR_POINTER;
 
     xftdraw = XftDrawCreate(dis, pix, DefaultVisual(dis, no), DefaultColormap(dis, no));
+    if (SoftRendering)
+        canvas = std::make_unique<vt::SoftCanvas>(lw, lh);
 }
 
 // Destructor
@@ -104,6 +158,10 @@ Layer::Layer(Layer&& other) noexcept
     , page_title(other.page_title)
     , buttons(std::move(other.buttons))
     , xftdraw(other.xftdraw)
+    , canvas(std::move(other.canvas))
+    , damage(std::move(other.damage))
+    , mask_pass(other.mask_pass)
+    , press_looks(std::move(other.press_looks))
 {
     // Transfer ownership of resources
     other.pix = 0;
@@ -156,6 +214,10 @@ Layer& Layer::operator=(Layer&& other) noexcept
         page_title = other.page_title;
         buttons = std::move(other.buttons);
         xftdraw = other.xftdraw;
+        canvas = std::move(other.canvas);
+        damage = std::move(other.damage);
+        mask_pass = other.mask_pass;
+        press_looks = std::move(other.press_looks);
         
         // Transfer ownership of resources
         other.pix = 0;
@@ -171,6 +233,29 @@ int Layer::DrawArea(int dx, int dy, int dw, int dh)
 {
     FnTrace("Layer::DrawArea()");
 
+    if (canvas)
+    {
+        // Clamp to the canvas; XPutImage() doesn't clip against the source
+        RegionInfo r(0, 0, canvas->Width(), canvas->Height());
+        r.Intersect(dx, dy, dw, dh);
+        if (r.w <= 0 || r.h <= 0)
+            return 0;
+
+        int no = DefaultScreen(dis);
+        XImage *image = XCreateImage(dis, DefaultVisual(dis, no), DefaultDepth(dis, no),
+                                     ZPixmap, 0, reinterpret_cast<char*>(canvas->Pixels()),
+                                     canvas->Width(), canvas->Height(), 32,
+                                     canvas->Width() * 4);
+        if (image == nullptr)
+            return 1;
+        // The pixels are native uint32_t; Xlib swaps if the server differs
+        image->byte_order = (std::endian::native == std::endian::little) ? LSBFirst : MSBFirst;
+        XPutImage(dis, win, gfx, image, r.x, r.y, r.x + x, r.y + y, r.w, r.h);
+        image->data = nullptr;  // owned by canvas
+        XDestroyImage(image);
+        return 0;
+    }
+
     XCopyArea(dis, pix, win, gfx, dx, dy, dw, dh, dx + x, dy + y);
     return 0;
 }
@@ -295,9 +380,7 @@ int Layer::BlankPage(int mode, int texture, int tc, int size, int split,
         }
         if (!so)
         {
-            XSetForeground(dis, gfx, ColorTE);
-            XFillRectangle(dis, pix, gfx, page_x, page_y + page_h - page_split,
-                           page_w, 2);
+            PaintRect(page_x, page_y + page_h - page_split, page_w, 2, FillSolid, ColorTE);
             Rectangle(0, page_h - page_split + 2, page_w, page_split - 2,
                       IMAGE_DARK_SAND);
         }
@@ -316,18 +399,15 @@ int Layer::BlankPage(int mode, int texture, int tc, int size, int split,
 
     if (page_w < w || page_h < h)
     {
-        XSetForeground(dis, gfx, ColorBlack);
         if (page_y > 0)
         {
-            XFillRectangle(dis, pix, gfx, 0, 0, w, page_y);
-            XFillRectangle(dis, pix, gfx, 0, page_y + page_h, w,
-                           h - (page_y + page_h));
+            PaintRect(0, 0, w, page_y, FillSolid, ColorBlack);
+            PaintRect(0, page_y + page_h, w, h - (page_y + page_h), FillSolid, ColorBlack);
         }
         if (page_x > 0)
         {
-            XFillRectangle(dis, pix, gfx, 0, page_y, page_x, page_h);
-            XFillRectangle(dis, pix, gfx, page_x + page_w, page_y,
-                           w - (page_x + page_w), page_h);
+            PaintRect(0, page_y, page_x, page_h, FillSolid, ColorBlack);
+            PaintRect(page_x + page_w, page_y, w - (page_x + page_w), page_h, FillSolid, ColorBlack);
         }
     }
     TitleBar();
@@ -354,8 +434,7 @@ int Layer::Background(int bx, int by, int bw, int bh)
         r.Intersect(bx, by, bw, bh);
         if (r.w > 0 && r.h > 0)
         {
-            XSetForeground(dis, gfx, ColorTE);
-            XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
+            PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillSolid, ColorTE);
         }
 
         r.SetRegion(0, page_h - page_split + 2, page_w, page_split - 2);
@@ -385,27 +464,26 @@ int Layer::Background(int bx, int by, int bw, int bh)
     {
         bx += page_x;
         by += page_y;
-        XSetForeground(dis, gfx, ColorBlack);
 
         tr.SetRegion(0, 0, w, page_y);
         tr.Intersect(bx, by, bw, bh);
         if (tr.w > 0 && tr.h > 0)
-            XFillRectangle(dis, pix, gfx, tr.x, tr.y, tr.w, tr.h);
+            PaintRect(tr.x, tr.y, tr.w, tr.h, FillSolid, ColorBlack);
 
         tr.SetRegion(0, page_y + page_h, w, h - (page_y + page_h));
         tr.Intersect(bx, by, bw, bh);
         if (tr.w > 0 && tr.h > 0)
-            XFillRectangle(dis, pix, gfx, tr.x, tr.y, tr.w, tr.h);
+            PaintRect(tr.x, tr.y, tr.w, tr.h, FillSolid, ColorBlack);
 
         tr.SetRegion(0, page_y, page_x, page_h);
         tr.Intersect(bx, by, bw, bh);
         if (tr.w > 0 && tr.h > 0)
-            XFillRectangle(dis, pix, gfx, tr.x, tr.y, tr.w, tr.h);
+            PaintRect(tr.x, tr.y, tr.w, tr.h, FillSolid, ColorBlack);
 
         tr.SetRegion(page_x + page_w, page_y, w - (page_x + page_w), page_h);
         tr.Intersect(bx, by, bw, bh);
         if (tr.w > 0 && tr.h > 0)
-            XFillRectangle(dis, pix, gfx, tr.x, tr.y, tr.w, tr.h);
+            PaintRect(tr.x, tr.y, tr.w, tr.h, FillSolid, ColorBlack);
     }
     return 0;
 }
@@ -417,18 +495,11 @@ int Layer::TitleBar()
     int tc = title_color;
     if (tc != COLOR_CLEAR)
     {
-        XSetForeground(dis, gfx, ColorTextH[tc]);
-        XFillRectangle(dis, pix, gfx, page_x, page_y, page_w, 2);
-        XFillRectangle(dis, pix, gfx, page_x, page_y + 2, 2,
-                       title_height - 4);
-        XSetForeground(dis, gfx, ColorTextT[tc]);
-        XFillRectangle(dis, pix, gfx, page_x + 2, page_y + 2, page_w - 4,
-                       title_height - 4);
-        XSetForeground(dis, gfx, ColorTextS[tc]);
-        XFillRectangle(dis, pix, gfx, page_x, page_y + title_height - 2,
-                       page_w, 2);
-        XFillRectangle(dis, pix, gfx, page_x + page_w - 2, page_y + 2, 2,
-                       title_height - 4);
+        PaintRect(page_x, page_y, page_w, 2, FillSolid, ColorTextH[tc]);
+        PaintRect(page_x, page_y + 2, 2, title_height - 4, FillSolid, ColorTextH[tc]);
+        PaintRect(page_x + 2, page_y + 2, page_w - 4, title_height - 4, FillSolid, ColorTextT[tc]);
+        PaintRect(page_x, page_y + title_height - 2, page_w, 2, FillSolid, ColorTextS[tc]);
+        PaintRect(page_x + page_w - 2, page_y + 2, 2, title_height - 4, FillSolid, ColorTextS[tc]);
     }
 
     int c1 = COLOR_WHITE, c2 = COLOR_YELLOW;
@@ -505,13 +576,27 @@ int Layer::Text(const char* string, int len, int tx, int ty, int c, int font,
         return 1;
     }
 
-    // Alignment logic can be improved with XftTextExtentsUtf8
-    int tw = 0;
-    if (xftfont) {
-        XGlyphInfo extents;
-        XftTextExtentsUtf8(dis, xftfont, reinterpret_cast<const FcChar8*>(string), len, &extents);
-        tw = extents.xOff;
+    if (canvas)
+    {
+        // FreeType straight into the canvas; embossing and shadows are
+        // X-only effects and are drawn as plain text here
+        vt::SoftFont *soft_font = GetSoftFont(f);
+        if (soft_font == nullptr)
+            return 1;
+        int sw = soft_font->TextWidth(string, len);
+        if (align == ALIGN_CENTER)
+            tx -= (sw + 1) / 2;
+        else if (align == ALIGN_RIGHT)
+            tx -= sw;
+        int pixel = (c >= 0 && c < TEXT_COLORS) ? ColorTextT[c] : ColorBlack;
+        canvas->DrawText(*soft_font, tx + page_x, ty + page_y + soft_font->Ascent(),
+                         string, len, static_cast<uint32_t>(pixel));
+        return 0;
     }
+
+    int tw = 0;
+    if (xftfont)
+        tw = GetTextWidth(f, string, len);
     if (align == ALIGN_CENTER)
     {
         tx -= (tw + 1) / 2;
@@ -544,10 +629,6 @@ int Layer::ZoneText(const char* str, int tx, int ty, int tw, int th,
 {
     FnTrace("Layer::ZoneText()");
 
-    const genericChar* sub_string[64];  // FIX - should allow any number of lines of text
-    int   sub_length[64];
-    int i;
-
     int f = font & 31;
     XftFont *xftfont = GetXftFontInfo(f);
     int font_h = 0;
@@ -561,99 +642,11 @@ int Layer::ZoneText(const char* str, int tx, int ty, int tw, int th,
     }
     
     int max_lines = th / font_h;
-    if (max_lines > 63)
-        max_lines = 63;
 
-    int line = 0;
-    const genericChar* c = str;
-    while (line < max_lines)
-    {
-        if (*c == '\0')
-            break;
-        int len = 0;
-        while (c[len] != '\0' && c[len] != '\\')
-            ++len;
-
-        while (line < max_lines)
-        {
-            sub_string[line] = c;
-            
-            // Use Xft for text width measurement
-            int text_width = 0;
-            if (xftfont) {
-                XGlyphInfo extents;
-                XftTextExtentsUtf8(dis, xftfont, reinterpret_cast<const FcChar8*>(c), len, &extents);
-                text_width = extents.xOff;
-            } else {
-                // Fallback to old method
-                XFontStruct *font_info = GetFontInfo(f);
-                text_width = XTextWidth(font_info, c, len);
-            }
-            
-            if (text_width <= tw)
-            {
-                sub_length[line] = len;
-                c += len;
-                while (isspace(*c))
-                    ++c;
-                if (*c == '\\')
-                    ++c;
-                while (isspace(*c))
-                    ++c;
-                ++line;
-                break;
-            }
-            // Find breaks in name that fit
-            int lw;
-            for (lw = len; lw > 0; --lw)
-            {
-                int lw_width = 0;
-                if (xftfont) {
-                    XGlyphInfo extents;
-                    XftTextExtentsUtf8(dis, xftfont, reinterpret_cast<const FcChar8*>(c), lw, &extents);
-                    lw_width = extents.xOff;
-                } else {
-                    XFontStruct *font_info = GetFontInfo(f);
-                    lw_width = XTextWidth(font_info, c, lw);
-                }
-                
-                if (isspace(c[lw]) && !isspace(c[lw-1]) && (lw_width <= tw))
-                {
-                    break;
-                }
-            }
-            if (lw <= 0)
-            {
-                // Truncate name
-                for (lw = len; lw > 1; --lw)
-                {
-                    int lw_width = 0;
-                    if (xftfont) {
-                        XGlyphInfo extents;
-                        XftTextExtentsUtf8(dis, xftfont, reinterpret_cast<const FcChar8*>(c), lw, &extents);
-                        lw_width = extents.xOff;
-                    } else {
-                        XFontStruct *font_info = GetFontInfo(f);
-                        lw_width = XTextWidth(font_info, c, lw);
-                    }
-                    
-                    if (lw_width <= tw)
-                        break;
-                }
-            }
-
-            sub_length[line] = lw;
-            c   += lw;
-            len -= lw;
-            while (isspace(*c))
-                ++c, --len;
-            if (*c == '\\')
-                ++c, --len;
-            while (isspace(*c))
-                ++c, --len;
-            ++line;
-        }
-    }
+    // Line breaks and widths come from TextMetrics, so redrawing the same
+    // labels doesn't measure them with Xft again
+    const vt::TextLayout &layout = GetTextLayout(f, str, tw, max_lines);
+    int line = static_cast<int>(layout.lines.size());
 
     int sx = tx, sy = ty + ((th - (line * font_h)) / 2);
     if (align == ALIGN_CENTER)
@@ -665,13 +658,13 @@ int Layer::ZoneText(const char* str, int tx, int ty, int tw, int th,
         sx += tw;
     }
 
-    for (i = 0; i < line; ++i)
+    for (const vt::TextLine &sub : layout.lines)
     {
-        if (sub_length[i] > 0)
-            Text(sub_string[i], sub_length[i], sx, sy, color, font, align, 0, embossed);
+        if (sub.length > 0)
+            Text(str + sub.offset, sub.length, sx, sy, color, font, align, 0, embossed);
         sy += font_h;
     }
-    if (*c && line >= max_lines && title_mode == ToInt(OperationMode::OpEdit))
+    if (layout.overflow && title_mode == ToInt(OperationMode::OpEdit))
         Text("!", 1, tx, ty, COLOR_RED, FONT_TIMES_24, ALIGN_LEFT, 0, embossed);
     return 0;
 }
@@ -689,15 +682,16 @@ int Layer::Rectangle(int rx, int ry, int rw, int rh, int image)
 
     if (r.w > 0 && r.h > 0)
     {
-        XSetTSOrigin(dis, gfx, page_x, page_y);
-        XSetTile(dis, gfx, GetTexture(image));
-        XSetFillStyle(dis, gfx, FillTiled);
-        XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillTiled, image);
     }
     return 0;
 }
 
+/****
+ * DrawPixmap:  Draws an image file scaled to rw x rh.  The decoded and
+ *  scaled image comes from PixmapCache, so redrawing a page of button
+ *  images costs a stat() and an XCopyArea() per image.
+ ****/
 int Layer::DrawPixmap(int rx, int ry, int rw, int rh, const char* filename)
 {
     FnTrace("Layer::DrawPixmap()");
@@ -705,233 +699,41 @@ int Layer::DrawPixmap(int rx, int ry, int rw, int rh, const char* filename)
     if (filename == nullptr || filename[0] == '\0' || rw <= 0 || rh <= 0)
         return 0;
 
-    auto load_image = [&](const std::string& path) -> Xpm*
-    {
-        std::string lowered = path;
-        std::transform(lowered.begin(), lowered.end(), lowered.begin(), ::tolower);
-
-        if (lowered.find(".png") != std::string::npos)
-        {
-#ifdef HAVE_PNG
-            return LoadPNGFile(path.c_str());
-#else
-            fprintf(stderr, "PNG support not available - please install libpng-dev\n");
-            return nullptr;
-#endif
-        }
-        else if (lowered.find(".jpg") != std::string::npos || lowered.find(".jpeg") != std::string::npos)
-        {
-#ifdef HAVE_JPEG
-            return LoadJPEGFile(path.c_str());
-#else
-            fprintf(stderr, "JPEG support not available - please install libjpeg-dev\n");
-            return nullptr;
-#endif
-        }
-        else if (lowered.find(".gif") != std::string::npos)
-        {
-#ifdef HAVE_GIF
-            return LoadGIFFile(path.c_str());
-#else
-            fprintf(stderr, "GIF support not available - please install libgif-dev\n");
-            return nullptr;
-#endif
-        }
-        else
-        {
-            std::vector<char> mutable_path(path.begin(), path.end());
-            mutable_path.push_back('\0');
-            return LoadPixmapFile(mutable_path.data());
-        }
-    };
+    RegionInfo r(rx, ry, rw, rh);
+    if (use_clip)
+        r.Intersect(clip);
+    if (r.w <= 0 || r.h <= 0)
+        return 0;
 
-    std::string resolved_path;
-    Xpm *xpm = nullptr;
+    const vt::CachedImage *image = GetCachedImage(filename, rw, rh);
+    if (image == nullptr)
+        return 0;
 
-    if (filename[0] == '/')
+    if (canvas)
     {
-        resolved_path = filename;
-        xpm = load_image(resolved_path);
+        // the canvas clip is already set to clip
+        canvas->DrawImage(*image->soft, page_x + rx, page_y + ry, rw, rh);
+        return 0;
     }
-    else
-    {
-        resolved_path = std::string(VIEWTOUCH_PATH "/imgs/") + filename;
-        xpm = load_image(resolved_path);
-
-        if (xpm == nullptr)
-        {
-            std::string viewtouch_relative = std::string(VIEWTOUCH_PATH "/") + filename;
-            resolved_path = viewtouch_relative;
-            xpm = load_image(resolved_path);
-        }
 
-        if (xpm == nullptr)
-        {
-            resolved_path = filename;
-            xpm = load_image(resolved_path);
-        }
+    // Copy only the visible part; the mask stays aligned with the whole image
+    if (image->mask)
+    {
+        XSetClipMask(dis, gfx, image->mask);
+        XSetClipOrigin(dis, gfx, page_x + rx, page_y + ry);
     }
 
-    if (xpm == nullptr)
-        return 0;
+    XCopyArea(dis, image->pixmap, pix, gfx, r.x - rx, r.y - ry, r.w, r.h,
+              page_x + r.x, page_y + r.y);
 
-    RegionInfo r(rx, ry, rw, rh);
-    if (use_clip)
-        r.Intersect(clip);
-
-    if (r.w > 0 && r.h > 0)
+    if (image->mask)
     {
-        // Calculate scaling to fit the image within the given dimensions
-        int img_w = xpm->Width();
-        int img_h = xpm->Height();
-
-        if (img_w <= 0 || img_h <= 0)
-            return 0;
-
-        const int draw_w = r.w;
-        const int draw_h = r.h;
-        const int draw_x = page_x + r.x;
-        const int draw_y = page_y + r.y;
-
-        const double inv_scale_x = static_cast<double>(img_w) / static_cast<double>(draw_w);
-        const double inv_scale_y = static_cast<double>(img_h) / static_cast<double>(draw_h);
-
-        // Check if we need to scale the image
-        bool need_scaling = (draw_w != img_w || draw_h != img_h);
-        
-        if (need_scaling)
-        {
-            // Scale both image and mask if present
-            XImage *orig_image = XGetImage(dis, xpm->PixmapID(), 0, 0, img_w, img_h,
-                                          AllPlanes, ZPixmap);
-
-            if (orig_image)
-            {
-                const int bits_per_pixel = orig_image->bits_per_pixel;
-                const int bitmap_pad = orig_image->bitmap_pad;
-                const int bytes_per_line =
-                    ((draw_w * bits_per_pixel + (bitmap_pad - 1)) / bitmap_pad) * (bitmap_pad / 8);
-
-                XImage *scaled_image = XCreateImage(dis, DefaultVisual(dis, DefaultScreen(dis)),
-                                                  orig_image->depth, ZPixmap, 0,
-                                                  static_cast<char*>(malloc(static_cast<size_t>(bytes_per_line) * static_cast<size_t>(draw_h))),
-                                                  draw_w, draw_h, bitmap_pad, bytes_per_line);
-
-                Pixmap scaled_mask = 0;
-                if (scaled_image && scaled_image->data)
-                {
-                    // Scale the image
-                    for (int y = 0; y < draw_h; ++y)
-                    {
-                        for (int x = 0; x < draw_w; ++x)
-                        {
-                            int src_x = static_cast<int>(x * inv_scale_x);
-                            int src_y = static_cast<int>(y * inv_scale_y);
-
-                            if (src_x >= img_w)
-                                src_x = img_w - 1;
-                            if (src_y >= img_h)
-                                src_y = img_h - 1;
-
-                            const unsigned long pixel = XGetPixel(orig_image, src_x, src_y);
-                            XPutPixel(scaled_image, x, y, pixel);
-                        }
-                    }
-
-                    // Scale the mask if present
-                    if (xpm->MaskID())
-                    {
-                        XImage *orig_mask = XGetImage(dis, xpm->MaskID(), 0, 0, img_w, img_h,
-                                                     AllPlanes, XYPixmap);
-                        if (orig_mask)
-                        {
-                            scaled_mask = XCreatePixmap(dis, pix, draw_w, draw_h, 1);
-                            XImage *scaled_mask_img = XCreateImage(dis, DefaultVisual(dis, DefaultScreen(dis)),
-                                                                  1, XYBitmap, 0,
-                                                                  static_cast<char*>(malloc((draw_w + 7) / 8 * draw_h)),
-                                                                  draw_w, draw_h, 8, 0);
-                            if (scaled_mask_img && scaled_mask_img->data)
-                            {
-                                memset(scaled_mask_img->data, 0, (draw_w + 7) / 8 * draw_h);
-                                for (int y = 0; y < draw_h; ++y)
-                                {
-                                    for (int x = 0; x < draw_w; ++x)
-                                    {
-                                        int src_x = static_cast<int>(x * inv_scale_x);
-                                        int src_y = static_cast<int>(y * inv_scale_y);
-                                        if (src_x >= img_w) src_x = img_w - 1;
-                                        if (src_y >= img_h) src_y = img_h - 1;
-                                        
-                                        unsigned long mask_pixel = XGetPixel(orig_mask, src_x, src_y);
-                                        XPutPixel(scaled_mask_img, x, y, mask_pixel);
-                                    }
-                                }
-                                GC mask_gc = XCreateGC(dis, scaled_mask, 0, nullptr);
-                                XPutImage(dis, scaled_mask, mask_gc, scaled_mask_img, 0, 0, 0, 0, draw_w, draw_h);
-                                XFreeGC(dis, mask_gc);
-                                XDestroyImage(scaled_mask_img);
-                            }
-                            XDestroyImage(orig_mask);
-                        }
-                    }
-
-                    // Apply mask if we have one
-                    if (scaled_mask || xpm->MaskID())
-                    {
-                        XSetClipMask(dis, gfx, scaled_mask ? scaled_mask : xpm->MaskID());
-                        XSetClipOrigin(dis, gfx, draw_x, draw_y);
-                    }
-                    
-                    XPutImage(dis, pix, gfx, scaled_image, 0, 0, draw_x, draw_y, draw_w, draw_h);
-                    
-                    // Clear clip mask
-                    if (scaled_mask || xpm->MaskID())
-                    {
-                        XSetClipMask(dis, gfx, None);
-                        XSetClipOrigin(dis, gfx, 0, 0);
-                    }
-                    
-                    if (scaled_mask)
-                        XFreePixmap(dis, scaled_mask);
-                }
-
-                if (scaled_image)
-                {
-                    if (scaled_image->data)
-                        free(scaled_image->data);
-                    scaled_image->data = nullptr;
-                    XDestroyImage(scaled_image);
-                }
-
-                XDestroyImage(orig_image);
-            }
-        }
+        XSetClipOrigin(dis, gfx, 0, 0);
+        if (use_clip)
+            SetClip(clip.x, clip.y, clip.w, clip.h);
         else
-        {
-            // No scaling needed - use XCopyArea with mask
-            if (xpm->MaskID())
-            {
-                XSetClipMask(dis, gfx, xpm->MaskID());
-                XSetClipOrigin(dis, gfx, draw_x, draw_y);
-            }
-            
-            XCopyArea(dis, xpm->PixmapID(), pix, gfx,
-                     0, 0, img_w, img_h,
-                     draw_x, draw_y);
-            
-            // Clear clip mask
-            if (xpm->MaskID())
-            {
-                XSetClipMask(dis, gfx, None);
-                XSetClipOrigin(dis, gfx, 0, 0);
-            }
-        }
+            XSetClipMask(dis, gfx, None);
     }
-
-    // Clean up - remove from PixmapList if it was added there
-    // For now, we'll leak the pixmap since we don't have a good way to manage it
-    // In a full implementation, we'd want proper resource management
-
     return 0;
 }
 
@@ -945,8 +747,7 @@ int Layer::SolidRectangle(int rx, int ry, int rw, int rh, int pixel)
 
     if (r.w > 0 && r.h > 0)
     {
-        XSetForeground(dis, gfx, pixel);
-        XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
+        PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillSolid, pixel);
     }
     return 0;
 }
@@ -958,11 +759,7 @@ int Layer::Circle(int cx, int cy, int cw, int ch, int image)
     if (image == IMAGE_CLEAR)
         return 0;
 
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
-    XFillArc(dis, pix, gfx, page_x + cx, page_y + cy, cw, ch, 0, 360 * 64);
-    XSetFillStyle(dis, gfx, FillSolid);
+    PaintEllipse(page_x + cx, page_y + cy, cw, ch, FillTiled, image);
     return 0;
 }
 
@@ -983,11 +780,7 @@ int Layer::Diamond(int dx, int dy, int dw, int dh, int image)
         {(short)(mid_x-1), far_y},   {(short)dx,      mid_y},
         {(short)dx,      (short)(mid_y-1)}, {(short)(mid_x-1), (short)dy}};
 
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
-    XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-    XSetFillStyle(dis, gfx, FillSolid);
+    PaintPolygon(pts, 8, FillTiled, image);
     return 0;
 }
 
@@ -1016,11 +809,7 @@ int Layer::Hexagon(int hx, int hy, int hw, int hh, int image)
         {quarter_x1, quarter_y1}     // Top-left
     };
 
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
-    XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-    XSetFillStyle(dis, gfx, FillSolid);
+    PaintPolygon(pts, 8, FillTiled, image);
     return 0;
 }
 
@@ -1054,11 +843,7 @@ int Layer::Octagon(int ox, int oy, int ow, int oh, int image)
         pts[i].y = center_y + (short)(radius_y * sin(angle));
     }
 
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
-    XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-    XSetFillStyle(dis, gfx, FillSolid);
+    PaintPolygon(pts, 8, FillTiled, image);
     return 0;
 }
 
@@ -1080,11 +865,7 @@ int Layer::Triangle(int tx, int ty, int tw, int th, int image)
         {static_cast<short>(far_x), static_cast<short>(far_y)}      // Bottom-right
     };
 
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
-    XFillPolygon(dis, pix, gfx, pts, 3, Convex, CoordModeOrigin);
-    XSetFillStyle(dis, gfx, FillSolid);
+    PaintPolygon(pts, 3, FillTiled, image);
     return 0;
 }
 
@@ -1120,35 +901,31 @@ int Layer::Edge(int ex, int ey, int ew, int eh, int thick, int image)
 
     RegionInfo r;
     int h2 = eh - (thick * 2);
-    XSetTSOrigin(dis, gfx, page_x, page_y);
-    XSetTile(dis, gfx, GetTexture(image));
-    XSetFillStyle(dis, gfx, FillTiled);
 
     r.SetRegion(ex, ey, ew, thick);
     if (use_clip)
         r.Intersect(clip);
     if (r.w > 0 && r.h > 0)
-        XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
+        PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillTiled, image);
 
     r.SetRegion(ex, ey + eh - thick, ew, thick);
     if (use_clip)
         r.Intersect(clip);
     if (r.w > 0 && r.h > 0)
-        XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
+        PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillTiled, image);
 
     r.SetRegion(ex, ey + thick, thick, h2);
     if (use_clip)
         r.Intersect(clip);
     if (r.w > 0 && r.h > 0)
-        XFillRectangle(dis, pix, gfx, r.x + page_x, r.y + page_y, r.w, r.h);
+        PaintRect(r.x + page_x, r.y + page_y, r.w, r.h, FillTiled, image);
 
     r.SetRegion(ex + ew - thick, ey + thick, thick, h2);
     if (use_clip)
         r.Intersect(clip);
     if (r.w > 0 && r.h > 0)
-        XFillRectangle(dis, pix, gfx, page_x + r.x, page_y + r.y, r.w, r.h);
+        PaintRect(page_x + r.x, page_y + r.y, r.w, r.h, FillTiled, image);
 
-    XSetFillStyle(dis, gfx, FillSolid);
     return 0;
 }
 
@@ -1216,18 +993,12 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         int cw = fw - (offset * 2) - 1;
         int ch = fh - (offset * 2) - 1;
 
-        XSetLineAttributes(dis, gfx, 3, LineSolid, CapProjecting, JoinMiter);
-        XSetForeground(dis, gfx, r);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch, 320 * 64, 80 * 64);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch, 220 * 64, 20 * 64);
-        XSetForeground(dis, gfx, t);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch,  60 * 64, 80 * 64);
-        XSetForeground(dis, gfx, l);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch, 140 * 64, 80 * 64);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch,  40 * 64, 20 * 64);
-        XSetForeground(dis, gfx, b);
-        XDrawArc(dis, pix, gfx, cx, cy, cw, ch, 240 * 64, 80 * 64);
-        XSetLineAttributes(dis, gfx, 1, LineSolid, CapProjecting, JoinMiter);
+        PaintArc(cx, cy, cw, ch, 320 * 64, 80 * 64, 3, r);
+        PaintArc(cx, cy, cw, ch, 220 * 64, 20 * 64, 3, r);
+        PaintArc(cx, cy, cw, ch, 60 * 64, 80 * 64, 3, t);
+        PaintArc(cx, cy, cw, ch, 140 * 64, 80 * 64, 3, l);
+        PaintArc(cx, cy, cw, ch, 40 * 64, 20 * 64, 3, l);
+        PaintArc(cx, cy, cw, ch, 240 * 64, 80 * 64, 3, b);
     }
     else if (shape == SHAPE_DIAMOND)
     {
@@ -1243,8 +1014,7 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         pts[2].y = far_y - thick;
         pts[3].x = mid_x - 1;
         pts[3].y = far_y;
-        XSetForeground(dis, gfx, l);
-        XFillPolygon(dis, pix, gfx, pts, 4, Convex, CoordModeOrigin);
+        PaintPolygon(pts, 4, FillSolid, l);
 
         pts[0].x = fx;
         pts[0].y = mid_y;
@@ -1254,8 +1024,7 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         pts[2].y = fy + thick;
         pts[3].x = fx + thick;
         pts[3].y = mid_y;
-        XSetForeground(dis, gfx, t);
-        XFillPolygon(dis, pix, gfx, pts, 4, Convex, CoordModeOrigin);
+        PaintPolygon(pts, 4, FillSolid, t);
 
         pts[0].x = mid_x;
         pts[0].y = fy;
@@ -1265,8 +1034,7 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         pts[2].y = mid_y;
         pts[3].x = mid_x;
         pts[3].y = fy + thick;
-        XSetForeground(dis, gfx, r);
-        XFillPolygon(dis, pix, gfx, pts, 4, Convex, CoordModeOrigin);
+        PaintPolygon(pts, 4, FillSolid, r);
 
         pts[0].x = mid_x;
         pts[0].y = far_y;
@@ -1276,8 +1044,7 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         pts[2].y = mid_y;
         pts[3].x = far_x;
         pts[3].y = mid_y;
-        XSetForeground(dis, gfx, b);
-        XFillPolygon(dis, pix, gfx, pts, 4, Convex, CoordModeOrigin);
+        PaintPolygon(pts, 4, FillSolid, b);
     }
     else if (shape == SHAPE_TRIANGLE)
     {
@@ -1287,35 +1054,31 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         rg.SetRegion(fx, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, l);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, l);
         }
 
         rg.SetRegion(fx + fw - thick, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, r);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, r);
         }
 
-        XSetForeground(dis, gfx, t);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + i;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, t);
         }
 
-        XSetForeground(dis, gfx, b);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + fh - i - 1;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, b);
         }
     }
     else if (shape == SHAPE_HEXAGON || shape == SHAPE_OCTAGON)
@@ -1326,35 +1089,31 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         rg.SetRegion(fx, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, l);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, l);
         }
 
         rg.SetRegion(fx + fw - thick, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, r);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, r);
         }
 
-        XSetForeground(dis, gfx, t);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + i;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, t);
         }
 
-        XSetForeground(dis, gfx, b);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + fh - i - 1;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, b);
         }
     }
     else
@@ -1364,35 +1123,31 @@ int Layer::Frame(int fx, int fy, int fw, int fh, int thick, int flags)
         rg.SetRegion(fx, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, l);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, l);
         }
 
         rg.SetRegion(fx + fw - thick, fy, thick, fh);
         if (rg.w > 0 && rg.h > 0)
         {
-            XSetForeground(dis, gfx, r);
-            XFillRectangle(dis, pix, gfx, rg.x, rg.y, rg.w, rg.h);
+            PaintRect(rg.x, rg.y, rg.w, rg.h, FillSolid, r);
         }
 
-        XSetForeground(dis, gfx, t);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + i;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, t);
         }
 
-        XSetForeground(dis, gfx, b);
         for (i = 0; i < thick; ++i)
         {
             int yy = fy + fh - i - 1;
             int x1 = fx + i;
             int x2 = fx + fw - i - 2;
             if (x2 >= x1)
-                XDrawLine(dis, pix, gfx, x1, yy, x2, yy);
+                PaintLine(x1, yy, x2, yy, b);
         }
     }
     return 0;
@@ -1404,8 +1159,20 @@ int Layer::FilledFrame(int fx, int fy, int fw, int fh, int ww,
     FnTrace("Layer::FilledFrame()");
 
     int ww2 = ww * 2;
-    Shape(fx + ww, fy + ww, fw - ww2, fh - ww2, texture, flags & 7);
-    Frame(fx, fy, fw, fh, ww, flags);
+    auto draw = [&]() {
+        Shape(fx + ww, fy + ww, fw - ww2, fh - ww2, texture, flags & 7);
+        Frame(fx, fy, fw, fh, ww, flags);
+    };
+
+    const int rect = IsRectShape(flags & 7);
+    const int opaque = rect && texture != IMAGE_CLEAR && fw > ww2 && fh > ww2;
+    std::string look = "filledframe," + std::to_string(ww) + "," + std::to_string(texture) +
+                       "," + std::to_string(flags);
+    AddTexturePhase(look, fx, fy, {texture});
+    if (CachedLook(look, fx, fy, fw, fh, rect ? 0 : 2, opaque, draw) == 0)
+        return 0;
+
+    draw();
     return 0;
 }
 
@@ -1415,9 +1182,7 @@ int Layer::StatusBar(int sx, int sy, int sw, int sh, int bar_color,
     FnTrace("Layer::StatusBar()");
 
     Frame(sx, sy, sw, sh, 2, FRAME_2COLOR);
-    XSetForeground(dis, gfx, ColorTextT[bar_color]);
-    XFillRectangle(dis, pix, gfx, page_x + sx + 2,
-                   page_y + sy + 2, sw - 4, sh - 4);
+    PaintRect(page_x + sx + 2, page_y + sy + 2, sw - 4, sh - 4, FillSolid, ColorTextT[bar_color]);
     auto len = strlen(text);
     if (len > 0)
         Text(text, len, x + sx + (sw / 2), y + sy + ((sh - GetFontHeight(font) + 1) / 2),
@@ -1433,14 +1198,11 @@ int Layer::HLine(int lx, int ly, int len, int ww, int color)
     ly += page_y;
 
     int w1 = ww / 2, w2 = ww - w1;
-    XSetForeground(dis, gfx, ColorTextH[color]);
-    XDrawLine(dis, pix, gfx, lx, ly - w1 - 1, lx + len - 1, ly - w1 - 1);
+    PaintLine(lx, ly - w1 - 1, lx + len - 1, ly - w1 - 1, ColorTextH[color]);
 
-    XSetForeground(dis, gfx, ColorTextT[color]);
-    XFillRectangle(dis, pix, gfx, lx, ly - w1, len, ww);
+    PaintRect(lx, ly - w1, len, ww, FillSolid, ColorTextT[color]);
 
-    XSetForeground(dis, gfx, ColorTextS[color]);
-    XDrawLine(dis, pix, gfx, lx, ly + w2, lx + len - 1, ly + w2);
+    PaintLine(lx, ly + w2, lx + len - 1, ly + w2, ColorTextS[color]);
     return 0;
 }
 
@@ -1452,14 +1214,11 @@ int Layer::VLine(int lx, int ly, int len, int ww, int color)
     ly += page_y;
 
     int w1 = ww / 2, w2 = ww - w1;
-    XSetForeground(dis, gfx, ColorTextH[color]);
-    XDrawLine(dis, pix, gfx, lx - w1 - 1, ly, lx - w1 - 1, ly + len - 1);
+    PaintLine(lx - w1 - 1, ly, lx - w1 - 1, ly + len - 1, ColorTextH[color]);
 
-    XSetForeground(dis, gfx, ColorTextT[color]);
-    XFillRectangle(dis, pix, gfx, lx - w1, ly, ww, len);
+    PaintRect(lx - w1, ly, ww, len, FillSolid, ColorTextT[color]);
 
-    XSetForeground(dis, gfx, ColorTextS[color]);
-    XDrawLine(dis, pix, gfx, lx + w2, ly, lx + w2, ly + len - 1);
+    PaintLine(lx + w2, ly, lx + w2, ly + len - 1, ColorTextS[color]);
     return 0;
 }
 
@@ -1470,10 +1229,12 @@ int Layer::EditCursor(int ex, int ey, int ew, int eh)
     ex += page_x;
     ey += page_y;
 
-    XSetForeground(dis, gfx, ColorBlack);
-    XDrawRectangle(dis, pix, gfx, ex, ey, ew - 1, eh - 1);
-    XDrawLine(dis, pix, gfx, ex, ey, ex + ew - 1, ey + eh - 1);
-    XDrawLine(dis, pix, gfx, ex, ey + eh - 1, ex + ew - 1, ey);
+    PaintLine(ex, ey, ex + ew - 1, ey, ColorBlack);
+    PaintLine(ex + ew - 1, ey, ex + ew - 1, ey + eh - 1, ColorBlack);
+    PaintLine(ex, ey + eh - 1, ex + ew - 1, ey + eh - 1, ColorBlack);
+    PaintLine(ex, ey, ex, ey + eh - 1, ColorBlack);
+    PaintLine(ex, ey, ex + ew - 1, ey + eh - 1, ColorBlack);
+    PaintLine(ex, ey + eh - 1, ex + ew - 1, ey, ColorBlack);
     return 0;
 }
 
@@ -1481,8 +1242,6 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
 {
     FnTrace("Layer::Shadow()");
 
-    XSetForeground(dis, gfx, ColorBlack);
-    XSetFillStyle(dis, gfx, FillStippled);
     RegionInfo r;
     switch (shape)
     {
@@ -1496,14 +1255,11 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
             {far_x,   mid_y},   {mid_x,   far_y},
             {(short)(mid_x-1), far_y},   {dx,      mid_y},
             {dx,      (short)(mid_y-1)}, {(short)(mid_x-1), dy}};
-        XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintPolygon(pts, 8, FillStippled, ColorBlack);
     }
     break;
     case SHAPE_CIRCLE:
-        XFillArc(dis, pix, gfx, page_x + sx + size,
-                 page_y + sy + size, sw, sh, 0, 360 * 64);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintEllipse(page_x + sx + size, page_y + sy + size, sw, sh, FillStippled, ColorBlack);
         break;
     case SHAPE_HEXAGON:
     {
@@ -1522,8 +1278,7 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
             {dx,      mid_y},            // Left
             {quarter_x1, quarter_y1}     // Top-left
         };
-        XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintPolygon(pts, 8, FillStippled, ColorBlack);
     }
     break;
     case SHAPE_OCTAGON:
@@ -1549,8 +1304,7 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
             pts[i].y = center_y + (short)(radius_y * sin(angle));
         }
 
-        XFillPolygon(dis, pix, gfx, pts, 8, Convex, CoordModeOrigin);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintPolygon(pts, 8, FillStippled, ColorBlack);
     }
     break;
     case SHAPE_TRIANGLE:
@@ -1563,8 +1317,7 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
             {dx,    far_y},     // Bottom-left
             {far_x, far_y}      // Bottom-right
         };
-        XFillPolygon(dis, pix, gfx, pts, 3, Convex, CoordModeOrigin);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintPolygon(pts, 3, FillStippled, ColorBlack);
     }
     break;
     default:
@@ -1572,14 +1325,13 @@ int Layer::Shadow(int sx, int sy, int sw, int sh, int size, int shape)
         if (use_clip)
             r.Intersect(clip);
         if (r.w > 0 && r.h > 0)
-            XFillRectangle(dis, pix, gfx, r.x + page_x, r.y + page_y, r.w, r.h);
+            PaintRect(r.x + page_x, r.y + page_y, r.w, r.h, FillStippled, ColorBlack);
 
         r.SetRegion(sx + size, sy + sh, sw - size, size);
         if (use_clip)
             r.Intersect(clip);
         if (r.w > 0 && r.h > 0)
-            XFillRectangle(dis, pix, gfx, r.x + page_x, r.y + page_y, r.w, r.h);
-        XSetFillStyle(dis, gfx, FillSolid);
+            PaintRect(r.x + page_x, r.y + page_y, r.w, r.h, FillStippled, ColorBlack);
 
         break;
     }
@@ -1595,19 +1347,44 @@ int Layer::Ghost(int gx, int gy, int gw, int gh)
         r.Intersect(clip);
     if (r.w > 0 && r.h > 0)
     {
-        XSetForeground(dis, gfx, ColorBlack);
-        XSetFillStyle(dis, gfx, FillStippled);
-        XFillRectangle(dis, pix, gfx, r.x + page_x, r.y + page_y, r.w, r.h);
-        XSetFillStyle(dis, gfx, FillSolid);
+        PaintRect(r.x + page_x, r.y + page_y, r.w, r.h, FillStippled, ColorBlack);
     }
     return 0;
 }
 
+/****
+ * Zone:  Draws a button background.  Pages repeat the same few looks
+ *  (size, frame, texture, shape and texture alignment) many times, so each
+ *  look is rendered once by DrawZone() into ZoneCache and copied after that.
+ ****/
 int Layer::Zone(int zx, int zy, int zw, int zh,
                 int zone_frame, int texture, int shape)
 {
     FnTrace("Layer::Zone()");
 
+    if (zone_frame == ZF_HIDDEN)
+        return 0;
+
+    const int b = frame_width;
+    const int rect = IsRectShape(shape);
+    // Every rectangle frame but ZF_CLEAR_BORDER covers the whole zone
+    const int opaque = rect && texture != IMAGE_CLEAR && zone_frame != ZF_CLEAR_BORDER &&
+                       zw > b * 10 && zh > b * 10;
+    std::string look = "zone," + std::to_string(zone_frame) + "," + std::to_string(texture) +
+                       "," + std::to_string(shape) + "," + std::to_string(b);
+    AddTexturePhase(look, zx, zy, {texture, ZoneEdgeTexture(zone_frame)});
+    if (CachedLook(look, zx, zy, zw, zh, rect ? 0 : 2, opaque,
+                   [&]() { DrawZone(zx, zy, zw, zh, zone_frame, texture, shape); }) == 0)
+        return 0;
+
+    return DrawZone(zx, zy, zw, zh, zone_frame, texture, shape);
+}
+
+int Layer::DrawZone(int zx, int zy, int zw, int zh,
+                    int zone_frame, int texture, int shape)
+{
+    FnTrace("Layer::DrawZone()");
+
     int frame;
     switch (zone_frame)
     {
@@ -1717,6 +1494,151 @@ int Layer::Zone(int zx, int zy, int zw, int zh,
     return 0;
 }
 
+int Layer::CachedLook(const std::string &look, int lx, int ly, int lw, int lh,
+                      int margin, int opaque, const std::function<void()> &draw)
+{
+    FnTrace("Layer::CachedLook()");
+
+    const int cw = lw + margin * 2;
+    const int ch = lh + margin * 2;
+    if (canvas || cw <= 0 || ch <= 0)
+        return 1;
+    // Page sized backgrounds would crowd out the buttons
+    const size_t bytes = static_cast<size_t>(cw) * static_cast<size_t>(ch) * 4;
+    if (bytes > ZoneCache.MaxBytes() / 16)
+        return 1;
+
+    vt::ImageKey key;
+    key.path   = look;
+    key.width  = cw;
+    key.height = ch;
+    const vt::CachedImage *image = ZoneCache.Find(key);
+    if (image == nullptr)
+    {
+        vt::CachedImage entry;
+        entry.width  = cw;
+        entry.height = ch;
+        entry.bytes  = bytes;
+        int no = DefaultScreen(dis);
+        entry.pixmap = XCreatePixmap(dis, win, cw, ch, DefaultDepth(dis, no));
+
+        // Draw with the look's corner at (margin, margin).  Moving page_x/y
+        // moves the tile origin with it, so textures line up as on the page.
+        Pixmap saved_pix = pix;
+        int saved_x = page_x;
+        int saved_y = page_y;
+        int saved_clip = use_clip;
+        pix      = entry.pixmap;
+        page_x   = margin - lx;
+        page_y   = margin - ly;
+        use_clip = 0;
+        XSetClipMask(dis, gfx, None);
+        draw();
+
+        if (!opaque)
+        {
+            // Same drawing again in 1 bits to record what it covers
+            entry.mask = XCreatePixmap(dis, win, cw, ch, 1);
+            GC mask_gc = XCreateGC(dis, entry.mask, 0, nullptr);
+            XSetForeground(dis, mask_gc, 0);
+            XFillRectangle(dis, entry.mask, mask_gc, 0, 0, cw, ch);
+            GC saved_gc = gfx;
+            gfx       = mask_gc;
+            pix       = entry.mask;
+            mask_pass = 1;
+            draw();
+            mask_pass = 0;
+            gfx       = saved_gc;
+            XFreeGC(dis, mask_gc);
+            entry.bytes += static_cast<size_t>((cw + 7) / 8) * static_cast<size_t>(ch);
+        }
+
+        pix      = saved_pix;
+        page_x   = saved_x;
+        page_y   = saved_y;
+        use_clip = saved_clip;
+        if (use_clip)
+            SetClip(clip.x, clip.y, clip.w, clip.h);
+        image = &ZoneCache.Insert(key, std::move(entry));
+    }
+
+    // Copy only the visible part, as DrawPixmap() does
+    const int dx = lx - margin;
+    const int dy = ly - margin;
+    RegionInfo r(dx, dy, cw, ch);
+    if (use_clip)
+        r.Intersect(clip);
+    if (r.w <= 0 || r.h <= 0)
+        return 0;
+
+    if (image->mask)
+    {
+        XSetClipMask(dis, gfx, image->mask);
+        XSetClipOrigin(dis, gfx, page_x + dx, page_y + dy);
+    }
+
+    XCopyArea(dis, image->pixmap, pix, gfx, r.x - dx, r.y - dy, r.w, r.h,
+              page_x + r.x, page_y + r.y);
+
+    if (image->mask)
+    {
+        XSetClipOrigin(dis, gfx, 0, 0);
+        if (use_clip)
+            SetClip(clip.x, clip.y, clip.w, clip.h);
+        else
+            XSetClipMask(dis, gfx, None);
+    }
+    return 0;
+}
+
+/****
+ * ShowPressed:  Draws a button with its selected look straight to the
+ *  window so a touch shows at once.  pix still holds what vt_main drew,
+ *  so its next update of the area, or LayerList::UpdateArea(), replaces
+ *  the local drawing.  Returns 1 if it can't be drawn here.
+ ****/
+int Layer::ShowPressed(const vt::PressLook &look)
+{
+    FnTrace("Layer::ShowPressed()");
+
+    if (canvas || xftdraw == nullptr || look.w <= 0 || look.h <= 0)
+        return 1;
+
+    int no = DefaultScreen(dis);
+    Pixmap scratch = XCreatePixmap(dis, win, look.w, look.h, DefaultDepth(dis, no));
+    XSetClipMask(dis, gfx, None);
+    // Shapes that don't fill the zone keep the page around them
+    XCopyArea(dis, pix, scratch, gfx, page_x + look.x, page_y + look.y,
+              look.w, look.h, 0, 0);
+
+    // Draw at page coordinates into scratch, as CachedLook() does
+    Pixmap saved_pix = pix;
+    int saved_x = page_x;
+    int saved_y = page_y;
+    int saved_clip = use_clip;
+    pix      = scratch;
+    page_x   = -look.x;
+    page_y   = -look.y;
+    use_clip = 0;
+    XftDrawChange(xftdraw, scratch);
+    Zone(look.x, look.y, look.w, look.h, look.frame, look.texture, look.shape);
+    if (!look.text.empty() && look.text_w > 0 && look.text_h > 0)
+        ZoneText(look.text.c_str(), look.text_x, look.text_y, look.text_w, look.text_h,
+                 look.color, look.font, ALIGN_CENTER, use_embossed_text);
+    XftDrawChange(xftdraw, saved_pix);
+    pix      = saved_pix;
+    page_x   = saved_x;
+    page_y   = saved_y;
+    use_clip = saved_clip;
+
+    XCopyArea(dis, scratch, win, gfx, 0, 0, look.w, look.h,
+              x + page_x + look.x, y + page_y + look.y);
+    if (use_clip)
+        SetClip(clip.x, clip.y, clip.w, clip.h);
+    XFreePixmap(dis, scratch);
+    return 0;
+}
+
 int Layer::FramedWindow(int wx, int wy, int ww, int wh, int color)
 {
     FnTrace("Layer::FramedWindow()");
@@ -1726,33 +1648,30 @@ int Layer::FramedWindow(int wx, int wy, int ww, int wh, int color)
     int far_x = wx + ww - 1;
     int far_y = wy + wh - 1;
 
-    XSetForeground(dis, gfx, ColorTextH[color]);
-    XDrawLine(dis, pix, gfx, wx, wy, far_x, wy);
-    XDrawLine(dis, pix, gfx, wx, wy + 1, far_x - 1, wy + 1);
-    XDrawLine(dis, pix, gfx, wx, wy + 2, wx, far_y - 1);
-    XDrawLine(dis, pix, gfx, wx + 1, wy + 2, wx + 1, far_y - 2);
-    XDrawLine(dis, pix, gfx, wx + 5, far_y - 5, far_x - 6, far_y - 5);
-    XDrawLine(dis, pix, gfx, wx + 6, far_y - 6, far_x - 7, far_y - 6);
-    XDrawLine(dis, pix, gfx, far_x - 5, wy + 29, far_x - 5, far_y - 5);
-    XDrawLine(dis, pix, gfx, far_x - 6, wy + 30, far_x - 6, far_y - 6);
-    XFillRectangle(dis, pix, gfx, wx + 5, wy + 5, ww - 10, 20);
-
-    XSetForeground(dis, gfx, ColorTextS[color]);
-    XDrawLine(dis, pix, gfx, far_x, wy + 1, far_x, far_y);
-    XDrawLine(dis, pix, gfx, far_x - 1, wy + 2, far_x - 1, far_y - 1);
-    XDrawLine(dis, pix, gfx, wx, far_y, far_x - 1, far_y);
-    XDrawLine(dis, pix, gfx, wx + 1, far_y - 1, far_x - 1, far_y - 1);
-    XDrawLine(dis, pix, gfx, wx + 6, wy + 28, far_x - 5, wy + 28);
-    XDrawLine(dis, pix, gfx, wx + 7, wy + 29, far_x - 6, wy + 29);
-    XDrawLine(dis, pix, gfx, wx + 5, wy + 28, wx + 5, far_y - 6);
-    XDrawLine(dis, pix, gfx, wx + 6, wy + 29, wx + 6, far_y - 7);
-
-    XSetForeground(dis, gfx, ColorTextT[color]);
-    XFillRectangle(dis, pix, gfx, wx + 2, wy + 2, ww - 4, 3);
-    XFillRectangle(dis, pix, gfx, wx + 2, wy + 25, ww - 4, 3);
-    XFillRectangle(dis, pix, gfx, wx + 2, wy + wh - 5, ww - 4, 3);
-    XFillRectangle(dis, pix, gfx, wx + 2, wy + 3, 3, wh - 6);
-    XFillRectangle(dis, pix, gfx, far_x - 4, wy + 3, 3, wh - 6);
+    PaintLine(wx, wy, far_x, wy, ColorTextH[color]);
+    PaintLine(wx, wy + 1, far_x - 1, wy + 1, ColorTextH[color]);
+    PaintLine(wx, wy + 2, wx, far_y - 1, ColorTextH[color]);
+    PaintLine(wx + 1, wy + 2, wx + 1, far_y - 2, ColorTextH[color]);
+    PaintLine(wx + 5, far_y - 5, far_x - 6, far_y - 5, ColorTextH[color]);
+    PaintLine(wx + 6, far_y - 6, far_x - 7, far_y - 6, ColorTextH[color]);
+    PaintLine(far_x - 5, wy + 29, far_x - 5, far_y - 5, ColorTextH[color]);
+    PaintLine(far_x - 6, wy + 30, far_x - 6, far_y - 6, ColorTextH[color]);
+    PaintRect(wx + 5, wy + 5, ww - 10, 20, FillSolid, ColorTextH[color]);
+
+    PaintLine(far_x, wy + 1, far_x, far_y, ColorTextS[color]);
+    PaintLine(far_x - 1, wy + 2, far_x - 1, far_y - 1, ColorTextS[color]);
+    PaintLine(wx, far_y, far_x - 1, far_y, ColorTextS[color]);
+    PaintLine(wx + 1, far_y - 1, far_x - 1, far_y - 1, ColorTextS[color]);
+    PaintLine(wx + 6, wy + 28, far_x - 5, wy + 28, ColorTextS[color]);
+    PaintLine(wx + 7, wy + 29, far_x - 6, wy + 29, ColorTextS[color]);
+    PaintLine(wx + 5, wy + 28, wx + 5, far_y - 6, ColorTextS[color]);
+    PaintLine(wx + 6, wy + 29, wx + 6, far_y - 7, ColorTextS[color]);
+
+    PaintRect(wx + 2, wy + 2, ww - 4, 3, FillSolid, ColorTextT[color]);
+    PaintRect(wx + 2, wy + 25, ww - 4, 3, FillSolid, ColorTextT[color]);
+    PaintRect(wx + 2, wy + wh - 5, ww - 4, 3, FillSolid, ColorTextT[color]);
+    PaintRect(wx + 2, wy + 3, 3, wh - 6, FillSolid, ColorTextT[color]);
+    PaintRect(far_x - 4, wy + 3, 3, wh - 6, FillSolid, ColorTextT[color]);
     return 0;
 }
 
@@ -1765,11 +1684,7 @@ int Layer::HGrip(int gx, int gy, int gw, int gh)
 
     for (i = 0; i < gh; ++i)
     {
-        if (toggle)
-            XSetForeground(dis, gfx, ColorBE);
-        else
-            XSetForeground(dis, gfx, ColorTE);
-        XDrawLine(dis, pix, gfx, gx, gy + i, gx + gw - 1, gy + i);
+        PaintLine(gx, gy + i, gx + gw - 1, gy + i, toggle ? ColorBE : ColorTE);
         toggle ^= 1;
     }
     return 0;
@@ -1784,11 +1699,7 @@ int Layer::VGrip(int gx, int gy, int gw, int gh)
 
     for (i = 0; i < gw; ++i)
     {
-        if (toggle)
-            XSetForeground(dis, gfx, ColorLE);
-        else
-            XSetForeground(dis, gfx, ColorRE);
-        XDrawLine(dis, pix, gfx, gx + i, gy, gx + i, gy + gh - 1);
+        PaintLine(gx + i, gy, gx + i, gy + gh - 1, toggle ? ColorLE : ColorRE);
         toggle ^= 1;
     }
     return 0;
@@ -1804,6 +1715,8 @@ int Layer::SetClip(int cx, int cy, int cw, int ch)
     clip_rec.width = cw;
     clip_rec.height = ch;
     XSetClipRectangles(dis, gfx, 0, 0, &clip_rec, 1, Unsorted);
+    if (canvas)
+        canvas->SetClip(clip_rec.x, clip_rec.y, cw, ch);
 
     use_clip = 1;
     clip.SetRegion(cx, cy, cw, ch);
@@ -1815,10 +1728,124 @@ int Layer::ClearClip()
     FnTrace("Layer::ClearClip()");
 
     XSetClipMask(dis, gfx, None);
+    if (canvas)
+        canvas->ClearClip();
     use_clip = 0;
     return 0;
 }
 
+/****
+ * Paint functions:  The raw drawing used by the shapes above.  With
+ *  VT_RENDER=software they rasterize into canvas; otherwise they set
+ *  up the GC, draw into pix and put the GC back to FillSolid.
+ ****/
+namespace
+{
+vt::SoftPaint MakeSoftPaint(int style, int value, int origin_x, int origin_y)
+{
+    if (style == FillTiled)
+    {
+        const vt::SoftImage *tile = GetSoftTexture(value);
+        if (tile)
+            return vt::SoftPaint::Tiled(tile, origin_x, origin_y);
+        return vt::SoftPaint::Solid(static_cast<uint32_t>(ColorBlack));
+    }
+    if (style == FillStippled)
+        return vt::SoftPaint::Stippled(static_cast<uint32_t>(value));
+    return vt::SoftPaint::Solid(static_cast<uint32_t>(value));
+}
+} // namespace
+
+void Layer::SetFill(int style, int value)
+{
+    if (mask_pass)
+    {
+        XSetForeground(dis, gfx, 1);
+        XSetFillStyle(dis, gfx, FillSolid);
+        return;
+    }
+    if (style == FillTiled)
+    {
+        XSetTSOrigin(dis, gfx, page_x, page_y);
+        XSetTile(dis, gfx, GetTexture(value));
+    }
+    else
+    {
+        XSetForeground(dis, gfx, value);
+    }
+    XSetFillStyle(dis, gfx, style);
+}
+
+int Layer::PaintRect(int px, int py, int pw, int ph, int style, int value)
+{
+    if (canvas)
+    {
+        canvas->FillRect(px, py, pw, ph, MakeSoftPaint(style, value, page_x, page_y));
+        return 0;
+    }
+    SetFill(style, value);
+    XFillRectangle(dis, pix, gfx, px, py, pw, ph);
+    XSetFillStyle(dis, gfx, FillSolid);
+    return 0;
+}
+
+int Layer::PaintPolygon(XPoint *pts, int count, int style, int value)
+{
+    if (canvas)
+    {
+        std::vector<vt::SoftPoint> points(count);
+        for (int i = 0; i < count; ++i)
+            points[i] = {pts[i].x, pts[i].y};
+        canvas->FillPolygon(points.data(), count, MakeSoftPaint(style, value, page_x, page_y));
+        return 0;
+    }
+    SetFill(style, value);
+    XFillPolygon(dis, pix, gfx, pts, count, Convex, CoordModeOrigin);
+    XSetFillStyle(dis, gfx, FillSolid);
+    return 0;
+}
+
+int Layer::PaintEllipse(int ex, int ey, int ew, int eh, int style, int value)
+{
+    if (canvas)
+    {
+        canvas->FillEllipse(ex, ey, ew, eh, MakeSoftPaint(style, value, page_x, page_y));
+        return 0;
+    }
+    SetFill(style, value);
+    XFillArc(dis, pix, gfx, ex, ey, ew, eh, 0, 360 * 64);
+    XSetFillStyle(dis, gfx, FillSolid);
+    return 0;
+}
+
+int Layer::PaintLine(int x1, int y1, int x2, int y2, int pixel)
+{
+    if (canvas)
+    {
+        canvas->DrawLine(x1, y1, x2, y2, static_cast<uint32_t>(pixel));
+        return 0;
+    }
+    XSetForeground(dis, gfx, mask_pass ? 1 : pixel);
+    XDrawLine(dis, pix, gfx, x1, y1, x2, y2);
+    return 0;
+}
+
+int Layer::PaintArc(int ax, int ay, int aw, int ah, int angle1, int angle2,
+                    int line_width, int pixel)
+{
+    if (canvas)
+    {
+        canvas->DrawArc(ax, ay, aw, ah, angle1 / 64, angle2 / 64, line_width,
+                        static_cast<uint32_t>(pixel));
+        return 0;
+    }
+    XSetLineAttributes(dis, gfx, line_width, LineSolid, CapProjecting, JoinMiter);
+    XSetForeground(dis, gfx, mask_pass ? 1 : pixel);
+    XDrawArc(dis, pix, gfx, ax, ay, aw, ah, angle1, angle2);
+    XSetLineAttributes(dis, gfx, 1, LineSolid, CapProjecting, JoinMiter);
+    return 0;
+}
+
 int Layer::MouseEnter(LayerList *ll)
 {
     FnTrace("Layer::MouseEnter()");
@@ -1857,6 +1884,7 @@ int Layer::MouseAction(LayerList *ll, int mx, int my, int code)
         return 0;
     }
 
+    WInputStamp();
     WInt8(ToInt(ServerProtocol::SrvMouse));
     WInt16(id);
     WInt8(code);
@@ -1869,6 +1897,8 @@ int Layer::Touch(LayerList *ll, int tx, int ty)
 {
     FnTrace("Layer::Touch()");
 
+    ShowPress(this, tx - page_x, ty - page_y);
+    WInputStamp();
     WInt8(ToInt(ServerProtocol::SrvTouch));
     WInt16(id);
     WInt16(tx - page_x);
@@ -2093,11 +2123,12 @@ int LayerList::UpdateAll(int select_all)
         while (l)
         {
             l->update = 1;
+            l->damage.Clear();  // redrawn in full below
             l = l->next;
         }
 
     l = list.Tail();
-    l->DrawArea(0, 0, l->w, l->h);
+    Blit(l, 0, 0, l->w, l->h);
 
     Layer *next_layer = l->fore;
     if (next_layer)
@@ -2172,7 +2203,7 @@ int LayerList::OptimalUpdateArea(int ax, int ay, int aw, int ah, Layer *end)
     {
         r.SetRegion(ax, ay, aw, ah);
         r.Intersect(l);
-        l->DrawArea(r.x - l->x, r.y - l->y, r.w, r.h);
+        Blit(l, r.x - l->x, r.y - l->y, r.w, r.h);
     }
 
     Layer *next_layer = l->fore;
@@ -2214,6 +2245,61 @@ int LayerList::OptimalUpdateArea(int ax, int ay, int aw, int ah, Layer *end)
     return 0;
 }
 
+int LayerList::AddDamage(int ax, int ay, int aw, int ah)
+{
+    FnTrace("LayerList::AddDamage()");
+
+    if (screen_blanked)
+        return UpdateArea(ax, ay, aw, ah);
+
+    ++frame_stats.damage_rects;
+    for (Layer *l = list.Head(); l != nullptr; l = l->next)
+    {
+        if (!l->Overlap(ax, ay, aw, ah))
+            continue;
+        RegionInfo r(ax, ay, aw, ah);
+        r.Intersect(l);
+        l->damage.Add(r.x, r.y, r.w, r.h);
+    }
+    return 0;
+}
+
+int LayerList::FlushDamage()
+{
+    FnTrace("LayerList::FlushDamage()");
+
+    // Each layer redraws its own rectangles; OptimalUpdateArea() still
+    // skips whatever another layer covers, so a merged rectangle can't
+    // paint over a dialog sitting on top of it.
+    const uint64_t blits = frame_stats.blits;
+    int count = 0;
+    for (Layer *l = list.Head(); l != nullptr; l = l->next)
+    {
+        if (l->damage.Empty())
+            continue;
+        l->update = 1;
+        for (const vt::DamageRect &r : l->damage.Take())
+        {
+            OptimalUpdateArea(r.x, r.y, r.w, r.h);
+            ++count;
+        }
+        l->update = 0;
+    }
+    if (count > 0)
+        ++frame_stats.frames;
+    frame_stats.frame_blits += frame_stats.blits - blits;
+    return count;
+}
+
+int LayerList::Blit(Layer *l, int bx, int by, int bw, int bh)
+{
+    if (bw <= 0 || bh <= 0)
+        return 0;
+    ++frame_stats.blits;
+    frame_stats.blit_pixels += static_cast<uint64_t>(bw) * static_cast<uint64_t>(bh);
+    return l->DrawArea(bx, by, bw, bh);
+}
+
 int LayerList::RubberBandOff()
 {
     FnTrace("LayerList::RubberBandOff()");
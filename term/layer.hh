@@ -23,8 +23,12 @@
 
 #include "term_view.hh"
 #include "list_utility.hh"
+#include "soft_canvas.hh"
+#include "damage_region.hh"
+#include "press_look.hh"
 #include <X11/Xft/Xft.h>
 #include <functional>
+#include <memory>
 
 
 /**** Types ****/
@@ -117,6 +121,10 @@ public:
     Str page_title;
     LayerObjectList buttons;
     XftDraw *xftdraw; // XftDraw context for scalable font rendering
+    std::unique_ptr<vt::SoftCanvas> canvas; // set when SoftRendering is on
+    vt::DamageRegion damage; // window area (not layer area) for LayerList::FlushDamage()
+    int mask_pass;           // Paint functions draw 1 bits for a ZoneCache mask
+    vt::PressLookList press_looks; // from TERM_PRESSLOOKS, see ShowPressed()
 
     // Constructor
     Layer(Display *d, GC g, Window dw, int lw, int lh);
@@ -152,6 +160,7 @@ public:
     int Triangle(int tx, int ty, int tw, int th, int image);
     int Zone(int x, int y, int w, int h, int frame, int texture,
              int shape = SHAPE_RECTANGLE);
+    int DrawZone(int x, int y, int w, int h, int frame, int texture, int shape);
     int Shadow(int x, int y, int w, int h, int s, int shape = SHAPE_RECTANGLE);
     int Ghost(int gx, int gy, int gw, int gh);
     int HLine(int x, int y, int len, int lw, int color);
@@ -162,6 +171,12 @@ public:
     int Frame(int fx, int fy, int fw, int fh, int thick, int flags = 0);
     int FilledFrame(int x, int y, int w, int h, int fw, int texture,
                     int flags = 0);
+    // Copies a look (Zone() or FilledFrame() appearance) from ZoneCache,
+    // rendering it with draw() on a miss.  Returns 1 if it can't be cached.
+    int CachedLook(const std::string &look, int lx, int ly, int lw, int lh,
+                   int margin, int opaque, const std::function<void()> &draw);
+    // Draws look pressed on the window only; pix keeps vt_main's drawing
+    int ShowPressed(const vt::PressLook &look);
     int StatusBar(int x, int y, int w, int h, int bar_color,
                   const genericChar* text, int font, int text_color);
     int EditCursor(int x, int y, int w, int h);
@@ -171,6 +186,17 @@ public:
     int SetClip(int x, int y, int w, int h);
     int ClearClip();
 
+    // Raw drawing in pixmap coordinates; goes to canvas when it is set.
+    // style is an X fill style; value is an image id for FillTiled and a
+    // pixel otherwise.  Arc angles are in 64ths of a degree like XDrawArc().
+    int PaintRect(int px, int py, int pw, int ph, int style, int value);
+    int PaintPolygon(XPoint *pts, int count, int style, int value);
+    int PaintEllipse(int ex, int ey, int ew, int eh, int style, int value);
+    int PaintLine(int x1, int y1, int x2, int y2, int pixel);
+    int PaintArc(int ax, int ay, int aw, int ah, int angle1, int angle2,
+                 int line_width, int pixel);
+    void SetFill(int style, int value);
+
     int MouseEnter(LayerList *ll);
     int MouseExit(LayerList *ll);
     int MouseAction(LayerList *ll, int x, int y, int code);
@@ -234,6 +260,11 @@ public:
     // redraws all layers in region
     int OptimalUpdateArea(int x, int y, int w, int h, Layer *end = nullptr);
     // redraws all layers with update flag set in region
+    int AddDamage(int x, int y, int w, int h);
+    // like UpdateArea() but only queues the area for the next FlushDamage()
+    int FlushDamage();
+    // draws queued areas with coalesced blits, returns the number of rectangles
+    [[nodiscard]] const vt::FrameStats &FrameStats() const noexcept { return frame_stats; }
     int RubberBandOff();
     int RubberBandUpdate(int x, int y);
     int MouseAction(int x, int y, int code);
@@ -245,6 +276,11 @@ public:
     
     // Access to internal list for font updates
     Layer *Head() { return list.Head(); }
+
+private:
+    vt::FrameStats frame_stats;
+
+    int Blit(Layer *l, int x, int y, int w, int h);
 };
 
 class LO_PushButton : public LayerObject
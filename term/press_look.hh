@@ -0,0 +1,67 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * press_look.hh - What a touched button looks like before vt_main answers
+ * No X dependencies; Layer::ShowPressed() does the drawing
+ */
+
+#ifndef VT_PRESS_LOOK_HH
+#define VT_PRESS_LOOK_HH
+
+#include <string>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief One zone of a TERM_PRESSLOOKS list: where it takes touches and,
+ *  if vt_term may draw it pressed, its selected frame, texture and label.
+ *
+ * vt_main sends every zone Page::FindZone() could return, in the order it
+ * searches them, so a zone that isn't a plain button still hides the ones
+ * beneath it.  Those have local == false and nothing else set.
+ */
+struct PressLook {
+    int x = 0, y = 0, w = 0, h = 0;
+    bool local = false;
+    int frame = 0, texture = 0, shape = 0;
+    int text_x = 0, text_y = 0, text_w = 0, text_h = 0;
+    int color = 0, font = 0;
+    std::string text;
+
+    [[nodiscard]] bool IsPointIn(int px, int py) const noexcept
+    {
+        return px >= x && py >= y && px < x + w && py < y + h;
+    }
+};
+
+using PressLookList = std::vector<PressLook>;
+
+// The zone vt_main will treat as touched at (px, py), if it can be drawn
+// pressed; nullptr for no zone or one that vt_term shouldn't draw
+inline const PressLook *FindPressLook(const PressLookList &looks, int px, int py)
+{
+    for (const PressLook &look : looks)
+    {
+        if (look.IsPointIn(px, py))
+            return look.local ? &look : nullptr;
+    }
+    return nullptr;
+}
+
+} // namespace vt
+
+#endif // VT_PRESS_LOOK_HH
@@ -0,0 +1,464 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * soft_canvas.cc - In-memory 32-bit framebuffer for the software Layer backend
+ */
+
+#include "soft_canvas.hh"
+#include "src/core/font_metrics.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fontconfig/fontconfig.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace vt {
+
+namespace {
+
+FT_Library FreeTypeLibrary()
+{
+    static FT_Library library = nullptr;
+    static bool tried = false;
+    if (!tried)
+    {
+        tried = true;
+        if (FT_Init_FreeType(&library) != 0)
+            library = nullptr;
+    }
+    return library;
+}
+
+inline uint32_t Blend(uint32_t dst, uint32_t src, unsigned alpha) noexcept
+{
+    unsigned inv = 255 - alpha;
+    uint32_t r = (((src >> 16) & 255) * alpha + ((dst >> 16) & 255) * inv) / 255;
+    uint32_t g = (((src >> 8) & 255) * alpha + ((dst >> 8) & 255) * inv) / 255;
+    uint32_t b = ((src & 255) * alpha + (dst & 255) * inv) / 255;
+    return (r << 16) | (g << 8) | b;
+}
+
+// Modulo that stays positive for tile lookups left/above the origin
+inline int Wrap(int v, int m) noexcept
+{
+    int r = v % m;
+    return r < 0 ? r + m : r;
+}
+
+} // namespace
+
+/**** SoftFont ****/
+SoftFont::~SoftFont()
+{
+    if (face)
+        FT_Done_Face(static_cast<FT_Face>(face));
+}
+
+int SoftFont::Open(const std::string &fc_name)
+{
+    FT_Library library = FreeTypeLibrary();
+    if (library == nullptr)
+        return 1;
+
+    FcPattern *pattern = FcNameParse(reinterpret_cast<const FcChar8*>(fc_name.c_str()));
+    if (pattern == nullptr)
+        return 1;
+    FcConfigSubstitute(nullptr, pattern, FcMatchPattern);
+    FcDefaultSubstitute(pattern);
+
+    FcResult result = FcResultNoMatch;
+    FcPattern *match = FcFontMatch(nullptr, pattern, &result);
+    FcPatternDestroy(pattern);
+    if (match == nullptr)
+        return 1;
+
+    FcChar8 *file = nullptr;
+    int index = 0;
+    double pixel_size = 0.0;
+    FcPatternGetString(match, FC_FILE, 0, &file);
+    FcPatternGetInteger(match, FC_INDEX, 0, &index);
+    if (FcPatternGetDouble(match, FC_PIXEL_SIZE, 0, &pixel_size) != FcResultMatch)
+        pixel_size = 16.0;
+
+    FT_Face new_face = nullptr;
+    int error = (file == nullptr) ||
+        FT_New_Face(library, reinterpret_cast<const char*>(file), index, &new_face) != 0;
+    FcPatternDestroy(match);
+    if (error)
+        return 1;
+
+    FT_Set_Pixel_Sizes(new_face, 0, static_cast<FT_UInt>(std::lround(pixel_size)));
+    if (face)
+        FT_Done_Face(static_cast<FT_Face>(face));
+    face = new_face;
+    glyphs.clear();
+
+    // 26.6 fixed point, rounded outward like Xft does
+    ascent  = static_cast<int>((new_face->size->metrics.ascender + 63) >> 6);
+    descent = static_cast<int>((-new_face->size->metrics.descender + 63) >> 6);
+    return 0;
+}
+
+const SoftFont::Glyph *SoftFont::GetGlyph(uint32_t codepoint)
+{
+    auto it = glyphs.find(codepoint);
+    if (it != glyphs.end())
+        return &it->second;
+    if (face == nullptr)
+        return nullptr;
+
+    auto ftface = static_cast<FT_Face>(face);
+    Glyph glyph;
+    FT_UInt index = FT_Get_Char_Index(ftface, codepoint);
+    if (FT_Load_Glyph(ftface, index, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT) == 0)
+    {
+        FT_GlyphSlot slot = ftface->glyph;
+        glyph.left    = slot->bitmap_left;
+        glyph.top     = slot->bitmap_top;
+        glyph.advance = static_cast<int>((slot->advance.x + 32) >> 6);
+        glyph.width   = static_cast<int>(slot->bitmap.width);
+        glyph.rows    = static_cast<int>(slot->bitmap.rows);
+        glyph.alpha.resize(static_cast<size_t>(glyph.width) * glyph.rows);
+        for (int row = 0; row < glyph.rows; ++row)
+        {
+            const unsigned char* src = slot->bitmap.buffer + row * slot->bitmap.pitch;
+            std::copy(src, src + glyph.width, glyph.alpha.begin() + row * glyph.width);
+        }
+    }
+    return &glyphs.emplace(codepoint, std::move(glyph)).first->second;
+}
+
+int SoftFont::TextWidth(const char* str, int len)
+{
+    int w = 0;
+    int pos = 0;
+    while (pos < len)
+    {
+        const Glyph *g = GetGlyph(DecodeUtf8(str, len, pos));
+        if (g)
+            w += g->advance;
+    }
+    return w;
+}
+
+/**** SoftCanvas ****/
+SoftCanvas::SoftCanvas(int w, int h)
+    : width(std::max(w, 0)), height(std::max(h, 0)),
+      pixels(static_cast<size_t>(width) * static_cast<size_t>(height), 0)
+{
+    ClearClip();
+}
+
+uint32_t SoftCanvas::Pixel(int px, int py) const noexcept
+{
+    if (px < 0 || py < 0 || px >= width || py >= height)
+        return 0;
+    return pixels[static_cast<size_t>(py) * width + px];
+}
+
+void SoftCanvas::SetClip(int cx, int cy, int cw, int ch) noexcept
+{
+    clip_x1 = std::max(cx, 0);
+    clip_y1 = std::max(cy, 0);
+    clip_x2 = std::min(cx + cw, width);
+    clip_y2 = std::min(cy + ch, height);
+}
+
+void SoftCanvas::ClearClip() noexcept
+{
+    clip_x1 = 0;
+    clip_y1 = 0;
+    clip_x2 = width;
+    clip_y2 = height;
+}
+
+// Paints [x1, x2) on row y
+void SoftCanvas::Span(int y, int x1, int x2, const SoftPaint &paint)
+{
+    if (y < clip_y1 || y >= clip_y2)
+        return;
+    x1 = std::max(x1, clip_x1);
+    x2 = std::min(x2, clip_x2);
+    if (x1 >= x2)
+        return;
+
+    uint32_t *row = pixels.data() + static_cast<size_t>(y) * width;
+    switch (paint.style)
+    {
+    case SoftPaint::SOLID:
+        std::fill(row + x1, row + x2, paint.color);
+        break;
+    case SoftPaint::STIPPLED:
+        // 2x2 checkerboard, as made by XmuCreateStippledPixmap(0, 1, 1)
+        for (int x = x1 + ((x1 + y) & 1); x < x2; x += 2)
+            row[x] = paint.color;
+        break;
+    case SoftPaint::TILED:
+    {
+        const SoftImage *tile = paint.tile;
+        if (tile == nullptr || !tile->Valid())
+            return;
+        const uint32_t *src = tile->pixels.data() +
+            static_cast<size_t>(Wrap(y - paint.origin_y, tile->height)) * tile->width;
+        int tx = Wrap(x1 - paint.origin_x, tile->width);
+        int x = x1;
+        while (x < x2)
+        {
+            // copy runs up to the tile's right edge
+            int run = std::min(x2 - x, tile->width - tx);
+            std::copy(src + tx, src + tx + run, row + x);
+            x += run;
+            tx = 0;
+        }
+        break;
+    }
+    }
+}
+
+void SoftCanvas::FillRect(int rx, int ry, int rw, int rh, const SoftPaint &paint)
+{
+    if (rw <= 0 || rh <= 0)
+        return;
+    int y1 = std::max(ry, clip_y1);
+    int y2 = std::min(ry + rh, clip_y2);
+    for (int y = y1; y < y2; ++y)
+        Span(y, rx, rx + rw, paint);
+}
+
+void SoftCanvas::FillPolygon(const SoftPoint* pts, int count, const SoftPaint &paint)
+{
+    if (pts == nullptr || count < 3)
+        return;
+
+    int min_y = pts[0].y;
+    int max_y = pts[0].y;
+    for (int i = 1; i < count; ++i)
+    {
+        min_y = std::min(min_y, pts[i].y);
+        max_y = std::max(max_y, pts[i].y);
+    }
+    min_y = std::max(min_y, clip_y1);
+    max_y = std::min(max_y, clip_y2 - 1);
+
+    // Scanline fill sampled at pixel centres (even-odd rule)
+    std::vector<double> nodes;
+    for (int y = min_y; y <= max_y; ++y)
+    {
+        double sy = y + 0.5;
+        nodes.clear();
+        for (int i = 0, j = count - 1; i < count; j = i++)
+        {
+            const SoftPoint &a = pts[i];
+            const SoftPoint &b = pts[j];
+            if ((a.y < sy && b.y >= sy) || (b.y < sy && a.y >= sy))
+                nodes.push_back(a.x + (sy - a.y) / (b.y - a.y) * (b.x - a.x));
+        }
+        std::sort(nodes.begin(), nodes.end());
+        for (size_t k = 0; k + 1 < nodes.size(); k += 2)
+        {
+            int x1 = static_cast<int>(std::ceil(nodes[k] - 0.5));
+            int x2 = static_cast<int>(std::ceil(nodes[k + 1] - 0.5));
+            Span(y, x1, x2, paint);
+        }
+    }
+}
+
+void SoftCanvas::FillEllipse(int ex, int ey, int ew, int eh, const SoftPaint &paint)
+{
+    if (ew <= 0 || eh <= 0)
+        return;
+
+    double rx = ew / 2.0;
+    double ry = eh / 2.0;
+    double cx = ex + rx;
+    double cy = ey + ry;
+    int y1 = std::max(ey, clip_y1);
+    int y2 = std::min(ey + eh, clip_y2);
+    for (int y = y1; y < y2; ++y)
+    {
+        double dy = (y + 0.5 - cy) / ry;
+        if (dy * dy >= 1.0)
+            continue;
+        double half = rx * std::sqrt(1.0 - dy * dy);
+        int x1 = static_cast<int>(std::ceil(cx - half - 0.5));
+        int x2 = static_cast<int>(std::ceil(cx + half - 0.5));
+        Span(y, x1, x2, paint);
+    }
+}
+
+void SoftCanvas::DrawLine(int x1, int y1, int x2, int y2, uint32_t color)
+{
+    if (y1 == y2)
+    {
+        // horizontal lines are most of what Layer draws
+        Span(y1, std::min(x1, x2), std::max(x1, x2) + 1, SoftPaint::Solid(color));
+        return;
+    }
+
+    int dx = std::abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -std::abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;)
+    {
+        if (x1 >= clip_x1 && x1 < clip_x2 && y1 >= clip_y1 && y1 < clip_y2)
+            pixels[static_cast<size_t>(y1) * width + x1] = color;
+        if (x1 == x2 && y1 == y2)
+            break;
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void SoftCanvas::DrawArc(int ax, int ay, int aw, int ah, int start, int extent,
+                         int thickness, uint32_t color)
+{
+    if (aw <= 0 || ah <= 0 || extent == 0)
+        return;
+
+    double rx = aw / 2.0;
+    double ry = ah / 2.0;
+    double cx = ax + rx;
+    double cy = ay + ry;
+    double half = std::max(thickness, 1) / 2.0;
+    double a1 = start;
+    double a2 = start + extent;
+    if (a2 < a1)
+        std::swap(a1, a2);
+
+    int pad = thickness + 1;
+    int y1 = std::max(ay - pad, clip_y1);
+    int y2 = std::min(ay + ah + pad, clip_y2);
+    int x1 = std::max(ax - pad, clip_x1);
+    int x2 = std::min(ax + aw + pad, clip_x2);
+    for (int y = y1; y < y2; ++y)
+    {
+        for (int x = x1; x < x2; ++x)
+        {
+            double px = x + 0.5 - cx;
+            double py = cy - (y + 0.5);  // y up, as X measures angles
+            double norm = std::sqrt((px * px) / (rx * rx) + (py * py) / (ry * ry));
+            if (std::fabs(norm - 1.0) * std::min(rx, ry) > half)
+                continue;
+            double angle = std::atan2(py / ry, px / rx) * 180.0 / M_PI;
+            while (angle < a1)
+                angle += 360.0;
+            if (angle <= a2)
+                pixels[static_cast<size_t>(y) * width + x] = color;
+        }
+    }
+}
+
+void SoftCanvas::DrawImage(const SoftImage &img, int dx, int dy, int dw, int dh)
+{
+    if (!img.Valid() || dw <= 0 || dh <= 0)
+        return;
+
+    bool masked = img.mask.size() == img.pixels.size();
+    int y1 = std::max(dy, clip_y1);
+    int y2 = std::min(dy + dh, clip_y2);
+    int x1 = std::max(dx, clip_x1);
+    int x2 = std::min(dx + dw, clip_x2);
+    for (int y = y1; y < y2; ++y)
+    {
+        int sy = std::min(static_cast<int>(static_cast<int64_t>(y - dy) * img.height / dh),
+                          img.height - 1);
+        const uint32_t *src = img.pixels.data() + static_cast<size_t>(sy) * img.width;
+        const uint8_t *msk = masked ? img.mask.data() + static_cast<size_t>(sy) * img.width : nullptr;
+        uint32_t *row = pixels.data() + static_cast<size_t>(y) * width;
+        for (int x = x1; x < x2; ++x)
+        {
+            int sx = std::min(static_cast<int>(static_cast<int64_t>(x - dx) * img.width / dw),
+                              img.width - 1);
+            if (msk == nullptr || msk[sx])
+                row[x] = src[sx];
+        }
+    }
+}
+
+int SoftCanvas::DrawText(SoftFont &font, int tx, int baseline, const char* str, int len,
+                         uint32_t color)
+{
+    if (str == nullptr || len <= 0 || !font.Valid())
+        return 0;
+
+    int pen = tx;
+    int pos = 0;
+    while (pos < len)
+    {
+        const SoftFont::Glyph *g = font.GetGlyph(DecodeUtf8(str, len, pos));
+        if (g == nullptr)
+            continue;
+
+        int gx = pen + g->left;
+        int gy = baseline - g->top;
+        int y1 = std::max(gy, clip_y1);
+        int y2 = std::min(gy + g->rows, clip_y2);
+        int x1 = std::max(gx, clip_x1);
+        int x2 = std::min(gx + g->width, clip_x2);
+        for (int y = y1; y < y2; ++y)
+        {
+            const uint8_t *a = g->alpha.data() + static_cast<size_t>(y - gy) * g->width;
+            uint32_t *row = pixels.data() + static_cast<size_t>(y) * width;
+            for (int x = x1; x < x2; ++x)
+            {
+                unsigned alpha = a[x - gx];
+                if (alpha == 255)
+                    row[x] = color;
+                else if (alpha > 0)
+                    row[x] = Blend(row[x], color, alpha);
+            }
+        }
+        pen += g->advance;
+    }
+    return pen - tx;
+}
+
+int SoftCanvas::WritePPM(const std::string &path) const
+{
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (fp == nullptr)
+        return 1;
+
+    fprintf(fp, "P6\n%d %d\n255\n", width, height);
+    std::vector<unsigned char> line(static_cast<size_t>(width) * 3);
+    int error = 0;
+    for (int y = 0; y < height && !error; ++y)
+    {
+        const uint32_t *row = pixels.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            line[x * 3]     = static_cast<unsigned char>((row[x] >> 16) & 255);
+            line[x * 3 + 1] = static_cast<unsigned char>((row[x] >> 8) & 255);
+            line[x * 3 + 2] = static_cast<unsigned char>(row[x] & 255);
+        }
+        error = fwrite(line.data(), 1, line.size(), fp) != line.size();
+    }
+    fclose(fp);
+    return error;
+}
+
+} // namespace vt
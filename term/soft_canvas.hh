@@ -0,0 +1,155 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * soft_canvas.hh - In-memory 32-bit framebuffer for the software Layer backend
+ * No X dependencies: fills, tiles, polygons, lines, images and FreeType text
+ */
+
+#ifndef VT_SOFT_CANVAS_HH
+#define VT_SOFT_CANVAS_HH
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief A decoded image: 0x00RRGGBB pixels plus an optional 1 byte/pixel
+ * mask (nonzero = opaque).  An empty mask means fully opaque.
+ */
+struct SoftImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+    std::vector<uint8_t> mask;
+
+    [[nodiscard]] bool Valid() const noexcept
+    {
+        return width > 0 && height > 0 &&
+               pixels.size() == static_cast<size_t>(width) * static_cast<size_t>(height);
+    }
+};
+
+struct SoftPoint {
+    int x;
+    int y;
+};
+
+/**
+ * @brief How a fill is painted, mirroring the X GC fill styles Layer uses.
+ */
+struct SoftPaint {
+    enum Style { SOLID, TILED, STIPPLED };
+
+    Style style = SOLID;
+    uint32_t color = 0;
+    const SoftImage *tile = nullptr;  // TILED only
+    int origin_x = 0;                 // tile origin
+    int origin_y = 0;
+
+    static SoftPaint Solid(uint32_t c) noexcept { return {SOLID, c, nullptr, 0, 0}; }
+    static SoftPaint Stippled(uint32_t c) noexcept { return {STIPPLED, c, nullptr, 0, 0}; }
+    static SoftPaint Tiled(const SoftImage *t, int ox, int oy) noexcept
+    {
+        return {TILED, 0, t, ox, oy};
+    }
+};
+
+/**
+ * @brief A FreeType face opened through fontconfig, with a glyph cache.
+ */
+class SoftFont {
+public:
+    SoftFont() = default;
+    ~SoftFont();
+    SoftFont(const SoftFont&) = delete;
+    SoftFont& operator=(const SoftFont&) = delete;
+
+    // Accepts the same names as XftFontOpenName(), e.g. "DejaVu Serif:size=14:dpi=96"
+    int Open(const std::string &fc_name);
+    [[nodiscard]] bool Valid() const noexcept { return face != nullptr; }
+
+    [[nodiscard]] int Ascent() const noexcept { return ascent; }
+    [[nodiscard]] int Descent() const noexcept { return descent; }
+    [[nodiscard]] int Height() const noexcept { return ascent + descent; }
+    int TextWidth(const char* str, int len);
+
+    struct Glyph {
+        int left = 0;      // bitmap offset from the pen position
+        int top = 0;       // bitmap rows above the baseline
+        int advance = 0;
+        int width = 0;
+        int rows = 0;
+        std::vector<uint8_t> alpha;
+    };
+    const Glyph *GetGlyph(uint32_t codepoint);
+
+private:
+    void *face = nullptr;  // FT_Face, kept opaque so callers don't need FreeType headers
+    int ascent = 0;
+    int descent = 0;
+    std::unordered_map<uint32_t, Glyph> glyphs;
+};
+
+/**
+ * @brief Software framebuffer with the drawing primitives of Layer.
+ *
+ * Coordinates are pixels from the top left.  Every primitive honours the
+ * clip rectangle, the same way Layer's X GC clip works.
+ */
+class SoftCanvas {
+public:
+    SoftCanvas(int w, int h);
+
+    [[nodiscard]] int Width() const noexcept { return width; }
+    [[nodiscard]] int Height() const noexcept { return height; }
+    [[nodiscard]] uint32_t *Pixels() noexcept { return pixels.data(); }
+    [[nodiscard]] const uint32_t *Pixels() const noexcept { return pixels.data(); }
+    [[nodiscard]] uint32_t Pixel(int px, int py) const noexcept;
+
+    void SetClip(int cx, int cy, int cw, int ch) noexcept;
+    void ClearClip() noexcept;
+
+    void FillRect(int rx, int ry, int rw, int rh, const SoftPaint &paint);
+    void FillPolygon(const SoftPoint* pts, int count, const SoftPaint &paint);
+    void FillEllipse(int ex, int ey, int ew, int eh, const SoftPaint &paint);
+    void DrawLine(int x1, int y1, int x2, int y2, uint32_t color);
+    // Angles in degrees, counter-clockwise from 3 o'clock as in XDrawArc()
+    void DrawArc(int ax, int ay, int aw, int ah, int start, int extent,
+                 int thickness, uint32_t color);
+    // Nearest-neighbour scales img to dw x dh, skipping masked pixels
+    void DrawImage(const SoftImage &img, int dx, int dy, int dw, int dh);
+    // Returns the advance; baseline is the y of the text baseline
+    int DrawText(SoftFont &font, int tx, int baseline, const char* str, int len,
+                 uint32_t color);
+
+    // Binary (P6) PPM of the whole canvas
+    int WritePPM(const std::string &path) const;
+
+private:
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+    int clip_x1, clip_y1, clip_x2, clip_y2;  // half-open
+
+    void Span(int y, int x1, int x2, const SoftPaint &paint);
+};
+
+} // namespace vt
+
+#endif // VT_SOFT_CANVAS_HH
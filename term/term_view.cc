@@ -15,17 +15,6 @@
 #include <X11/Xft/Xft.h>
 #include <fontconfig/fontconfig.h>
 
-#ifdef HAVE_PNG
-#include <png.h>
-#endif
-
-#ifdef HAVE_JPEG
-#include <jpeglib.h>
-#endif
-
-#ifdef HAVE_GIF
-#include <gif_lib.h>
-#endif
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <sys/socket.h>
@@ -47,6 +36,10 @@
 #include <system_error>
 #include <cstring>
 #include <cstdlib>
+#include <bit>
+#include <fstream>
+#include <future>
+#include <sstream>
 
 #include "debug.hh"
 #include "safe_string_utils.hh"
@@ -57,6 +50,13 @@
 #include "touch_screen.hh"
 #include "layer.hh"
 #include "generic_char.hh"
+#include "font_metrics.hh"
+#include "image_pipeline.hh"
+#include "font_cache.hh"
+#include "asset_cache.hh"
+#include "content_hash.hh"
+#include "thread_pool.hh"
+#include "metrics.hh"
 
 #ifdef CREDITMCVE
 #include "term_credit_mcve.hh"
@@ -78,6 +78,7 @@
 #include <iostream>
 #include <vector>
 #include <numeric>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
@@ -164,6 +165,11 @@ public:
         reconnect_attempts_++;
     }
 
+    // An attempt failed; the next one waits for should_attempt_reconnect()
+    void set_retry() {
+        state_ = CONNECTION_DISCONNECTED;
+    }
+
     void set_failed() {
         state_ = CONNECTION_FAILED;
         ReportError("Connection failed permanently");
@@ -175,6 +181,10 @@ public:
         if (state_ != CONNECTION_DISCONNECTED) return false;
         if (reconnect_attempts_ >= max_reconnect_attempts_) return false;
 
+        // The first attempt is immediate, a resumed session is worth more
+        // than a moment's wait
+        if (reconnect_attempts_ == 0) return true;
+
         time_t now = time(nullptr);
         int delay = reconnect_delay_ * (1 << (reconnect_attempts_ - 1)); // Exponential backoff
         if (delay > 60) delay = 60; // Cap at 60 seconds
@@ -685,6 +695,21 @@ std::array<XftFont*, FONT_SPACE> XftFontsArr{};
 std::array<int, FONT_SPACE> FontBaseline{};
 std::array<int, FONT_SPACE> FontHeight{};
 
+int SoftRendering = 0;  // VT_RENDER=software: Layers draw into vt::SoftCanvas
+std::array<std::unique_ptr<vt::SoftFont>, FONT_SPACE> SoftFonts{};
+std::array<vt::SoftImage, IMAGE_COUNT> SoftTextures{};  // decoded copies of Texture[]
+
+static void ReleaseCachedImage(vt::CachedImage &image);
+vt::ImageCache PixmapCache(vt::ImageCache::DEFAULT_MAX_BYTES, ReleaseCachedImage);
+vt::ImageCache ZoneCache(16 * 1024 * 1024, ReleaseCachedImage);
+vt::TextCache TextMetrics;
+static vt::FontCache ResolvedFonts;  // fontconfig matches and metrics kept between runs
+static std::string   FontCachePath;
+static std::array<bool, FONT_SPACE> XftFontTried{};  // opened, or failed to open
+static vt::AssetCache TermAssets;     // translations and converted textures kept between runs
+static std::string   TranslationsHash;  // of the table in MasterTranslations
+static void SetTranslations(const vt::TranslationList &list);
+
 
 std::array<int, TEXT_COLORS> ColorTextT{};
 std::array<int, TEXT_COLORS> ColorTextH{};
@@ -806,12 +831,40 @@ static int          MaxColors = 0;
 static std::array<Ulong, 256> Palette{};
 static int          ScreenBlankTime = 60;
 static int          UpdateTimerID = 0;
+static int          FrameTimerID  = 0;
+static int          FrameTime     = 16;  // ms of server updates coalesced per frame
 static int          TouchInputID  = 0;
 static std::unique_ptr<TouchScreen> TScreen = nullptr;
 static int          ResetTime = 20;
 static TimeInfo     TimeOut, LastInput;
 static int          CalibrateStage = 0;
 static int          SocketInputID = 0;
+static int          ReconnectTimerID = 0;
+// Touch to pixel tracing (see Terminal::ReadInputSpans() in vt_main)
+static int64_t      InputStartNs  = 0;  // when the touch being dispatched happened
+static uint32_t     InputSeq      = 0;
+static int64_t      FrameReadNs   = 0;  // when the frame being decoded was read
+static int          TraceWaiting  = 0;  // TERM_INPUT_DONE seen, frame not yet drawn
+static uint32_t     TraceSeq      = 0;
+static int64_t      TraceReadNs   = 0;
+static int64_t      TraceDecodedNs = 0;
+static int          SyntheticTouchMs = 0;  // VT_SYNTHETIC_TOUCH
+static int          SyntheticTouchX  = 0;
+static int          SyntheticTouchY  = 0;
+static uint32_t     StampSeq = 0;      // the last input stamped, and when
+static int64_t      StampNs  = 0;
+static vt::LatencyHistogram TouchLatency;  // reported with VT_SYNTHETIC_TOUCH
+// Local button press feedback (see ShowPress())
+#define PRESS_REVERT_MS 500
+static int          LocalPress    = 1;  // VT_LOCAL_PRESS=0 waits for vt_main
+static int          PressRevertID = 0;
+static RegionInfo   PressArea;          // window area drawn by ShowPressed()
+static RegionInfo   PressZone;          // the button vt_main should draw, page coordinates
+static int64_t      PressStartNs  = 0;  // touch time, while waiting for vt_main's drawing
+static int          PressDrawn    = 0;  // vt_main's TERM_ZONE for it is in this frame
+static std::string  SessionToken;  // from TERM_SESSION; presented on SessionPath
+static std::string  SessionPath;
+static bool         ResumeUnconfirmed = false;  // resumed, but vt_main hasn't sent anything yet
 static Cursor       CursorPointer = 0;
 static Cursor       CursorBlank = 0;
 static Cursor       CursorWait = 0;
@@ -870,6 +923,143 @@ CharQueue BufferOut(QUEUE_SIZE);  // 1 meg buffers
 CharQueue BufferIn(QUEUE_SIZE);
 
 int  SendNow() noexcept { return BufferOut.Write(SocketNo); }
+
+/****
+ * WInputStamp:  Numbers the touch or click about to be sent and says when
+ *  it happened, so vt_main can time it through to TERM_INPUT_DONE.  Only
+ *  input that arrived through TouchScreenCB() or MouseClickCB() is timed.
+ ****/
+int WInputStamp()
+{
+    if (InputStartNs == 0)
+        return 1;
+    WInt8(ToInt(ServerProtocol::SrvInputStamp));
+    WInt32(static_cast<int>(++InputSeq));
+    WLLong(InputStartNs);
+    StampSeq = InputSeq;
+    StampNs = InputStartNs;
+    InputStartNs = 0;
+    return 0;
+}
+
+/****
+ * SendInputSpans:  The frame holding the result of a traced input reached
+ *  X; tells vt_main when each step happened.
+ ****/
+static void SendInputSpans(int64_t blitted_ns)
+{
+    TraceWaiting = 0;
+    WInt8(ToInt(ServerProtocol::SrvInputSpans));
+    WInt32(static_cast<int>(TraceSeq));
+    WLLong(TraceReadNs);
+    WLLong(TraceDecodedNs);
+    WLLong(blitted_ns);
+    SendNow();
+
+    if (TraceSeq != StampSeq || SyntheticTouchMs <= 0)
+        return;
+    TouchLatency.Record(blitted_ns - StampNs);
+    if (TouchLatency.Count() % 100 == 0)
+    {
+        fprintf(stderr, "Synthetic touch: %llu touches, mean %.2f ms touch to pixel\n",
+                static_cast<unsigned long long>(TouchLatency.Count()),
+                static_cast<double>(TouchLatency.SumNs()) / 1e6 /
+                static_cast<double>(TouchLatency.Count()));
+    }
+}
+
+static void SendPressShown(int64_t ns, int local)
+{
+    if (SocketNo <= 0)
+        return;
+    WInt8(ToInt(ServerProtocol::SrvPressShown));
+    WLLong(ns);
+    WInt8(local);
+    SendNow();
+}
+
+static void PressRevertCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
+{
+    PressRevertID = 0;
+    Layers.UpdateArea(PressArea.x, PressArea.y, PressArea.w, PressArea.h);
+    XFlush(Dis);
+}
+
+/****
+ * ShowPress:  A touch at page point (px, py) of l.  If TERM_PRESSLOOKS
+ *  listed a button there it is drawn pressed now, and put back after
+ *  PRESS_REVERT_MS in case vt_main doesn't draw over it.  The time until
+ *  the button looked pressed, whoever drew it, goes to vt_main as
+ *  SrvPressShown so VT_LOCAL_PRESS=0 can be compared with the default.
+ ****/
+int ShowPress(Layer *l, int px, int py)
+{
+    FnTrace("ShowPress()");
+
+    const vt::PressLook *look = vt::FindPressLook(l->press_looks, px, py);
+    if (look == nullptr)
+        return 1;
+
+    int64_t now = vt::MetricsNowNs();
+    PressStartNs = (InputStartNs > 0) ? InputStartNs : now;
+    PressZone.SetRegion(look->x, look->y, look->w, look->h);
+    PressDrawn = 0;
+    if (LocalPress == 0 || Layers.screen_blanked)
+        return 0;
+
+    RegionInfo area(l->x + l->page_x + look->x, l->y + l->page_y + look->y,
+                    look->w, look->h);
+    for (Layer *above = l->next; above != nullptr; above = above->next)
+    {
+        if (above->Overlap(area.x, area.y, area.w, area.h))
+            return 0;  // vt_main will have to show it
+    }
+    if (l->ShowPressed(*look))
+        return 0;
+
+    XFlush(Dis);
+    SendPressShown(vt::MetricsNowNs() - PressStartNs, 1);
+    PressStartNs = 0;
+    PressArea = area;
+    if (PressRevertID)
+        XtRemoveTimeOut(PressRevertID);
+    PressRevertID = XtAppAddTimeOut(App, PRESS_REVERT_MS, (XtTimerCallbackProc) PressRevertCB, nullptr);
+    return 0;
+}
+
+/****
+ * SyntheticTouchCB:  VT_SYNTHETIC_TOUCH="rate:x:y" touches (x, y) rate
+ *  times a second, through the same path as the touch screen, so
+ *  vt_input_latency_seconds can be measured without anyone at the screen.
+ *  The button there is pressed every time; use a test database.
+ ****/
+static void SyntheticTouchCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
+{
+    if (SocketNo > 0)
+    {
+        InputStartNs = vt::MetricsNowNs();
+        Layers.Touch(SyntheticTouchX, SyntheticTouchY);
+        InputStartNs = 0;
+    }
+    XtAppAddTimeOut(App, SyntheticTouchMs, (XtTimerCallbackProc) SyntheticTouchCB, nullptr);
+}
+
+static void StartSyntheticTouches()
+{
+    const char* spec = getenv("VT_SYNTHETIC_TOUCH");
+    int rate = 0;
+    if (spec == nullptr ||
+        sscanf(spec, "%d:%d:%d", &rate, &SyntheticTouchX, &SyntheticTouchY) != 3 ||
+        rate <= 0)
+    {
+        return;
+    }
+    SyntheticTouchMs = Max(1, 1000 / Min(rate, 1000));
+    fprintf(stderr, "Synthetic touch: %d per second at %d,%d\n",
+            rate, SyntheticTouchX, SyntheticTouchY);
+    // Give vt_main time to draw the first page
+    XtAppAddTimeOut(App, Max(SyntheticTouchMs, 2000), (XtTimerCallbackProc) SyntheticTouchCB, nullptr);
+}
 int  WInt8(int val) noexcept  { return BufferOut.Put8(val); }
 int  RInt8() noexcept         { return BufferIn.Get8(); }
 int  WInt16(int val) noexcept { return BufferOut.Put16(val); }
@@ -1083,6 +1273,7 @@ int StopTouches();
 int StopUpdates();
 int ResetView();
 int SaveToPPM();
+int LoadSoftFonts();
 int OpenLayer(int id, int x, int y, int w, int h, int win_frame, const genericChar* title);
 int ShowLayer(int id);
 int KillLayer(int id);
@@ -1185,6 +1376,106 @@ void UpdateCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
     UpdateTimerID = XtAppAddTimeOut(App, update_time, (XtTimerCallbackProc) UpdateCB, nullptr);
 }
 
+/****
+ * Startup timing:  StartupMark() records when each phase of starting vt_term
+ *  ends, in ms since the kernel started the process (so dynamic linking and
+ *  the connection to vt_main count too).  The first frame drawn prints them.
+ ****/
+static const auto StartupClock = std::chrono::steady_clock::now();
+static std::vector<std::pair<const char*, double>> StartupPhases;
+static int StartupReported = 0;
+
+// How long the process had been running when StartupClock was read
+static double ProcessAgeMs()
+{
+    std::ifstream stat_file("/proc/self/stat");
+    std::string line;
+    if (!std::getline(stat_file, line))
+        return 0.0;
+    // starttime is field 22; the command name (field 2) may hold spaces
+    const size_t paren = line.rfind(')');
+    if (paren == std::string::npos || paren + 2 >= line.size())
+        return 0.0;
+    std::istringstream fields(line.substr(paren + 2));
+    std::string field;
+    unsigned long long start_ticks = 0;
+    for (int i = 3; i <= 22 && (fields >> field); ++i)
+    {
+        if (i == 22)
+            start_ticks = std::strtoull(field.c_str(), nullptr, 10);
+    }
+
+    struct timespec now;
+    const long ticks = sysconf(_SC_CLK_TCK);
+    if (start_ticks == 0 || ticks <= 0 || clock_gettime(CLOCK_BOOTTIME, &now) != 0)
+        return 0.0;
+    const double age = static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1e6 -
+                       static_cast<double>(start_ticks) * 1000.0 / static_cast<double>(ticks);
+    return Max(0.0, age);
+}
+static const double StartupOffset = ProcessAgeMs();
+
+static void StartupMark(const char* phase)
+{
+    if (StartupReported || (!StartupPhases.empty() && StartupPhases.back().first == phase))
+        return;
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - StartupClock;
+    StartupPhases.emplace_back(phase, StartupOffset + elapsed.count());
+}
+
+static void StartupReport()
+{
+    StartupMark("frame");
+    StartupReported = 1;
+
+    std::string phases;
+    std::array<char, 64> str{};
+    double last = 0.0;
+    for (const auto& [phase, ms] : StartupPhases)
+    {
+        snprintf(str.data(), str.size(), "%s%s %.1f", phases.empty() ? "" : ", ", phase, ms - last);
+        phases += str.data();
+        last = ms;
+    }
+    fprintf(stderr, "Startup: %.1f ms to first frame (%s)\n", last, phases.c_str());
+    StartupPhases.clear();
+}
+
+void FrameCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
+{
+    FnTrace("FrameCB()");
+
+    FrameTimerID = 0;
+    if (Layers.FlushDamage() > 0)
+    {
+        XFlush(Dis);
+        if (StartupReported == 0)
+            StartupReport();
+    }
+    if (TraceWaiting)
+        SendInputSpans(vt::MetricsNowNs());
+    if (PressDrawn)
+    {
+        SendPressShown(vt::MetricsNowNs() - PressStartNs, 0);
+        PressStartNs = 0;
+        PressDrawn = 0;
+    }
+}
+
+/****
+ * ScheduleFrame:  Server updates are queued with Layers.AddDamage() and drawn
+ *  together when the frame timer fires, so a page render that sends dozens of
+ *  UPDATEAREA commands costs a few blits instead of dozens.
+ ****/
+static void ScheduleFrame()
+{
+    StartupMark("page");  // first update from vt_main
+    if (FrameTime <= 0)
+        FrameCB(nullptr, nullptr);
+    else if (FrameTimerID == 0)
+        FrameTimerID = XtAppAddTimeOut(App, FrameTime, (XtTimerCallbackProc) FrameCB, nullptr);
+}
+
 void TouchScreenCB(XtPointer /*client_data*/, int * /*fid*/, XtInputId * /*id*/)
 {
     FnTrace("TouchScreenCB()");
@@ -1203,6 +1494,8 @@ void TouchScreenCB(XtPointer /*client_data*/, int * /*fid*/, XtInputId * /*id*/)
     
     if (status == 1 && UserInput() == 0)
     {
+        InputStartNs = vt::MetricsNowNs();
+
         // Process touch events for gestures
         TScreen->ProcessTouchEvents();
         
@@ -1245,6 +1538,7 @@ void TouchScreenCB(XtPointer /*client_data*/, int * /*fid*/, XtInputId * /*id*/)
                 // Handle other touch modes
                 break;
         }
+        InputStartNs = 0;
     }
     else if (status == -1)
     {
@@ -1610,10 +1904,12 @@ void MouseClickCB(Widget /*widget*/, XtPointer /*client_data*/, XEvent *event,
         code |= MOUSE_SHIFT;
 
     moves_count = 0;
+    InputStartNs = vt::MetricsNowNs();
     if (touch)
         Layers.Touch(btnevent->x, btnevent->y);
     else
         Layers.MouseAction(btnevent->x, btnevent->y, code);
+    InputStartNs = 0;  // handled without vt_main
 }
 
 void MouseReleaseCB(Widget widget, XtPointer client_data, XEvent *event,
@@ -1712,6 +2008,86 @@ void CalibrateCB(XtPointer client_data, int *fid, XtInputId *id)
         Calibrate(status);
 }
 
+static int AttemptReconnect();
+
+// Stops reading the dead socket and closes it
+static void DropSocket()
+{
+    FnTrace("DropSocket()");
+    if (SocketInputID != 0) {
+        try {
+            XtRemoveInput(SocketInputID);
+        } catch (...) {
+            fprintf(stderr, "DropSocket: Exception during XtRemoveInput, continuing\n");
+        }
+        SocketInputID = 0;
+    }
+    if (SocketNo > 0) {
+        close(SocketNo);
+        SocketNo = -1;
+    }
+}
+
+static void ReconnectCB(XtPointer /*client_data*/, XtIntervalId * /*timer_id*/)
+{
+    FnTrace("ReconnectCB()");
+    ReconnectTimerID = 0;
+    AttemptReconnect();
+}
+
+/****
+ * AttemptReconnect:  Drops the dead socket and tries ReconnectToServer()
+ *  when the backoff allows.  Until it works or the attempts run out a
+ *  timer keeps trying, since there's no socket left to wake us up.
+ *  Returns 0 once reconnected.
+ ****/
+static int AttemptReconnect()
+{
+    FnTrace("AttemptReconnect()");
+    if (connection_monitor.should_attempt_reconnect()) {
+        connection_monitor.set_reconnecting();
+
+        fprintf(stderr, "AttemptReconnect: Attempting reconnection (attempt %d/%d)\n",
+                connection_monitor.get_reconnect_attempts(),
+                connection_monitor.get_max_reconnect_attempts());
+
+        DropSocket();
+
+        if (ReconnectToServer() == 0) {
+            // vt_main hangs up on a session it no longer has, so a resume
+            // only counts once it draws something (see SocketInputCB())
+            if (ResumeUnconfirmed)
+                return 0;
+            connection_monitor.set_connected();
+
+            // Hide reconnecting message and restore normal operation
+            if (MainLayer != nullptr) {
+                HideReconnectingMessage();
+            }
+
+            ReportError("Successfully reconnected to server.");
+            return 0;
+        }
+
+        // Reconnection failed, will try again later
+        fprintf(stderr, "AttemptReconnect: Reconnection attempt failed\n");
+        connection_monitor.set_retry();
+    }
+
+    // If we've exceeded max reconnection attempts, fail permanently
+    if (connection_monitor.get_reconnect_attempts() >= connection_monitor.get_max_reconnect_attempts()) {
+        connection_monitor.set_failed();
+        ReportError("Unable to reconnect to server after maximum attempts. Terminal will continue in offline mode.");
+
+        // Keep the terminal running in offline mode instead of restarting
+        return 1;
+    }
+
+    if (SocketInputID == 0 && ReconnectTimerID == 0)
+        ReconnectTimerID = XtAppAddTimeOut(App, 1000, (XtTimerCallbackProc) ReconnectCB, nullptr);
+    return 1;
+}
+
 void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
 {
     FnTrace("SocketInputCB()");
@@ -1721,6 +2097,20 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
 
     if (val <= 0)
     {
+        if (ResumeUnconfirmed)
+        {
+            // vt_main turned the resume down: the session's grace period
+            // ran out or vt_main restarted.  Start over on the default
+            // socket rather than presenting the dead token again.
+            fprintf(stderr, "SocketInputCB: Session resume refused, reconnecting afresh\n");
+            ResumeUnconfirmed = false;
+            SessionToken.clear();
+            SessionPath.clear();
+            DropSocket();
+            connection_monitor.set_retry();
+            AttemptReconnect();
+            return;
+        }
         consecutive_failures++;
 
         // Update connection monitor state
@@ -1736,62 +2126,15 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
             }
         }
 
-        // Check if we should attempt reconnection
-        if (connection_monitor.should_attempt_reconnect()) {
-            connection_monitor.set_reconnecting();
-
-            fprintf(stderr, "SocketInputCB: Attempting reconnection (attempt %d/%d)\n",
-                    connection_monitor.get_reconnect_attempts(),
-                    connection_monitor.get_max_reconnect_attempts());
-
-            // Remove the invalid input handler
-            if (SocketInputID != 0) {
-                try {
-                    XtRemoveInput(SocketInputID);
-                } catch (...) {
-                    fprintf(stderr, "SocketInputCB: Exception during XtRemoveInput, continuing\n");
-                }
-                SocketInputID = 0;
-            }
-
-            // Close the invalid socket
-            if (SocketNo > 0) {
-                close(SocketNo);
-                SocketNo = -1;
-            }
-
-            // Attempt to reconnect
-            if (ReconnectToServer() == 0) {
-                connection_monitor.set_connected();
-                consecutive_failures = 0;
-
-                // Hide reconnecting message and restore normal operation
-                if (MainLayer != nullptr) {
-                    HideReconnectingMessage();
-                }
-
-                ReportError("Successfully reconnected to server.");
-                return;
-            } else {
-                // Reconnection failed, will try again later
-                fprintf(stderr, "SocketInputCB: Reconnection attempt failed\n");
-            }
-        }
-
-        // If we've exceeded max reconnection attempts, fail permanently
-        if (connection_monitor.get_reconnect_attempts() >= connection_monitor.get_max_reconnect_attempts()) {
-            connection_monitor.set_failed();
-            ReportError("Unable to reconnect to server after maximum attempts. Terminal will continue in offline mode.");
+        if (AttemptReconnect() == 0 ||
+            connection_monitor.get_state() == CONNECTION_FAILED)
             consecutive_failures = 0;
-
-            // Keep the terminal running in offline mode instead of restarting
-            return;
-        }
-
         return;
     }
 
     // Successful read - update connection health
+    FrameReadNs = vt::MetricsNowNs();
+    ResumeUnconfirmed = false;
     consecutive_failures = 0;
     if (connection_monitor.get_state() != CONNECTION_CONNECTED) {
         connection_monitor.set_connected();
@@ -1851,15 +2194,12 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
             {
                 if (l->use_clip)
                 {
-                    Layers.UpdateArea(offset_x + l->clip.x, offset_y + l->clip.y,
-                                      l->clip.w, l->clip.h);
+                    Layers.AddDamage(offset_x + l->clip.x, offset_y + l->clip.y,
+                                     l->clip.w, l->clip.h);
                 }
                 else
-                {
-                    l->update = 1;
-                    Layers.UpdateAll(0);
-                }
-                XFlush(Dis);
+                    Layers.AddDamage(l->x, l->y, l->w, l->h);
+                ScheduleFrame();
             }
             l->ClearClip();
             break;
@@ -1872,8 +2212,8 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
                 n2 = RInt16();
                 n3 = RInt16();
                 n4 = RInt16();
-                Layers.UpdateArea(offset_x + n1, offset_y + n2, n3, n4);
-                XFlush(Dis);
+                Layers.AddDamage(offset_x + n1, offset_y + n2, n3, n4);
+                ScheduleFrame();
             }
             l->ClearClip();
             break;
@@ -1965,6 +2305,15 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
             n6 = RInt8();
             n7 = RInt8();
             l->Zone(n1, n2, n3, n4, n5, n6, n7);
+            // The touched button, drawn by vt_main within a second of the touch
+            if (PressStartNs > 0 && PressZone.x == n1 && PressZone.y == n2 &&
+                PressZone.w == n3 && PressZone.h == n4)
+            {
+                if (vt::MetricsNowNs() - PressStartNs < 1000000000LL)
+                    PressDrawn = 1;
+                else
+                    PressStartNs = 0;
+            }
             break;
         case TERM_EDITCURSOR:
             n1 = RInt16();
@@ -2207,16 +2556,58 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
             XBell(Dis, RInt16());
             break;
         case TERM_TRANSLATIONS:
-            MasterTranslations.Clear();
+        {
+            vt::TranslationList list;
             n1 = RInt8();
             for (n2 = 0; n2 < n1; n2++)
             {
                 RStr(key.data());
                 RStr(value.data());
-                MasterTranslations.AddTranslation(key.data(), value.data());
+                list.emplace_back(key.data(), value.data());
+            }
+            SetTranslations(list);
+            TermAssets.Store("translations", vt::PackTranslations(list));
+            break;
+        }
+        case TERM_SESSION:
+            SessionToken = RStr(key.data());
+            SessionPath = RStr(value.data());
+            break;
+        case TERM_PRESSLOOKS:
+            n1 = RInt16();
+            l->press_looks.clear();
+            l->press_looks.reserve(static_cast<size_t>(Max(n1, 0)));
+            for (n2 = 0; n2 < n1; ++n2)
+            {
+                vt::PressLook look;
+                look.x = RInt16();
+                look.y = RInt16();
+                look.w = RInt16();
+                look.h = RInt16();
+                look.frame = RInt8();
+                look.local = (look.frame != ZF_HIDDEN);
+                if (look.local)
+                {
+                    look.texture = RInt8();
+                    look.shape   = RInt8();
+                    look.text_x  = RInt16();
+                    look.text_y  = RInt16();
+                    look.text_w  = RInt16();
+                    look.text_h  = RInt16();
+                    look.color   = RInt8();
+                    look.font    = RInt8();
+                    look.text    = RStr(s.data());
+                }
+                l->press_looks.push_back(std::move(look));
             }
-            new_page_translations = 1;
-            new_zone_translations = 1;
+            break;
+        case TERM_INPUT_DONE:
+            TraceSeq = static_cast<uint32_t>(RInt32());
+            TraceReadNs = FrameReadNs;
+            TraceDecodedNs = vt::MetricsNowNs();
+            TraceWaiting = 1;
+            if (FrameTimerID == 0)  // nothing left to draw
+                SendInputSpans(TraceDecodedNs);
             break;
         case TERM_CC_AUTH:
             if (creditcard == nullptr)
@@ -2385,6 +2776,8 @@ void SocketInputCB(XtPointer client_data, int *fid, XtInputId *id)
             break;
         case Constants::TERM_RELOAD_FONTS:
             TerminalReloadFonts();
+            SendFontMetrics();
+            SendNow();
             break;
         }
 	}
@@ -2613,6 +3006,14 @@ int SaveToPPM()
              Constants::XWD, DisplayString(Dis), filename.data());
     system(command.data());
 
+    // The software renderer's own framebuffer, for comparing against the xwd
+    if (SoftRendering && MainLayer != nullptr && MainLayer->canvas)
+    {
+        vt_safe_string::safe_format(filename.data(), filename.size(), "%s/vtscreen%d.ppm",
+                                    Constants::SCREEN_DIR, no - 1);
+        MainLayer->canvas->WritePPM(filename.data());
+    }
+
     return 0;
 }
 
@@ -2724,233 +3125,106 @@ Xpm *LoadPixmapFile(char* file_name)
     return retxpm;
 }
 
-#ifdef HAVE_PNG
 /****
- * RemoveCheckeredBackground: Detect and remove checkered/checked backgrounds
- * from PNG images. Common checkered patterns use alternating light gray (#C0C0C0)
- * and white (#FFFFFF) squares, or similar light colors. This function detects
- * these patterns and converts matching pixels to transparent.
- * 
- * Returns true if checkered background was detected and removed, false otherwise.
- * If checkered background is detected, the image will be converted to RGBA format
- * with alpha channel added.
+ * UploadRgbaImage:  Sends a premultiplied RGBA image to new server-side
+ *  pixmaps with one XPutImage() for the colours and one for the 1 bit
+ *  mask (alpha >= 128 is opaque; no mask for opaque images).  Assumes
+ *  the 0xRRGGBB TrueColor visual vt_term's colours already rely on.
  ****/
-static bool RemoveCheckeredBackground(png_bytep** row_pointers_ptr, int width, int height, 
-                                       int& channels, int& rowbytes)
+static int UploadRgbaImage(const vt::RgbaImage &image, Pixmap &pixmap, Pixmap &mask)
 {
-    FnTrace("RemoveCheckeredBackground()");
-    
-    fprintf(stderr, "RemoveCheckeredBackground: Processing image %dx%d, channels=%d\n", 
-            width, height, channels);
-    
-    // Common checkered background colors (light gray and white variations)
-    // Typical patterns: #C0C0C0/#FFFFFF, #D0D0D0/#FFFFFF, #E0E0E0/#FFFFFF
-    const int CHECKERED_COLOR_THRESHOLD = 40;  // Tolerance for color matching
-    const int MIN_LIGHTNESS = 180;  // Minimum RGB average for checkered colors (light colors only)
-    
-    // Checkered pattern typically uses 8x8 or 16x16 pixel squares
-    const int CHECKER_SIZE_MIN = 4;
-    const int CHECKER_SIZE_MAX = 32;
-    
-    png_bytep* row_pointers = *row_pointers_ptr;
-    
-    // We need RGB data to detect checkered patterns
-    if (channels < 3) {
-        return false;  // Can't detect checkered pattern in grayscale
-    }
-    
-    // First pass: detect if checkered pattern exists by sampling
-    int total_pixels = width * height;
-    int checkered_threshold = total_pixels / 50;  // At least 2% of pixels should match
-    
-    // Try different checker sizes to detect pattern
-    int detected_checker_size = 0;
-    int best_match_score = 0;
-    
-    for (int checker_size = CHECKER_SIZE_MIN; checker_size <= CHECKER_SIZE_MAX; checker_size *= 2) {
-        int pattern_matches = 0;
-        int samples = 0;
-        
-        // Sample the image to detect checkered pattern
-        // Check multiple positions to find the pattern
-        for (int offset_y = 0; offset_y < checker_size && offset_y < height; offset_y++) {
-            for (int offset_x = 0; offset_x < checker_size && offset_x < width; offset_x++) {
-                for (int y = offset_y; y < height - checker_size; y += checker_size * 2) {
-                    for (int x = offset_x; x < width - checker_size; x += checker_size * 2) {
-                        samples++;
-                        
-                        // Get colors from two adjacent squares in the checker pattern
-                        if (y + checker_size / 2 < height && x + checker_size / 2 < width) {
-                            png_bytep row1 = row_pointers[y];
-                            png_bytep row2 = row_pointers[y + checker_size / 2];
-                            
-                            unsigned char r1 = row1[x * channels + 0];
-                            unsigned char g1 = row1[x * channels + 1];
-                            unsigned char b1 = row1[x * channels + 2];
-                            
-                            unsigned char r2 = row2[(x + checker_size / 2) * channels + 0];
-                            unsigned char g2 = row2[(x + checker_size / 2) * channels + 1];
-                            unsigned char b2 = row2[(x + checker_size / 2) * channels + 2];
-                            
-                            // Check if colors are light (potential checkered background)
-                            int lightness1 = (r1 + g1 + b1) / 3;
-                            int lightness2 = (r2 + g2 + b2) / 3;
-                            
-                            if (lightness1 >= MIN_LIGHTNESS && lightness2 >= MIN_LIGHTNESS) {
-                                // Check if colors are different (alternating pattern)
-                                int diff_r = abs((int)r1 - (int)r2);
-                                int diff_g = abs((int)g1 - (int)g2);
-                                int diff_b = abs((int)b1 - (int)b2);
-                                
-                                if (diff_r + diff_g + diff_b > CHECKERED_COLOR_THRESHOLD) {
-                                    pattern_matches++;
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                // Check if this offset gives us a good pattern match
-                if (samples > 0) {
-                    int match_score = pattern_matches * 100 / samples;
-                    if (match_score > best_match_score) {
-                        best_match_score = match_score;
-                        detected_checker_size = checker_size;
-                    }
-                }
-            }
-        }
-    }
-    
-    // Also try a simpler approach: just count light pixels that could be checkered
-    int light_pixel_count = 0;
-    for (int y = 0; y < height; y++) {
-        png_bytep row = row_pointers[y];
-        for (int x = 0; x < width; x++) {
-            unsigned char r = row[x * channels + 0];
-            unsigned char g = row[x * channels + 1];
-            unsigned char b = row[x * channels + 2];
-            int lightness = (r + g + b) / 3;
-            
-            // Count very light pixels (white or light gray)
-            if (lightness >= 240 || (lightness >= 190 && lightness <= 230)) {
-                int color_variance = abs((int)r - (int)g) + abs((int)g - (int)b) + abs((int)r - (int)b);
-                if (color_variance < 30) {  // Grayish or white
-                    light_pixel_count++;
-                }
-            }
-        }
-    }
-    
-    // If we have a lot of light pixels, likely has checkered background
-    bool has_many_light_pixels = (light_pixel_count * 100 / total_pixels) > 10;  // More than 10% light pixels
-    
-    if (detected_checker_size == 0 && !has_many_light_pixels) {
-        fprintf(stderr, "RemoveCheckeredBackground: No checkered pattern detected\n");
-        return false;  // No checkered pattern detected
-    }
-    
-    if (detected_checker_size > 0) {
-        fprintf(stderr, "RemoveCheckeredBackground: Detected checkered pattern (checker size ~%d, %d%% match)\n", 
-                detected_checker_size, best_match_score);
-    } else if (has_many_light_pixels) {
-        fprintf(stderr, "RemoveCheckeredBackground: Detected many light pixels (%.1f%%), treating as checkered background\n",
-                light_pixel_count * 100.0 / total_pixels);
-        // Use a default checker size for removal
-        detected_checker_size = 8;
-    }
-    
-    // Convert to RGBA if not already (needed to add transparency)
-    bool needs_alpha = (channels == 3);
-    png_bytep* new_row_pointers = nullptr;
-    
-    if (needs_alpha) {
-        // Allocate new row pointers with alpha channel
-        int new_rowbytes = width * 4;
-        new_row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * height);
-        if (!new_row_pointers) {
-            fprintf(stderr, "RemoveCheckeredBackground: Cannot allocate new row pointers\n");
-            return false;
+    FnTrace("UploadRgbaImage()");
+
+    pixmap = 0;
+    mask = 0;
+    if (!image.Valid())
+        return 1;
+
+    const int width  = image.width;
+    const int height = image.height;
+    std::vector<uint32_t> pixels(image.pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = vt::Unpremultiply(image.pixels[i]) & 0xFFFFFF;
+
+    XImage ximage{};
+    ximage.width            = width;
+    ximage.height           = height;
+    ximage.format           = ZPixmap;
+    ximage.data             = reinterpret_cast<char*>(pixels.data());
+    ximage.byte_order       = (std::endian::native == std::endian::little) ? LSBFirst : MSBFirst;
+    ximage.bitmap_unit      = 32;
+    ximage.bitmap_bit_order = ximage.byte_order;
+    ximage.bitmap_pad       = 32;
+    ximage.depth            = ScrDepth;
+    ximage.bytes_per_line   = width * 4;
+    ximage.bits_per_pixel   = 32;
+    ximage.red_mask         = ScrVis->red_mask;
+    ximage.green_mask       = ScrVis->green_mask;
+    ximage.blue_mask        = ScrVis->blue_mask;
+    if (XInitImage(&ximage) == 0)
+        return 1;
+
+    pixmap = XCreatePixmap(Dis, MainWin, width, height, ScrDepth);
+    XPutImage(Dis, pixmap, Gfx, &ximage, 0, 0, 0, 0, width, height);
+
+    if (image.has_alpha)
+    {
+        const int mask_bpl = (width + 7) / 8;
+        std::vector<unsigned char> bits(static_cast<size_t>(mask_bpl) * static_cast<size_t>(height), 0);
+        for (int y = 0; y < height; ++y)
+        {
+            const uint32_t *row = image.pixels.data() + static_cast<size_t>(y) * width;
+            unsigned char *out = bits.data() + static_cast<size_t>(y) * mask_bpl;
+            for (int x = 0; x < width; ++x)
+                if ((row[x] >> 24) >= 128)
+                    out[x >> 3] |= static_cast<unsigned char>(1 << (x & 7));
         }
-        
-        for (int y = 0; y < height; y++) {
-            new_row_pointers[y] = (png_byte*)malloc(new_rowbytes);
-            if (!new_row_pointers[y]) {
-                fprintf(stderr, "RemoveCheckeredBackground: Cannot allocate new row data\n");
-                for (int i = 0; i < y; i++) free(new_row_pointers[i]);
-                free(new_row_pointers);
-                return false;
-            }
-            
-            // Copy RGB data and add alpha channel (fully opaque initially)
-            for (int x = 0; x < width; x++) {
-                new_row_pointers[y][x * 4 + 0] = row_pointers[y][x * 3 + 0];
-                new_row_pointers[y][x * 4 + 1] = row_pointers[y][x * 3 + 1];
-                new_row_pointers[y][x * 4 + 2] = row_pointers[y][x * 3 + 2];
-                new_row_pointers[y][x * 4 + 3] = 255;  // Fully opaque initially
-            }
+
+        XImage mask_image{};
+        mask_image.width            = width;
+        mask_image.height           = height;
+        mask_image.format           = XYBitmap;
+        mask_image.data             = reinterpret_cast<char*>(bits.data());
+        mask_image.byte_order       = LSBFirst;
+        mask_image.bitmap_unit      = 8;
+        mask_image.bitmap_bit_order = LSBFirst;
+        mask_image.bitmap_pad       = 8;
+        mask_image.depth            = 1;
+        mask_image.bytes_per_line   = mask_bpl;
+        mask_image.bits_per_pixel   = 1;
+        if (XInitImage(&mask_image))
+        {
+            mask = XCreatePixmap(Dis, MainWin, width, height, 1);
+            GC mask_gc = XCreateGC(Dis, mask, 0, nullptr);
+            XPutImage(Dis, mask, mask_gc, &mask_image, 0, 0, 0, 0, width, height);
+            XFreeGC(Dis, mask_gc);
         }
-        
-        // Update to use new row pointers
-        *row_pointers_ptr = new_row_pointers;
-        row_pointers = new_row_pointers;
-        channels = 4;
-        rowbytes = new_rowbytes;
-    } else if (channels == 4) {
-        // Image already has alpha channel - we'll modify it
-        // Make sure existing transparent pixels stay transparent
-        fprintf(stderr, "RemoveCheckeredBackground: Image already has alpha channel, will modify existing transparency\n");
     }
-    
-    // Second pass: remove checkered background pixels
-    int checkered_pixel_count = 0;
-    for (int y = 0; y < height; y++) {
-        png_bytep row = row_pointers[y];
-        for (int x = 0; x < width; x++) {
-            unsigned char r = row[x * channels + 0];
-            unsigned char g = row[x * channels + 1];
-            unsigned char b = row[x * channels + 2];
-            
-            int lightness = (r + g + b) / 3;
-            int color_variance = abs((int)r - (int)g) + abs((int)g - (int)b) + abs((int)r - (int)b);
-            
-            bool should_remove = false;
-            
-            // Simple and aggressive: remove any pixel that looks like checkered background
-            // Check for white pixels (very common in checkered backgrounds: #FFFFFF, #FEFEFE, etc.)
-            if (r >= 240 && g >= 240 && b >= 240) {
-                should_remove = true;
-            }
-            // Check for light gray pixels - common checkered background colors:
-            // #C0C0C0 (192), #D0D0D0 (208), #E0E0E0 (224), #F0F0F0 (240)
-            else if (lightness >= 180 && lightness <= 245) {
-                // Check if it's a uniform grayish color (low color variance = gray, not colored)
-                if (color_variance < 45) {
-                    // This is a light grayish color - very likely checkered background
-                    should_remove = true;
-                }
-            }
-            
-            // Note: We don't require perfect pattern matching - if it's a light uniform color,
-            // it's likely a checkered background pixel, so remove it.
-            
-            if (should_remove) {
-                // Only remove if pixel isn't already transparent (preserve existing transparency)
-                unsigned char current_alpha = (channels == 4) ? row[x * channels + 3] : 255;
-                if (current_alpha > 0) {  // Not already transparent
-                    row[x * channels + 3] = 0;  // Make transparent
-                    checkered_pixel_count++;
-                }
-            }
-        }
+    return 0;
+}
+
+/****
+ * RgbaToXpm:  The decoded image at its own size, refused (like .xpm files)
+ *  if it is bigger than the window.
+ ****/
+static Xpm *RgbaToXpm(const vt::RgbaImage &image, const char* file_name)
+{
+    FnTrace("RgbaToXpm()");
+
+    if (image.width > WinWidth || image.height > WinHeight)
+    {
+        fprintf(stderr, "Image %s too large (%dx%d > %dx%d)\n", file_name,
+                image.width, image.height, WinWidth, WinHeight);
+        return nullptr;
     }
-    
-    fprintf(stderr, "RemoveCheckeredBackground: Removed %d checkered background pixels (%.1f%%)\n", 
-            checkered_pixel_count, checkered_pixel_count * 100.0 / total_pixels);
-    
-    return checkered_pixel_count > checkered_threshold;
+    Pixmap pixmap = 0;
+    Pixmap mask = 0;
+    if (UploadRgbaImage(image, pixmap, mask))
+        return nullptr;
+    return new Xpm(pixmap, mask, image.width, image.height);
 }
 
+#ifdef HAVE_PNG
 /****
  * LoadPNGFile: Load a PNG file and convert it to an Xpm object
  ****/
@@ -2958,252 +3232,10 @@ Xpm *LoadPNGFile(const char* file_name)
 {
     FnTrace("LoadPNGFile()");
 
-    if (!file_name) {
-        fprintf(stderr, "LoadPNGFile: No filename provided\n");
+    vt::RgbaImage image;
+    if (vt::DecodePNG(file_name, image))
         return nullptr;
-    }
-
-    FILE *fp = fopen(file_name, "rb");
-    if (!fp) {
-        fprintf(stderr, "LoadPNGFile: Cannot open file %s\n", file_name);
-        return nullptr;
-    }
-
-    // Read PNG header to verify format
-    std::array<png_byte, 8> header{};
-    if (fread(header.data(), 1, header.size(), fp) != header.size()) {
-        fprintf(stderr, "LoadPNGFile: Cannot read PNG header from %s\n", file_name);
-        fclose(fp);
-        return nullptr;
-    }
-
-    if (png_sig_cmp(header.data(), 0, header.size())) {
-        fprintf(stderr, "LoadPNGFile: File %s is not a valid PNG\n", file_name);
-        fclose(fp);
-        return nullptr;
-    }
-
-    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-    if (!png_ptr) {
-        fprintf(stderr, "LoadPNGFile: Cannot create PNG read struct\n");
-        fclose(fp);
-        return nullptr;
-    }
-
-    png_infop info_ptr = png_create_info_struct(png_ptr);
-    if (!info_ptr) {
-        fprintf(stderr, "LoadPNGFile: Cannot create PNG info struct\n");
-        png_destroy_read_struct(&png_ptr, nullptr, nullptr);
-        fclose(fp);
-        return nullptr;
-    }
-
-    if (setjmp(png_jmpbuf(png_ptr))) {
-        fprintf(stderr, "LoadPNGFile: PNG read error in %s\n", file_name);
-        png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-        fclose(fp);
-        return nullptr;
-    }
-
-    png_init_io(png_ptr, fp);
-    png_set_sig_bytes(png_ptr, 8);
-    png_read_info(png_ptr, info_ptr);
-
-    int width = png_get_image_width(png_ptr, info_ptr);
-    int height = png_get_image_height(png_ptr, info_ptr);
-    png_byte color_type = png_get_color_type(png_ptr, info_ptr);
-    png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
-
-    fprintf(stderr, "LoadPNGFile: Loading %s - %dx%d, color_type=%d, bit_depth=%d\n",
-            file_name, width, height, color_type, bit_depth);
-
-    // Convert palette images to RGB
-    if (color_type == PNG_COLOR_TYPE_PALETTE)
-        png_set_palette_to_rgb(png_ptr);
-
-    // Ensure we have at least 8 bits per channel
-    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
-        png_set_expand_gray_1_2_4_to_8(png_ptr);
-
-    // Convert grayscale to RGB
-    if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
-        png_set_gray_to_rgb(png_ptr);
-
-    // Add alpha channel if missing for consistency
-    if (color_type != PNG_COLOR_TYPE_RGBA && png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
-        png_set_tRNS_to_alpha(png_ptr);
-
-    // Ensure 8-bit depth
-    if (bit_depth == 16)
-        png_set_strip_16(png_ptr);
-
-    png_read_update_info(png_ptr, info_ptr);
-
-    int rowbytes = png_get_rowbytes(png_ptr, info_ptr);
-    int channels = png_get_channels(png_ptr, info_ptr);
-    fprintf(stderr, "LoadPNGFile: Row bytes = %d, channels = %d\n", rowbytes, channels);
-
-    // Allocate image data
-    auto* row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * height);
-    if (!row_pointers) {
-        fprintf(stderr, "LoadPNGFile: Cannot allocate row pointers\n");
-        png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-        fclose(fp);
-        return nullptr;
-    }
-
-    for (int y = 0; y < height; y++) {
-        row_pointers[y] = (png_byte*)malloc(rowbytes);
-        if (!row_pointers[y]) {
-            fprintf(stderr, "LoadPNGFile: Cannot allocate row data\n");
-            for (int i = 0; i < y; i++) free(row_pointers[i]);
-            free(row_pointers);
-            png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-            fclose(fp);
-            return nullptr;
-        }
-    }
-
-    png_read_image(png_ptr, row_pointers);
-
-    // Remove checkered backgrounds if detected
-    png_bytep* original_row_pointers = row_pointers;
-    bool checkered_removed = RemoveCheckeredBackground(&row_pointers, width, height, channels, rowbytes);
-    if (checkered_removed && row_pointers != original_row_pointers) {
-        // Free original row pointers if they were replaced
-        for (int y = 0; y < height; y++) {
-            free(original_row_pointers[y]);
-        }
-        free(original_row_pointers);
-        fprintf(stderr, "LoadPNGFile: Checkered background removed, image converted to RGBA\n");
-    }
-
-    // Convert to X11 Pixmap with transparency mask
-    Pixmap pixmap = 0;
-    Pixmap mask = 0;
-    bool has_transparency = (channels == 4);  // RGBA format
-    
-    if (width <= WinWidth && height <= WinHeight) {
-        Visual *visual = DefaultVisual(Dis, DefaultScreen(Dis));
-        int depth = DefaultDepth(Dis, DefaultScreen(Dis));
-
-        fprintf(stderr, "LoadPNGFile: Creating pixmap %dx%d, depth=%d, has_transparency=%d\n", 
-                width, height, depth, has_transparency);
-
-        pixmap = XCreatePixmap(Dis, MainWin, width, height, depth);
-        if (!pixmap) {
-            fprintf(stderr, "LoadPNGFile: Cannot create pixmap\n");
-        } else {
-            // Create mask pixmap if we have transparency
-            if (has_transparency) {
-                mask = XCreatePixmap(Dis, MainWin, width, height, 1);  // 1-bit depth for mask
-                if (!mask) {
-                    fprintf(stderr, "LoadPNGFile: Cannot create mask pixmap\n");
-                }
-            }
-            
-            // Create XImage with proper format for the visual
-            XImage *ximage = XCreateImage(Dis, visual, depth, ZPixmap, 0,
-                                         (char*)malloc(width * height * 4), width, height, 32, 0);
-            if (!ximage) {
-                fprintf(stderr, "LoadPNGFile: Cannot create XImage\n");
-                XFreePixmap(Dis, pixmap);
-                if (mask) XFreePixmap(Dis, mask);
-                pixmap = 0;
-                mask = 0;
-            } else {
-                // Create mask image if needed
-                XImage *mask_image = nullptr;
-                if (mask) {
-                    mask_image = XCreateImage(Dis, visual, 1, XYBitmap, 0,
-                                            (char*)malloc((width + 7) / 8 * height), 
-                                            width, height, 8, 0);
-                    if (mask_image) {
-                        // Initialize mask to all transparent
-                        memset(mask_image->data, 0, (width + 7) / 8 * height);
-                    }
-                }
-                
-                // Copy PNG data to XImage pixels
-                for (int y = 0; y < height; y++) {
-                    png_bytep row = row_pointers[y];
-                    for (int x = 0; x < width; x++) {
-                        unsigned long pixel;
-                        bool is_opaque = true;
-                        
-                        if (channels >= 3) {
-                            // RGB or RGBA format
-                            unsigned char r = row[x*channels + 0];
-                            unsigned char g = row[x*channels + 1];
-                            unsigned char b = row[x*channels + 2];
-
-                            if (channels == 4) {
-                                // RGBA format - handle alpha transparency
-                                unsigned char a = row[x*channels + 3];
-                                is_opaque = (a >= 128);  // Threshold for transparency
-                                
-                                if (!is_opaque) {
-                                    // Set pixel to black for transparent areas (will be masked)
-                                    pixel = 0;
-                                } else {
-                                    pixel = (r << 16) | (g << 8) | b;
-                                }
-                            } else {
-                                // RGB format - fully opaque
-                                pixel = (r << 16) | (g << 8) | b;
-                            }
-                        } else if (channels == 1) {
-                            // Grayscale - fully opaque
-                            unsigned char gray = row[x];
-                            pixel = (gray << 16) | (gray << 8) | gray;
-                        } else {
-                            // Unknown format, use black
-                            pixel = 0;
-                        }
-                        XPutPixel(ximage, x, y, pixel);
-                        
-                        // Update mask if we have one
-                        if (mask_image && is_opaque) {
-                            XPutPixel(mask_image, x, y, 1);  // 1 = opaque, 0 = transparent
-                        }
-                    }
-                }
-
-                // Put image to pixmap
-                XPutImage(Dis, pixmap, Gfx, ximage, 0, 0, 0, 0, width, height);
-                
-                // Put mask to mask pixmap
-                if (mask && mask_image) {
-                    GC mask_gc = XCreateGC(Dis, mask, 0, nullptr);
-                    XPutImage(Dis, mask, mask_gc, mask_image, 0, 0, 0, 0, width, height);
-                    XFreeGC(Dis, mask_gc);
-                    XDestroyImage(mask_image);
-                }
-                
-                XDestroyImage(ximage);
-                fprintf(stderr, "LoadPNGFile: Successfully loaded PNG with%s transparency\n",
-                        mask ? "" : "out");
-            }
-        }
-    } else {
-        fprintf(stderr, "LoadPNGFile: Image too large (%dx%d > %dx%d)\n",
-                width, height, WinWidth, WinHeight);
-    }
-
-    // Cleanup
-    for (int y = 0; y < height; y++) {
-        free(row_pointers[y]);
-    }
-    free(row_pointers);
-    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-    fclose(fp);
-
-    if (pixmap) {
-        return new Xpm(pixmap, mask, width, height);
-    }
-
-    fprintf(stderr, "LoadPNGFile: Failed to load PNG %s\n", file_name);
-    return nullptr;
+    return RgbaToXpm(image, file_name);
 }
 #endif
 
@@ -3215,67 +3247,10 @@ Xpm *LoadJPEGFile(const char* file_name)
 {
     FnTrace("LoadJPEGFile()");
 
-    if (!file_name)
-        return nullptr;
-
-    FILE *fp = fopen(file_name, "rb");
-    if (!fp)
+    vt::RgbaImage image;
+    if (vt::DecodeJPEG(file_name, image))
         return nullptr;
-
-    struct jpeg_decompress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, fp);
-    jpeg_read_header(&cinfo, TRUE);
-    jpeg_start_decompress(&cinfo);
-
-    int width = cinfo.output_width;
-    int height = cinfo.output_height;
-    int num_components = cinfo.output_components;
-
-    // Allocate image data
-    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)
-        ((j_common_ptr) &cinfo, JPOOL_IMAGE, width * num_components, 1);
-
-    Pixmap pixmap = 0;
-    if (width <= WinWidth && height <= WinHeight) {
-        pixmap = XCreatePixmap(Dis, MainWin, width, height, DefaultDepth(Dis, DefaultScreen(Dis)));
-
-        XImage *ximage = XCreateImage(Dis, DefaultVisual(Dis, DefaultScreen(Dis)),
-                                     DefaultDepth(Dis, DefaultScreen(Dis)), ZPixmap, 0,
-                                     (char*)malloc(width * height * 4), width, height, 32, 0);
-
-        // Read and convert JPEG data
-        while (cinfo.output_scanline < height) {
-            jpeg_read_scanlines(&cinfo, buffer, 1);
-            int y = cinfo.output_scanline - 1;
-
-            for (int x = 0; x < width; x++) {
-                unsigned long pixel = 0;
-                if (num_components >= 3) {
-                    pixel = (buffer[0][x*num_components+0] << 16) |
-                           (buffer[0][x*num_components+1] << 8) |
-                           buffer[0][x*num_components+2];
-                }
-                XPutPixel(ximage, x, y, pixel);
-            }
-        }
-
-        XPutImage(Dis, pixmap, Gfx, ximage, 0, 0, 0, 0, width, height);
-        XDestroyImage(ximage);
-    }
-
-    jpeg_finish_decompress(&cinfo);
-    jpeg_destroy_decompress(&cinfo);
-    fclose(fp);
-
-    if (pixmap) {
-        return new Xpm(pixmap, width, height);
-    }
-
-    return nullptr;
+    return RgbaToXpm(image, file_name);
 }
 #endif
 
@@ -3287,72 +3262,10 @@ Xpm *LoadGIFFile(const char* file_name)
 {
     FnTrace("LoadGIFFile()");
 
-    if (!file_name)
-        return nullptr;
-
-    // For simplicity, we'll use libgif to load the first frame
-    GifFileType *gif = DGifOpenFileName(file_name, NULL);
-    if (!gif) {
-        return nullptr;
-    }
-
-    if (DGifSlurp(gif) != GIF_OK) {
-        DGifCloseFile(gif, NULL);
+    vt::RgbaImage image;
+    if (vt::DecodeGIF(file_name, image))
         return nullptr;
-    }
-
-    if (gif->ImageCount == 0) {
-        DGifCloseFile(gif, NULL);
-        return nullptr;
-    }
-
-    SavedImage *image = &gif->SavedImages[0];
-    GifImageDesc *desc = &image->ImageDesc;
-    ColorMapObject *color_map = image->ImageDesc.ColorMap ?
-                               image->ImageDesc.ColorMap : gif->SColorMap;
-
-    if (!color_map) {
-        DGifCloseFile(gif, NULL);
-        return nullptr;
-    }
-
-    int width = desc->Width;
-    int height = desc->Height;
-
-    Pixmap pixmap = 0;
-    if (width <= WinWidth && height <= WinHeight) {
-        pixmap = XCreatePixmap(Dis, MainWin, width, height, DefaultDepth(Dis, DefaultScreen(Dis)));
-
-        XImage *ximage = XCreateImage(Dis, DefaultVisual(Dis, DefaultScreen(Dis)),
-                                     DefaultDepth(Dis, DefaultScreen(Dis)), ZPixmap, 0,
-                                     (char*)malloc(width * height * 4), width, height, 32, 0);
-
-        // Convert GIF pixels to X11 pixels
-        GifPixelType *gif_pixels = image->RasterBits;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                int pixel_index = y * width + x;
-                GifPixelType color_index = gif_pixels[pixel_index];
-
-                if (color_index < color_map->ColorCount) {
-                    GifColorType *color = &color_map->Colors[color_index];
-                    unsigned long pixel = (color->Red << 16) | (color->Green << 8) | color->Blue;
-                    XPutPixel(ximage, x, y, pixel);
-                }
-            }
-        }
-
-        XPutImage(Dis, pixmap, Gfx, ximage, 0, 0, 0, 0, width, height);
-        XDestroyImage(ximage);
-    }
-
-    DGifCloseFile(gif, NULL);
-
-    if (pixmap) {
-        return new Xpm(pixmap, width, height);
-    }
-
-    return nullptr;
+    return RgbaToXpm(image, file_name);
 }
 #endif
 
@@ -3768,6 +3681,240 @@ static bool IsRaspberryPi()
     return is_pi;
 }
 
+/****
+ * SetTranslations:  Replaces the dialog translations and notes the hash
+ *  vt_main compares against its own table (see Terminal::ReadAssetHashes()).
+ ****/
+static void SetTranslations(const vt::TranslationList &list)
+{
+    vt::ContentHash hash;
+    MasterTranslations.Clear();
+    for (const auto& [key, value] : list)
+    {
+        MasterTranslations.AddTranslation(key.c_str(), value.c_str());
+        hash.Add(key).Add(value);
+    }
+    TranslationsHash = hash.Hex();
+    new_page_translations = 1;
+    new_zone_translations = 1;
+}
+
+/****
+ * SendAssetHashes:  Tells vt_main what vt_term already has from an earlier
+ *  run, so only what changed is sent.  The caller is responsible for
+ *  SendNow().
+ ****/
+static int SendAssetHashes()
+{
+    FnTrace("SendAssetHashes()");
+
+    WInt8(ToInt(ServerProtocol::SrvAssetHashes));
+    WInt8(1);
+    WStr("translations");
+    WStr(TranslationsHash.c_str());
+    return 0;
+}
+
+/****
+ * LoadCachedAssets:  Starts with the translations of the last run.  An
+ *  empty VT_ASSET_CACHE turns the cache off.
+ ****/
+static int LoadCachedAssets()
+{
+    FnTrace("LoadCachedAssets()");
+
+    const char* asset_dir = getenv("VT_ASSET_CACHE");
+    TermAssets.SetDirectory(asset_dir ? asset_dir : vt::AssetCache::DefaultDirectory());
+
+    std::string data;
+    vt::TranslationList list;
+    if (TermAssets.Load("translations", data) || vt::UnpackTranslations(data, list))
+        return 1;
+    SetTranslations(list);
+    return 0;
+}
+
+/****
+ * FontSlot:  The FontData entry that draws font_id.  FONT_DEFAULT, and any
+ *  id vt_main sends that vt_term doesn't know, draw with FONT_TIMES_24.
+ ****/
+static int FontSlot(const int font_id) noexcept
+{
+    for (const auto& fontData : FontData)
+    {
+        if (fontData.id == font_id)
+            return font_id;
+    }
+    return FONT_TIMES_24;
+}
+
+/****
+ * XftFontSpec:  The fontconfig name of a FontData entry, at the fixed 96 DPI
+ *  that keeps fonts the same size on every display.
+ ****/
+static std::string XftFontSpec(const int font_id)
+{
+    for (const auto& fontData : FontData)
+    {
+        if (fontData.id != font_id)
+            continue;
+        std::string name = fontData.font;
+        if (name.find(":dpi=") == std::string::npos)
+            name += ":dpi=96";
+        return name;
+    }
+    return {};
+}
+
+// The cache entry for a FontData font, if it has the metrics vt_main needs
+static const vt::ResolvedFont *FindResolvedFont(const int font_id)
+{
+    size_t glyphs = 0;
+    for (const auto& range : vt::GLYPH_RANGES)
+        glyphs += range.count;
+    const vt::ResolvedFont *font = ResolvedFonts.Find(XftFontSpec(FontSlot(font_id)));
+    if (font == nullptr || font->advances.size() != glyphs)
+        return nullptr;
+    return font;
+}
+
+static void SetFontSize(const int font_id, const int ascent, const int descent) noexcept
+{
+    FontHeight[font_id]   = ascent + descent;
+    FontBaseline[font_id] = ascent;
+}
+
+/****
+ * MeasureXftFont:  What fontconfig matched for an open font, with the glyph
+ *  advances SendFontMetrics() reports, for the per-host font cache.
+ ****/
+static vt::ResolvedFont MeasureXftFont(XftFont *font)
+{
+    vt::ResolvedFont resolved;
+    if (FcChar8 *name = FcNameUnparse(font->pattern))
+    {
+        resolved.pattern = reinterpret_cast<const char*>(name);
+        FcStrFree(name);
+    }
+    FcChar8 *file = nullptr;
+    if (FcPatternGetString(font->pattern, FC_FILE, 0, &file) == FcResultMatch && file)
+        resolved.file = reinterpret_cast<const char*>(file);
+    resolved.file_mtime = vt::FontCache::FileTime(resolved.file);
+
+    XGlyphInfo extents;
+    XftTextExtents8(Dis, font, reinterpret_cast<const FcChar8*>("M"), 1, &extents);
+    resolved.ascent = font->ascent;
+    resolved.descent = font->descent;
+    resolved.default_advance = extents.xOff;
+    for (const auto& range : vt::GLYPH_RANGES)
+    {
+        for (uint32_t cp = range.first; cp < range.first + range.count; ++cp)
+        {
+            FT_UInt glyph = XftCharIndex(Dis, font, cp);
+            XftGlyphExtents(Dis, font, &glyph, 1, &extents);
+            resolved.advances.push_back(static_cast<uint8_t>(Max(0, Min(255, static_cast<int>(extents.xOff)))));
+        }
+    }
+    return resolved;
+}
+
+/****
+ * AddXftFont:  Installs a newly opened font (nullptr if it couldn't be
+ *  opened) and records its match so the next start can skip matching.
+ ****/
+static XftFont *AddXftFont(const int f, XftFont *font, const int from_cache)
+{
+    if (font == nullptr)
+    {
+        std::string spec = XftFontSpec(f);
+        printf("Failed to load Xft font: %s, trying fallback\n", spec.c_str());
+        font = XftFontOpenName(Dis, ScrNo, "DejaVu Serif:size=24:style=Book:dpi=96");
+        if (font == nullptr)
+            printf("Failed to load fallback font too!\n");
+    }
+    else if (from_cache == 0)
+        ResolvedFonts.Store(XftFontSpec(f), MeasureXftFont(font));
+
+    XftFontsArr[f] = font;
+    XftFontTried[f] = true;
+    if (font)
+        SetFontSize(f, font->ascent, font->descent);
+    else
+        SetFontSize(f, 20, 8);  // fallback values if font loading fails
+    return font;
+}
+
+/****
+ * LoadXftFont:  Fonts are opened the first time they're drawn or measured.
+ *  A font matched on an earlier run is opened straight from the saved
+ *  pattern, skipping fontconfig's match (the slow part on SD cards).
+ ****/
+static XftFont *LoadXftFont(const int font_id)
+{
+    const int f = FontSlot(font_id);
+    if (XftFontsArr[f] || XftFontTried[f] || Dis == nullptr)
+        return XftFontsArr[f];
+
+    if (const vt::ResolvedFont *resolved = FindResolvedFont(f))
+    {
+        FcPattern *pattern = FcNameParse(reinterpret_cast<const FcChar8*>(resolved->pattern.c_str()));
+        XftFont *font = pattern ? XftFontOpenPattern(Dis, pattern) : nullptr;
+        if (font)
+            return AddXftFont(f, font, 1);
+        if (pattern)
+            FcPatternDestroy(pattern);
+    }
+    return AddXftFont(f, XftFontOpenName(Dis, ScrNo, XftFontSpec(f).c_str()), 0);
+}
+
+/****
+ * ResolveFonts:  Matches and opens every font the cache doesn't know yet, so
+ *  SendFontMetrics() has their widths.  Substitution reads the X resources
+ *  and stays on this thread; the fontconfig matches run in the thread pool.
+ *  Saves the cache when anything was added.
+ ****/
+static int ResolveFonts()
+{
+    FnTrace("ResolveFonts()");
+
+    std::vector<int> fonts;
+    std::vector<std::future<FcPattern*>> matches;
+    for (const auto& fontData : FontData)
+    {
+        const int f = fontData.id;
+        if (XftFontTried[f] || FindResolvedFont(f))
+            continue;
+        FcPattern *pattern = FcNameParse(reinterpret_cast<const FcChar8*>(XftFontSpec(f).c_str()));
+        if (pattern == nullptr)
+        {
+            AddXftFont(f, nullptr, 0);
+            continue;
+        }
+        FcConfigSubstitute(nullptr, pattern, FcMatchPattern);
+        XftDefaultSubstitute(Dis, ScrNo, pattern);
+        fonts.push_back(f);
+        matches.push_back(vt::ThreadPool::instance().enqueue([pattern]() {
+            FcResult result;
+            FcPattern *match = FcFontMatch(nullptr, pattern, &result);
+            FcPatternDestroy(pattern);
+            return match;
+        }));
+    }
+
+    for (size_t i = 0; i < fonts.size(); ++i)
+    {
+        FcPattern *match = matches[i].get();
+        XftFont *font = match ? XftFontOpenPattern(Dis, match) : nullptr;
+        if (font == nullptr && match)
+            FcPatternDestroy(match);
+        AddXftFont(fonts[i], font, 0);
+    }
+
+    if (ResolvedFonts.Dirty() && !FontCachePath.empty() && ResolvedFonts.Save(FontCachePath))
+        ReportError("Unable to save font cache '" + FontCachePath + "'");
+    return static_cast<int>(fonts.size());
+}
+
 int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_hardware,
              int set_width, int set_height)
 {
@@ -3775,8 +3922,17 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
 
     int i;
 
+    StartupMark("launch");
+
     srand(time(nullptr));
 
+    // VT_PROTOCOL_RECORD=<file> captures the session for vt_replay
+    if (auto recorder = vt::ProtocolRecorder::FromEnvironment())
+    {
+        BufferIn.SetRecorder(recorder, vt::RecordDirection::ToTerminal);
+        BufferOut.SetRecorder(recorder, vt::RecordDirection::ToServer);
+    }
+
     // Init Xt & Create Application Context
     App = XtCreateApplicationContext();
 
@@ -3796,6 +3952,7 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
         ReportError(error_msg);
         throw DisplayException(error_msg);
     }
+    StartupMark("display");
 
     Connection = ConnectionNumber(Dis);
     ScrNo      = DefaultScreen(Dis);
@@ -3803,6 +3960,43 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
     ScrVis     = DefaultVisual(Dis, ScrNo);
     ScrCol     = DefaultColormap(Dis, ScrNo);
     ScrDepth   = DefaultDepth(Dis, ScrNo);
+
+    // VT_RENDER=software draws every Layer into an in-memory framebuffer.
+    // The canvas stores 0xRRGGBB, so it needs a visual that uses the same.
+    const char* render = getenv("VT_RENDER");
+    if (render && strcmp(render, "software") == 0)
+    {
+        if (ScrVis->c_class == TrueColor && ScrDepth >= 24 &&
+            ScrVis->red_mask == 0xFF0000 && ScrVis->green_mask == 0xFF00 &&
+            ScrVis->blue_mask == 0xFF)
+            SoftRendering = 1;
+        else
+            ReportError("VT_RENDER=software needs a 24 bit RGB TrueColor visual, using X rendering");
+    }
+
+    // VT_IMAGE_CACHE_MB caps the memory held by decoded button/table images
+    const char* cache_mb = getenv("VT_IMAGE_CACHE_MB");
+    if (cache_mb && *cache_mb)
+        PixmapCache.SetMaxBytes(static_cast<size_t>(std::strtoul(cache_mb, nullptr, 10)) * 1024 * 1024);
+
+    // VT_ZONE_CACHE_MB caps the pre-rendered button backgrounds; 0 turns them off
+    const char* zone_mb = getenv("VT_ZONE_CACHE_MB");
+    if (zone_mb && *zone_mb)
+        ZoneCache.SetMaxBytes(static_cast<size_t>(std::strtoul(zone_mb, nullptr, 10)) * 1024 * 1024);
+
+    // VT_FRAME_MS sets how long server updates are gathered before drawing;
+    // 0 draws each one as it arrives
+    const char* frame_ms = getenv("VT_FRAME_MS");
+    if (frame_ms && *frame_ms)
+        FrameTime = std::clamp(atoi(frame_ms), 0, 100);
+    const char* local_press = getenv("VT_LOCAL_PRESS");
+    if (local_press && *local_press)
+        LocalPress = atoi(local_press) != 0;
+
+    StartSyntheticTouches();
+
+    LoadCachedAssets();
+
     if (set_width > -1)
         ScrWidth = set_width;
     else
@@ -3817,48 +4011,30 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
     TScreen.reset(ts);
     RootWin    = RootWindow(Dis, ScrNo);
 
-    // Load Fonts
-    // Use fixed DPI (96) for consistent font rendering across all displays
-    // This ensures fonts render at the same size regardless of display DPI
-    static std::array<char, 256> font_spec_with_dpi{};
+    // Fonts open on first use (LoadXftFont()).  The sizes of fonts matched on
+    // an earlier run come from the per-host font cache; the rest are matched
+    // together when SendFontMetrics() needs their widths.
+    const char* font_cache = getenv("VT_FONT_CACHE");
+    FontCachePath = font_cache ? font_cache : vt::FontCache::DefaultPath();
+    if (!FontCachePath.empty())
+        ResolvedFonts.Load(FontCachePath);
+    XftFontsArr.fill(nullptr);
+    XftFontTried.fill(false);
     for (const auto& fontData : FontData)
     {
-        int f = fontData.id;
-
-        // Load Xft font with fixed DPI (96) for consistency across displays
-        // Append :dpi=96 to font specification if not already present
-        const char* xft_font_name = fontData.font;
-        if (strstr(xft_font_name, ":dpi=") == nullptr) {
-            vt::cpp23::format_to_buffer(font_spec_with_dpi.data(), font_spec_with_dpi.size(), "{}:dpi=96", xft_font_name);
-            xft_font_name = font_spec_with_dpi.data();
-        }
-        XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, xft_font_name);
-        
-        // If Xft font loading failed, try a simple fallback with fixed DPI
-        if (XftFontsArr[f] == nullptr) {
-            printf("Failed to load Xft font: %s, trying fallback\n", xft_font_name);
-            XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, "DejaVu Serif:size=24:style=Book:dpi=96");
-            if (XftFontsArr[f] == nullptr) {
-                printf("Failed to load fallback font too!\n");
-            }
-        }
-        
-        // Calculate font metrics from Xft font
-        if (XftFontsArr[f]) {
-            FontHeight[f] = XftFontsArr[f]->ascent + XftFontsArr[f]->descent;
-            FontBaseline[f] = XftFontsArr[f]->ascent;
-        } else {
-            // Fallback values if font loading fails
-            FontHeight[f] = 28; // Default height
-            FontBaseline[f] = 20; // Default baseline
-        }
+        const vt::ResolvedFont *resolved = FindResolvedFont(fontData.id);
+        if (resolved)
+            SetFontSize(fontData.id, resolved->ascent, resolved->descent);
+        else
+            SetFontSize(fontData.id, 0, 0);
     }
 
+    if (SoftRendering)
+        LoadSoftFonts();
+
     // Set Default Font
     FontInfo[FONT_DEFAULT]     = FontInfo[FONT_TIMES_24];
-    XftFontsArr[FONT_DEFAULT]  = XftFontsArr[FONT_TIMES_24];
-    FontHeight[FONT_DEFAULT]   = FontHeight[FONT_TIMES_24];
-    FontBaseline[FONT_DEFAULT] = FontBaseline[FONT_TIMES_24];
+    StartupMark("fonts");
 
     // Create Window
     int n = 0;
@@ -3882,6 +4058,7 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
 
     XtRealizeWidget(MainShell);
     MainWin = XtWindow(MainShell);
+    StartupMark("window");
 
         if (ScrDepth <= 8)
         {
@@ -4060,12 +4237,17 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
     else if (WinWidth >= 768 && WinHeight >= 1024)
         screen_size = PAGE_SIZE_768x1024;
 
+    // What's cached decides what vt_main sends; metrics go before the
+    // terminal info so the first page vt_main lays out uses them
+    SendAssetHashes();
+    SendFontMetrics();
     WInt8(ToInt(ServerProtocol::SrvTermInfo));
     WInt8(screen_size);
     WInt16(WinWidth);
     WInt16(WinHeight);
     WInt16(ScrDepth);
     SendNow();
+    StartupMark("metrics");
     if (TScreen)
         TScreen->Flush();
 
@@ -4089,7 +4271,7 @@ int OpenTerm(const char* display, TouchScreen *ts, int is_term_local, int term_h
         if (XtAppPending(App) == 0)
         {
             // No events pending, check if we should exit
-            if (SocketNo <= 0 && SocketInputID == 0)
+            if (SocketNo <= 0 && SocketInputID == 0 && ReconnectTimerID == 0)
             {
                 fprintf(stderr, "No socket connection and no input handler, exiting gracefully\n");
                 break;
@@ -4175,9 +4357,12 @@ void ShowReconnectingMessage()
 
     // Calculate text width using XftTextExtentsUtf8
     XGlyphInfo extents;
-    XftTextExtentsUtf8(Dis, XftFontsArr[FONT_TIMES_24], reinterpret_cast<const FcChar8*>(message), message_len, &extents);
+    XftFont *font = GetXftFontInfo(FONT_TIMES_24);
+    if (font == nullptr)
+        return;
+    XftTextExtentsUtf8(Dis, font, reinterpret_cast<const FcChar8*>(message), message_len, &extents);
     int text_width = extents.width;
-    int text_height = FontHeight[FONT_TIMES_24];
+    int text_height = GetFontHeight(FONT_TIMES_24);
 
     int x = (WinWidth - text_width) / 2;
     int y = (WinHeight - text_height) / 2;
@@ -4190,7 +4375,7 @@ void ShowReconnectingMessage()
 
     XftDraw* draw = XftDrawCreate(Dis, reconnect_window, ScrVis, ScrCol);
     if (draw) {
-        XftDrawStringUtf8(draw, &color, XftFontsArr[FONT_TIMES_24], x, y + FontBaseline[FONT_TIMES_24],
+        XftDrawStringUtf8(draw, &color, font, x, y + GetFontBaseline(FONT_TIMES_24),
                          reinterpret_cast<const FcChar8*>(message), message_len);
         XftDrawDestroy(draw);
     }
@@ -4239,16 +4424,14 @@ int ReconnectToServer()
 {
     FnTrace("ReconnectToServer()");
 
-    // Check if we're already trying to reconnect
-    if (connection_monitor.get_state() == CONNECTION_RECONNECTING) {
-        fprintf(stderr, "ReconnectToServer: Already attempting reconnection\n");
-        return 1;
-    }
-
-    // Try to reconnect to the server
+    // With a session token vt_main still holds our page, user and anything
+    // drawn since the link dropped; without one we start over on the
+    // default socket
+    const bool resume = !SessionToken.empty() && !SessionPath.empty();
     struct sockaddr_un server_adr;
     server_adr.sun_family = AF_UNIX;
-    vt_safe_string::safe_copy(server_adr.sun_path, sizeof(server_adr.sun_path), "/tmp/vt_term"); // Default socket path
+    vt_safe_string::safe_copy(server_adr.sun_path, sizeof(server_adr.sun_path),
+                              resume ? SessionPath.c_str() : "/tmp/vt_term");
 
     int new_socket = socket(AF_UNIX, SOCK_STREAM, 0);
     if (new_socket <= 0)
@@ -4276,6 +4459,19 @@ int ReconnectToServer()
         return 1;
     }
 
+    if (resume)
+    {
+        CharQueue hello(1024);
+        hello.Put8(ToInt(ServerProtocol::SrvResume));
+        hello.PutString(SessionToken, 0);
+        if (hello.Write(new_socket) <= 0)
+        {
+            fprintf(stderr, "ReconnectToServer: Can't send resume request\n");
+            close(new_socket);
+            return 1;
+        }
+    }
+
     // Close the old socket if it exists
     if (SocketNo > 0) {
         close(SocketNo);
@@ -4284,15 +4480,20 @@ int ReconnectToServer()
     // Update the global socket
     SocketNo = new_socket;
 
-    // Clear and reset buffers
+    // A partial frame from the old link is useless, but input that
+    // couldn't be sent is still wanted by a resumed session
     BufferIn.Clear();
-    BufferOut.Clear();
+    if (!resume)
+        BufferOut.Clear();
 
     // Re-add the input handler
     SocketInputID = XtAppAddInput(App, SocketNo, (XtPointer) XtInputReadMask,
                                   (XtInputCallbackProc) SocketInputCB, nullptr);
+    if (resume)
+        SendNow();
+    ResumeUnconfirmed = resume;
 
-    fprintf(stderr, "ReconnectToServer: Successfully reconnected\n");
+    fprintf(stderr, "ReconnectToServer: Successfully %s\n", resume ? "sent resume request" : "reconnected");
     return 0;
 }
 
@@ -4333,6 +4534,29 @@ int KillTerm()
 
     StopTouches();
     StopUpdates();
+    if (FrameTimerID && App)
+    {
+        XtRemoveTimeOut(FrameTimerID);
+        FrameTimerID = 0;
+    }
+    if (PressRevertID && App)
+    {
+        XtRemoveTimeOut(PressRevertID);
+        PressRevertID = 0;
+    }
+
+    const vt::FrameStats &frames = Layers.FrameStats();
+    if (frames.frames > 0)
+    {
+        fprintf(stderr, "Frames: %llu server updates drawn in %llu frames with %llu blits (%.1f per frame), "
+                "%llu blits in all, %llu Mpixels\n",
+                static_cast<unsigned long long>(frames.damage_rects),
+                static_cast<unsigned long long>(frames.frames),
+                static_cast<unsigned long long>(frames.frame_blits),
+                static_cast<double>(frames.frame_blits) / static_cast<double>(frames.frames),
+                static_cast<unsigned long long>(frames.blits),
+                static_cast<unsigned long long>(frames.blit_pixels / 1000000));
+    }
 
     XUndefineCursor(Dis, MainWin);
     if (MainShell)
@@ -4362,6 +4586,44 @@ int KillTerm()
             texture = 0;
         }
 
+    const vt::ImageCache::Stats image_stats = PixmapCache.GetStats();
+    if (image_stats.hits + image_stats.misses > 0)
+    {
+        fprintf(stderr, "Image cache: %llu hits, %llu misses, %llu evictions, %zu images in %zu KB\n",
+                static_cast<unsigned long long>(image_stats.hits),
+                static_cast<unsigned long long>(image_stats.misses),
+                static_cast<unsigned long long>(image_stats.evictions),
+                image_stats.entries, image_stats.bytes / 1024);
+    }
+    PixmapCache.Clear();
+
+    const vt::ImageCache::Stats zone_stats = ZoneCache.GetStats();
+    if (zone_stats.hits + zone_stats.misses > 0)
+    {
+        fprintf(stderr, "Zone cache: %llu hits, %llu misses, %llu evictions, %zu looks in %zu KB\n",
+                static_cast<unsigned long long>(zone_stats.hits),
+                static_cast<unsigned long long>(zone_stats.misses),
+                static_cast<unsigned long long>(zone_stats.evictions),
+                zone_stats.entries, zone_stats.bytes / 1024);
+    }
+    ZoneCache.Clear();
+
+    const vt::TextCache::Stats text_stats = TextMetrics.GetStats();
+    const uint64_t text_lookups = text_stats.width_hits + text_stats.width_misses +
+                                  text_stats.layout_hits + text_stats.layout_misses;
+    if (text_lookups > 0)
+    {
+        fprintf(stderr, "Text cache: %.1f%% hits (widths %llu/%llu, layouts %llu/%llu), %zu entries\n",
+                100.0 * static_cast<double>(text_stats.width_hits + text_stats.layout_hits) /
+                    static_cast<double>(text_lookups),
+                static_cast<unsigned long long>(text_stats.width_hits),
+                static_cast<unsigned long long>(text_stats.width_hits + text_stats.width_misses),
+                static_cast<unsigned long long>(text_stats.layout_hits),
+                static_cast<unsigned long long>(text_stats.layout_hits + text_stats.layout_misses),
+                text_stats.entries);
+    }
+    TextMetrics.Clear();
+
     if (CursorPointer)
     {
         XFreeCursor(Dis, CursorPointer);
@@ -4391,6 +4653,10 @@ int KillTerm()
             font = nullptr;
         }
 
+    // Fonts opened without a match in the cache (a failed pattern, say)
+    if (ResolvedFonts.Dirty() && !FontCachePath.empty())
+        ResolvedFonts.Save(FontCachePath);
+
     // Clean up Xft fonts
     for (auto& xftFont : XftFontsArr)
         if (xftFont)
@@ -4436,27 +4702,124 @@ int GetFontBaseline(const int font_id) noexcept
 {
     FnTrace("GetFontBaseline()");
 
-    if (font_id >= 0 && font_id < FONT_SPACE && XftFontsArr[font_id])
-        return XftFontsArr[font_id]->ascent;
-    else if (font_id >= 0 && font_id < FONT_SPACE && FontInfo[font_id])
-        return FontBaseline[font_id];
-    else
-        return FontBaseline[FONT_DEFAULT];
+    // Sizes known from the font cache don't need the font opened
+    const int f = FontSlot(font_id);
+    if (FontHeight[f] <= 0)
+        LoadXftFont(f);
+    return FontBaseline[f];
 }
 
 int GetFontHeight(const int font_id) noexcept
 {
     FnTrace("GetFontHeight()");
 
-    int retval = 0;
+    const int f = FontSlot(font_id);
+    if (FontHeight[f] <= 0)
+        LoadXftFont(f);
+    return FontHeight[f];
+}
 
-    if (font_id >= 0 && font_id < FONT_SPACE && XftFontsArr[font_id])
-        retval = XftFontsArr[font_id]->ascent + XftFontsArr[font_id]->descent;
-    else if (font_id >= 0 && font_id < FONT_SPACE && FontInfo[font_id])
-        retval = FontHeight[font_id];
-    else
-        retval = FontHeight[FONT_DEFAULT];
-    return retval;
+/****
+ * Converted textures:  Creating a pixmap from a built-in XPM allocates each
+ *  of its colors with a round trip to the X server, which is most of a cold
+ *  start on a remote display.  The converted pixels are kept in the asset
+ *  cache, named by the XPM data and the visual, and uploaded with a single
+ *  XPutImage() on later runs.  Only TrueColor pixels are independent of the
+ *  colormap, so other visuals always convert.
+ ****/
+struct CachedTextureHeader
+{
+    uint32_t magic;
+    int32_t  width;
+    int32_t  height;
+    int32_t  depth;
+    int32_t  bits_per_pixel;
+    int32_t  bytes_per_line;
+};
+static constexpr uint32_t TEXTURE_MAGIC = 0x31585456;  // "VTX1"
+
+static std::string TextureAssetName(const char** xpm)
+{
+    int width = 0, height = 0, colors = 0, chars = 0;
+    if (xpm == nullptr || sscanf(xpm[0], "%d %d %d %d", &width, &height, &colors, &chars) != 4)
+        return {};
+
+    vt::ContentHash hash;
+    hash.AddValue(static_cast<uint64_t>(ScrDepth)).AddValue(ScrVis->red_mask)
+        .AddValue(ScrVis->green_mask).AddValue(ScrVis->blue_mask)
+        .AddValue(static_cast<uint64_t>(ImageByteOrder(Dis)));
+    for (int line = 0; line < 1 + colors + height; ++line)
+        hash.Add(xpm[line]);
+    return "texture-" + hash.Hex();
+}
+
+static Pixmap TextureFromAsset(const std::string &data)
+{
+    CachedTextureHeader header;
+    if (data.size() < sizeof(header))
+        return 0;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != TEXTURE_MAGIC || header.depth != ScrDepth ||
+        header.width <= 0 || header.height <= 0 ||
+        data.size() != sizeof(header) + static_cast<size_t>(header.bytes_per_line) * header.height)
+        return 0;
+
+    XImage *image = XCreateImage(Dis, ScrVis, header.depth, ZPixmap, 0,
+                                 const_cast<char*>(data.data() + sizeof(header)),
+                                 header.width, header.height, 32, header.bytes_per_line);
+    if (image == nullptr)
+        return 0;
+    Pixmap pm = 0;
+    if (image->bits_per_pixel == header.bits_per_pixel)
+    {
+        pm = XCreatePixmap(Dis, MainWin, header.width, header.height, header.depth);
+        GC gc = XCreateGC(Dis, pm, 0, nullptr);
+        XPutImage(Dis, pm, gc, image, 0, 0, 0, 0, header.width, header.height);
+        XFreeGC(Dis, gc);
+    }
+    image->data = nullptr;  // owned by data
+    XDestroyImage(image);
+    return pm;
+}
+
+static int StoreTextureAsset(const std::string &name, Pixmap pm)
+{
+    Window root;
+    int x, y;
+    unsigned int width, height, border, depth;
+    if (!XGetGeometry(Dis, pm, &root, &x, &y, &width, &height, &border, &depth))
+        return 1;
+    XImage *image = XGetImage(Dis, pm, 0, 0, width, height, AllPlanes, ZPixmap);
+    if (image == nullptr)
+        return 1;
+
+    CachedTextureHeader header{TEXTURE_MAGIC, static_cast<int32_t>(width), static_cast<int32_t>(height),
+                               static_cast<int32_t>(depth), image->bits_per_pixel, image->bytes_per_line};
+    std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(image->data, static_cast<size_t>(image->bytes_per_line) * height);
+    XDestroyImage(image);
+    return TermAssets.Store(name, data);
+}
+
+static Pixmap LoadTexture(const int texture)
+{
+    FnTrace("LoadTexture()");
+
+    std::string name;
+    if (ScrVis->c_class == TrueColor && !TermAssets.Directory().empty())
+        name = TextureAssetName(ImageData[texture]);
+
+    std::string data;
+    if (!name.empty() && TermAssets.Load(name, data) == 0)
+    {
+        if (Pixmap pm = TextureFromAsset(data))
+            return pm;
+    }
+
+    Pixmap pm = LoadPixmap(ImageData[texture]);
+    if (pm && !name.empty())
+        StoreTextureAsset(name, pm);
+    return pm;
 }
 
 Pixmap GetTexture(const int texture) noexcept
@@ -4475,7 +4838,7 @@ Pixmap GetTexture(const int texture) noexcept
     }
 
     // Load and cache the texture (lazy loading)
-    Texture[texture] = LoadPixmap(ImageData[texture]);
+    Texture[texture] = LoadTexture(texture);
     return Texture[texture];
 }
 
@@ -4488,7 +4851,9 @@ void ClearTextureCache() noexcept
             XFreePixmap(Dis, Texture[i]);
             Texture[i] = 0;
         }
+        SoftTextures[i] = vt::SoftImage{};
     }
+    ZoneCache.Clear();  // rendered with the old textures
 }
 
 void PreloadAllTextures() noexcept
@@ -4522,43 +4887,451 @@ XftFont *GetXftFontInfo(const int font_id) noexcept
 {
     FnTrace("GetXftFontInfo()");
 
-    if (font_id >= 0 && font_id < FONT_SPACE && XftFontsArr[font_id])
-        return XftFontsArr[font_id];
+    return LoadXftFont(font_id);
+}
+
+/****
+ * LoadSoftFonts:  Opens the FontData faces through FreeType for the
+ *  software renderer, at the same fixed 96 DPI as the Xft fonts.
+ ****/
+int LoadSoftFonts()
+{
+    FnTrace("LoadSoftFonts()");
+
+    int failed = 0;
+    for (const auto& fontData : FontData)
+    {
+        std::string name = XftFontSpec(fontData.id);
+        auto font = std::make_unique<vt::SoftFont>();
+        if (font->Open(name))
+        {
+            ReportError("Unable to load software font '" + name + "'");
+            ++failed;
+            font.reset();
+        }
+        SoftFonts[fontData.id] = std::move(font);
+    }
+    return failed;
+}
+
+vt::SoftFont *GetSoftFont(const int font_id) noexcept
+{
+    FnTrace("GetSoftFont()");
+
+    if (font_id >= 0 && font_id < FONT_SPACE && SoftFonts[font_id])
+        return SoftFonts[font_id].get();
+    else
+        return SoftFonts[FONT_TIMES_24].get();
+}
+
+/****
+ * PixmapToSoftImage:  Reads a pixmap (and optional 1 bit mask) back from
+ *  the X server.  Only used with SoftRendering, which guarantees the
+ *  pixel values are 0xRRGGBB.
+ ****/
+int PixmapToSoftImage(Pixmap pm, Pixmap mask, int w, int h, vt::SoftImage &image)
+{
+    FnTrace("PixmapToSoftImage()");
+
+    if (pm == 0 || w <= 0 || h <= 0)
+        return 1;
+    XImage *ximage = XGetImage(Dis, pm, 0, 0, w, h, AllPlanes, ZPixmap);
+    if (ximage == nullptr)
+        return 1;
+
+    image.width  = w;
+    image.height = h;
+    image.pixels.resize(static_cast<size_t>(w) * static_cast<size_t>(h));
+    image.mask.clear();
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            image.pixels[y * w + x] = XGetPixel(ximage, x, y) & 0xFFFFFF;
+    XDestroyImage(ximage);
+
+    if (mask)
+    {
+        XImage *xmask = XGetImage(Dis, mask, 0, 0, w, h, 1, XYPixmap);
+        if (xmask)
+        {
+            image.mask.resize(image.pixels.size());
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                    image.mask[y * w + x] = XGetPixel(xmask, x, y) ? 255 : 0;
+            XDestroyImage(xmask);
+        }
+    }
+    return 0;
+}
+
+const vt::SoftImage *GetSoftTexture(const int texture)
+{
+    FnTrace("GetSoftTexture()");
+
+    if (texture < 0 || texture >= IMAGE_COUNT)
+        return GetSoftTexture(IMAGE_DARK_SAND);
+
+    vt::SoftImage &image = SoftTextures[texture];
+    if (!image.Valid())
+    {
+        Pixmap pm = GetTexture(texture);
+        Window root;
+        int gx, gy;
+        unsigned int gw = 0, gh = 0, border, depth;
+        if (pm == 0 || !XGetGeometry(Dis, pm, &root, &gx, &gy, &gw, &gh, &border, &depth))
+            return nullptr;
+        if (PixmapToSoftImage(pm, 0, static_cast<int>(gw), static_cast<int>(gh), image))
+            return nullptr;
+    }
+    return &image;
+}
+
+/****
+ * ScalePixmap:  Nearest-neighbour scales a pixmap (and its mask, if any)
+ *  into new server-side pixmaps of dw x dh.  Only .xpm files still take
+ *  this path; everything else is scaled by vt::ScaleImage() before upload.
+ ****/
+static int ScalePixmap(Pixmap src, Pixmap src_mask, int sw, int sh, int dw, int dh,
+                       Pixmap &dst, Pixmap &dst_mask)
+{
+    FnTrace("ScalePixmap()");
+
+    dst = 0;
+    dst_mask = 0;
+    XImage *orig_image = XGetImage(Dis, src, 0, 0, sw, sh, AllPlanes, ZPixmap);
+    if (orig_image == nullptr)
+        return 1;
+
+    const double inv_scale_x = static_cast<double>(sw) / static_cast<double>(dw);
+    const double inv_scale_y = static_cast<double>(sh) / static_cast<double>(dh);
+    auto source_x = [&](int x) { return Min(static_cast<int>(x * inv_scale_x), sw - 1); };
+    auto source_y = [&](int y) { return Min(static_cast<int>(y * inv_scale_y), sh - 1); };
+
+    const int bits_per_pixel = orig_image->bits_per_pixel;
+    const int bitmap_pad = orig_image->bitmap_pad;
+    const int bytes_per_line =
+        ((dw * bits_per_pixel + (bitmap_pad - 1)) / bitmap_pad) * (bitmap_pad / 8);
+    char *data = static_cast<char*>(malloc(static_cast<size_t>(bytes_per_line) * static_cast<size_t>(dh)));
+    XImage *scaled_image = data ? XCreateImage(Dis, ScrVis, orig_image->depth, ZPixmap, 0, data,
+                                               dw, dh, bitmap_pad, bytes_per_line) : nullptr;
+    if (scaled_image == nullptr)
+    {
+        free(data);
+        XDestroyImage(orig_image);
+        return 1;
+    }
+
+    for (int y = 0; y < dh; ++y)
+    {
+        const int sy = source_y(y);
+        for (int x = 0; x < dw; ++x)
+            XPutPixel(scaled_image, x, y, XGetPixel(orig_image, source_x(x), sy));
+    }
+
+    dst = XCreatePixmap(Dis, MainWin, dw, dh, orig_image->depth);
+    GC gc = XCreateGC(Dis, dst, 0, nullptr);
+    XPutImage(Dis, dst, gc, scaled_image, 0, 0, 0, 0, dw, dh);
+    XFreeGC(Dis, gc);
+    XDestroyImage(scaled_image);
+    XDestroyImage(orig_image);
+
+    if (src_mask)
+    {
+        XImage *orig_mask = XGetImage(Dis, src_mask, 0, 0, sw, sh, 1, XYPixmap);
+        if (orig_mask)
+        {
+            const int mask_bytes = (dw + 7) / 8 * dh;
+            char *mask_data = static_cast<char*>(calloc(static_cast<size_t>(mask_bytes), 1));
+            XImage *scaled_mask = mask_data ? XCreateImage(Dis, ScrVis, 1, XYBitmap, 0, mask_data,
+                                                           dw, dh, 8, 0) : nullptr;
+            if (scaled_mask)
+            {
+                for (int y = 0; y < dh; ++y)
+                {
+                    const int sy = source_y(y);
+                    for (int x = 0; x < dw; ++x)
+                        XPutPixel(scaled_mask, x, y, XGetPixel(orig_mask, source_x(x), sy));
+                }
+                dst_mask = XCreatePixmap(Dis, MainWin, dw, dh, 1);
+                GC mask_gc = XCreateGC(Dis, dst_mask, 0, nullptr);
+                XPutImage(Dis, dst_mask, mask_gc, scaled_mask, 0, 0, 0, 0, dw, dh);
+                XFreeGC(Dis, mask_gc);
+                XDestroyImage(scaled_mask);
+            }
+            else
+                free(mask_data);
+            XDestroyImage(orig_mask);
+        }
+    }
+    return 0;
+}
+
+static void ReleaseCachedImage(vt::CachedImage &image)
+{
+    if (Dis == nullptr)
+        return;
+    if (image.pixmap)
+        XFreePixmap(Dis, image.pixmap);
+    if (image.mask)
+        XFreePixmap(Dis, image.mask);
+    image.pixmap = 0;
+    image.mask = 0;
+}
+
+/****
+ * GetCachedImage:  Returns filename decoded and scaled to w x h (0 x 0 for
+ *  its own size), loading it into PixmapCache on a miss.  Relative names
+ *  are looked up in VIEWTOUCH_PATH/imgs, VIEWTOUCH_PATH and the current
+ *  directory.  Returns nullptr if the file can't be found or decoded; a
+ *  file that fails to decode isn't retried until it changes.
+ ****/
+const vt::CachedImage *GetCachedImage(const char* filename, int w, int h)
+{
+    FnTrace("GetCachedImage()");
+
+    if (filename == nullptr || filename[0] == '\0')
+        return nullptr;
+
+    const std::string name(filename);
+    struct stat sb;
+    std::string path;
+    const std::string *known = PixmapCache.Resolved(name);
+    if (known && stat(known->c_str(), &sb) == 0)
+        path = *known;
+    else
+    {
+        PixmapCache.ForgetResolved(name);
+        std::vector<std::string> candidates;
+        if (filename[0] == '/')
+            candidates = {name};
+        else
+            candidates = {VIEWTOUCH_PATH "/imgs/" + name, VIEWTOUCH_PATH "/" + name, name};
+        for (const auto& candidate : candidates)
+        {
+            if (stat(candidate.c_str(), &sb) == 0 && S_ISREG(sb.st_mode))
+            {
+                path = candidate;
+                break;
+            }
+        }
+        if (path.empty())
+            return nullptr;
+        PixmapCache.RememberResolved(name, path);
+    }
+
+    vt::ImageKey key;
+    key.path     = path;
+    key.mtime_ns = static_cast<int64_t>(sb.st_mtim.tv_sec) * 1'000'000'000 + sb.st_mtim.tv_nsec;
+    key.width    = w;
+    key.height   = h;
+
+    const vt::CachedImage *cached = PixmapCache.Find(key);
+    if (cached)
+        return (cached->pixmap || cached->soft) ? cached : nullptr;
+
+    // Failures are cached too (as an empty entry) so a bad file isn't
+    // decoded and reported on every redraw
+    vt::CachedImage image;
+    if (vt::HasRgbaDecoder(path))
+    {
+        // PNG/JPEG/GIF: decode and scale raw pixels, then upload once
+        vt::RgbaImage decoded;
+        if (vt::DecodeImageFile(path, decoded) == 0)
+        {
+            if (w > 0 && h > 0)
+                decoded = vt::ScaleImage(decoded, w, h);
+            if (SoftRendering)
+            {
+                auto soft = std::make_shared<vt::SoftImage>(vt::ToSoftImage(decoded));
+                image.width  = soft->width;
+                image.height = soft->height;
+                image.bytes  = soft->pixels.size() * sizeof(uint32_t) + soft->mask.size();
+                image.soft   = std::move(soft);
+            }
+            else
+            {
+                Pixmap pm = 0, mask = 0;
+                if (UploadRgbaImage(decoded, pm, mask) == 0)
+                {
+                    image.pixmap = pm;
+                    image.mask   = mask;
+                    image.width  = decoded.width;
+                    image.height = decoded.height;
+                }
+            }
+        }
+    }
     else
-        return XftFontsArr[FONT_DEFAULT];
+    {
+        std::vector<char> mutable_path(path.begin(), path.end());
+        mutable_path.push_back('\0');
+        std::unique_ptr<Xpm> xpm(LoadPixmapFile(mutable_path.data()));
+        if (xpm && xpm->Width() > 0 && xpm->Height() > 0)
+        {
+            const int img_w = xpm->Width();
+            const int img_h = xpm->Height();
+            Pixmap pm   = static_cast<Pixmap>(xpm->PixmapID());
+            Pixmap mask = xpm->MaskID();
+
+            if (SoftRendering)
+            {
+                auto soft = std::make_shared<vt::SoftImage>();
+                if (PixmapToSoftImage(pm, mask, img_w, img_h, *soft) == 0)
+                {
+                    image.width  = img_w;
+                    image.height = img_h;
+                    image.bytes  = soft->pixels.size() * sizeof(uint32_t) + soft->mask.size();
+                    image.soft   = std::move(soft);
+                }
+                XFreePixmap(Dis, pm);
+                if (mask)
+                    XFreePixmap(Dis, mask);
+            }
+            else if (w > 0 && h > 0 && (w != img_w || h != img_h))
+            {
+                Pixmap scaled = 0, scaled_mask = 0;
+                if (ScalePixmap(pm, mask, img_w, img_h, w, h, scaled, scaled_mask) == 0)
+                {
+                    image.pixmap = scaled;
+                    image.mask   = scaled_mask;
+                    image.width  = w;
+                    image.height = h;
+                }
+                XFreePixmap(Dis, pm);
+                if (mask)
+                    XFreePixmap(Dis, mask);
+            }
+            else
+            {
+                image.pixmap = pm;
+                image.mask   = mask;
+                image.width  = img_w;
+                image.height = img_h;
+            }
+        }
+    }
+
+    if (image.pixmap)
+    {
+        image.bytes = static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4;
+        if (image.mask)
+            image.bytes += static_cast<size_t>((image.width + 7) / 8) * static_cast<size_t>(image.height);
+    }
+
+    const vt::CachedImage &entry = PixmapCache.Insert(key, std::move(image));
+    return (entry.pixmap || entry.soft) ? &entry : nullptr;
+}
+
+// Xft measuring for TextMetrics, XTextWidth() for fonts Xft couldn't open
+static vt::MeasureFn TextMeasure(const int font_id)
+{
+    XftFont *font = GetXftFontInfo(font_id);
+    if (font == nullptr)
+    {
+        XFontStruct *font_info = GetFontInfo(font_id);
+        return [font_info](const char* str, int len) {
+            return (font_info && len > 0) ? XTextWidth(font_info, str, len) : 0;
+        };
+    }
+    return [font](const char* str, int len) {
+        if (len <= 0)
+            return 0;
+        XGlyphInfo extents;
+        XftTextExtentsUtf8(Dis, font, reinterpret_cast<const FcChar8*>(str), len, &extents);
+        return static_cast<int>(extents.xOff);
+    };
+}
+
+/****
+ * GetTextWidth:  Pixel advance of the first len bytes of str.  Each string
+ *  is measured once per font; TerminalReloadFonts() empties TextMetrics.
+ ****/
+int GetTextWidth(const int font_id, const char* str, const int len)
+{
+    FnTrace("GetTextWidth()");
+
+    return TextMetrics.Width(font_id, str, len, TextMeasure(font_id));
+}
+
+/****
+ * GetTextLayout:  str word-wrapped to width pixels (see vt::WrapText()),
+ *  computed once per font, string and size.  The result is valid until the
+ *  next call.
+ ****/
+const vt::TextLayout &GetTextLayout(const int font_id, const char* str, const int width,
+                                    const int max_lines)
+{
+    FnTrace("GetTextLayout()");
+
+    return TextMetrics.Layout(font_id, str, width, max_lines, TextMeasure(font_id));
+}
+
+/****
+ * SendFontMetrics:  Queues the glyph advances of each font over
+ *  vt::GLYPH_RANGES for vt_main, which uses them in Terminal::TextWidth()
+ *  instead of guessing from fixed cell widths.  The widths come from the
+ *  font cache, so fonts don't have to be opened to be reported; fonts the
+ *  cache doesn't know are resolved first.  The caller is responsible for
+ *  SendNow().
+ ****/
+int SendFontMetrics()
+{
+    FnTrace("SendFontMetrics()");
+
+    ResolveFonts();
+
+    // FONT_DEFAULT is an alias (for FONT_TIMES_24) but vt_main can ask for it
+    std::vector<std::pair<int, const vt::ResolvedFont*>> fonts;
+    if (const vt::ResolvedFont *font = FindResolvedFont(FONT_DEFAULT))
+        fonts.emplace_back(FONT_DEFAULT, font);
+    for (const auto& fontData : FontData)
+    {
+        if (const vt::ResolvedFont *font = FindResolvedFont(fontData.id))
+            fonts.emplace_back(fontData.id, font);
+    }
+
+    WInt8(ToInt(ServerProtocol::SrvFontMetrics));
+    WInt8(static_cast<int>(fonts.size()));
+    for (const auto& [font_id, font] : fonts)
+    {
+        WInt8(font_id);
+        WInt16(font->ascent + font->descent);
+        WInt16(font->default_advance);  // default for code points outside the ranges
+        WInt8(static_cast<int>(vt::GLYPH_RANGES.size()));
+        size_t glyph = 0;
+        for (const auto& range : vt::GLYPH_RANGES)
+        {
+            WInt32(static_cast<int>(range.first));
+            WInt16(range.count);
+            for (int i = 0; i < range.count; ++i)
+                WInt8(font->advances[glyph++]);
+        }
+    }
+    return 0;
 }
 
 // Reload all Xft fonts and update font metrics
 void TerminalReloadFonts()
 {
-    // Free existing Xft fonts
+    FnTrace("TerminalReloadFonts()");
+
+    // Free existing Xft fonts; they reopen as they're drawn
     for (const auto& fontData : FontData) {
         int f = fontData.id;
         if (XftFontsArr[f]) {
             XftFontClose(Dis, XftFontsArr[f]);
             XftFontsArr[f] = nullptr;
         }
+        XftFontTried[f] = false;
+        SetFontSize(f, 0, 0);
     }
-    // Reload fonts with fixed DPI (96) for consistency
-    static std::array<char, 256> font_spec_with_dpi{};
-    for (const auto& fontData : FontData) {
-        int f = fontData.id;
-        const char* xft_font_name = fontData.font;
-        // Append :dpi=96 to font specification if not already present
-        if (strstr(xft_font_name, ":dpi=") == nullptr) {
-            vt::cpp23::format_to_buffer(font_spec_with_dpi.data(), font_spec_with_dpi.size(), "{}:dpi=96", xft_font_name);
-            xft_font_name = font_spec_with_dpi.data();
-        }
-        XftFontsArr[f] = XftFontOpenName(Dis, ScrNo, xft_font_name);
-        if (XftFontsArr[f]) {
-            FontHeight[f] = XftFontsArr[f]->ascent + XftFontsArr[f]->descent;
-            FontBaseline[f] = XftFontsArr[f]->ascent;
-        } else {
-            FontHeight[f] = 0;
-            FontBaseline[f] = 0;
-        }
-    }
-    
+    // A reload picks up newly installed fonts, so match everything again
+    // (SendFontMetrics() follows and does it in parallel)
+    FcInitBringUptoDate();
+    ResolvedFonts.Clear();
+    if (SoftRendering)
+        LoadSoftFonts();
+    TextMetrics.Clear();  // measured with the old fonts
+
     // Update all layer objects (buttons) to use the new fonts
     // This ensures toolbar buttons and other layer objects get updated fonts
     Layer *layer = Layers.Head();
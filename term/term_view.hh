@@ -11,6 +11,9 @@
 
 #include "list_utility.hh"
 #include "utility.hh"
+#include "soft_canvas.hh"
+#include "image_cache.hh"
+#include "text_cache.hh"
 #include <X11/Xlib.h>
 #include <X11/Xft/Xft.h>
 #include <array>
@@ -353,6 +356,25 @@ extern void         PreloadAllTextures() noexcept;  // Preload all textures to a
 extern void         ClearTextureCache() noexcept;  // Clear cached textures to free memory
 extern int          GetCachedTextureCount() noexcept;  // Get number of currently loaded textures
 
+// Software rendering (VT_RENDER=software, see soft_canvas.hh)
+extern int SoftRendering;
+extern vt::SoftFont          *GetSoftFont(int font_id) noexcept;
+extern const vt::SoftImage   *GetSoftTexture(int texture);
+extern int                    PixmapToSoftImage(Pixmap pm, Pixmap mask, int w, int h,
+                                                vt::SoftImage &image);
+
+// Image files drawn by Layer::DrawPixmap(), decoded once and kept per size
+extern vt::ImageCache PixmapCache;
+extern const vt::CachedImage *GetCachedImage(const char* filename, int w, int h);
+
+// Zone and FilledFrame backgrounds, rendered once per look (see Layer::Zone())
+extern vt::ImageCache ZoneCache;
+
+// Text widths and zone label line breaks, measured once per font
+extern vt::TextCache TextMetrics;
+extern int                   GetTextWidth(int font_id, const char* str, int len);
+extern const vt::TextLayout &GetTextLayout(int font_id, const char* str, int width, int max_lines);
+
 // Image loading functions
 extern Pixmap LoadPixmap(const char** image_data);
 extern Xpm *LoadPixmapFile(char* file_name);
@@ -384,8 +406,12 @@ extern Flt   RFlt() noexcept;
 extern int   WStr(const char* s, int len = 0);
 extern genericChar* RStr(genericChar* s = nullptr);
 extern int   SendNow() noexcept;
+extern int   WInputStamp();     // before SrvTouch/SrvMouse; see InputStartNs
+class Layer;
+extern int   ShowPress(Layer *l, int px, int py);  // local feedback for a touch
 extern int   ReloadTermFonts();  // Reload fonts when global defaults change
 void TerminalReloadFonts();
+int  SendFontMetrics();     // glyph advance tables for vt_main
 
 // Reconnection functions
 extern int   ReconnectToServer();
@@ -0,0 +1,154 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * text_cache.cc - Per-font cache of text widths and word-wrapped layouts
+ */
+
+#include "text_cache.hh"
+
+#include <cctype>
+
+namespace vt {
+
+namespace {
+
+bool IsSpace(char c) noexcept
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+} // namespace
+
+TextLayout WrapText(const char* str, int width, int max_lines, const MeasureFn &measure)
+{
+    TextLayout layout;
+    int line = 0;
+    const char* c = str;
+    while (line < max_lines)
+    {
+        if (*c == '\0')
+            break;
+        int len = 0;
+        while (c[len] != '\0' && c[len] != '\\')
+            ++len;
+
+        while (line < max_lines)
+        {
+            TextLine sub;
+            sub.offset = static_cast<int>(c - str);
+            if (measure(c, len) <= width)
+            {
+                sub.length = len;
+                layout.lines.push_back(sub);
+                c += len;
+                while (IsSpace(*c))
+                    ++c;
+                if (*c == '\\')
+                    ++c;
+                while (IsSpace(*c))
+                    ++c;
+                ++line;
+                break;
+            }
+            // Find breaks in name that fit
+            int lw;
+            for (lw = len; lw > 0; --lw)
+            {
+                if (IsSpace(c[lw]) && !IsSpace(c[lw - 1]) && measure(c, lw) <= width)
+                    break;
+            }
+            if (lw <= 0)
+            {
+                // Truncate name
+                for (lw = len; lw > 1; --lw)
+                {
+                    if (measure(c, lw) <= width)
+                        break;
+                }
+            }
+
+            sub.length = lw;
+            layout.lines.push_back(sub);
+            c   += lw;
+            len -= lw;
+            while (IsSpace(*c))
+                ++c, --len;
+            if (*c == '\\')
+                ++c, --len;
+            while (IsSpace(*c))
+                ++c, --len;
+            ++line;
+        }
+    }
+    layout.overflow = (*c != '\0' && line >= max_lines);
+    return layout;
+}
+
+TextCache::TextCache(size_t entries_per_font)
+    : max_entries(entries_per_font)
+{
+}
+
+int TextCache::Width(int font, const char* str, int len, const MeasureFn &measure)
+{
+    if (len <= 0)
+        return 0;
+
+    Lru<int> &widths = fonts[font].widths;
+    const std::string_view text(str, static_cast<size_t>(len));
+    if (const int *width = widths.Find(text))
+    {
+        ++stats.width_hits;
+        return *width;
+    }
+    ++stats.width_misses;
+    return widths.Insert(text, measure(str, len), max_entries);
+}
+
+const TextLayout &TextCache::Layout(int font, const char* str, int width, int max_lines,
+                                    const MeasureFn &measure)
+{
+    // The numbers go first, so no label can produce another label's key
+    key.clear();
+    key.append(std::to_string(width)).append(1, ',');
+    key.append(std::to_string(max_lines)).append(1, ',');
+    key.append(str);
+
+    Lru<TextLayout> &layouts = fonts[font].layouts;
+    if (const TextLayout *layout = layouts.Find(key))
+    {
+        ++stats.layout_hits;
+        return *layout;
+    }
+    ++stats.layout_misses;
+    return layouts.Insert(key, WrapText(str, width, max_lines, measure), max_entries);
+}
+
+void TextCache::Clear() noexcept
+{
+    fonts.clear();
+}
+
+TextCache::Stats TextCache::GetStats() const noexcept
+{
+    Stats out = stats;
+    out.entries = 0;
+    for (const auto& [font, entries] : fonts)
+        out.entries += entries.widths.Size() + entries.layouts.Size();
+    return out;
+}
+
+} // namespace vt
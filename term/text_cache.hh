@@ -0,0 +1,135 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * text_cache.hh - Per-font cache of text widths and word-wrapped layouts
+ * No X dependencies; term_view.cc supplies the Xft measuring function
+ */
+
+#ifndef VT_TEXT_CACHE_HH
+#define VT_TEXT_CACHE_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace vt {
+
+// Pixel width of the first len bytes of str in one font
+using MeasureFn = std::function<int(const char* str, int len)>;
+
+struct TextLine {
+    int offset = 0;  // bytes from the start of the string
+    int length = 0;
+};
+
+struct TextLayout {
+    std::vector<TextLine> lines;
+    bool overflow = false;  // text was left over after max_lines
+};
+
+/**
+ * @brief Splits a zone label into lines no wider than width.
+ *
+ * A backslash forces a line break.  Lines break after a word where
+ * possible; a single word that doesn't fit is truncated.  This is the
+ * wrapping Layer::ZoneText() has always done.
+ */
+TextLayout WrapText(const char* str, int width, int max_lines, const MeasureFn &measure);
+
+/**
+ * @brief Least recently used widths and layouts, kept separately per font.
+ *
+ * The same button labels are measured and wrapped on every redraw, and each
+ * XftTextExtentsUtf8() call walks the glyphs again.  Entries are only valid
+ * for the fonts they were measured with: call Clear() when fonts reload.
+ */
+class TextCache {
+public:
+    static constexpr size_t DEFAULT_ENTRIES = 2048;  // per font, widths and layouts each
+
+    struct Stats {
+        uint64_t width_hits = 0;
+        uint64_t width_misses = 0;
+        uint64_t layout_hits = 0;
+        uint64_t layout_misses = 0;
+        size_t entries = 0;
+    };
+
+    explicit TextCache(size_t entries_per_font = DEFAULT_ENTRIES);
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    int Width(int font, const char* str, int len, const MeasureFn &measure);
+    // The reference stays valid until the next Layout() call
+    const TextLayout &Layout(int font, const char* str, int width, int max_lines,
+                             const MeasureFn &measure);
+    void Clear() noexcept;
+
+    [[nodiscard]] Stats GetStats() const noexcept;
+
+private:
+    // Keys in the index point into the strings held by the list nodes
+    template <typename Value>
+    class Lru {
+    public:
+        Value *Find(std::string_view key)
+        {
+            auto it = index.find(key);
+            if (it == index.end())
+                return nullptr;
+            order.splice(order.begin(), order, it->second);
+            return &it->second->second;
+        }
+
+        Value &Insert(std::string_view key, Value value, size_t max_entries)
+        {
+            order.emplace_front(std::string(key), std::move(value));
+            index[order.front().first] = order.begin();
+            while (order.size() > max_entries && order.size() > 1)
+            {
+                index.erase(order.back().first);
+                order.pop_back();
+            }
+            return order.front().second;
+        }
+
+        [[nodiscard]] size_t Size() const noexcept { return order.size(); }
+
+    private:
+        using Entry = std::pair<std::string, Value>;
+        std::list<Entry> order;  // front is most recently used
+        std::unordered_map<std::string_view, typename std::list<Entry>::iterator> index;
+    };
+
+    struct FontEntries {
+        Lru<int> widths;
+        Lru<TextLayout> layouts;
+    };
+
+    size_t max_entries;
+    std::unordered_map<int, FontEntries> fonts;
+    std::string key;  // reused to build layout keys without allocating
+    Stats stats;
+};
+
+} // namespace vt
+
+#endif // VT_TEXT_CACHE_HH
@@ -0,0 +1,93 @@
+#pragma once
+
+// A TCP printer on localhost for print spooler and Printer tests
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// A raw TCP printer: keeps what every connection sent, in arrival order
+class FakePrinter {
+public:
+    explicit FakePrinter(int port_wanted = 0)
+    {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port_wanted));
+        bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        listen(fd, 8);
+        socklen_t len = sizeof(addr);
+        getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+        port = ntohs(addr.sin_port);
+        thread = std::thread([this]() { Run(); });
+    }
+
+    ~FakePrinter()
+    {
+        stop = true;
+        thread.join();
+        close(fd);
+    }
+
+    std::string Received()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received;
+    }
+
+    int port = 0;
+    std::atomic<int> connections{0};
+
+private:
+    void Run()
+    {
+        std::vector<pollfd> fds{{fd, POLLIN, 0}};
+        while (!stop)
+        {
+            if (poll(fds.data(), fds.size(), 20) <= 0)
+                continue;
+            if (fds[0].revents & POLLIN)
+            {
+                fds.push_back({accept(fd, nullptr, nullptr), POLLIN, 0});
+                ++connections;
+            }
+            for (size_t i = 1; i < fds.size(); ++i)
+            {
+                if ((fds[i].revents & (POLLIN | POLLHUP)) == 0)
+                    continue;
+                char buffer[512];
+                const ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+                if (n > 0)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    received.append(buffer, static_cast<size_t>(n));
+                }
+                else
+                {
+                    close(fds[i].fd);
+                    fds.erase(fds.begin() + static_cast<long>(i--));
+                }
+            }
+        }
+        for (size_t i = 1; i < fds.size(); ++i)
+            close(fds[i].fd);
+    }
+
+    int fd = -1;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+    std::mutex mutex;
+    std::string received;
+};
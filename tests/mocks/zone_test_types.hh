@@ -0,0 +1,98 @@
+#pragma once
+
+// Minimal Zone and Page types for testing zone.cc's page logic without
+// PosZone, Terminal or a loaded layout (see main_link_stubs.cc)
+
+#include "zone.hh"
+#include "pos_zone.hh"
+
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TestZone : public Zone {
+public:
+    Str item_name;
+    int mask = 0;                    // what UpdateMask() returns
+    std::vector<int> *log = nullptr; // where Update() records its messages
+    std::function<void(TestZone *)> on_update;
+
+    static std::unique_ptr<TestZone> Make(const char* zone_name, int update_mask = 0,
+                                          std::vector<int> *update_log = nullptr)
+    {
+        auto z = std::make_unique<TestZone>();
+        z->name.Set(zone_name);
+        z->mask = update_mask;
+        z->log = update_log;
+        return z;
+    }
+
+    int Type() override { return ZONE_STANDARD; }
+    std::unique_ptr<Zone> Copy() override
+    {
+        auto z = Make(name.Value(), mask, log);
+        z->item_name.Set(item_name.Value());
+        z->on_update = on_update;
+        return z;
+    }
+    Str *ItemName() override { return &item_name; }
+    int UpdateMask() override { return mask; }
+    int Update(Terminal * /*t*/, int update_message, const genericChar* /*value*/) override
+    {
+        if (log)
+            log->push_back(update_message);
+        if (on_update)
+            on_update(this);
+        return 0;
+    }
+};
+
+class TestPage : public Page {
+public:
+    static std::unique_ptr<TestPage> Make(int page_id, std::initializer_list<const char*> zones)
+    {
+        auto p = std::make_unique<TestPage>();
+        p->id = page_id;
+        for (const char* zone_name : zones)
+            p->Add(TestZone::Make(zone_name).release());
+        return p;
+    }
+
+    std::unique_ptr<Page> Copy() override
+    {
+        auto p = CopyProperties();
+        for (Zone *z = ZoneList(); z != nullptr; z = z->next)
+            p->Add(z->Copy().release());
+        return p;
+    }
+    // like PosPage::Share()
+    std::unique_ptr<Page> Share() override
+    {
+        auto p = CopyProperties();
+        p->shared = shared ? shared : this;
+        return p;
+    }
+
+private:
+    std::unique_ptr<TestPage> CopyProperties() const
+    {
+        auto p = std::make_unique<TestPage>();
+        p->name      = name;
+        p->id        = id;
+        p->parent_id = parent_id;
+        p->type      = type;
+        p->size      = size;
+        return p;
+    }
+};
+
+// Names of a page's zones, in order (copies a shared page's zones)
+inline std::vector<std::string> ZoneNames(Page *page)
+{
+    std::vector<std::string> names;
+    for (Zone *z = page->ZoneList(); z != nullptr; z = z->next)
+        names.emplace_back(z->name.Value());
+    return names;
+}
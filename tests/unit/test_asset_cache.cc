@@ -0,0 +1,79 @@
+/*
+ * test_asset_cache.cc - Unit tests for asset_cache.hh and content_hash.hh
+ * Covers the on-disk store, the cached translation table and its hash
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/asset_cache.hh"
+#include "content_hash.hh"
+
+#include <chrono>
+#include <filesystem>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct ScratchDir {
+    fs::path dir = fs::temp_directory_path() / ("vt_asset_cache_" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    ~ScratchDir()
+    {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+};
+
+} // namespace
+
+TEST_CASE("ContentHash separates fields", "[asset_cache]") {
+    const std::string empty = vt::ContentHash().Hex();
+    REQUIRE(empty.size() == 16);
+    REQUIRE(empty == "cbf29ce484222325");  // FNV-1a offset basis
+
+    REQUIRE(vt::ContentHash().Add("ab").Add("c").Hex() !=
+            vt::ContentHash().Add("a").Add("bc").Hex());
+    REQUIRE(vt::ContentHash().Add("Burger").Add("Hamburguesa").Value() ==
+            vt::ContentHash().Add("Burger").Add("Hamburguesa").Value());
+    REQUIRE(vt::ContentHash().Add("").Hex() != empty);
+}
+
+TEST_CASE("AssetCache stores and loads named blobs", "[asset_cache]") {
+    ScratchDir tmp;
+    vt::AssetCache cache((tmp.dir / "assets-host").string());
+
+    std::string data;
+    REQUIRE(cache.Load("translations", data) != 0);
+
+    const std::string blob("pixels\0with\0nulls", 17);
+    REQUIRE(cache.Store("texture-0123", blob) == 0);
+    REQUIRE(cache.Load("texture-0123", data) == 0);
+    REQUIRE(data == blob);
+
+    REQUIRE(cache.Store("texture-0123", "replaced") == 0);
+    REQUIRE(cache.Load("texture-0123", data) == 0);
+    REQUIRE(data == "replaced");
+
+    SECTION("names can't leave the directory") {
+        REQUIRE(cache.Store("../escape", "x") != 0);
+        REQUIRE(cache.Store(".hidden", "x") != 0);
+        REQUIRE(cache.Store("", "x") != 0);
+    }
+
+    SECTION("no directory turns the cache off") {
+        vt::AssetCache off;
+        REQUIRE(off.Store("translations", "x") != 0);
+        REQUIRE(off.Load("translations", data) != 0);
+    }
+}
+
+TEST_CASE("Translation tables round trip", "[asset_cache]") {
+    const vt::TranslationList list = {{"Bar", "Barra"}, {"Kitchen", ""}, {"", "x"}};
+    vt::TranslationList back;
+    REQUIRE(vt::UnpackTranslations(vt::PackTranslations(list), back) == 0);
+    REQUIRE(back == list);
+
+    REQUIRE(vt::UnpackTranslations("", back) == 0);
+    REQUIRE(back.empty());
+    REQUIRE(vt::UnpackTranslations(std::string("key\0value", 9), back) != 0);
+}
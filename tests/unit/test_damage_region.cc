@@ -0,0 +1,99 @@
+/*
+ * test_damage_region.cc - Unit tests for damage_region.hh
+ * Covers merging of nearby updates, containment and the rectangle cap
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/damage_region.hh"
+
+#include <algorithm>
+
+namespace {
+
+// True if every pixel of r is covered by some rectangle of the region
+bool Covers(const vt::DamageRegion &region, const vt::DamageRect &r)
+{
+    for (int y = r.y; y < r.y + r.h; ++y)
+        for (int x = r.x; x < r.x + r.w; ++x)
+        {
+            const vt::DamageRect px{x, y, 1, 1};
+            if (std::none_of(region.Rects().begin(), region.Rects().end(),
+                             [&px](const vt::DamageRect &d) { return d.Contains(px); }))
+                return false;
+        }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("DamageRegion merges a row of buttons into one strip", "[damage_region]") {
+    vt::DamageRegion region;
+    // 8 buttons 100x60 with 4 pixel gaps, as a page render sends them
+    for (int i = 0; i < 8; ++i)
+        region.Add(10 + i * 104, 200, 100, 60);
+
+    REQUIRE(region.Rects().size() == 1);
+    REQUIRE(region.Rects()[0] == vt::DamageRect{10, 200, 828, 60});
+}
+
+TEST_CASE("DamageRegion keeps distant updates apart", "[damage_region]") {
+    vt::DamageRegion region;
+    region.Add(0, 0, 50, 50);
+    region.Add(900, 700, 50, 50);
+    REQUIRE(region.Rects().size() == 2);
+    REQUIRE(region.Area() == 2 * 50 * 50);
+
+    SECTION("a rectangle already covered adds nothing") {
+        region.Add(10, 10, 20, 20);
+        REQUIRE(region.Rects().size() == 2);
+    }
+
+    SECTION("a covering rectangle absorbs the ones inside it") {
+        region.Add(850, 650, 200, 200);
+        REQUIRE(region.Rects().size() == 2);
+        REQUIRE(Covers(region, {900, 700, 50, 50}));
+        REQUIRE(region.Area() == 50 * 50 + 200 * 200);
+    }
+
+    SECTION("empty rectangles are ignored") {
+        region.Add(5, 5, 0, 10);
+        region.Add(5, 5, 10, -1);
+        REQUIRE(region.Rects().size() == 2);
+    }
+
+    SECTION("take empties the region") {
+        auto rects = region.Take();
+        REQUIRE(rects.size() == 2);
+        REQUIRE(region.Empty());
+    }
+}
+
+TEST_CASE("DamageRegion caps the number of rectangles", "[damage_region]") {
+    vt::DamageRegion region;
+    // A scattered grid that no heuristic merge would join
+    std::vector<vt::DamageRect> added;
+    for (int y = 0; y < 6; ++y)
+        for (int x = 0; x < 6; ++x)
+        {
+            vt::DamageRect r{x * 170, y * 130, 20, 20};
+            region.Add(r);
+            added.push_back(r);
+        }
+
+    REQUIRE(region.Rects().size() <= static_cast<size_t>(vt::DamageRegion::MAX_RECTS));
+    for (const auto &r : added)
+        REQUIRE(Covers(region, r));
+    // No rectangle may sit inside another
+    for (const auto &a : region.Rects())
+        for (const auto &b : region.Rects())
+            REQUIRE((&a == &b || !a.Contains(b)));
+}
+
+TEST_CASE("DamageRect helpers", "[damage_region]") {
+    const vt::DamageRect a{0, 0, 10, 10};
+    const vt::DamageRect b{5, 5, 10, 10};
+    REQUIRE(vt::Union(a, b) == vt::DamageRect{0, 0, 15, 15});
+    REQUIRE(vt::Intersection(a, b) == vt::DamageRect{5, 5, 5, 5});
+    REQUIRE(vt::Intersection(a, vt::DamageRect{20, 0, 5, 5}).Empty());
+    REQUIRE(vt::Union(vt::DamageRect{}, b) == b);
+}
@@ -0,0 +1,345 @@
+/*
+ * test_data_tape.cc - Unit tests for data_tape.hh
+ * Covers packing a zone file's recorded values, refusing damaged tapes,
+ * and InputDataFile giving the same Read() calls the same values from a
+ * tape as from the file it was recorded from
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/core/data_tape.hh"
+#include "src/core/data_file.hh"
+#include "image_data.hh"
+#include "pos_zone.hh"
+#include "terminal.hh"
+#include "zone.hh"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// The sort of values Page::Read() and Zone::Read() leave on a tape
+vt::DataTape SampleTape()
+{
+    vt::DataTape tape;
+    tape.key = 0x1234abcd5678ef00ULL;
+    tape.version = 30;
+    tape.PutValue(2);                                      // page count
+    tape.PutStr("Index");
+    tape.PutValue(static_cast<uint64_t>(int64_t{-60}));   // a system page id
+    tape.PutFlt(1.25);
+    tape.PutStr("");
+    tape.PutStr("Index");                                  // shared in the string table
+    tape.AddPage(-60, 14, 1, 6);
+    tape.PutValue(0xFFFFFFFFFFFFFFFFULL);
+    tape.PutValue(1ULL << 40);
+    tape.AddPage(3, 6, 6, 8);
+    tape.eof_at = tape.Count();
+    return tape;
+}
+
+std::string TestPath(const char* name)
+{
+    return "/tmp/vt_test_data_tape." + std::string(name) + "." + std::to_string(getpid());
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// A small data file in the mix of values a Page::Read() takes
+void WriteSample(const std::string &path)
+{
+    OutputDataFile df;
+    df.Open(path, 30, 0);
+    df.Write(3);
+    Str name("Index Page");
+    df.Write(name);
+    df.Write(Flt{1.25});
+    df.Write(-60);
+    df.Write("");
+    df.Write(uint64_t{1} << 40);
+    df.Close();
+}
+
+// What ReadSample() got, and end_of_file after each Read()
+struct Sample
+{
+    int count = 0;
+    Str name;
+    Flt price = 0.0;
+    int page_id = 0;
+    Str empty;
+    uint64_t big = 0;
+    int past_end = -1;
+    std::vector<bool> eof;
+};
+
+// The same Read() calls for a file and for its tape; the last one runs
+// past the end
+Sample ReadSample(InputDataFile &in)
+{
+    Sample v;
+    in.Read(v.count);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.name);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.price);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.page_id);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.empty);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.big);
+    v.eof.push_back(in.end_of_file);
+    in.Read(v.past_end);
+    v.eof.push_back(in.end_of_file);
+    return v;
+}
+
+void RequireSame(const Sample &a, const Sample &b)
+{
+    REQUIRE(a.count == b.count);
+    REQUIRE(std::string(a.name.Value()) == b.name.Value());
+    REQUIRE(a.price == b.price);
+    REQUIRE(a.page_id == b.page_id);
+    REQUIRE(std::string(a.empty.Value()) == b.empty.Value());
+    REQUIRE(a.big == b.big);
+    REQUIRE(a.past_end == b.past_end);
+    REQUIRE(a.eof == b.eof);
+}
+
+} // namespace
+
+TEST_CASE("DataTape reads back what it packed", "[data_tape]") {
+    const vt::DataTape tape = SampleTape();
+    vt::DataTape copy;
+    REQUIRE(copy.Unpack(tape.Pack(), tape.key) == 0);
+
+    REQUIRE(copy.version == 30);
+    REQUIRE(copy.eof_at == 8);
+    REQUIRE(copy.Count() == tape.Count());
+    for (uint32_t i = 0; i < tape.Count(); ++i)
+    {
+        REQUIRE(copy.KindAt(i) == tape.KindAt(i));
+        if (tape.KindAt(i) == vt::DataTape::Kind::Str)
+            REQUIRE(copy.StrAt(i) == tape.StrAt(i));
+        else
+            REQUIRE(copy.ValueAt(i) == tape.ValueAt(i));
+    }
+    REQUIRE(static_cast<int64_t>(copy.ValueAt(2)) == -60);
+    REQUIRE(copy.FltAt(3) == 1.25);
+    REQUIRE(copy.StrAt(5) == "Index");
+
+    REQUIRE(copy.Pages().size() == 2);
+    REQUIRE(copy.Pages()[0].id == -60);
+    REQUIRE(copy.Pages()[0].size == 14);
+    REQUIRE(copy.Pages()[1].first == 6);
+    REQUIRE(copy.Pages()[1].end == 8);
+}
+
+TEST_CASE("DataTape refuses a tape for other contents or a damaged one", "[data_tape]") {
+    const vt::DataTape tape = SampleTape();
+    const std::string packed = tape.Pack();
+    vt::DataTape copy;
+
+    REQUIRE(copy.Unpack(packed, tape.key + 1) != 0);
+    REQUIRE(copy.Count() == 0);
+
+    REQUIRE(copy.Unpack(packed.substr(0, packed.size() - 1), tape.key) != 0);
+    REQUIRE(copy.Unpack("", tape.key) != 0);
+
+    // every single byte flipped is caught by the magic or the checksum
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        std::string damaged = packed;
+        damaged[i] = static_cast<char>(damaged[i] ^ 0x20);
+        REQUIRE(copy.Unpack(damaged, tape.key) != 0);
+        REQUIRE(copy.Count() == 0);
+    }
+}
+
+TEST_CASE("DataTape saves and loads through a file", "[data_tape]") {
+    const vt::DataTape tape = SampleTape();
+    const std::string path = "/tmp/vt_test_data_tape." + std::to_string(getpid()) + ".vtz";
+
+    REQUIRE(tape.Save(path) == 0);
+    vt::DataTape copy;
+    REQUIRE(copy.Load(path, tape.key) == 0);
+    REQUIRE(copy.Count() == tape.Count());
+    REQUIRE(copy.Pack() == tape.Pack());
+    std::remove(path.c_str());
+
+    REQUIRE(copy.Load(path, tape.key) != 0);
+    REQUIRE(copy.Count() == 0);
+}
+
+TEST_CASE("InputDataFile replays a recorded tape through the same reads", "[data_tape]") {
+    const std::string path = TestPath("sample");
+    WriteSample(path);
+
+    vt::DataTape tape;
+    InputDataFile file;
+    int version = 0;
+    REQUIRE(file.Open(path, version) == 0);
+    REQUIRE(version == 30);
+    tape.version = version;
+    file.Record(&tape);
+    const Sample parsed = ReadSample(file);
+    file.Close();
+    REQUIRE_FALSE(tape.Spoiled());
+
+    REQUIRE(parsed.count == 3);
+    REQUIRE(std::string(parsed.name.Value()) == "Index Page");
+    REQUIRE(parsed.price == 1.25);
+    REQUIRE(parsed.page_id == -60);
+    REQUIRE(parsed.empty.empty());
+    REQUIRE(parsed.big == (uint64_t{1} << 40));
+    REQUIRE(parsed.eof.back());
+    REQUIRE(tape.eof_at != vt::DataTape::NoEof);
+
+    // straight from the tape, and from the tape after a save and load
+    vt::DataTape loaded;
+    REQUIRE(loaded.Unpack(tape.Pack(), tape.key) == 0);
+    for (const vt::DataTape *t : {&tape, &loaded})
+    {
+        InputDataFile replay;
+        version = 0;
+        REQUIRE(replay.Open(*t, version) == 0);
+        REQUIRE(version == 30);
+        const Sample replayed = ReadSample(replay);
+        RequireSame(replayed, parsed);
+        REQUIRE_FALSE(replay.ReplayFailed());
+        REQUIRE(replay.TapePosition() == t->Count());
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Reads a tape can't repeat spoil the recording or fail the replay", "[data_tape]") {
+    const std::string path = TestPath("spoil");
+    WriteSample(path);
+    int version = 0;
+    std::array<char, 64> token{};
+
+    SECTION("GetToken") {
+        vt::DataTape tape;
+        InputDataFile file;
+        REQUIRE(file.Open(path, version) == 0);
+        file.Record(&tape);
+        int count = 0;
+        file.Read(count);
+        REQUIRE_FALSE(tape.Spoiled());
+        REQUIRE(file.GetToken(token.data(), static_cast<int>(token.size())) == 0);
+        REQUIRE(tape.Spoiled());
+
+        InputDataFile replay;
+        replay.Open(tape, version);
+        REQUIRE(replay.GetToken(token.data(), static_cast<int>(token.size())) != 0);
+        REQUIRE(replay.ReplayFailed());
+    }
+
+    SECTION("PeekTokens") {
+        vt::DataTape tape;
+        InputDataFile file;
+        REQUIRE(file.Open(path, version) == 0);
+        file.Record(&tape);
+        REQUIRE(file.PeekTokens() > 0);
+        REQUIRE(tape.Spoiled());
+
+        InputDataFile replay;
+        replay.Open(tape, version);
+        replay.PeekTokens();
+        REQUIRE(replay.ReplayFailed());
+    }
+
+    SECTION("a value of another kind") {
+        vt::DataTape tape;
+        InputDataFile file;
+        REQUIRE(file.Open(path, version) == 0);
+        file.Record(&tape);
+        ReadSample(file);
+        file.Close();
+
+        InputDataFile replay;
+        replay.Open(tape, version);
+        int count = 0;
+        REQUIRE(replay.Read(count) == 0);
+        REQUIRE_FALSE(replay.ReplayFailed());
+        Flt price = 0.0;
+        REQUIRE(replay.Read(price) != 0);  // the tape has the name here
+        REQUIRE(replay.ReplayFailed());
+        REQUIRE(replay.end_of_file);
+
+        // and it stays failed
+        Str name;
+        REQUIRE(replay.Read(name) != 0);
+        REQUIRE(replay.ReplayFailed());
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("ZoneDB::Load parses the file again when its tape doesn't replay", "[data_tape]") {
+    const std::string path = TestPath("zone_db");
+    const std::string cache = path + ".vtz";
+    {
+        OutputDataFile df;
+        REQUIRE(df.Open(path, ZONE_VERSION, 0) == 0);
+        df.Write(0);  // no pages, then the global defaults
+        const std::initializer_list<int> defaults = {
+            FONT_TIMES_20, 2, 3,
+            ZF_RAISED, IMAGE_DARK_SAND, COLOR_RED,
+            ZF_DOUBLE, IMAGE_LIT_SAND, COLOR_BLUE,
+            ZF_HIDDEN, IMAGE_SAND, COLOR_WHITE,
+            IMAGE_GREEN_MARBLE, COLOR_YELLOW, SIZE_1024x768};
+        for (int value : defaults)
+            df.Write(value);
+        df.Close();
+    }
+
+    ZoneDB parsed;
+    REQUIRE(parsed.Load(path.c_str()) == 0);  // parses and writes the tape
+    REQUIRE(parsed.default_font == FONT_TIMES_20);
+    REQUIRE(parsed.default_color[1] == COLOR_BLUE);
+    REQUIRE(parsed.default_size == SIZE_1024x768);
+    const std::string good = ReadFile(cache);
+    REQUIRE_FALSE(good.empty());
+
+    // the key is after the magic; a tape for the same file whose values
+    // don't fit the reads (a name where the page count goes)
+    uint64_t key = 0;
+    for (int i = 7; i >= 0; --i)
+        key = (key << 8) | static_cast<unsigned char>(good[sizeof(vt::DataTape::MAGIC) + i]);
+    vt::DataTape tape;
+    REQUIRE(tape.Load(cache, key) == 0);
+    vt::DataTape bad;
+    bad.key = key;
+    bad.version = tape.version;
+    bad.PutStr("not a count");
+    for (uint32_t i = 1; i < tape.Count(); ++i)
+        bad.PutValue(tape.ValueAt(i));
+    bad.eof_at = tape.eof_at;
+    REQUIRE(bad.Save(cache) == 0);
+
+    ZoneDB replayed;
+    REQUIRE(replayed.Load(path.c_str()) == 0);
+    REQUIRE(replayed.default_font == FONT_TIMES_20);
+    REQUIRE(replayed.default_color[1] == COLOR_BLUE);
+    REQUIRE(replayed.default_size == SIZE_1024x768);
+    REQUIRE(ReadFile(cache) == good);  // and a good tape replaced the bad one
+
+    ZoneDB from_tape;
+    REQUIRE(from_tape.Load(path.c_str()) == 0);
+    REQUIRE(from_tape.default_texture[0] == IMAGE_DARK_SAND);
+    REQUIRE(from_tape.default_title_color == COLOR_YELLOW);
+
+    std::remove(path.c_str());
+    std::remove(cache.c_str());
+}
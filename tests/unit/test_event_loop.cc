@@ -0,0 +1,146 @@
+/*
+ * test_event_loop.cc - Unit tests for the epoll event loop backend
+ * Covers timer ordering, removal, fd inputs and work procs
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/core/event_loop.hh"
+
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct TimerLog {
+    std::vector<int> fired;
+};
+
+struct TimerData {
+    TimerLog *log;
+    int tag;
+};
+
+void TimerCB(void *client_data, unsigned long * /*id*/)
+{
+    auto *data = static_cast<TimerData *>(client_data);
+    data->log->fired.push_back(data->tag);
+}
+
+struct InputData {
+    int reads = 0;
+    char last = 0;
+};
+
+void InputCB(void *client_data, int *fd, unsigned long * /*id*/)
+{
+    auto *data = static_cast<InputData *>(client_data);
+    char c = 0;
+    if (read(*fd, &c, 1) == 1)
+    {
+        data->last = c;
+        ++data->reads;
+    }
+}
+
+int CountdownWork(void *client_data)
+{
+    int *remaining = static_cast<int *>(client_data);
+    --(*remaining);
+    return *remaining <= 0;
+}
+
+// Runs the loop until 'done' returns true or the attempt budget runs out
+template<typename Pred>
+void RunUntil(vt::EventLoop &loop, Pred done, int attempts = 100)
+{
+    while (!done() && attempts-- > 0)
+        loop.RunOnce(50);
+}
+
+} // namespace
+
+TEST_CASE("EventLoop timers fire once in deadline order", "[event_loop][timer]") {
+    vt::EventLoop loop;
+    REQUIRE(loop.Valid());
+
+    TimerLog log;
+    TimerData late{&log, 2};
+    TimerData early{&log, 1};
+    REQUIRE(loop.AddTimeOut(TimerCB, 30, &late) != 0);
+    REQUIRE(loop.AddTimeOut(TimerCB, 5, &early) != 0);
+    REQUIRE(loop.TimerCount() == 2);
+
+    RunUntil(loop, [&] { return log.fired.size() == 2; });
+
+    REQUIRE(log.fired == std::vector<int>{1, 2});
+    REQUIRE(loop.TimerCount() == 0);
+}
+
+TEST_CASE("EventLoop removed timers do not fire", "[event_loop][timer]") {
+    vt::EventLoop loop;
+    TimerLog log;
+    TimerData removed{&log, 1};
+    TimerData kept{&log, 2};
+
+    unsigned long id = loop.AddTimeOut(TimerCB, 1, &removed);
+    loop.AddTimeOut(TimerCB, 10, &kept);
+    REQUIRE(loop.RemoveTimeOut(id) == 0);
+    REQUIRE(loop.RemoveTimeOut(id) == 1);
+
+    RunUntil(loop, [&] { return !log.fired.empty(); });
+
+    REQUIRE(log.fired == std::vector<int>{2});
+}
+
+TEST_CASE("EventLoop dispatches readable inputs", "[event_loop][input]") {
+    vt::EventLoop loop;
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    InputData data;
+    unsigned long id = loop.AddInput(InputCB, fds[0], &data);
+    REQUIRE(id != 0);
+
+    SECTION("idle descriptor does not fire") {
+        REQUIRE(loop.RunOnce(0) == 0);
+        REQUIRE(data.reads == 0);
+    }
+
+    SECTION("written byte is delivered") {
+        REQUIRE(write(fds[1], "x", 1) == 1);
+        RunUntil(loop, [&] { return data.reads > 0; });
+        REQUIRE(data.reads == 1);
+        REQUIRE(data.last == 'x');
+    }
+
+    SECTION("removed input is not dispatched") {
+        REQUIRE(loop.RemoveInput(id) == 0);
+        REQUIRE(write(fds[1], "y", 1) == 1);
+        loop.RunOnce(0);
+        REQUIRE(data.reads == 0);
+        REQUIRE(loop.InputCount() == 0);
+    }
+
+    loop.RemoveInput(id);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("EventLoop work procs run until they report done", "[event_loop][work]") {
+    vt::EventLoop loop;
+    int remaining = 3;
+    REQUIRE(loop.AddWorkProc(CountdownWork, &remaining) != 0);
+
+    RunUntil(loop, [&] { return loop.WorkCount() == 0; });
+
+    REQUIRE(remaining == 0);
+    REQUIRE(loop.WorkCount() == 0);
+}
+
+TEST_CASE("EventLoop Wakeup interrupts a blocking wait", "[event_loop]") {
+    vt::EventLoop loop;
+    int64_t start = vt::EventLoop::NowNs();
+    loop.Wakeup();
+    REQUIRE(loop.RunOnce(5000) == 0);
+    REQUIRE(vt::EventLoop::NowNs() - start < 1000000000LL);
+}
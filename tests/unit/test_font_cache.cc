@@ -0,0 +1,135 @@
+/*
+ * test_font_cache.cc - Unit tests for font_cache.hh
+ * Covers saving and loading resolved fonts and dropping stale entries
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/font_cache.hh"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// A scratch directory with a stand-in font file
+struct CacheDir {
+    fs::path dir;
+    fs::path font;
+
+    CacheDir()
+    {
+        dir = fs::temp_directory_path() / ("vt_font_cache_" + std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count()));
+        fs::create_directories(dir);
+        font = dir / "DejaVuSerif.ttf";
+        std::ofstream(font) << "not really a font";
+    }
+    ~CacheDir()
+    {
+        std::error_code ec;
+        fs::remove_all(dir, ec);
+    }
+
+    vt::ResolvedFont Resolved() const
+    {
+        vt::ResolvedFont resolved;
+        resolved.pattern = "DejaVu Serif:size=14:style=Book:dpi=96:file=" + font.string();
+        resolved.file = font.string();
+        resolved.file_mtime = vt::FontCache::FileTime(font.string());
+        resolved.ascent = 17;
+        resolved.descent = 5;
+        resolved.default_advance = 15;
+        resolved.advances = {5, 6, 7, 0, 255};
+        return resolved;
+    }
+};
+
+const std::string SPEC = "DejaVu Serif:size=14:style=Book:dpi=96";
+
+} // namespace
+
+TEST_CASE("FontCache saves and loads resolved fonts", "[font_cache]") {
+    CacheDir tmp;
+    const std::string path = (tmp.dir / "sub" / "fonts-host.cache").string();
+
+    vt::FontCache cache;
+    REQUIRE(cache.Load(path) != 0);  // nothing yet
+    cache.Store(SPEC, tmp.Resolved());
+    REQUIRE(cache.Dirty());
+    REQUIRE(cache.Save(path) == 0);
+    REQUIRE_FALSE(cache.Dirty());
+
+    vt::FontCache loaded;
+    REQUIRE(loaded.Load(path) == 0);
+    REQUIRE(loaded.Size() == 1);
+    const vt::ResolvedFont *font = loaded.Find(SPEC);
+    REQUIRE(font != nullptr);
+    REQUIRE(font->pattern == tmp.Resolved().pattern);
+    REQUIRE(font->ascent == 17);
+    REQUIRE(font->descent == 5);
+    REQUIRE(font->default_advance == 15);
+    REQUIRE(font->advances == std::vector<uint8_t>{5, 6, 7, 0, 255});
+    REQUIRE(loaded.Find("Liberation Serif:size=11") == nullptr);
+    REQUIRE_FALSE(loaded.Dirty());
+}
+
+TEST_CASE("FontCache forgets fonts whose file changed", "[font_cache]") {
+    CacheDir tmp;
+    const std::string path = (tmp.dir / "fonts-host.cache").string();
+
+    vt::FontCache cache;
+    cache.Store(SPEC, tmp.Resolved());
+    vt::ResolvedFont gone = tmp.Resolved();
+    gone.file = (tmp.dir / "removed.ttf").string();
+    cache.Store("Liberation Serif:size=11", gone);
+    REQUIRE(cache.Save(path) == 0);
+
+    SECTION("a removed font file drops its entry") {
+        vt::FontCache loaded;
+        REQUIRE(loaded.Load(path) == 0);
+        REQUIRE(loaded.Size() == 1);
+        REQUIRE(loaded.Find(SPEC) != nullptr);
+        REQUIRE(loaded.Dirty());  // so the next save rewrites the file
+    }
+
+    SECTION("an upgraded font file drops its entry") {
+        fs::last_write_time(tmp.font, fs::last_write_time(tmp.font) + std::chrono::seconds(5));
+        vt::FontCache loaded;
+        REQUIRE(loaded.Load(path) == 0);
+        REQUIRE(loaded.Find(SPEC) == nullptr);
+    }
+}
+
+TEST_CASE("FontCache rejects what it can't read back", "[font_cache]") {
+    CacheDir tmp;
+    const std::string path = (tmp.dir / "fonts-host.cache").string();
+
+    SECTION("another version's file is ignored") {
+        std::ofstream(path) << "vt_font_cache 0\n";
+        vt::FontCache cache;
+        REQUIRE(cache.Load(path) != 0);
+        REQUIRE(cache.Size() == 0);
+    }
+
+    SECTION("specs and patterns must fit on one line") {
+        vt::FontCache cache;
+        cache.Store("bad\tspec", tmp.Resolved());
+        vt::ResolvedFont bad = tmp.Resolved();
+        bad.pattern = "two\nlines";
+        cache.Store(SPEC, bad);
+        REQUIRE(cache.Size() == 0);
+        REQUIRE_FALSE(cache.Dirty());
+    }
+
+    SECTION("clear marks the file for rewriting") {
+        vt::FontCache cache;
+        cache.Store(SPEC, tmp.Resolved());
+        REQUIRE(cache.Save(path) == 0);
+        cache.Clear();
+        REQUIRE(cache.Dirty());
+        REQUIRE(cache.Find(SPEC) == nullptr);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * test_font_metrics.cc - Unit tests for font_metrics.hh
+ * Tests UTF-8 decoding and glyph advance table widths
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/core/font_metrics.hh"
+
+#include <cstring>
+
+TEST_CASE("DecodeUtf8 handles valid and invalid sequences", "[font_metrics][utf8]") {
+    int pos = 0;
+
+    SECTION("ASCII is one byte") {
+        REQUIRE(vt::DecodeUtf8("A", 1, pos) == 'A');
+        REQUIRE(pos == 1);
+    }
+
+    SECTION("Two, three and four byte sequences") {
+        const char* s = "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";  // é € 😀
+        int len = static_cast<int>(strlen(s));
+        REQUIRE(vt::DecodeUtf8(s, len, pos) == 0xE9);
+        REQUIRE(pos == 2);
+        REQUIRE(vt::DecodeUtf8(s, len, pos) == 0x20AC);
+        REQUIRE(pos == 5);
+        REQUIRE(vt::DecodeUtf8(s, len, pos) == 0x1F600);
+        REQUIRE(pos == len);
+    }
+
+    SECTION("Latin-1 bytes fall back to their byte value") {
+        const char* s = "caf\xE9";  // ISO-8859-1 é
+        pos = 3;
+        REQUIRE(vt::DecodeUtf8(s, 4, pos) == 0xE9);
+        REQUIRE(pos == 4);
+    }
+
+    SECTION("Truncated sequence consumes one byte") {
+        const char* s = "\xE2\x82";
+        REQUIRE(vt::DecodeUtf8(s, 2, pos) == 0xE2);
+        REQUIRE(pos == 1);
+    }
+}
+
+TEST_CASE("GlyphAdvanceTable sums advances", "[font_metrics]") {
+    vt::GlyphAdvanceTable table;
+    table.default_advance = 10;
+    table.SetAdvance('i', 4);
+    table.SetAdvance('W', 18);
+    table.SetAdvance(0xE9, 9);
+
+    SECTION("ASCII fast path uses measured advances") {
+        REQUIRE(table.TextWidth("iW", 2) == 22);
+    }
+
+    SECTION("Unmeasured code points use the default advance") {
+        REQUIRE(table.TextWidth("ix", 2) == 14);
+        REQUIRE(table.TextWidth("\xE2\x82\xAC", 3) == 10);
+    }
+
+    SECTION("UTF-8 and Latin-1 encodings measure the same glyph") {
+        REQUIRE(table.TextWidth("\xC3\xA9", 2) == 9);
+        REQUIRE(table.TextWidth("\xE9", 1) == 9);
+    }
+
+    SECTION("Length limits the measured text") {
+        REQUIRE(table.TextWidth("iWiW", 2) == 22);
+        REQUIRE(table.TextWidth("iW", 0) == 0);
+        REQUIRE(table.TextWidth(nullptr, 5) == 0);
+    }
+}
+
+TEST_CASE("FontMetrics tracks received fonts", "[font_metrics]") {
+    vt::FontMetrics metrics;
+    REQUIRE_FALSE(metrics.Has(3));
+    REQUIRE(metrics.TextWidth(3, "abc", 3) == -1);
+
+    vt::GlyphAdvanceTable *table = metrics.Reset(3);
+    REQUIRE(table != nullptr);
+    table->default_advance = 7;
+    table->height = 20;
+
+    REQUIRE(metrics.Has(3));
+    REQUIRE(metrics.Count() == 1);
+    REQUIRE(metrics.TextWidth(3, "abc", 3) == 21);
+    REQUIRE(metrics.Height(3) == 20);
+    REQUIRE(metrics.Reset(vt::FontMetrics::MAX_FONTS) == nullptr);
+
+    metrics.Clear();
+    REQUIRE(metrics.Count() == 0);
+}
@@ -0,0 +1,74 @@
+/*
+ * test_hit_grid.cc - Unit tests for hit_grid.hh
+ * Covers finding the first zone under a touch the way Page::FindZone() does
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "zone/hit_grid.hh"
+
+#include <vector>
+
+namespace {
+
+using Grid = vt::HitGrid<int>;
+
+bool Any(int) { return true; }
+
+// The list walk Page::FindZone() did before the grid
+int Walk(const std::vector<Grid::Entry> &list, int px, int py)
+{
+    for (const Grid::Entry &e : list)
+    {
+        if (px >= e.x && py >= e.y && px < e.x + e.w && py < e.y + e.h)
+            return e.item;
+    }
+    return 0;
+}
+
+} // namespace
+
+TEST_CASE("HitGrid finds the rectangle under a point", "[hit_grid]") {
+    Grid grid;
+    REQUIRE_FALSE(grid.Built());
+    REQUIRE(grid.Find(10, 10, Any) == 0);
+
+    grid.Build({{1, 0, 0, 100, 50}, {2, 100, 0, 100, 50}, {3, 0, 50, 200, 50}});
+    REQUIRE(grid.Built());
+    REQUIRE(grid.Find(10, 10, Any) == 1);
+    REQUIRE(grid.Find(100, 49, Any) == 2);
+    REQUIRE(grid.Find(199, 99, Any) == 3);
+    REQUIRE(grid.Find(200, 10, Any) == 0);   // right edge is outside
+    REQUIRE(grid.Find(-1, 10, Any) == 0);
+    REQUIRE(grid.Find(10, 100, Any) == 0);
+
+    grid.Clear();
+    REQUIRE_FALSE(grid.Built());
+    REQUIRE(grid.Find(10, 10, Any) == 0);
+}
+
+TEST_CASE("HitGrid keeps the order it was given", "[hit_grid]") {
+    Grid grid;
+    // a parent page's full screen backdrop, then buttons on top of it
+    grid.Build({{1, 0, 0, 1024, 768}, {2, 10, 10, 100, 100}, {3, 50, 50, 100, 100}, {4, 0, 0, 0, 0}});
+
+    REQUIRE(grid.Find(60, 60, Any) == 1);
+    REQUIRE(grid.Find(60, 60, [](int item) { return item != 1; }) == 2);
+    REQUIRE(grid.Find(120, 120, [](int item) { return item != 1; }) == 3);
+    REQUIRE(grid.Find(500, 500, [](int item) { return item != 1; }) == 0);
+    REQUIRE(grid.Size() == 4);
+}
+
+TEST_CASE("HitGrid agrees with a list walk on a crowded page", "[hit_grid]") {
+    std::vector<Grid::Entry> list;
+    int item = 0;
+    for (int row = 0; row < 12; ++row)
+        for (int col = 0; col < 16; ++col)
+            list.push_back({++item, col * 64 - 20, row * 64 + 5, 70 + (item % 3) * 20, 60});
+    list.push_back({++item, 300, 200, 400, 300});  // overlaps many cells
+
+    Grid grid;
+    grid.Build(list);
+    for (int y = -30; y < 820; y += 7)
+        for (int x = -30; x < 1100; x += 11)
+            REQUIRE(grid.Find(x, y, Any) == Walk(list, x, y));
+}
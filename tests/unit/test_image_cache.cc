@@ -0,0 +1,118 @@
+/*
+ * test_image_cache.cc - Unit tests for image_cache.hh
+ * Covers LRU order, the memory cap, stale file versions and the release hook
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/image_cache.hh"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+vt::ImageKey Key(const std::string &path, int w, int h, int64_t mtime = 1)
+{
+    vt::ImageKey key;
+    key.path = path;
+    key.mtime_ns = mtime;
+    key.width = w;
+    key.height = h;
+    return key;
+}
+
+vt::CachedImage Image(unsigned long pixmap, size_t bytes)
+{
+    vt::CachedImage image;
+    image.pixmap = pixmap;
+    image.bytes = bytes;
+    return image;
+}
+
+} // namespace
+
+TEST_CASE("ImageCache keys on path, mtime and size", "[image_cache]") {
+    vt::ImageCache cache(1000);
+    cache.Insert(Key("a.png", 10, 10), Image(1, 100));
+
+    REQUIRE(cache.Find(Key("a.png", 10, 10)) != nullptr);
+    REQUIRE(cache.Find(Key("a.png", 10, 10))->pixmap == 1);
+    REQUIRE(cache.Find(Key("a.png", 20, 10)) == nullptr);
+    REQUIRE(cache.Find(Key("a.png", 10, 10, 2)) == nullptr);
+    REQUIRE(cache.Find(Key("b.png", 10, 10)) == nullptr);
+
+    auto stats = cache.GetStats();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 3);
+    REQUIRE(stats.entries == 1);
+    REQUIRE(stats.bytes == 100);
+}
+
+TEST_CASE("ImageCache evicts the least recently used entries", "[image_cache]") {
+    std::vector<unsigned long> released;
+    vt::ImageCache cache(300, [&released](vt::CachedImage &image) {
+        released.push_back(image.pixmap);
+    });
+
+    cache.Insert(Key("a.png", 1, 1), Image(1, 100));
+    cache.Insert(Key("b.png", 1, 1), Image(2, 100));
+    cache.Insert(Key("c.png", 1, 1), Image(3, 100));
+    REQUIRE(cache.Find(Key("a.png", 1, 1)) != nullptr);  // b is now the oldest
+
+    cache.Insert(Key("d.png", 1, 1), Image(4, 100));
+    REQUIRE(released == std::vector<unsigned long>{2});
+    REQUIRE(cache.Find(Key("b.png", 1, 1)) == nullptr);
+    REQUIRE(cache.GetStats().evictions == 1);
+    REQUIRE(cache.GetStats().bytes == 300);
+
+    SECTION("shrinking the cap evicts at once") {
+        cache.SetMaxBytes(100);
+        REQUIRE(cache.GetStats().entries == 1);
+        REQUIRE(cache.Find(Key("d.png", 1, 1)) != nullptr);
+    }
+
+    SECTION("an oversized entry is kept until the next insert") {
+        cache.Insert(Key("big.png", 1, 1), Image(5, 1000));
+        REQUIRE(cache.GetStats().entries == 1);
+        REQUIRE(cache.Find(Key("big.png", 1, 1)) != nullptr);
+        cache.Insert(Key("e.png", 1, 1), Image(6, 10));
+        REQUIRE(cache.Find(Key("big.png", 1, 1)) == nullptr);
+    }
+
+    SECTION("clear releases everything") {
+        cache.Clear();
+        REQUIRE(cache.GetStats().entries == 0);
+        REQUIRE(cache.GetStats().bytes == 0);
+        REQUIRE(released.size() == 4);
+    }
+}
+
+TEST_CASE("ImageCache drops every size of a changed file", "[image_cache]") {
+    std::vector<unsigned long> released;
+    vt::ImageCache cache(10000, [&released](vt::CachedImage &image) {
+        released.push_back(image.pixmap);
+    });
+
+    cache.Insert(Key("a.png", 10, 10, 1), Image(1, 100));
+    cache.Insert(Key("a.png", 20, 20, 1), Image(2, 400));
+    cache.Insert(Key("b.png", 10, 10, 1), Image(3, 100));
+
+    cache.Insert(Key("a.png", 10, 10, 2), Image(4, 100));
+    REQUIRE(released.size() == 2);
+    REQUIRE(cache.GetStats().entries == 2);
+    REQUIRE(cache.GetStats().bytes == 200);
+    REQUIRE(cache.GetStats().evictions == 0);
+    REQUIRE(cache.Find(Key("b.png", 10, 10, 1)) != nullptr);
+}
+
+TEST_CASE("ImageCache remembers resolved file names", "[image_cache]") {
+    vt::ImageCache cache;
+    REQUIRE(cache.Resolved("burger.png") == nullptr);
+
+    cache.RememberResolved("burger.png", "/usr/viewtouch/imgs/burger.png");
+    REQUIRE(cache.Resolved("burger.png") != nullptr);
+    REQUIRE(*cache.Resolved("burger.png") == "/usr/viewtouch/imgs/burger.png");
+
+    cache.ForgetResolved("burger.png");
+    REQUIRE(cache.Resolved("burger.png") == nullptr);
+}
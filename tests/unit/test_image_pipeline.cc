@@ -0,0 +1,189 @@
+/*
+ * test_image_pipeline.cc - Unit tests for image_pipeline.hh
+ * Covers the scaling kernels against a reference, premultiplied alpha and keying
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/image_pipeline.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+vt::RgbaImage Solid(int w, int h, uint32_t pixel)
+{
+    vt::RgbaImage image;
+    image.width = w;
+    image.height = h;
+    image.pixels.assign(static_cast<size_t>(w) * static_cast<size_t>(h), pixel);
+    image.has_alpha = (pixel >> 24) != 255;
+    return image;
+}
+
+vt::RgbaImage Noise(int w, int h, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    vt::RgbaImage image = Solid(w, h, 0);
+    for (auto& p : image.pixels)
+        p = static_cast<uint32_t>(rng());
+    image.has_alpha = true;
+    vt::Premultiply(image);
+    return image;
+}
+
+// Straightforward double precision version of the same filters
+double Reference(const vt::RgbaImage &src, int dw, int dh, int x, int y, int shift)
+{
+    auto weights = [](int s, int d, int i) {
+        std::vector<std::pair<int, double>> out;
+        const double scale = static_cast<double>(s) / d;
+        if (d >= s)
+        {
+            double c = std::max(0.0, (i + 0.5) * scale - 0.5);
+            int j = static_cast<int>(c);
+            double f = c - j;
+            if (j >= s - 1)
+            {
+                j = s - 1;
+                f = 0.0;
+            }
+            out.emplace_back(j, 1.0 - f);
+            if (j + 1 < s)
+                out.emplace_back(j + 1, f);
+        }
+        else
+        {
+            const double lo = i * scale, hi = lo + scale;
+            for (int j = static_cast<int>(lo); j < s && j < hi; ++j)
+            {
+                double overlap = std::min(hi, j + 1.0) - std::max(lo, static_cast<double>(j));
+                if (overlap > 0)
+                    out.emplace_back(j, overlap / scale);
+            }
+        }
+        return out;
+    };
+
+    double sum = 0;
+    for (auto [sy, wy] : weights(src.height, dh, y))
+        for (auto [sx, wx] : weights(src.width, dw, x))
+            sum += wx * wy * ((src.pixels[sy * src.width + sx] >> shift) & 255);
+    return sum;
+}
+
+int Channel(uint32_t p, int shift) { return static_cast<int>((p >> shift) & 255); }
+
+} // namespace
+
+TEST_CASE("ScaleImage matches the reference filters", "[image_pipeline]") {
+    INFO("backend " << vt::ImagePipelineBackend());
+    struct Case { int sw, sh, dw, dh; };
+    for (Case c : {Case{50, 40, 17, 13}, Case{13, 7, 40, 30}, Case{64, 64, 64, 9}, Case{33, 5, 7, 5}})
+    {
+        vt::RgbaImage src = Noise(c.sw, c.sh, 7);
+        vt::RgbaImage out = vt::ScaleImage(src, c.dw, c.dh);
+        REQUIRE(out.Valid());
+        REQUIRE(out.width == c.dw);
+        REQUIRE(out.height == c.dh);
+
+        int worst = 0;
+        for (int y = 0; y < c.dh; ++y)
+            for (int x = 0; x < c.dw; ++x)
+                for (int shift = 0; shift < 32; shift += 8)
+                {
+                    int expected = static_cast<int>(std::lround(Reference(src, c.dw, c.dh, x, y, shift)));
+                    worst = std::max(worst, std::abs(expected - Channel(out.pixels[y * c.dw + x], shift)));
+                }
+        // two fixed point passes, each rounding once
+        REQUIRE(worst <= 2);
+    }
+}
+
+TEST_CASE("ScaleImage keeps solid images exact", "[image_pipeline]") {
+    const uint32_t colour = 0xFF3366CC;
+    for (auto [dw, dh] : {std::pair{64, 64}, std::pair{200, 100}, std::pair{1, 1}, std::pair{3000, 2}})
+    {
+        vt::RgbaImage out = vt::ScaleImage(Solid(1024, 1024, colour), dw, dh);
+        REQUIRE(std::all_of(out.pixels.begin(), out.pixels.end(),
+                            [colour](uint32_t p) { return p == colour; }));
+    }
+}
+
+TEST_CASE("Box filtering averages covered pixels", "[image_pipeline]") {
+    vt::RgbaImage checker = Solid(4, 4, 0xFF000000);
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x)
+            if ((x + y) % 2)
+                checker.pixels[y * 4 + x] = 0xFFFFFFFF;
+
+    vt::RgbaImage out = vt::ScaleImage(checker, 2, 2);
+    for (uint32_t p : out.pixels)
+    {
+        REQUIRE(Channel(p, 24) == 255);
+        REQUIRE(Channel(p, 16) >= 127);
+        REQUIRE(Channel(p, 16) <= 128);
+    }
+}
+
+TEST_CASE("Premultiplied alpha keeps transparent colour out of edges", "[image_pipeline]") {
+    // Left half transparent "green", right half opaque blue
+    vt::RgbaImage image = Solid(8, 1, 0xFF0000FF);
+    for (int x = 0; x < 4; ++x)
+        image.pixels[x] = 0x0000FF00;
+    image.has_alpha = true;
+    vt::Premultiply(image);
+    REQUIRE(image.pixels[0] == 0);
+
+    vt::RgbaImage out = vt::ScaleImage(image, 3, 1);
+    vt::SoftImage soft = vt::ToSoftImage(out);
+    for (uint32_t p : soft.pixels)
+        REQUIRE(Channel(p, 8) == 0);   // no green anywhere
+    REQUIRE(soft.mask.size() == 3);
+    REQUIRE(soft.mask[0] == 0);
+    REQUIRE(soft.mask[2] == 255);
+    REQUIRE(soft.pixels[2] == 0x0000FF);
+
+    SECTION("unpremultiply restores the straight colour") {
+        REQUIRE(vt::Unpremultiply(0x80400000) == 0x80800000);
+        REQUIRE(vt::Unpremultiply(0xFF123456) == 0xFF123456);
+        REQUIRE(vt::Unpremultiply(0) == 0);
+    }
+}
+
+TEST_CASE("Checkered backgrounds are keyed out", "[image_pipeline]") {
+    // 64x64 editor checkerboard with an opaque red square in the middle
+    vt::RgbaImage image = Solid(64, 64, 0xFFFFFFFF);
+    for (int y = 0; y < 64; ++y)
+        for (int x = 0; x < 64; ++x)
+        {
+            if (((x / 8) + (y / 8)) % 2)
+                image.pixels[y * 64 + x] = 0xFFC0C0C0;
+            if (x >= 24 && x < 40 && y >= 24 && y < 40)
+                image.pixels[y * 64 + x] = 0xFFD02020;
+        }
+    image.has_alpha = false;
+
+    const int keyed = vt::KeyCheckeredBackground(image);
+    REQUIRE(keyed == 64 * 64 - 16 * 16);
+    REQUIRE(image.has_alpha);
+    REQUIRE(image.pixels[0] >> 24 == 0);
+    REQUIRE(image.pixels[32 * 64 + 32] == 0xFFD02020);
+
+    SECTION("images without light backgrounds are left alone") {
+        vt::RgbaImage dark = Solid(32, 32, 0xFF202020);
+        REQUIRE(vt::KeyCheckeredBackground(dark) == 0);
+        REQUIRE_FALSE(dark.has_alpha);
+    }
+}
+
+TEST_CASE("ScaleNearest picks source pixels", "[image_pipeline]") {
+    vt::RgbaImage src = Solid(2, 1, 0xFF000000);
+    src.pixels[1] = 0xFFFFFFFF;
+    vt::RgbaImage out = vt::ScaleNearest(src, 4, 2);
+    REQUIRE(out.pixels == std::vector<uint32_t>{0xFF000000, 0xFF000000, 0xFFFFFFFF, 0xFFFFFFFF,
+                                                0xFF000000, 0xFF000000, 0xFFFFFFFF, 0xFFFFFFFF});
+    REQUIRE(vt::DecodeImageFile("button.bmp", src) == 1);
+}
@@ -0,0 +1,75 @@
+/*
+ * test_input_trace.cc - Unit tests for input_trace.hh
+ * Covers nested spans and matching vt_term's reply to its input
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "input_trace.hh"
+
+using vt::InputSpan;
+
+TEST_CASE("InputTrace counts nested spans once", "[input_trace]") {
+    vt::InputTrace trace;
+    REQUIRE_FALSE(trace.Active());
+
+    trace.Begin(7, 1'000, 1'400);
+    REQUIRE(trace.Active());
+    REQUIRE(trace.SpanNs(InputSpan::Queue) == 400);
+
+    trace.Enter(InputSpan::Touch, 2'000);
+    trace.Enter(InputSpan::Signal, 2'100);
+    trace.Enter(InputSpan::Signal, 2'200);   // a signal sending a signal
+    trace.Enter(InputSpan::Render, 2'300);
+    trace.Leave(InputSpan::Render, 2'500);
+    trace.Leave(InputSpan::Signal, 2'600);
+    trace.Leave(InputSpan::Signal, 2'700);
+    trace.Enter(InputSpan::Render, 2'800);
+    trace.Leave(InputSpan::Render, 2'900);
+    trace.Leave(InputSpan::Touch, 3'000);
+
+    REQUIRE(trace.SpanNs(InputSpan::Touch) == 1'000);
+    REQUIRE(trace.SpanNs(InputSpan::Signal) == 600);
+    REQUIRE(trace.SpanNs(InputSpan::Render) == 300);
+
+    SECTION("a stray Leave changes nothing") {
+        trace.Leave(InputSpan::Write, 3'100);
+        REQUIRE(trace.SpanNs(InputSpan::Write) == 0);
+    }
+
+    SECTION("End closes spans still open") {
+        trace.Enter(InputSpan::Write, 3'100);
+        trace.End(3'300);
+        REQUIRE_FALSE(trace.Active());
+        REQUIRE(trace.SpanNs(InputSpan::Write) == 200);
+    }
+}
+
+TEST_CASE("InputTrace matches vt_term's reply to its input", "[input_trace]") {
+    vt::InputTrace trace;
+    REQUIRE(trace.Complete(1, 0, 0, 0) == -1);  // nothing traced
+
+    trace.Begin(1, 1'000, 1'500);
+    REQUIRE(trace.Complete(1, 0, 0, 0) == -1);  // not written yet
+    trace.End(5'000);
+
+    REQUIRE(trace.Complete(2, 6'000, 6'500, 9'000) == -1);
+    REQUIRE(trace.Complete(1, 6'000, 6'500, 9'000) == 8'000);
+    REQUIRE(trace.SpanNs(InputSpan::Transit) == 1'000);
+    REQUIRE(trace.SpanNs(InputSpan::Decode) == 500);
+    REQUIRE(trace.SpanNs(InputSpan::Blit) == 2'500);
+    REQUIRE(trace.Complete(1, 6'000, 6'500, 9'000) == -1);  // answered once
+
+    SECTION("a new input abandons the unanswered one") {
+        trace.Begin(2, 10'000, 10'100);
+        trace.End(11'000);
+        trace.Begin(3, 12'000, 12'100);
+        trace.End(13'000);
+        REQUIRE(trace.Complete(2, 14'000, 14'100, 14'200) == -1);
+        REQUIRE(trace.Complete(3, 14'000, 14'100, 14'200) == 2'200);
+    }
+}
+
+TEST_CASE("InputSpan names", "[input_trace]") {
+    REQUIRE(std::string(vt::InputSpanName(InputSpan::Queue)) == "queue");
+    REQUIRE(std::string(vt::InputSpanName(InputSpan::Blit)) == "blit");
+}
@@ -0,0 +1,182 @@
+/*
+ * test_metrics.cc - Unit tests for metrics.hh
+ * Covers histogram bucketing, the Prometheus rendering and the stats socket
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/core/metrics.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string TempPath(const char* prefix)
+{
+    std::string path = std::string("/tmp/") + prefix + "_XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd >= 0)
+        close(fd);
+    std::remove(path.c_str());
+    return path;
+}
+
+bool Contains(const std::string &text, const std::string &needle)
+{
+    return text.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TEST_CASE("LatencyHistogram buckets by upper bound", "[metrics]") {
+    vt::LatencyHistogram hist;
+    hist.Record(10'000);          // 10us   -> first bucket
+    hist.Record(50'000);          // 50us   -> bounds are inclusive
+    hist.Record(3'000'000);       // 3ms    -> le 0.005
+    hist.Record(60'000'000'000);  // 60s    -> +Inf
+
+    REQUIRE(hist.Count() == 4);
+    REQUIRE(hist.SumNs() == 10'000 + 50'000 + 3'000'000 + 60'000'000'000);
+    REQUIRE(hist.Bucket(0) == 2);
+    REQUIRE(hist.Bucket(6) == 1);
+    REQUIRE(hist.Bucket(vt::LatencyHistogram::BOUNDS_NS.size()) == 1);
+}
+
+TEST_CASE("MetricsRegistry renders the Prometheus text format", "[metrics]") {
+    vt::MetricsRegistry registry;
+    auto &a = registry.Histogram("test_seconds", "A test histogram",
+                                 vt::MetricLabel("terminal", "Bar \"1\""));
+    auto &again = registry.Histogram("test_seconds", "A test histogram",
+                                     vt::MetricLabel("terminal", "Bar \"1\""));
+    REQUIRE(&a == &again);
+
+    a.Record(2'000'000);  // 2ms
+    registry.Counter("test_bytes_total", "A test counter").Add(42);
+
+    std::string text = registry.RenderPrometheus();
+    REQUIRE(Contains(text, "# HELP test_seconds A test histogram\n"));
+    REQUIRE(Contains(text, "# TYPE test_seconds histogram\n"));
+    REQUIRE(Contains(text, "test_seconds_bucket{terminal=\"Bar \\\"1\\\"\",le=\"0.001\"} 0\n"));
+    REQUIRE(Contains(text, "test_seconds_bucket{terminal=\"Bar \\\"1\\\"\",le=\"0.0025\"} 1\n"));
+    REQUIRE(Contains(text, "test_seconds_bucket{terminal=\"Bar \\\"1\\\"\",le=\"+Inf\"} 1\n"));
+    REQUIRE(Contains(text, "test_seconds_sum{terminal=\"Bar \\\"1\\\"\"} 0.002\n"));
+    REQUIRE(Contains(text, "test_seconds_count{terminal=\"Bar \\\"1\\\"\"} 1\n"));
+    REQUIRE(Contains(text, "# TYPE test_bytes_total counter\n"));
+    REQUIRE(Contains(text, "test_bytes_total 42\n"));
+
+    SECTION("dump writes the same text to a file") {
+        std::string path = TempPath("vt_metrics_dump");
+        REQUIRE(registry.Dump(path) == 0);
+        std::ifstream in(path);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        REQUIRE(contents.str() == text);
+        std::remove(path.c_str());
+    }
+}
+
+TEST_CASE("MetricsRegistry::Remove drops a terminal's series", "[metrics]") {
+    vt::MetricsRegistry registry;
+    const std::string bar = vt::MetricLabel("terminal", "Bar");
+    const std::string bar2 = vt::MetricLabel("terminal", "Bar 2");
+    registry.Histogram("span_seconds", "Spans", bar + "," + vt::MetricLabel("span", "decode"));
+    registry.Histogram("span_seconds", "Spans", vt::MetricLabel("span", "decode") + "," + bar);
+    registry.Histogram("span_seconds", "Spans", bar2);
+    registry.Counter("sent_total", "Sent", bar).Add(3);
+    registry.Counter("other_total", "Not per terminal").Add(1);
+
+    REQUIRE(registry.Remove(bar) == 3);
+    REQUIRE(registry.Remove(bar) == 0);
+    REQUIRE(registry.Remove("") == 0);
+
+    std::string text = registry.RenderPrometheus();
+    REQUIRE_FALSE(Contains(text, "terminal=\"Bar\""));
+    REQUIRE(Contains(text, "span_seconds_count{terminal=\"Bar 2\"} 0\n"));
+    REQUIRE_FALSE(Contains(text, "sent_total"));  // the family went with its last series
+    REQUIRE(Contains(text, "other_total 1\n"));
+
+    // a series made again after removal starts from zero
+    REQUIRE(registry.Counter("sent_total", "Sent", bar).Value() == 0);
+}
+
+TEST_CASE("MetricsServer sends one snapshot per connection", "[metrics]") {
+    vt::MetricsRegistry registry;
+    registry.Counter("served_total", "Served").Add(7);
+
+    std::string path = TempPath("vt_metrics_sock");
+    vt::MetricsServer server;
+    REQUIRE(server.Listen(path) == 0);
+    REQUIRE(server.Fd() >= 0);
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(client >= 0);
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+    REQUIRE(connect(client, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    REQUIRE(server.Serve(registry) == 0);
+
+    std::string received;
+    char buffer[256];
+    ssize_t n;
+    while ((n = read(client, buffer, sizeof(buffer))) > 0)
+        received.append(buffer, static_cast<size_t>(n));
+    close(client);
+    REQUIRE(received == registry.RenderPrometheus());
+
+    server.Close();
+    REQUIRE(access(path.c_str(), F_OK) != 0);
+}
+
+TEST_CASE("MetricsServer finishes a snapshot bigger than the socket buffer", "[metrics]") {
+    vt::MetricsRegistry registry;
+    for (int i = 0; i < 400; ++i)
+    {
+        registry.Histogram("big_seconds", "Enough series to fill the socket buffer",
+                           vt::MetricLabel("terminal", "Terminal " + std::to_string(i)))
+            .Record(1'000'000);
+    }
+    const std::string expected = registry.RenderPrometheus();
+
+    std::string path = TempPath("vt_metrics_big");
+    vt::MetricsServer server;
+    REQUIRE(server.Listen(path) == 0);
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(client >= 0);
+    int small = 4096;
+    setsockopt(client, SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+    REQUIRE(connect(client, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    REQUIRE(server.Serve(registry) == 0);
+    REQUIRE(server.Pending() == 1);
+
+    // read a bit at a time, as a slow scraper would, flushing in between
+    std::string received;
+    char buffer[4096];
+    ssize_t n;
+    for (int i = 0; i < 10000; ++i)
+    {
+        n = recv(client, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0)
+            received.append(buffer, static_cast<size_t>(n));
+        if (n == 0)
+            break;  // the server closed it: all sent
+        server.Flush();
+    }
+    while ((n = read(client, buffer, sizeof(buffer))) > 0)
+        received.append(buffer, static_cast<size_t>(n));
+    close(client);
+    REQUIRE(server.Pending() == 0);
+    REQUIRE(received == expected);
+    server.Close();
+}
@@ -0,0 +1,77 @@
+/*
+ * test_page_index.cc - Unit tests for page_index.hh
+ * Covers finding the same page ZoneDB's list walk used to find
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "zone/page_index.hh"
+
+#include <vector>
+
+namespace {
+
+struct FakePage {
+    FakePage *next = nullptr;
+    int id = 0;
+    int type = 0;
+    int index = 0;
+    int size = 0;
+};
+
+// Links pages in the order given, which stands in for ZoneDB::Add() order
+struct FakeList {
+    std::vector<FakePage> pages;
+    explicit FakeList(std::vector<FakePage> list) : pages(std::move(list))
+    {
+        for (size_t i = 0; i + 1 < pages.size(); ++i)
+            pages[i].next = &pages[i + 1];
+    }
+    FakePage *Head() { return pages.empty() ? nullptr : &pages.front(); }
+};
+
+using Index = vt::PageIndex<FakePage>;
+
+} // namespace
+
+TEST_CASE("PageIndex finds pages by id and size", "[page_index]") {
+    FakeList list({{nullptr, -5, 0, 0, 14}, {nullptr, 3, 3, 0, 14},
+                   {nullptr, 3, 3, 0, 6},   {nullptr, 0, 3, 0, 6}});
+    Index index;
+    REQUIRE_FALSE(index.Built());
+    index.Build(list.Head());
+    REQUIRE(index.Built());
+
+    REQUIRE(index.FindByID(3, 14) == &list.pages[1]);  // larger size comes first
+    REQUIRE(index.FindByID(3, 8) == &list.pages[2]);
+    REQUIRE(index.FindByID(3, 5) == nullptr);
+    REQUIRE(index.FindByID(-5, 14) == &list.pages[0]);
+    REQUIRE(index.FindByID(0, 14) == nullptr);         // id 0 is never listed
+    REQUIRE(index.FindByID(7, 14) == nullptr);
+
+    REQUIRE(index.IsDefined(3, 6));
+    REQUIRE_FALSE(index.IsDefined(3, 8));
+}
+
+TEST_CASE("PageIndex finds pages by type and period", "[page_index]") {
+    constexpr int index_page = 2;
+    FakeList list({{nullptr, 10, index_page, 3, 14}, {nullptr, 10, index_page, 3, 6},
+                   {nullptr, 11, index_page, 5, 6},  {nullptr, 12, 1, 0, 6}});
+    Index index;
+    index.Build(list.Head());
+
+    REQUIRE(index.FindByType(index_page, 5, 14) == &list.pages[2]);
+    REQUIRE(index.FindByType(index_page, 3, 8) == &list.pages[1]);
+    REQUIRE(index.FindByType(index_page, 4, 14) == nullptr);
+    REQUIRE(index.FindByType(index_page, Index::AnyIndex, 14) == &list.pages[0]);
+    REQUIRE(index.FindByType(1, Index::AnyIndex, 6) == &list.pages[3]);
+    REQUIRE(index.FindByType(7, Index::AnyIndex, 14) == nullptr);
+
+    SECTION("Clear() empties it until the next Build()") {
+        index.Clear();
+        REQUIRE_FALSE(index.Built());
+        REQUIRE(index.FindByType(index_page, 5, 14) == nullptr);
+        list.pages[2].index = 4;
+        index.Build(list.Head());
+        REQUIRE(index.FindByType(index_page, 4, 14) == &list.pages[2]);
+    }
+}
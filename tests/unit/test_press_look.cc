@@ -0,0 +1,60 @@
+/*
+ * test_press_look.cc - Unit tests for press_look.hh
+ * Covers picking the zone a touch lands on the way Page::FindZone() does
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/press_look.hh"
+
+namespace {
+
+vt::PressLook Button(int x, int y, int w, int h, const char* text)
+{
+    vt::PressLook look;
+    look.x = x;
+    look.y = y;
+    look.w = w;
+    look.h = h;
+    look.local = true;
+    look.text = text;
+    return look;
+}
+
+vt::PressLook Blocker(int x, int y, int w, int h)
+{
+    vt::PressLook look;
+    look.x = x;
+    look.y = y;
+    look.w = w;
+    look.h = h;
+    return look;
+}
+
+} // namespace
+
+TEST_CASE("FindPressLook finds the button under the touch", "[press_look]") {
+    const vt::PressLookList looks = {Button(0, 0, 100, 50, "Burger"),
+                                     Button(100, 0, 100, 50, "Fries")};
+
+    REQUIRE(vt::FindPressLook(looks, 10, 10)->text == "Burger");
+    REQUIRE(vt::FindPressLook(looks, 100, 49)->text == "Fries");
+    REQUIRE(vt::FindPressLook(looks, 200, 10) == nullptr);  // right edge is outside
+    REQUIRE(vt::FindPressLook(looks, 50, 50) == nullptr);
+    REQUIRE(vt::FindPressLook({}, 10, 10) == nullptr);
+}
+
+TEST_CASE("FindPressLook takes the first zone like vt_main does", "[press_look]") {
+    SECTION("an earlier button wins an overlap") {
+        const vt::PressLookList looks = {Button(0, 0, 60, 60, "Parent page"),
+                                         Button(40, 40, 60, 60, "This page")};
+        REQUIRE(vt::FindPressLook(looks, 50, 50)->text == "Parent page");
+        REQUIRE(vt::FindPressLook(looks, 70, 70)->text == "This page");
+    }
+
+    SECTION("a zone without a local look blocks the button beneath") {
+        const vt::PressLookList looks = {Blocker(0, 0, 60, 60),
+                                         Button(0, 0, 200, 200, "Big button")};
+        REQUIRE(vt::FindPressLook(looks, 30, 30) == nullptr);
+        REQUIRE(vt::FindPressLook(looks, 100, 100)->text == "Big button");
+    }
+}
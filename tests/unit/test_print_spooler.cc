@@ -0,0 +1,217 @@
+/*
+ * test_print_spooler.cc - Unit tests for print_spooler.hh
+ * Covers job order, connection reuse, coalescing, retries and requeueing
+ * spooled jobs against a printer listening on localhost
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/network/print_spooler.hh"
+#include "../mocks/fake_printer.hh"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// A port nothing listens on, for now
+int UnusedPort()
+{
+    FakePrinter probe;
+    return probe.port;
+}
+
+vt::PrintSpooler::Options FastOptions()
+{
+    vt::PrintSpooler::Options options;
+    options.retry_base = 20ms;
+    options.retry_max = 100ms;
+    options.connect_timeout = 500ms;
+    return options;
+}
+
+vt::PrintTarget Target(int port)
+{
+    vt::PrintTarget target;
+    target.host = "127.0.0.1";
+    target.port = port;
+    return target;
+}
+
+std::string SpoolDir(const char *name)
+{
+    const std::string dir = "/tmp/vt_test_spool." + std::string(name) + "." + std::to_string(getpid());
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+size_t JobFiles(const std::string &dir)
+{
+    size_t count = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+        count += (entry.path().extension() == ".job");
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("PrintSpooler sends a printer's jobs in order over one connection", "[print_spooler]") {
+    FakePrinter printer;
+    vt::PrintSpooler spooler(FastOptions());
+    std::string expected;
+    for (int i = 1; i <= 20; ++i)
+    {
+        const std::string job = "ticket " + std::to_string(i) + "\n";
+        REQUIRE(spooler.Submit(Target(printer.port), job) != 0);
+        expected += job;
+    }
+    REQUIRE(spooler.WaitIdle(5s));
+
+    for (int i = 0; i < 100 && printer.Received().size() < expected.size(); ++i)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(printer.Received() == expected);
+    REQUIRE(printer.connections == 1);
+
+    const vt::PrintQueueStats stats = spooler.Stats(Target(printer.port));
+    REQUIRE(stats.depth == 0);
+    REQUIRE(stats.printed == 20);
+    REQUIRE(stats.failed == 0);
+    REQUIRE(stats.last_latency_ms >= 0);
+    REQUIRE(stats.connections == 1);
+    REQUIRE(stats.transmissions == 20);
+}
+
+TEST_CASE("PrintSpooler coalesces jobs arriving within the window", "[print_spooler]") {
+    FakePrinter printer;
+    vt::PrintSpooler::Options options = FastOptions();
+    options.coalesce_max_jobs = 4;
+    vt::PrintSpooler spooler(options);
+    spooler.SetCoalesce(Target(printer.port), 200ms);
+    std::string expected;
+    for (int i = 1; i <= 6; ++i)
+    {
+        const std::string job = "ticket " + std::to_string(i) + "\x1dV\x01";
+        spooler.Submit(Target(printer.port), job);
+        expected += job;
+    }
+    REQUIRE(spooler.WaitIdle(5s));
+    for (int i = 0; i < 100 && printer.Received().size() < expected.size(); ++i)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(printer.Received() == expected);
+
+    // four at once (the cap), then the two left once the window ran out
+    vt::PrintQueueStats stats = spooler.Stats(Target(printer.port));
+    REQUIRE(stats.printed == 6);
+    REQUIRE(stats.transmissions == 2);
+    REQUIRE(stats.connections == 1);
+    REQUIRE(stats.total_latency_ms >= stats.last_latency_ms);
+    REQUIRE(stats.last_latency_ms >= 150);
+
+    // with the window off again each job goes out by itself
+    spooler.SetCoalesce(Target(printer.port), 0ms);
+    spooler.Submit(Target(printer.port), "a");
+    REQUIRE(spooler.WaitIdle(5s));
+    spooler.Submit(Target(printer.port), "b");
+    REQUIRE(spooler.WaitIdle(5s));
+    stats = spooler.Stats(Target(printer.port));
+    REQUIRE(stats.transmissions == 4);
+    REQUIRE(stats.last_latency_ms < 150);
+}
+
+TEST_CASE("PrintSpooler retries until the printer comes up", "[print_spooler]") {
+    const int port = UnusedPort();
+    vt::PrintSpooler spooler(FastOptions());
+    spooler.Submit(Target(port), "first\n");
+    spooler.Submit(Target(port), "second\n");
+
+    std::this_thread::sleep_for(150ms);
+    vt::PrintQueueStats stats = spooler.Stats(Target(port));
+    REQUIRE(stats.depth == 2);
+    REQUIRE(stats.attempts > 0);
+    REQUIRE_FALSE(stats.last_error.empty());
+
+    FakePrinter printer(port);
+    REQUIRE(spooler.WaitIdle(5s));
+    for (int i = 0; i < 100 && printer.Received().size() < 13; ++i)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(printer.Received() == "first\nsecond\n");
+    stats = spooler.Stats(Target(port));
+    REQUIRE(stats.printed == 2);
+    REQUIRE(stats.attempts == 0);
+    REQUIRE(stats.last_error.empty());
+}
+
+TEST_CASE("PrintSpooler holds jobs it gave up on until they're requeued", "[print_spooler]") {
+    const std::string dir = SpoolDir("held");
+    vt::PrintSpooler::Options options = FastOptions();
+    options.max_attempts = 2;
+    const int port = UnusedPort();
+    {
+        vt::PrintSpooler spooler(options);
+        REQUIRE(spooler.Open(dir) == 0);
+        spooler.Submit(Target(port), "held\n");
+        REQUIRE(spooler.WaitIdle(5s));
+        const vt::PrintQueueStats stats = spooler.Stats(Target(port));
+        REQUIRE(stats.failed == 1);
+        REQUIRE(stats.held == 1);
+        REQUIRE(stats.printed == 0);
+        REQUIRE(JobFiles(dir) == 0);
+        REQUIRE(std::filesystem::exists(dir + "/0000000000000001.failed"));
+    }
+
+    // a restart keeps holding it rather than printing it
+    FakePrinter printer(port);
+    vt::PrintSpooler spooler(options);
+    REQUIRE(spooler.Open(dir) == 0);
+    REQUIRE(spooler.Stats(Target(port)).held == 1);
+
+    REQUIRE(spooler.RequeueFailed(Target(port)) == 1);
+    REQUIRE(spooler.WaitIdle(5s));
+    for (int i = 0; i < 100 && printer.Received().size() < 5; ++i)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(printer.Received() == "held\n");
+    const vt::PrintQueueStats stats = spooler.Stats(Target(port));
+    REQUIRE(stats.held == 0);
+    REQUIRE(stats.printed == 1);
+    REQUIRE(std::filesystem::is_empty(dir));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("PrintSpooler requeues spooled jobs after a restart", "[print_spooler]") {
+    const std::string dir = SpoolDir("restart");
+    const int port = UnusedPort();
+    {
+        vt::PrintSpooler::Options options = FastOptions();
+        options.retry_base = 10s;  // hold the jobs until shutdown
+        vt::PrintSpooler spooler(options);
+        REQUIRE(spooler.Open(dir) == 0);
+        spooler.Submit(Target(port), "kept 1\n");
+        spooler.Submit(Target(port), std::string("kept 2 \0 binary\n", 16));
+        vt::PrintTarget lpd;
+        lpd.kind = vt::PrintTarget::Kind::Lpd;
+        lpd.host = "no_such_queue_for_vt_tests";
+        spooler.Shutdown();
+        REQUIRE(spooler.Submit(lpd, "after shutdown") == 0);
+    }
+    REQUIRE(JobFiles(dir) == 2);
+
+    FakePrinter printer(port);
+    vt::PrintSpooler spooler(FastOptions());
+    REQUIRE(spooler.Open(dir) == 2);
+    REQUIRE(spooler.WaitIdle(5s));
+    const std::string expected = "kept 1\n" + std::string("kept 2 \0 binary\n", 16);
+    for (int i = 0; i < 100 && printer.Received().size() < expected.size(); ++i)
+        std::this_thread::sleep_for(10ms);
+    REQUIRE(printer.Received() == expected);
+    REQUIRE(JobFiles(dir) == 0);
+
+    // new jobs number after the requeued ones
+    REQUIRE(spooler.Submit(Target(port), "next\n") > 2);
+    REQUIRE(spooler.WaitIdle(5s));
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,153 @@
+/*
+ * test_printer_job.cc - Unit tests for Printer's in-memory print jobs
+ * Covers Emit() and AppendJob() keeping printer codes with NULs intact,
+ * and file, socket and PDF targets getting the bytes the temp file held
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "printer.hh"
+#include "../mocks/fake_printer.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+
+// An Epson with its job buffer opened up
+class TestEpson : public PrinterEpson {
+public:
+    using PrinterEpson::PrinterEpson;
+    using Printer::Emit;
+    using Printer::AppendJob;
+};
+
+// A short receipt, with a NUL of its own besides the ones in Epson's codes
+void PrintTicket(Printer &p)
+{
+    p.Start();
+    p.Write("Table 12");
+    p.Put('\0');
+    p.Write("1 Burger", PRINT_RED);
+    p.End();
+}
+
+// What PrintTicket() sends an Epson, byte for byte
+const std::string EPSON_TICKET =
+    "\x1b\x40\x1b\x21\0"s             // Init()
+    "\x1b\x21\0\x1b\x72\0\x1b\x55\0"s // WriteFlags(0)
+    "\x1b\x3c"                        // Start()
+    "Table 12\n"
+    "\0"s
+    "\x1b\x72\x01"                    // PRINT_RED
+    "1 Burger\n"
+    "\x1b\x64\x08"                    // End(): LineFeed(END_PAGE)
+    "\x1b\x69";                       // and CutPaper()
+
+std::string TestPath(const char *name)
+{
+    return "/tmp/vt_test_printer." + std::string(name) + "." + std::to_string(getpid());
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void WriteFile(const std::string &path, const std::string &data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+} // namespace
+
+TEST_CASE("Printer::Emit and AppendJob keep binary data whole", "[printer_job]") {
+    const std::string path = TestPath("append");
+    std::filesystem::remove(path);
+    TestEpson p("", 0, path.c_str(), TARGET_FILE);
+    REQUIRE(p.Emit("x", 1) == -1);  // no job open
+
+    const std::string data = "a\0b\0\0c\xff\n"s;
+    p.Open();
+    REQUIRE(p.Emit(data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+    REQUIRE(p.AppendJob(path.c_str()) == 0);
+    REQUIRE(p.AppendJob(path.c_str()) == 0);
+    REQUIRE(ReadFile(path) == data + data);
+    REQUIRE(p.AppendJob("/nonexistent_vt_dir/job") == 1);
+
+    // closing a file target replaces the file with the job
+    p.Close();
+    REQUIRE_FALSE(p.IsOpen());
+    REQUIRE(ReadFile(path) == data);
+    REQUIRE(p.Emit("x", 1) == -1);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("A file printer gets the job byte for byte", "[printer_job]") {
+    const std::string path = TestPath("file");
+    WriteFile(path, "an older, longer job to be replaced\n");
+    PrinterEpson p("", 0, path.c_str(), TARGET_FILE);
+    PrintTicket(p);
+    REQUIRE(ReadFile(path) == EPSON_TICKET);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Socket and lpd jobs go to the print spooler unchanged", "[printer_job]") {
+    SECTION("socket") {
+        FakePrinter printer;
+        PrinterEpson p("", printer.port, "127.0.0.1", TARGET_SOCKET);
+        REQUIRE(p.SpoolTarget().kind == vt::PrintTarget::Kind::Socket);
+        REQUIRE(p.SpoolTarget().port == printer.port);
+
+        PrintTicket(p);
+        PrintTicket(p);
+        const std::string expected = EPSON_TICKET + EPSON_TICKET;
+        for (int i = 0; i < 500 && printer.Received().size() < expected.size(); ++i)
+            std::this_thread::sleep_for(10ms);
+        REQUIRE(printer.Received() == expected);
+    }
+
+    SECTION("lpd") {
+        PrinterEpson p("", 0, "kitchen", TARGET_LPD);
+        const vt::PrintTarget target = p.SpoolTarget();
+        REQUIRE(target.kind == vt::PrintTarget::Kind::Lpd);
+        REQUIRE(target.host == "kitchen");
+    }
+}
+
+TEST_CASE("A PDF printer sends ps2pdf's output", "[printer_job]") {
+    // a ps2pdf that marks its input, so the test doesn't need Ghostscript
+    const std::string bin = TestPath("bin");
+    std::filesystem::create_directories(bin);
+    WriteFile(bin + "/ps2pdf", "#!/bin/sh\n{ printf '%%PDF\\n'; cat; } > \"$2\"\n");
+    std::filesystem::permissions(bin + "/ps2pdf", std::filesystem::perms::owner_all);
+    const std::string old_path = std::getenv("PATH") ? std::getenv("PATH") : "";
+    setenv("PATH", (bin + ":" + old_path).c_str(), 1);
+
+    const std::string ps_path = TestPath("ps");
+    const std::string pdf_path = TestPath("pdf");
+    PrinterPostScript ps("", 0, ps_path.c_str(), TARGET_FILE);
+    PrinterPDF pdf("", 0, pdf_path.c_str(), TARGET_FILE);
+    PrintTicket(ps);
+    PrintTicket(pdf);
+    setenv("PATH", old_path.c_str(), 1);
+
+    const std::string postscript = ReadFile(ps_path);
+    REQUIRE(postscript.starts_with("%!PS"));
+    REQUIRE(ReadFile(pdf_path) == "%PDF\n" + postscript);
+
+    std::filesystem::remove(ps_path);
+    std::filesystem::remove(pdf_path);
+    std::filesystem::remove_all(bin);
+}
@@ -0,0 +1,172 @@
+/*
+ * test_protocol_recorder.cc - Unit tests for protocol_recorder.hh
+ * Covers CharQueue recording, reading recordings back and frame decoding
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "src/network/protocol_recorder.hh"
+#include "src/network/remote_link.hh"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+std::string TempPath()
+{
+    char path[] = "/tmp/vt_recorder_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        close(fd);
+    return path;
+}
+
+// Queues a frame the way Terminal::RenderText() and friends do
+void PutTextFrame(CharQueue &queue)
+{
+    queue.Put8(TerminalProtocol::TEXTL);
+    queue.PutString("Hello", 0);
+    queue.Put16(10);
+    queue.Put16(20);
+    queue.Put8(3);
+    queue.Put8(4);
+    queue.Put16(100);
+    queue.Put8(TerminalProtocol::HLINE);
+    queue.Put16(1);
+    queue.Put16(2);
+    queue.Put16(30);
+    queue.Put8(5);
+    queue.Put8(1);
+    queue.Put8(TerminalProtocol::UPDATEALL);
+}
+
+} // namespace
+
+TEST_CASE("CharQueue frames are recorded and read back", "[protocol_recorder]") {
+    std::string path = TempPath();
+    auto recorder = std::make_shared<vt::ProtocolRecorder>();
+    REQUIRE(recorder->Open(path) == 0);
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    CharQueue out(4096);
+    CharQueue in(4096);
+    out.SetRecorder(recorder, vt::RecordDirection::ToServer);
+    in.SetRecorder(recorder, vt::RecordDirection::ToTerminal);
+
+    PutTextFrame(out);
+    int payload = out.CurrSize();
+    REQUIRE(out.Write(fds[1]) == payload);
+    REQUIRE(in.Read(fds[0]) == payload);
+    REQUIRE(recorder->Frames() == 2);
+    recorder->Close();
+
+    vt::ProtocolReader reader;
+    REQUIRE(reader.Open(path) == 0);
+
+    vt::RecordedFrame first;
+    vt::RecordedFrame second;
+    REQUIRE(reader.Next(first));
+    REQUIRE(reader.Next(second));
+    REQUIRE_FALSE(reader.Next(second));
+
+    REQUIRE(first.direction == vt::RecordDirection::ToServer);
+    REQUIRE(second.direction == vt::RecordDirection::ToTerminal);
+    REQUIRE(first.payload == second.payload);
+    REQUIRE(static_cast<int>(first.payload.size()) == payload);
+    REQUIRE(second.timestamp_ns >= first.timestamp_ns);
+
+    close(fds[0]);
+    close(fds[1]);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("ProtocolReader rejects files without the magic", "[protocol_recorder]") {
+    std::string path = TempPath();
+    FILE *fp = fopen(path.c_str(), "wb");
+    REQUIRE(fp != nullptr);
+    fputs("not a recording", fp);
+    fclose(fp);
+
+    vt::ProtocolReader reader;
+    REQUIRE(reader.Open(path) != 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("DecodeTermFrame counts commands", "[protocol_recorder][decode]") {
+    std::string path = TempPath();
+    auto recorder = std::make_shared<vt::ProtocolRecorder>();
+    REQUIRE(recorder->Open(path) == 0);
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    CharQueue out(4096);
+    out.SetRecorder(recorder, vt::RecordDirection::ToTerminal);
+
+    SECTION("known commands decode completely") {
+        PutTextFrame(out);
+        REQUIRE(out.Write(fds[1]) > 0);
+        recorder->Close();
+
+        vt::ProtocolReader reader;
+        vt::RecordedFrame frame;
+        REQUIRE(reader.Open(path) == 0);
+        REQUIRE(reader.Next(frame));
+
+        vt::TermDecodeStats stats;
+        int n = vt::DecodeTermFrame(frame.payload.data(),
+                                    static_cast<int>(frame.payload.size()), stats);
+        REQUIRE(n == 3);
+        REQUIRE(stats.commands == 3);
+        REQUIRE(stats.frames == 1);
+        REQUIRE(stats.per_code[TerminalProtocol::TEXTL] == 1);
+        REQUIRE(stats.per_code[TerminalProtocol::HLINE] == 1);
+        REQUIRE(stats.undecoded_bytes == 0);
+        REQUIRE(stats.type_errors == 0);
+    }
+
+    SECTION("translations table is walked") {
+        out.Put8(TerminalProtocol::TRANSLATIONS);
+        out.Put8(2);
+        out.PutString("Yes", 0);
+        out.PutString("Si", 0);
+        out.PutString("No", 0);
+        out.PutString("No", 0);
+        out.Put8(TerminalProtocol::FLUSH);
+        REQUIRE(out.Write(fds[1]) > 0);
+        recorder->Close();
+
+        vt::ProtocolReader reader;
+        vt::RecordedFrame frame;
+        REQUIRE(reader.Open(path) == 0);
+        REQUIRE(reader.Next(frame));
+
+        vt::TermDecodeStats stats;
+        REQUIRE(vt::DecodeTermFrame(frame.payload.data(),
+                                    static_cast<int>(frame.payload.size()), stats) == 2);
+    }
+
+    SECTION("dialog commands stop decoding") {
+        out.Put8(TerminalProtocol::UPDATEALL);
+        out.Put8(TerminalProtocol::LISTSTART);
+        out.PutString("anything", 0);
+        REQUIRE(out.Write(fds[1]) > 0);
+        recorder->Close();
+
+        vt::ProtocolReader reader;
+        vt::RecordedFrame frame;
+        REQUIRE(reader.Open(path) == 0);
+        REQUIRE(reader.Next(frame));
+
+        vt::TermDecodeStats stats;
+        REQUIRE(vt::DecodeTermFrame(frame.payload.data(),
+                                    static_cast<int>(frame.payload.size()), stats) == 1);
+        REQUIRE(stats.undecoded_bytes == static_cast<long long>(frame.payload.size()) - 2);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    std::remove(path.c_str());
+}
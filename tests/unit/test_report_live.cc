@@ -0,0 +1,127 @@
+/*
+ * test_report_live.cc - Unit tests for Report's live entries
+ * A kitchen video blink patches the ticket's timer and flashing orders in
+ * place; the result has to match rebuilding the whole check report
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "report.hh"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Lays out a kitchen ticket the way Check::MakeReport() and
+// PrintWorkOrder() do.  The flashing orders are drawn white while the
+// blink is on, as they were before live entries.
+void BuildTicket(Report &r, const std::string &age, bool blink_on)
+{
+    const int flash_color = blink_on ? COLOR_WHITE : COLOR_RED;
+    r.Purge();
+
+    r.Header();
+    r.Mode(PRINT_BOLD);
+    r.TextL("Table 12");
+    r.TextR(age);
+    r.MarkLive(LIVE_TIMER);
+    r.NewLine();
+    r.Mode(0);
+
+    r.Body();
+    r.TextL("1 Hamburger", COLOR_DEFAULT);
+    r.NewLine();
+    r.TextL("2 Fries", flash_color);
+    r.MarkLive(LIVE_FLASH);
+    r.NewLine();
+    r.Text("    No Salt", blink_on ? COLOR_WHITE : COLOR_BLUE, ALIGN_LEFT, 0);
+    r.MarkLive(LIVE_FLASH);
+    r.NewLine();
+    r.Mode(PRINT_LARGE);
+    r.TextPosL(3, "1 Shake", flash_color);
+    r.MarkLive(LIVE_FLASH);
+    r.TextPosR(0, "3.50", COLOR_DEFAULT);
+    r.NewLine();
+    r.Mode(0);
+    r.TextL(age);
+    r.MarkLive(LIVE_TIMER);
+    r.NewLine();
+}
+
+bool SameEntries(const std::vector<ReportEntry> &a, const std::vector<ReportEntry> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].text != b[i].text || a[i].pos != b[i].pos || a[i].max_len != b[i].max_len ||
+            a[i].new_lines != b[i].new_lines || a[i].color != b[i].color ||
+            a[i].align != b[i].align || a[i].edge != b[i].edge || a[i].mode != b[i].mode ||
+            a[i].draw_a_line != b[i].draw_a_line)
+            return false;
+    }
+    return true;
+}
+
+bool SameReport(const Report &a, const Report &b)
+{
+    return SameEntries(a.HeaderEntries(), b.HeaderEntries()) &&
+           SameEntries(a.BodyEntries(), b.BodyEntries());
+}
+
+} // namespace
+
+TEST_CASE("Patching a ticket's live entries matches rebuilding it", "[report_live]") {
+    Report patched;
+    BuildTicket(patched, "1:05", false);
+    REQUIRE(patched.LiveCount(LIVE_TIMER) == 2);
+    REQUIRE(patched.LiveCount(LIVE_FLASH) == 3);
+
+    Report rebuilt;
+    SECTION("blink on with a new timer") {
+        patched.SetLiveText(LIVE_TIMER, "1:06");
+        patched.SetLiveBlink(LIVE_FLASH, 1);
+        BuildTicket(rebuilt, "1:06", true);
+        REQUIRE(SameReport(patched, rebuilt));
+    }
+
+    SECTION("blink back off restores each entry's own color") {
+        patched.SetLiveBlink(LIVE_FLASH, 1);
+        patched.SetLiveText(LIVE_TIMER, "1:07");
+        patched.SetLiveBlink(LIVE_FLASH, 0);
+        BuildTicket(rebuilt, "1:07", false);
+        REQUIRE(SameReport(patched, rebuilt));
+    }
+
+    SECTION("many blinks") {
+        for (int tick = 0; tick < 10; ++tick)
+        {
+            const std::string age = "2:" + std::to_string(10 + tick);
+            patched.SetLiveText(LIVE_TIMER, age);
+            patched.SetLiveBlink(LIVE_FLASH, tick & 1);
+            BuildTicket(rebuilt, age, tick & 1);
+            REQUIRE(SameReport(patched, rebuilt));
+        }
+    }
+}
+
+TEST_CASE("Live entries go with the entries they tag", "[report_live]") {
+    Report r;
+    REQUIRE(r.MarkLive(LIVE_TIMER) == 1);  // nothing to tag yet
+    REQUIRE(r.LiveCount(LIVE_TIMER) == 0);
+
+    BuildTicket(r, "0:30", false);
+    r.PurgeHeader();
+    REQUIRE(r.LiveCount(LIVE_TIMER) == 1);  // the body's
+    REQUIRE(r.LiveCount(LIVE_FLASH) == 3);
+    r.SetLiveText(LIVE_TIMER, "0:31");
+    REQUIRE(r.HeaderEntries().empty());
+    REQUIRE(r.BodyEntries().back().text == "0:31");
+
+    r.Purge();
+    REQUIRE(r.LiveCount(LIVE_TIMER) == 0);
+    REQUIRE(r.LiveCount(LIVE_FLASH) == 0);
+    r.SetLiveText(LIVE_TIMER, "0:32");
+    r.SetLiveBlink(LIVE_FLASH, 1);
+    REQUIRE(r.BodyEntries().empty());
+}
@@ -0,0 +1,75 @@
+/*
+ * test_resume_session.cc - Unit tests for resume_session.hh
+ * Covers issuing tokens and timing out lost sessions
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "resume_session.hh"
+
+#include <chrono>
+
+namespace {
+
+struct FakeTerm {
+    int id;
+};
+
+using Table = vt::SessionTable<FakeTerm>;
+
+} // namespace
+
+TEST_CASE("Session tokens are long and unique", "[resume_session]") {
+    const std::string a = vt::NewSessionToken();
+    const std::string b = vt::NewSessionToken();
+    REQUIRE(a.size() == 32);
+    REQUIRE(a.find_first_not_of("0123456789abcdef") == std::string::npos);
+    REQUIRE(a != b);
+}
+
+TEST_CASE("SessionTable maps tokens to their owner", "[resume_session]") {
+    FakeTerm bar{1};
+    FakeTerm patio{2};
+    Table table;
+
+    const std::string bar_token = table.Issue(&bar);
+    const std::string patio_token = table.Issue(&patio);
+    REQUIRE(table.Find(bar_token) == &bar);
+    REQUIRE(table.Find(patio_token) == &patio);
+    REQUIRE(table.Find("not-a-token") == nullptr);
+
+    SECTION("issuing again replaces the old token") {
+        const std::string fresh = table.Issue(&bar);
+        REQUIRE(table.Find(fresh) == &bar);
+        REQUIRE(table.Find(bar_token) == nullptr);
+        REQUIRE(table.Size() == 2);
+    }
+
+    SECTION("removed owners can't be resumed") {
+        table.Remove(&bar);
+        REQUIRE(table.Find(bar_token) == nullptr);
+        REQUIRE_FALSE(table.Has(&bar));
+        REQUIRE(table.Has(&patio));
+    }
+}
+
+TEST_CASE("SessionTable reports sessions lost past the grace period", "[resume_session]") {
+    using namespace std::chrono_literals;
+    FakeTerm bar{1};
+    FakeTerm patio{2};
+    Table table;
+    table.Issue(&bar);
+    table.Issue(&patio);
+
+    const auto t0 = Table::Clock::time_point{} + 1h;
+    table.Lost(&bar, t0);
+    table.Lost(&bar, t0 + 20s);  // still counts from the first loss
+    REQUIRE(table.IsLost(&bar));
+    REQUIRE_FALSE(table.IsLost(&patio));
+
+    REQUIRE(table.Expired(t0 + 29s, 30s).empty());
+    REQUIRE(table.Expired(t0 + 31s, 30s) == std::vector<FakeTerm *>{&bar});
+
+    table.Resumed(&bar);
+    REQUIRE_FALSE(table.IsLost(&bar));
+    REQUIRE(table.Expired(t0 + 60s, 30s).empty());
+}
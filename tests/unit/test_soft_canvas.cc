@@ -0,0 +1,157 @@
+/*
+ * test_soft_canvas.cc - Unit tests for soft_canvas.hh
+ * Covers the software Layer backend's fills, clipping, images and PPM output
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/soft_canvas.hh"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t RED   = 0xFF0000;
+constexpr uint32_t GREEN = 0x00FF00;
+constexpr uint32_t BLUE  = 0x0000FF;
+
+int CountColor(const vt::SoftCanvas &canvas, uint32_t color)
+{
+    int count = 0;
+    for (int y = 0; y < canvas.Height(); ++y)
+        for (int x = 0; x < canvas.Width(); ++x)
+            count += canvas.Pixel(x, y) == color;
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("SoftCanvas fills rectangles inside the clip", "[soft_canvas]") {
+    vt::SoftCanvas canvas(20, 10);
+    REQUIRE(CountColor(canvas, 0) == 200);
+
+    canvas.FillRect(2, 3, 4, 5, vt::SoftPaint::Solid(RED));
+    REQUIRE(CountColor(canvas, RED) == 20);
+    REQUIRE(canvas.Pixel(2, 3) == RED);
+    REQUIRE(canvas.Pixel(5, 7) == RED);
+    REQUIRE(canvas.Pixel(6, 7) == 0);
+
+    SECTION("off-canvas parts are dropped") {
+        canvas.FillRect(-5, -5, 100, 100, vt::SoftPaint::Solid(GREEN));
+        REQUIRE(CountColor(canvas, GREEN) == 200);
+    }
+
+    SECTION("clip limits every primitive") {
+        canvas.SetClip(10, 0, 5, 5);
+        canvas.FillRect(0, 0, 20, 10, vt::SoftPaint::Solid(GREEN));
+        canvas.DrawLine(0, 0, 19, 9, BLUE);
+        REQUIRE(CountColor(canvas, GREEN) + CountColor(canvas, BLUE) == 25);
+        REQUIRE(canvas.Pixel(9, 0) == 0);
+
+        canvas.ClearClip();
+        canvas.FillRect(0, 0, 20, 10, vt::SoftPaint::Solid(GREEN));
+        REQUIRE(CountColor(canvas, GREEN) == 200);
+    }
+}
+
+TEST_CASE("SoftCanvas stipples and tiles like the X GC", "[soft_canvas]") {
+    vt::SoftCanvas canvas(8, 8);
+
+    SECTION("stipple is a checkerboard") {
+        canvas.FillRect(0, 0, 8, 8, vt::SoftPaint::Stippled(RED));
+        REQUIRE(CountColor(canvas, RED) == 32);
+        REQUIRE(canvas.Pixel(0, 0) == RED);
+        REQUIRE(canvas.Pixel(1, 0) == 0);
+        REQUIRE(canvas.Pixel(1, 1) == RED);
+    }
+
+    SECTION("tiles repeat from the origin") {
+        vt::SoftImage tile;
+        tile.width = 2;
+        tile.height = 1;
+        tile.pixels = {RED, BLUE};
+
+        canvas.FillRect(0, 0, 8, 2, vt::SoftPaint::Tiled(&tile, 1, 0));
+        REQUIRE(canvas.Pixel(0, 0) == BLUE);
+        REQUIRE(canvas.Pixel(1, 0) == RED);
+        REQUIRE(canvas.Pixel(2, 1) == BLUE);
+        REQUIRE(canvas.Pixel(7, 1) == RED);
+        REQUIRE(CountColor(canvas, RED) == 8);
+    }
+}
+
+TEST_CASE("SoftCanvas shapes stay inside their bounds", "[soft_canvas]") {
+    vt::SoftCanvas canvas(40, 40);
+
+    SECTION("polygon") {
+        vt::SoftPoint square[] = {{10, 10}, {20, 10}, {20, 20}, {10, 20}};
+        canvas.FillPolygon(square, 4, vt::SoftPaint::Solid(RED));
+        REQUIRE(CountColor(canvas, RED) == 100);
+
+        vt::SoftPoint triangle[] = {{0, 39}, {39, 39}, {0, 0}};
+        canvas.FillPolygon(triangle, 3, vt::SoftPaint::Solid(BLUE));
+        REQUIRE(canvas.Pixel(1, 38) == BLUE);
+        REQUIRE(canvas.Pixel(38, 1) == 0);
+    }
+
+    SECTION("ellipse") {
+        canvas.FillEllipse(0, 0, 40, 40, vt::SoftPaint::Solid(GREEN));
+        REQUIRE(canvas.Pixel(20, 20) == GREEN);
+        REQUIRE(canvas.Pixel(0, 0) == 0);
+        REQUIRE(canvas.Pixel(39, 39) == 0);
+        int area = CountColor(canvas, GREEN);
+        REQUIRE(area > 1200);   // pi * 20^2 ~ 1257
+        REQUIRE(area < 1320);
+    }
+
+    SECTION("arc covers only its angle range") {
+        // 0 to 90 degrees is the top right quarter
+        canvas.DrawArc(0, 0, 40, 40, 0, 90, 3, RED);
+        REQUIRE(CountColor(canvas, RED) > 0);
+        REQUIRE(canvas.Pixel(34, 6) == RED);
+        REQUIRE(canvas.Pixel(6, 34) == 0);
+        REQUIRE(canvas.Pixel(20, 20) == 0);
+    }
+}
+
+TEST_CASE("SoftCanvas scales masked images", "[soft_canvas]") {
+    vt::SoftImage image;
+    image.width = 2;
+    image.height = 2;
+    image.pixels = {RED, GREEN, BLUE, RED};
+    image.mask = {255, 255, 255, 0};
+
+    vt::SoftCanvas canvas(4, 4);
+    canvas.FillRect(0, 0, 4, 4, vt::SoftPaint::Solid(0x123456));
+    canvas.DrawImage(image, 0, 0, 4, 4);
+    REQUIRE(canvas.Pixel(0, 0) == RED);
+    REQUIRE(canvas.Pixel(1, 1) == RED);
+    REQUIRE(canvas.Pixel(2, 0) == GREEN);
+    REQUIRE(canvas.Pixel(0, 3) == BLUE);
+    REQUIRE(canvas.Pixel(3, 3) == 0x123456);  // masked out
+}
+
+TEST_CASE("SoftCanvas writes a binary PPM", "[soft_canvas]") {
+    vt::SoftCanvas canvas(3, 2);
+    canvas.FillRect(0, 0, 3, 2, vt::SoftPaint::Solid(0x102030));
+
+    char path[] = "/tmp/vt_canvas_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+    REQUIRE(canvas.WritePPM(path) == 0);
+
+    FILE *fp = fopen(path, "rb");
+    REQUIRE(fp != nullptr);
+    char header[16] = {};
+    REQUIRE(fread(header, 1, 11, fp) == 11);
+    REQUIRE(std::string(header) == "P6\n3 2\n255\n");
+    unsigned char rgb[3] = {};
+    REQUIRE(fread(rgb, 1, 3, fp) == 3);
+    REQUIRE(rgb[0] == 0x10);
+    REQUIRE(rgb[1] == 0x20);
+    REQUIRE(rgb[2] == 0x30);
+    fclose(fp);
+    std::remove(path);
+}
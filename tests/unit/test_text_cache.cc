@@ -0,0 +1,119 @@
+/*
+ * test_text_cache.cc - Unit tests for text_cache.hh
+ * Covers zone label wrapping, cache hits and eviction
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "term/text_cache.hh"
+
+#include <string>
+
+namespace {
+
+// Fixed 10 pixel cells, counting how often the cache falls through
+struct CountingMeasure {
+    int calls = 0;
+    vt::MeasureFn Fn()
+    {
+        return [this](const char* /*str*/, int len) {
+            ++calls;
+            return len > 0 ? len * 10 : 0;
+        };
+    }
+};
+
+std::string Line(const char* str, const vt::TextLine &line)
+{
+    return std::string(str + line.offset, static_cast<size_t>(line.length));
+}
+
+} // namespace
+
+TEST_CASE("WrapText breaks zone labels like ZoneText", "[text_cache]") {
+    CountingMeasure measure;
+
+    SECTION("a label that fits is one line") {
+        const char* str = "Burger";
+        vt::TextLayout layout = vt::WrapText(str, 100, 3, measure.Fn());
+        REQUIRE(layout.lines.size() == 1);
+        REQUIRE(Line(str, layout.lines[0]) == "Burger");
+        REQUIRE_FALSE(layout.overflow);
+    }
+
+    SECTION("words wrap at spaces") {
+        const char* str = "Grilled Cheese Sandwich";
+        vt::TextLayout layout = vt::WrapText(str, 100, 3, measure.Fn());
+        REQUIRE(layout.lines.size() == 3);
+        REQUIRE(Line(str, layout.lines[0]) == "Grilled");
+        REQUIRE(Line(str, layout.lines[1]) == "Cheese");
+        REQUIRE(Line(str, layout.lines[2]) == "Sandwich");
+    }
+
+    SECTION("a backslash forces a break") {
+        const char* str = "Ham\\Eggs";
+        vt::TextLayout layout = vt::WrapText(str, 200, 3, measure.Fn());
+        REQUIRE(layout.lines.size() == 2);
+        REQUIRE(Line(str, layout.lines[0]) == "Ham");
+        REQUIRE(Line(str, layout.lines[1]) == "Eggs");
+    }
+
+    SECTION("a long word is truncated and the rest flagged") {
+        const char* str = "Supercalifragilistic";
+        vt::TextLayout layout = vt::WrapText(str, 50, 1, measure.Fn());
+        REQUIRE(layout.lines.size() == 1);
+        REQUIRE(Line(str, layout.lines[0]) == "Super");
+        REQUIRE(layout.overflow);
+    }
+}
+
+TEST_CASE("TextCache measures each string once per font", "[text_cache]") {
+    vt::TextCache cache;
+    CountingMeasure measure;
+
+    REQUIRE(cache.Width(1, "Coffee", 6, measure.Fn()) == 60);
+    REQUIRE(cache.Width(1, "Coffee", 6, measure.Fn()) == 60);
+    REQUIRE(cache.Width(1, "Coffee refill", 6, measure.Fn()) == 60);  // same bytes
+    REQUIRE(measure.calls == 1);
+    REQUIRE(cache.Width(2, "Coffee", 6, measure.Fn()) == 60);
+    REQUIRE(measure.calls == 2);
+    REQUIRE(cache.Width(1, "", 0, measure.Fn()) == 0);
+
+    const vt::TextLayout &first = cache.Layout(1, "Grilled Cheese", 100, 3, measure.Fn());
+    REQUIRE(first.lines.size() == 2);
+    const int calls = measure.calls;
+    const vt::TextLayout &again = cache.Layout(1, "Grilled Cheese", 100, 3, measure.Fn());
+    REQUIRE(again.lines.size() == 2);
+    REQUIRE(measure.calls == calls);
+    // A different size is a different layout
+    REQUIRE(cache.Layout(1, "Grilled Cheese", 200, 3, measure.Fn()).lines.size() == 1);
+
+    auto stats = cache.GetStats();
+    REQUIRE(stats.width_hits == 2);
+    REQUIRE(stats.width_misses == 2);
+    REQUIRE(stats.layout_hits == 1);
+    REQUIRE(stats.layout_misses == 2);
+
+    SECTION("clear forgets everything, as after a font reload") {
+        cache.Clear();
+        REQUIRE(cache.GetStats().entries == 0);
+        cache.Width(1, "Coffee", 6, measure.Fn());
+        REQUIRE(cache.GetStats().width_misses == 3);
+    }
+}
+
+TEST_CASE("TextCache evicts the least recently used strings", "[text_cache]") {
+    vt::TextCache cache(2);
+    CountingMeasure measure;
+
+    cache.Width(0, "a", 1, measure.Fn());
+    cache.Width(0, "b", 1, measure.Fn());
+    cache.Width(0, "a", 1, measure.Fn());  // b is now the oldest
+    cache.Width(0, "c", 1, measure.Fn());
+    REQUIRE(measure.calls == 3);
+
+    cache.Width(0, "a", 1, measure.Fn());
+    REQUIRE(measure.calls == 3);
+    cache.Width(0, "b", 1, measure.Fn());
+    REQUIRE(measure.calls == 4);
+    REQUIRE(cache.GetStats().entries == 2);
+}
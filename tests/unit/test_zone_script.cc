@@ -0,0 +1,157 @@
+/*
+ * test_zone_script.cc - Unit tests for zone_script.hh
+ * Covers compiling button expressions and modifier scripts to the same
+ * results the sscanf() parsers in ConditionalZone and RunScript() gave
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "zone/zone_script.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const KeyWords[] = {
+    "check", "guests", "subchecks", "settle", "order", "drawer",
+    "drawercount", "orderbyseat", "developer", "flow", "assigned",
+    "local", "supervisor", "manager", "editusers", "merchandise",
+    "movetable", "tablepages", "passwords", "superuser",
+    "payexpenses", "fastfood", "selforder", "lastendday",
+    "checkbalanced", "haspayments", "training", "selectedorder", nullptr};
+
+const char* const OperatorWords[] = {"=", ">", "<", "!=", ">=", nullptr};
+
+// CompareList() with StringCompare()'s lower casing
+int OldCompareList(const std::string &word, const char* const list[])
+{
+    auto lower = [](std::string s) {
+        for (char &c : s)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    };
+    for (int i = 0; list[i] != nullptr; ++i)
+    {
+        if (lower(word) == lower(list[i]))
+            return i;
+    }
+    return -1;
+}
+
+// ConditionalZone::RenderInit() before vt::Condition
+vt::Condition OldCondition(const std::string &expression)
+{
+    char str1[256] = "", str2[256] = "";
+    int val = 0;
+    sscanf(expression.c_str(), "%255s %255s %d", str1, str2, &val);
+    vt::Condition result;
+    result.keyword = OldCompareList(str1, KeyWords);
+    result.op      = OldCompareList(str2, OperatorWords);
+    result.value   = val;
+    return result;
+}
+
+// Terminal::RunScript() before vt::PageScript
+std::vector<int> OldScript(const std::string &script)
+{
+    int j[16];
+    const int count = sscanf(script.c_str(), "%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d",
+                             &j[ 0], &j[ 1], &j[ 2], &j[ 3], &j[ 4], &j[ 5], &j[ 6], &j[ 7],
+                             &j[ 8], &j[ 9], &j[10], &j[11], &j[12], &j[13], &j[14], &j[15]);
+    return std::vector<int>(j, j + std::max(0, count));
+}
+
+std::vector<int> NewScript(const std::string &script)
+{
+    vt::PageScript compiled;
+    compiled.Compile(script);
+    return std::vector<int>(compiled.pages.begin(), compiled.pages.begin() + compiled.count);
+}
+
+void RequireSameCondition(const std::string &expression)
+{
+    INFO("expression: '" << expression << "'");
+    vt::Condition compiled;
+    compiled.Compile(expression, KeyWords, OperatorWords);
+    const vt::Condition old = OldCondition(expression);
+    REQUIRE(compiled.keyword == old.keyword);
+    REQUIRE(compiled.op == old.op);
+    // the value only matters once the keyword and operator are known
+    if (old.keyword >= 0 && old.op >= 0)
+        REQUIRE(compiled.value == old.value);
+}
+
+void RequireSameScript(const std::string &script)
+{
+    INFO("script: '" << script << "'");
+    REQUIRE(NewScript(script) == OldScript(script));
+}
+
+} // namespace
+
+TEST_CASE("Condition compiles expressions like the old sscanf parse", "[zone_script]") {
+    const std::vector<std::string> corpus = {
+        "", " ", "check", "check =", "check = 1", "guests > 4", "GUESTS >= 2",
+        "subchecks != 0", "drawercount < 3", "lastendday >= -1", "  settle   =   1  ",
+        "\tmanager\t=\t1\n", "flow = +1", "flow = -0", "training = 1x", "training = x1",
+        "haspayments", "selectedorder = 1 extra words", "bogus = 1", "check == 1",
+        "check => 1", "check = 2147483647", "check = 2147483648", "check = -2147483649",
+        "check = 4294967297", "check = 99999999999999999999", "check = -99999999999999999999",
+        "check =1", "check=1", "Check = 0", "checkbalanced != 1", "fastfood = 1", "selforder = 0",
+        std::string(300, 'a') + " = 1", "check " + std::string(260, '=') + " 1",
+        std::string(255, 'x') + "= 1"
+    };
+    for (const std::string &expression : corpus)
+        RequireSameCondition(expression);
+}
+
+TEST_CASE("Condition recompiles only when its expression changes", "[zone_script]") {
+    vt::Condition condition;
+    REQUIRE_FALSE(condition.Compiled(""));
+    condition.Compile("bogus = 1", KeyWords, OperatorWords);
+    REQUIRE(condition.Compiled("bogus = 1"));
+    REQUIRE(condition.keyword == -1);
+    REQUIRE_FALSE(condition.Compiled("guests > 2"));
+    condition.Compile("guests > 2", KeyWords, OperatorWords);
+    REQUIRE(condition.keyword == 1);
+    REQUIRE(condition.op == 1);
+    REQUIRE(condition.value == 2);
+}
+
+TEST_CASE("PageScript compiles scripts like the old sscanf parse", "[zone_script]") {
+    const std::vector<std::string> corpus = {
+        "", "   ", "12", "12 13 14", " -5 7", "+3 4", "1\t2\n3", "1 2 x 3", "1-2",
+        "1 - 2", "- 1", "+", "0x10 5", "007 08", "1,2,3",
+        "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18",
+        "2147483647 2147483648 -2147483648 -2147483649 4294967297",
+        "99999999999999999999 -99999999999999999999 1"
+    };
+    for (const std::string &script : corpus)
+        RequireSameScript(script);
+
+    vt::PageScript script;
+    script.Compile("20 21");
+    REQUIRE(script.Compiled("20 21"));
+    REQUIRE_FALSE(script.Compiled("20 22"));
+}
+
+TEST_CASE("Compiled expressions and scripts agree on random text", "[zone_script]") {
+    std::mt19937 rng(20261018);
+    const std::string alphabet = "checkguestsdrawer=<>!+-0123456789 \t";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<int> length(0, 40);
+    for (int n = 0; n < 5000; ++n)
+    {
+        std::string text;
+        for (int i = length(rng); i > 0; --i)
+            text.push_back(alphabet[pick(rng)]);
+        RequireSameCondition(text);
+        RequireSameScript(text);
+        // and with a real keyword in front
+        RequireSameCondition("guests " + text);
+    }
+}
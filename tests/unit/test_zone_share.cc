@@ -0,0 +1,124 @@
+/*
+ * test_zone_share.cc - Unit tests for ZoneDB::Share() and Page::Unshare()
+ * Covers terminals sharing the master layout's zones until they first use
+ * a page, and what editing or replacing either side does to the other
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../mocks/zone_test_types.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A master layout: page 1 with zones "a" and "b", page 2 with "c"
+std::shared_ptr<ZoneDB> MasterDB()
+{
+    auto db = std::make_shared<ZoneDB>();
+    db->Add(TestPage::Make(1, {"a", "b"}).release());
+    db->Add(TestPage::Make(2, {"c"}).release());
+    return db;
+}
+
+} // namespace
+
+TEST_CASE("A shared page has no zones of its own until first used", "[zone_share]") {
+    std::shared_ptr<ZoneDB> master = MasterDB();
+    std::unique_ptr<ZoneDB> term = ZoneDB::Share(master);
+    REQUIRE(term != nullptr);
+    REQUIRE(term->PageCount() == 2);
+    REQUIRE(term->SharedPages() == 2);
+
+    Page *page = term->FindByID(1);
+    REQUIRE(page != nullptr);
+    REQUIRE(page != master->FindByID(1));
+    REQUIRE(page->IsShared());
+    REQUIRE(page->ZoneCount() == 2);  // counted through the definition
+    REQUIRE(term->SharedPages() == 2);
+
+    // the first ZoneList() copies the definition's zones
+    const std::vector<std::string> names = ZoneNames(page);
+    REQUIRE(names == std::vector<std::string>{"a", "b"});
+    REQUIRE_FALSE(page->IsShared());
+    REQUIRE(term->SharedPages() == 1);
+    for (Zone *z = page->ZoneList(); z != nullptr; z = z->next)
+    {
+        REQUIRE(z->page == page);
+        REQUIRE_FALSE(master->FindByID(1)->IsZoneOnPage(z));
+    }
+}
+
+TEST_CASE("Editing one terminal's page leaves the master and other terminals alone", "[zone_share]") {
+    std::shared_ptr<ZoneDB> master = MasterDB();
+    std::unique_ptr<ZoneDB> term1 = ZoneDB::Share(master);
+    std::unique_ptr<ZoneDB> term2 = ZoneDB::Share(master);
+
+    Page *page1 = term1->FindByID(1);
+    REQUIRE(page1->Add(TestZone::Make("d").release()) == 0);
+    REQUIRE_FALSE(page1->IsShared());
+    REQUIRE(ZoneNames(page1) == std::vector<std::string>{"a", "b", "d"});
+
+    Zone *first = page1->ZoneList();
+    REQUIRE(page1->Remove(first) == 0);
+    delete first;
+    REQUIRE(ZoneNames(page1) == std::vector<std::string>{"b", "d"});
+
+    // adding to a page never used before copies its zones first
+    Page *page2 = term1->FindByID(2);
+    REQUIRE(page2->IsShared());
+    Zone *c = TestZone::Make("x").release();
+    REQUIRE(page2->AddFront(c) == 0);
+    REQUIRE(ZoneNames(page2) == std::vector<std::string>{"x", "c"});
+
+    REQUIRE(ZoneNames(master->FindByID(1)) == std::vector<std::string>{"a", "b"});
+    REQUIRE(ZoneNames(master->FindByID(2)) == std::vector<std::string>{"c"});
+    REQUIRE(term2->FindByID(1)->IsShared());
+    REQUIRE(ZoneNames(term2->FindByID(1)) == std::vector<std::string>{"a", "b"});
+    REQUIRE(ZoneNames(term2->FindByID(2)) == std::vector<std::string>{"c"});
+}
+
+TEST_CASE("ChangeItemName reaches shared and unshared pages", "[zone_share]") {
+    std::shared_ptr<ZoneDB> master = MasterDB();
+    for (Page *p = master->PageList(); p != nullptr; p = p->next)
+    {
+        for (Zone *z = p->ZoneList(); z != nullptr; z = z->next)
+            z->ItemName()->Set("Burger");
+    }
+    std::unique_ptr<ZoneDB> term = ZoneDB::Share(master);
+    Page *unshared = term->FindByID(1);
+    unshared->ZoneList();
+    REQUIRE_FALSE(unshared->IsShared());
+    REQUIRE(term->FindByID(2)->IsShared());
+
+    // Control::ChangeItemName() renames in the master and every terminal
+    REQUIRE(master->ChangeItemName("burger", "Cheeseburger") == 3);
+    REQUIRE(term->ChangeItemName("burger", "Cheeseburger") == 2);  // its own copies only
+
+    for (Page *p = term->PageList(); p != nullptr; p = p->next)
+    {
+        for (Zone *z = p->ZoneList(); z != nullptr; z = z->next)
+            REQUIRE(std::string(z->ItemName()->Value()) == "Cheeseburger");
+    }
+}
+
+TEST_CASE("Replacing the master ZoneDB leaves its sharers valid", "[zone_share]") {
+    std::shared_ptr<ZoneDB> master = MasterDB();
+    std::unique_ptr<ZoneDB> term = ZoneDB::Share(master);
+    std::weak_ptr<ZoneDB> old_master = master;
+
+    // saving an edit replaces Control::zone_db instead of changing it
+    master = std::make_shared<ZoneDB>();
+    master->Add(TestPage::Make(1, {"new"}).release());
+    REQUIRE_FALSE(old_master.expired());  // held by the terminal's shared_base
+
+    REQUIRE(term->FindByID(1)->IsShared());
+    REQUIRE(ZoneNames(term->FindByID(1)) == std::vector<std::string>{"a", "b"});
+    REQUIRE(ZoneNames(term->FindByID(2)) == std::vector<std::string>{"c"});
+
+    // a terminal that reloads picks up the new layout, and the old one goes
+    term = ZoneDB::Share(master);
+    REQUIRE(old_master.expired());
+    REQUIRE(ZoneNames(term->FindByID(1)) == std::vector<std::string>{"new"});
+}
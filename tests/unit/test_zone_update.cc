@@ -0,0 +1,115 @@
+/*
+ * test_zone_update.cc - Unit tests for Page::Update() message dispatch
+ * Covers which zones Page::Subscribe() collects, that parent pages get
+ * the message too, and zones that change the page while it is dispatching
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include "../mocks/zone_test_types.hh"
+#include "terminal.hh"
+
+#include <memory>
+#include <vector>
+
+TEST_CASE("Page::Update passes a message only to zones whose mask has it", "[zone_update]") {
+    std::vector<int> minute_log, checks_log, both_log, none_log;
+    TestPage page;
+    page.Add(TestZone::Make("minute", UPDATE_MINUTE, &minute_log).release());
+    page.Add(TestZone::Make("checks", UPDATE_CHECKS, &checks_log).release());
+    page.Add(TestZone::Make("both", UPDATE_MINUTE | UPDATE_CHECKS, &both_log).release());
+    page.Add(TestZone::Make("none", 0, &none_log).release());
+
+    page.Update(nullptr, UPDATE_MINUTE, nullptr);
+    REQUIRE(minute_log == std::vector<int>{UPDATE_MINUTE});
+    REQUIRE(checks_log.empty());
+    REQUIRE(both_log == std::vector<int>{UPDATE_MINUTE});
+
+    page.Update(nullptr, UPDATE_CHECKS, nullptr);
+    page.Update(nullptr, UPDATE_BLINK, nullptr);
+    REQUIRE(minute_log == std::vector<int>{UPDATE_MINUTE});
+    REQUIRE(checks_log == std::vector<int>{UPDATE_CHECKS});
+    REQUIRE(both_log == std::vector<int>{UPDATE_MINUTE, UPDATE_CHECKS});
+    REQUIRE(none_log.empty());
+
+    SECTION("a zone added later is subscribed on the next message") {
+        std::vector<int> blink_log;
+        page.Add(TestZone::Make("blink", UPDATE_BLINK, &blink_log).release());
+        page.Update(nullptr, UPDATE_BLINK, nullptr);
+        REQUIRE(blink_log == std::vector<int>{UPDATE_BLINK});
+    }
+}
+
+TEST_CASE("Page::Update reaches the zones of parent pages", "[zone_update]") {
+    std::vector<int> log;
+    TestPage grandparent, parent, page;
+    grandparent.Add(TestZone::Make("grandparent", UPDATE_MINUTE, &log).release());
+    parent.Add(TestZone::Make("parent", UPDATE_CHECKS, &log).release());
+    page.Add(TestZone::Make("page", UPDATE_MINUTE, &log).release());
+    page.parent_page = &parent;
+    parent.parent_page = &grandparent;
+
+    page.Update(nullptr, UPDATE_MINUTE, nullptr);
+    REQUIRE(log == std::vector<int>{UPDATE_MINUTE, UPDATE_MINUTE});
+
+    log.clear();
+    page.Update(nullptr, UPDATE_CHECKS, nullptr);
+    REQUIRE(log == std::vector<int>{UPDATE_CHECKS});
+
+    // the parent's own update doesn't go down to its children
+    log.clear();
+    parent.Update(nullptr, UPDATE_MINUTE, nullptr);
+    REQUIRE(log == std::vector<int>{UPDATE_MINUTE});
+}
+
+TEST_CASE("Page::Update stops safely when a zone changes the page", "[zone_update]") {
+    std::vector<int> log, parent_log;
+    TestPage parent, page;
+    parent.Add(TestZone::Make("parent", UPDATE_MINUTE, &parent_log).release());
+    page.parent_page = &parent;
+
+    auto first = TestZone::Make("first", UPDATE_MINUTE, &log);
+    TestZone *second = TestZone::Make("second", UPDATE_MINUTE, &log).release();
+    TestZone *third = TestZone::Make("third", UPDATE_MINUTE, &log).release();
+
+    SECTION("removing a later zone") {
+        first->on_update = [&](TestZone *z) {
+            if (second == nullptr)
+                return;
+            z->page->Remove(second);
+            delete second;
+            second = nullptr;
+        };
+        page.Add(first.release());
+        page.Add(second);
+        page.Add(third);
+
+        page.Update(nullptr, UPDATE_MINUTE, nullptr);
+        REQUIRE(log == std::vector<int>{UPDATE_MINUTE});         // second and third skipped
+        REQUIRE(parent_log == std::vector<int>{UPDATE_MINUTE});  // the parent still gets it
+
+        log.clear();
+        page.Update(nullptr, UPDATE_MINUTE, nullptr);
+        REQUIRE(log == std::vector<int>{UPDATE_MINUTE, UPDATE_MINUTE});  // first and third
+    }
+
+    SECTION("adding a zone") {
+        std::vector<int> added_log;
+        first->on_update = [&](TestZone *z) {
+            if (added_log.empty() && log.size() == 1)
+                z->page->Add(TestZone::Make("added", UPDATE_MINUTE, &added_log).release());
+        };
+        page.Add(first.release());
+        page.Add(second);
+        page.Add(third);
+
+        page.Update(nullptr, UPDATE_MINUTE, nullptr);
+        REQUIRE(log == std::vector<int>{UPDATE_MINUTE});
+        REQUIRE(added_log.empty());
+        REQUIRE(parent_log == std::vector<int>{UPDATE_MINUTE});
+
+        // the next message goes to all of them, the new zone included
+        page.Update(nullptr, UPDATE_MINUTE, nullptr);
+        REQUIRE(log.size() == 4);
+        REQUIRE(added_log == std::vector<int>{UPDATE_MINUTE});
+    }
+}
@@ -179,6 +179,15 @@ RenderResult ButtonZone::Render(Terminal *term, int update_flag)
     return Zone::Render(term, update_flag);
 }
 
+const genericChar* ButtonZone::PressText(Terminal *term)
+{
+    FnTrace("ButtonZone::PressText()");
+    Str *path = ImagePath();
+    if (path && path->size() > 0 && term->show_button_images)
+        return nullptr;
+    return name.Value();
+}
+
 // Member Functions
 std::unique_ptr<Zone> ButtonZone::Copy()
 {
@@ -461,7 +470,7 @@ char* MessageButtonZone::ValidateCommand(char* source)
 
 
 /**** ConditionalZone class ****/
-static const genericChar* KeyWords[] = {
+static const genericChar* const KeyWords[] = {
     "check", "guests", "subchecks", "settle", "order", "drawer",
     "drawercount", "orderbyseat", "developer", "flow", "assigned",
     "local", "supervisor", "manager", "editusers", "merchandise",
@@ -476,19 +485,14 @@ enum comms {
     PAYEXPENSES, FASTFOOD, SELFORDER, LASTENDDAY,
     CHECKBALANCED, HASPAYMENTS, TRAINING, SELECTORDER};
 
-static const genericChar* OperatorWords[] = {
+static const genericChar* const OperatorWords[] = {
     "=", ">", "<", "!=", ">=", nullptr};
 enum operators {
     EQUAL, GREATER, LESSER, NOTEQUAL, GREATEREQUAL
 };
 
 // Constructor
-ConditionalZone::ConditionalZone()
-{
-    keyword = -1;
-    op      = -1;
-    val     =  0;
-}
+ConditionalZone::ConditionalZone() = default;
 
 // Member Functions
 std::unique_ptr<Zone> ConditionalZone::Copy()
@@ -521,16 +525,6 @@ std::unique_ptr<Zone> ConditionalZone::Copy()
 int ConditionalZone::RenderInit(Terminal *term, int /*update_flag*/)
 {
     FnTrace("ConditionalZone::RenderInit()");
-    if (keyword < 0)
-    {
-        genericChar str1[256] = "", str2[256] = "";
-
-        // FIX - really lame expression parser
-        // Use safer scanf with field width limits to prevent buffer overflow
-        sscanf(expression.Value(), "%255s %255s %d", str1, str2, &val);
-        keyword = CompareList(str1, KeyWords);
-        op      = CompareList(str2, OperatorWords);
-    }
     active = static_cast<Uchar>(EvalExp(term));
     return 0;
 }
@@ -577,12 +571,15 @@ int ConditionalZone::Update(Terminal *term, int update_message, const genericCha
 int ConditionalZone::EvalExp(Terminal *term)
 {
     FnTrace("ConditionalZone::EvalExp()");
+    if (!condition.Compiled(expression.Value()))
+        condition.Compile(expression.Value(), KeyWords, OperatorWords);
+
     int n = 0;
     Check    *c = term->check;
     Employee *e = term->user;
     Settings *s = term->GetSettings();
 
-    switch (keyword)
+    switch (condition.keyword)
     {
     case CHECK: // Check
         if (c)
@@ -661,7 +658,7 @@ int ConditionalZone::EvalExp(Terminal *term)
         break;
     case FASTFOOD: // fastfood
     case SELFORDER: // selforder
-        n = (term->type == ((keyword == FASTFOOD) ? TERMINAL_FASTFOOD : TERMINAL_SELFORDER));
+        n = (term->type == ((condition.keyword == FASTFOOD) ? TERMINAL_FASTFOOD : TERMINAL_SELFORDER));
         break;
     case LASTENDDAY: // lastendday
         if (term && term->system_data && term->system_data->CheckEndDay(term) > 0)
@@ -690,22 +687,22 @@ int ConditionalZone::EvalExp(Terminal *term)
     }
 
     int retval = 0;
-    switch (op)
+    switch (condition.op)
     {
     case EQUAL:
-        retval = (n == val);
+        retval = (n == condition.value);
         break;
     case GREATER:
-        retval = (n > val);
+        retval = (n > condition.value);
         break;
     case LESSER:
-        retval = (n < val);
+        retval = (n < condition.value);
         break;
     case NOTEQUAL:
-        retval = (n != val);
+        retval = (n != condition.value);
         break;
     case GREATEREQUAL:
-        retval = (n >= val);
+        retval = (n >= condition.value);
         break;
     default:
         // null case; return 0
@@ -23,6 +23,7 @@
 
 #include "pos_zone.hh"
 #include "layout_zone.hh"
+#include "zone_script.hh"
 
 
 /**** Types ****/
@@ -41,6 +42,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          GainFocus(Terminal *term, Zone *oldfocus) override { return 0; }
+    const genericChar* PressText(Terminal *term) override;
 
     int *JumpType() override { return &jump_type; }
     int *JumpID() override   { return &jump_id;   }
@@ -73,7 +75,7 @@ public:
 class ConditionalZone : public MessageButtonZone
 {
     Str expression;
-    int keyword, op, val;
+    vt::Condition condition;  // expression, recompiled when it changes
 
 public:
     // Constructor
@@ -85,6 +87,7 @@ public:
     int          RenderInit(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_CHECKS; }
 
     Str *Expression() override { return &expression; }
     int  ZoneStates() override { return 3; }
@@ -133,6 +136,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_USERS; }
 };
 
 class ClearSystemZone : public PosZone
@@ -210,6 +214,7 @@ public:
     int          Type() override { return ZONE_LANGUAGE_BUTTON; }
     std::unique_ptr<Zone> Copy() override;
     RenderResult Render(Terminal *term, int update_flag) override;
+    const genericChar* PressText(Terminal *term) override { return nullptr; }
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int  GainFocus(Terminal *term, Zone *oldfocus) override { return 0; }
 };
@@ -53,6 +53,7 @@ public:
     SignalResult Signal(Terminal *term, const genericChar* message) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_CHECKS | UPDATE_ARCHIVE | UPDATE_SERVER; }
     Flt         *Spacing() override { return &spacing; }
 
     int  MakeList(Terminal *term);
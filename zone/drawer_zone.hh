@@ -53,6 +53,7 @@ public:
     RenderResult Render(Terminal *t, int update_flag) override;
     SignalResult Touch(Terminal *t, int tx, int ty) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_USERS | UPDATE_DRAWERS; }
     int          ZoneStates() override { return 1; }
 
     int MoveDrawers(Terminal *t, Employee *user);
@@ -92,6 +93,7 @@ public:
     SignalResult Touch(Terminal *t, int tx, int ty) override;
     SignalResult Keyboard(Terminal *t, int key, int state) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ARCHIVE | UPDATE_SETTINGS | UPDATE_DRAWER; }
     Flt         *Spacing() override { return &spacing; }
     int         *DrawerZoneType() override { return &drawer_zone_type; }
 
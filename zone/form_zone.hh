@@ -126,6 +126,7 @@ public:
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     SignalResult Mouse(Terminal *term, int action, int mx, int my) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ANY; }  // list_report.update_flag
 
     virtual int ListReport(Terminal *term, Report *report) = 0;
 };
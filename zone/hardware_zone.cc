@@ -132,6 +132,7 @@ HardwareZone::HardwareZone()
     AddListField("Kitchen Print Mode", PrintModeName, PrintModeValue);
     kitchen_mode_field = FieldListEnd();
     AddTextField("Requisition Ticket Header Margin", 4);
+    AddTextField("Combine Tickets Sent Within (milliseconds)", 5);
 }
 
 // Member Functions
@@ -454,7 +455,8 @@ int HardwareZone::LoadRecord(Terminal *term, int record)
             thisForm->active = 1;
         }
         thisForm = thisForm->next;
-	thisForm->Set(pi->order_margin); thisForm->active = 1;
+	thisForm->Set(pi->order_margin); thisForm->active = 1; thisForm = thisForm->next;
+        thisForm->Set(pi->coalesce_ms); thisForm->active = 1;
 
         #ifdef HW_ZONE_DEBUG_MAP
         printf("HWDBG: Loaded PrinterInfo %p name=%s host=%s\n", (void*)pi, pi->name.Value(), pi->host.Value());
@@ -628,7 +630,13 @@ int HardwareZone::SaveRecord(Terminal *term, int record, int write_file)
 	    pi->port = PORT_VT_DAEMON;
             field->Get(pi->model); field = field->next;
             field->Get(pi->kitchen_mode); field = field->next;
-	    field->Get(pi->order_margin);
+	    field->Get(pi->order_margin); field = field->next;
+            field->Get(pi->coalesce_ms);
+            if (pi->coalesce_ms < 0)
+                pi->coalesce_ms = 0;
+            Printer *running = term ? pi->FindPrinter(term->parent) : nullptr;
+            if (running)
+                running->SetCoalesce(pi->coalesce_ms);
             #ifdef HW_ZONE_DEBUG_MAP
             printf("HWDBG: Saved PrinterInfo %p name=%s host=%s\n", (void*)pi, pi->name.Value(), pi->host.Value());
             #endif
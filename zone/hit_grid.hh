@@ -0,0 +1,140 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * hit_grid.hh - Uniform grid for finding the rectangle under a touch
+ * No zone dependencies; Page::FindZone() supplies the rectangles
+ */
+
+#ifndef VT_HIT_GRID_HH
+#define VT_HIT_GRID_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief Rectangles bucketed into a grid over their bounding box, each cell
+ *  listing the rectangles that overlap it in the order they were given.
+ *
+ * Find() returns the first rectangle, in that order, that holds the point
+ * and that accept() agrees to, so it picks the same item a walk of the
+ * whole list would while only looking at one cell.  Rectangles with no
+ * area never hold a point and are left out.
+ */
+template <typename T>
+class HitGrid {
+public:
+    struct Entry {
+        T   item;
+        int x, y, w, h;
+    };
+
+    static constexpr int MaxCells = 64;  // per side
+
+    [[nodiscard]] bool Built() const noexcept { return built; }
+    [[nodiscard]] size_t Size() const noexcept { return entries.size(); }
+
+    void Clear() noexcept
+    {
+        built = false;
+        entries.clear();
+        cells.clear();
+        cols = rows = 0;
+    }
+
+    void Build(std::vector<Entry> list)
+    {
+        Clear();
+        entries = std::move(list);
+        built = true;
+
+        int left = 0, top = 0, right = 0, bottom = 0;
+        bool first = true;
+        for (const Entry &e : entries)
+        {
+            if (e.w <= 0 || e.h <= 0)
+                continue;
+            left   = first ? e.x : std::min(left, e.x);
+            top    = first ? e.y : std::min(top, e.y);
+            right  = first ? e.x + e.w : std::max(right, e.x + e.w);
+            bottom = first ? e.y + e.h : std::max(bottom, e.y + e.h);
+            first = false;
+        }
+        if (first)
+            return;  // nothing can be hit
+
+        // About one cell per rectangle, so a cell holds a handful
+        const int side = std::clamp(static_cast<int>(std::sqrt(static_cast<double>(entries.size()))) + 1,
+                                    1, MaxCells);
+        origin_x = left;
+        origin_y = top;
+        cell_w = std::max(1, (right - left + side - 1) / side);
+        cell_h = std::max(1, (bottom - top + side - 1) / side);
+        cols = std::max(1, (right - left + cell_w - 1) / cell_w);
+        rows = std::max(1, (bottom - top + cell_h - 1) / cell_h);
+        cells.assign(static_cast<size_t>(cols * rows), {});
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const Entry &e = entries[i];
+            if (e.w <= 0 || e.h <= 0)
+                continue;
+            const int c0 = (e.x - origin_x) / cell_w;
+            const int c1 = (e.x + e.w - 1 - origin_x) / cell_w;
+            const int r0 = (e.y - origin_y) / cell_h;
+            const int r1 = (e.y + e.h - 1 - origin_y) / cell_h;
+            for (int r = r0; r <= r1; ++r)
+                for (int c = c0; c <= c1; ++c)
+                    cells[static_cast<size_t>(r * cols + c)].push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // First item whose rectangle holds (px, py) and that accept() takes;
+    // T{} if there is none
+    template <typename Accept>
+    [[nodiscard]] T Find(int px, int py, Accept &&accept) const
+    {
+        if (cols == 0 || px < origin_x || py < origin_y)
+            return T{};
+        const int c = (px - origin_x) / cell_w;
+        const int r = (py - origin_y) / cell_h;
+        if (c >= cols || r >= rows)
+            return T{};
+
+        for (uint32_t i : cells[static_cast<size_t>(r * cols + c)])
+        {
+            const Entry &e = entries[i];
+            if (px >= e.x && py >= e.y && px < e.x + e.w && py < e.y + e.h && accept(e.item))
+                return e.item;
+        }
+        return T{};
+    }
+
+private:
+    bool built = false;
+    std::vector<Entry> entries;
+    std::vector<std::vector<uint32_t>> cells;
+    int origin_x = 0, origin_y = 0;
+    int cell_w = 1, cell_h = 1;
+    int cols = 0, rows = 0;
+};
+
+} // namespace vt
+
+#endif // VT_HIT_GRID_HH
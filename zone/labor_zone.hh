@@ -56,6 +56,7 @@ public:
     SignalResult Signal(Terminal *term, const genericChar* message) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ANY; }  // report->update_flag
     int          LoadRecord(Terminal *term, int record) override;
     int          SaveRecord(Terminal *term, int record, int write_file) override;
     int          UpdateForm(Terminal *term, int record) override;
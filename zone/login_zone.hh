@@ -43,6 +43,7 @@ public:
     SignalResult Signal(Terminal *term, const genericChar* message) override;
     SignalResult Keyboard(Terminal *term, int key, int state) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_TIMEOUT; }
 
     int ClockOn(Terminal *term, int job = -1);
     int ClockOff(Terminal *term);
@@ -2056,7 +2056,9 @@ SignalResult ItemZone::Touch(Terminal *t, int tx, int ty)
     }
 
     t->Update(my_update, nullptr);
-    t->RunScript(modifier_script.Value(), jump_type, jump_id);
+    if (!script.Compiled(modifier_script.Value()))
+        script.Compile(modifier_script.Value());
+    t->RunScript(script, jump_type, jump_id);
     if (t->cdu != nullptr)
     {
         genericChar buffer[STRLONG];
@@ -22,6 +22,7 @@
 #define _ORDER_ZONE_HH
 
 #include "layout_zone.hh"
+#include "zone_script.hh"
 
 
 /**** Types ****/
@@ -57,6 +58,7 @@ public:
     SignalResult Keyboard(Terminal *term, int key, int state) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ORDERS | UPDATE_QUALIFIER; }
     int          AddQualifier(Terminal *term, int qualifier_type);
     Flt         *Spacing() override { return &spacing; }
     Flt          SpacingValue(Terminal *term);  // returns spacing value
@@ -110,6 +112,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_MEAL_PERIOD | UPDATE_CHECKS | UPDATE_GUESTS; }
     int          ZoneStates() override { return 3; }
 };
 
@@ -129,6 +132,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ORDERS; }
     int          ZoneStates() override { return 3; }
 };
 
@@ -148,6 +152,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ORDERS; }
     int          ZoneStates() override { return 3; }
 };
 
@@ -165,6 +170,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_CHECKS | UPDATE_ORDERS; }
     int          ZoneStates() override { return 3; }
 };
 
@@ -190,6 +196,7 @@ class ItemZone : public PosZone
 {
     Str item_name;
     Str modifier_script;
+    vt::PageScript script;  // modifier_script, recompiled when it changes
     int jump_type, jump_id;
     SalesItem *item;
     int addanyway;
@@ -206,6 +213,7 @@ public:
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          AddPayment(Terminal *term, int ptype, int pid, int pflags, int pamount);
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_MENU | UPDATE_QUALIFIER; }
     SalesItem   *Item(ItemDB *db) override;
     const genericChar* TranslateString(Terminal *term) override { return nullptr; }
 
@@ -233,6 +241,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_QUALIFIER; }
     const genericChar* TranslateString(Terminal *term) override { return nullptr; }
 
     int *QualifierType() override { return &qualifier_type; }
@@ -0,0 +1,123 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * page_index.hh - Hash lookup of pages by id and by type/index
+ * Works on any list of nodes with id, type, index, size and next members
+ */
+
+#ifndef VT_PAGE_INDEX_HH
+#define VT_PAGE_INDEX_HH
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vt {
+
+/**
+ * @brief Buckets of a page list by id and by (type, index), each bucket in
+ *  list order, so a lookup returns the same page a walk of the list would.
+ *
+ * Sizes aren't part of the key: callers ask for the first page no larger
+ * than the terminal, and a bucket rarely holds more than one per size.
+ * The owner calls Clear() whenever a page is added, removed or has one of
+ * those members changed; the next lookup rebuilds.
+ */
+template <typename PageT>
+class PageIndex {
+public:
+    static constexpr int AnyIndex = -1;  // INDEX_ANY
+
+    [[nodiscard]] bool Built() const noexcept { return built; }
+
+    void Clear() noexcept
+    {
+        built = false;
+        by_id.clear();
+        by_type.clear();
+    }
+
+    void Build(PageT *head)
+    {
+        Clear();
+        for (PageT *p = head; p != nullptr; p = p->next)
+        {
+            if (p->id == 0)
+                continue;  // never found by id or type
+            by_id[p->id].push_back(p);
+            by_type[TypeKey(p->type, p->index)].push_back(p);
+            if (p->index != AnyIndex)
+                by_type[TypeKey(p->type, AnyIndex)].push_back(p);
+        }
+        built = true;
+    }
+
+    // First page with this id no larger than max_size
+    [[nodiscard]] PageT *FindByID(int id, int max_size) const
+    {
+        auto it = by_id.find(id);
+        if (it == by_id.end())
+            return nullptr;
+        for (PageT *p : it->second)
+        {
+            if (p->size <= max_size)
+                return p;
+        }
+        return nullptr;
+    }
+
+    // Page with exactly this id and size
+    [[nodiscard]] bool IsDefined(int id, int size) const
+    {
+        auto it = by_id.find(id);
+        if (it == by_id.end())
+            return false;
+        for (const PageT *p : it->second)
+        {
+            if (p->size == size)
+                return true;
+        }
+        return false;
+    }
+
+    // First page of this type for period (or any period) no larger than max_size
+    [[nodiscard]] PageT *FindByType(int type, int period, int max_size) const
+    {
+        auto it = by_type.find(TypeKey(type, period));
+        if (it == by_type.end())
+            return nullptr;
+        for (PageT *p : it->second)
+        {
+            if (p->size <= max_size)
+                return p;
+        }
+        return nullptr;
+    }
+
+private:
+    static int64_t TypeKey(int type, int index) noexcept
+    {
+        return (static_cast<int64_t>(type) << 32) | static_cast<uint32_t>(index);
+    }
+
+    bool built = false;
+    std::unordered_map<int, std::vector<PageT *>> by_id;
+    std::unordered_map<int64_t, std::vector<PageT *>> by_type;
+};
+
+} // namespace vt
+
+#endif // VT_PAGE_INDEX_HH
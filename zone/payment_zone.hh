@@ -50,6 +50,7 @@ public:
     SignalResult Keyboard(Terminal *term, int key, int state) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_AUTHORIZE | UPDATE_ORDERS; }
     int          AddPayment(Terminal *term, int type, int id,
                             int amount, int flags);
     int          AddPayment(Terminal *term, int type, const genericChar* swipe_value);
@@ -78,6 +78,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Signal(Terminal *term, const genericChar* message) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_MINUTE; }
     int          EndOfDay(Terminal *term, int force = 0);
 };
 
@@ -662,7 +662,8 @@ int PosZone::Write(OutputDataFile &df, int version)
 
 /**** PosPage Class ****/
 // Member Functions
-std::unique_ptr<Page> PosPage::Copy()
+// Page properties only, no zones
+std::unique_ptr<PosPage> PosPage::CopyProperties()
 {
     auto p = std::make_unique<PosPage>();
     if (!p)
@@ -688,6 +689,14 @@ std::unique_ptr<Page> PosPage::Copy()
         p->default_texture[i] = default_texture[i];
         p->default_color[i]   = default_color[i];
     }
+    return p;
+}
+
+std::unique_ptr<Page> PosPage::Copy()
+{
+    auto p = CopyProperties();
+    if (!p)
+        return nullptr;
 
     for (Zone *z = ZoneList(); z != nullptr; z = z->next)
     {
@@ -707,6 +716,16 @@ std::unique_ptr<Page> PosPage::Copy()
     return p;
 }
 
+std::unique_ptr<Page> PosPage::Share()
+{
+    auto p = CopyProperties();
+    if (!p)
+        return nullptr;
+
+    p->shared = shared ? shared : this;
+    return p;
+}
+
 int PosPage::Read(InputDataFile &infile, int version)
 {
     infile.Read(name);
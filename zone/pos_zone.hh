@@ -140,9 +140,12 @@ public:
 
 class PosPage : public Page
 {
+    std::unique_ptr<PosPage> CopyProperties();
+
 public:
     // Member Functions
     std::unique_ptr<Page> Copy() override;
+    std::unique_ptr<Page> Share() override;
     int   Read(InputDataFile &df, int version) override;
     int   Write(OutputDataFile &df, int version) override;
 };
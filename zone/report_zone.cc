@@ -35,6 +35,8 @@
 #include "manager.hh"
 #include "labels.hh"
 #include "safe_string_utils.hh"
+#include "src/core/content_hash.hh"
+#include "src/core/metrics.hh"
 
 #ifdef DMALLOC
 #include <dmalloc.h>
@@ -63,6 +65,8 @@ ReportZone::ReportZone()
     rzstate          = 0;
     printing_to_printer = 0;
     blink_state      = 0;
+    ticket_check     = nullptr;
+    ticket_stamp     = 0;
 }
 
 // Destructor
@@ -326,6 +330,7 @@ RenderResult ReportZone::DisplayCheckReport(Terminal *term, Report *disp_report)
     FnTrace("ReportZone::DisplayCheckReport()");
     Settings *settings = term->GetSettings();
     rzstate = 0;
+    ticket_check = nullptr;
     if (check_disp_num)
     {
         // This is only for the Kitchen Video reports.
@@ -372,6 +377,13 @@ RenderResult ReportZone::DisplayCheckReport(Terminal *term, Report *disp_report)
                 disp_check->PrintWorkOrder(term, disp_report, video_target, 0, this);
             term->curr_font_id = -1;
             term->curr_font_width = -1;
+
+            if (video_target != PRINTER_DEFAULT)
+            {
+                disp_report->SetLiveBlink(LIVE_FLASH, blink_state);
+                ticket_check = disp_check;
+                ticket_stamp = TicketStamp(term, disp_check);
+            }
         }
         else
         {
@@ -393,6 +405,26 @@ RenderResult ReportZone::DisplayCheckReport(Terminal *term, Report *disp_report)
     return RENDER_OKAY;
 }
 
+/****
+ * TicketStamp:  Names what a kitchen video ticket for check shows, short of
+ *   its timer and flashing: the check's contents, the minute of its age the
+ *   alert colors go by, and the zone and terminal state the report reads.
+ ****/
+uint64_t ReportZone::TicketStamp(Terminal *term, Check *check)
+{
+    FnTrace("ReportZone::TicketStamp()");
+    Settings *settings = term->GetSettings();
+    vt::ContentHash stamp;
+    stamp.AddValue(check->KitchenStamp());
+    if (check->chef_time.IsSet())
+        stamp.AddValue(static_cast<uint64_t>(SecondsElapsedToNow(check->chef_time) / 60));
+    stamp.AddValue(this == term->active_zone).AddValue(static_cast<uint64_t>(term->workorder_heading));
+    stamp.AddValue(static_cast<uint64_t>(term->sortorder)).AddValue(static_cast<uint64_t>(font));
+    stamp.AddValue(static_cast<uint64_t>(w)).AddValue(static_cast<uint64_t>(columns));
+    stamp.AddValue(static_cast<uint64_t>(settings->kv_print_method));
+    return stamp.Value();
+}
+
 /****
  * IsKitchenCheck:  For Kitchen Video, we only want to display checks that have
  *   been closed, but have not yet been served by the specific video target.
@@ -1353,10 +1385,39 @@ int ReportZone::Update(Terminal *t, int update_message, const genericChar* value
         if (check_disp_num && video_target != PRINTER_DEFAULT)
         {
             blink_state ^= 1;
+            // A kitchen ticket that hasn't changed only needs its timer
+            // and flashing orders redrawn, not the check report rebuilt
+            static vt::StatCounter &patched = vt::Metrics().Counter(
+                "vt_kitchen_ticket_patches_total",
+                "Kitchen video blinks drawn by patching the ticket in place");
+            static vt::StatCounter &rebuilt = vt::Metrics().Counter(
+                "vt_kitchen_ticket_rebuilds_total",
+                "Kitchen video blinks that rebuilt the ticket report");
+            if (report && report->is_complete && ticket_check != nullptr &&
+                (update_message & ~UPDATE_BLINK) == 0)
+            {
+                Check *check = GetDisplayCheck(t);
+                if (check == ticket_check && TicketStamp(t, check) == ticket_stamp)
+                {
+                    genericChar str[256];
+                    StringElapsedToNow(str, 256, check->chef_time);
+                    report->SetLiveText(LIVE_TIMER, str);
+                    report->SetLiveBlink(LIVE_FLASH, blink_state);
+                    patched.Add(1);
+                    Draw(t, 0);
+                    return 0;
+                }
+            }
+            rebuilt.Add(1);
         }
         Draw(t, 1);
         return 0;
     }
+    else if (update_message & ~UPDATE_BLINK)
+    {
+        // Anything else may have changed what the ticket shows
+        ticket_check = nullptr;
+    }
 
     Report *r = report.get();
     if (r == nullptr)
@@ -24,6 +24,7 @@
 #include "layout_zone.hh"
 #include "report.hh"
 
+#include <cstdint>
 #include <memory>
 
 /**** Types ****/
@@ -53,6 +54,8 @@ class ReportZone : public LayoutZone
     int       rzstate;
     int       printing_to_printer;
     int       blink_state;  // for flashing long-waiting orders
+    Check    *ticket_check; // kitchen video check the report was built from
+    uint64_t  ticket_stamp; // and TicketStamp() when it was
 
 public:
     // Constructor
@@ -77,6 +80,7 @@ public:
     SignalResult ToggleCheckReport(Terminal *term);
     SignalResult Keyboard(Terminal *t, int key, int state) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ANY; }  // report->update_flag
     int          State(Terminal *term) override;
     int         *ReportType()        override { return &report_type; }
     int         *CheckDisplayNum()   override { return &check_disp_num; }
@@ -91,6 +95,8 @@ public:
     SignalResult QuickBooksExport(Terminal *term);
 
 private:
+    uint64_t TicketStamp(Terminal *term, Check *check);
+
     int last_page_touch = -1;
     int last_selected_y_touch = -10000;
 };
@@ -43,6 +43,7 @@ public:
     RenderResult Render(Terminal *term, int update_flag) override;
     SignalResult Touch(Terminal *term, int tx, int ty) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_SETTINGS; }
     const genericChar* TranslateString(Terminal *term) override;
     int         *SwitchType() override { return &type; }
 };
@@ -288,6 +289,7 @@ public:
     int          Type() override { return ZONE_TIME_SETTINGS; }
     RenderResult Render(Terminal *term, int update_flag) override;
     int          Update(Terminal *term, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_MINUTE; }
 
     int LoadRecord(Terminal *term, int record) override;
     int SaveRecord(Terminal *term, int record, int write_file) override;
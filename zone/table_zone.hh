@@ -72,6 +72,7 @@ public:
     SignalResult Touch(Terminal *t, int tx, int ty) override;
     SignalResult Keyboard(Terminal *t, int key, int state) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_TIMEOUT | UPDATE_CHECKS; }
     const genericChar* TranslateString(Terminal *t) override;
     int          ZoneStates() override { return 1; }
 
@@ -99,6 +100,7 @@ public:
     SignalResult Signal(Terminal *t, const genericChar* message) override;
     SignalResult Touch(Terminal *t, int tx, int ty) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ANY; }  // redraws whenever the terminal's check changes
     int         *CustomerType() override { return &customer_type; }
     Check       *GetCheck() override { return check; }
 };
@@ -118,6 +120,7 @@ public:
     SignalResult Signal(Terminal *t, const genericChar* message) override;
     SignalResult Keyboard(Terminal *t, int key, int state) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_TIMEOUT; }
 };
 
 class TableAssignZone : public PosZone
@@ -131,6 +134,7 @@ public:
     SignalResult Signal(Terminal *t, const genericChar* message) override;
     SignalResult Touch(Terminal *t, int tx, int ty) override;
     int          Update(Terminal *t, int update_message, const genericChar* value) override;
+    int          UpdateMask() override { return UPDATE_ALL_TABLES | UPDATE_USERS; }
     int          ZoneStates() override { return 1; }
 
     int MoveTables(Terminal *t, ServerTableObj *sto);
@@ -18,11 +18,17 @@
 #include "logger.hh"     // logmsg()
 #include "safe_string_utils.hh"
 #include "src/utils/cpp23_utils.hh"
+#include "src/core/content_hash.hh"
+#include "src/core/data_tape.hh"
+#include "src/core/metrics.hh"
+#include "version/vt_version_info.hh"
 
 #include <cstring>
 #include <cerrno>
 #include <dirent.h>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -160,6 +166,7 @@ int Zone::State(Terminal *t)
 int Zone::Draw(Terminal *term, int update_flag)
 {
     FnTrace("Zone::Draw()");
+    vt::InputSpanScope trace_span(term->input_trace, vt::InputSpan::Render);
     if (update_flag)
     {
         RenderInit(term, update_flag);  // Method NOT implemented as of 9.14.01
@@ -386,6 +393,8 @@ int Zone::AlterSize(Terminal *t, int wchange, int hchange,
     int old_w = w;
     int old_h = h;
     SetSize(t, w + wchange, h + hchange);
+    if (page)
+        page->ZonesChanged();
 
     wchange = w - old_w;
     if (move_x == 0)
@@ -423,7 +432,10 @@ int Zone::AlterPosition(Terminal *t, int xchange, int ychange)
         new_y = page->height - grid_y;
 
     if (new_x != x || new_y != y)
+    {
         SetPosition(t, new_x, new_y);
+        page->ZonesChanged();
+    }
     return 0;
 }
 
@@ -505,6 +517,12 @@ Page::Page()
     next        = nullptr;
     fore        = nullptr;
     parent_page = nullptr;
+    shared      = nullptr;
+    zone_generation = 0;
+    ZonesChanged();
+    update_mask = 0;
+    video_report = false;
+    update_generation = 0;
     id          = 0;
     parent_id   = 0;
     image       = IMAGE_DEFAULT;
@@ -575,6 +593,10 @@ int Page::Init(ZoneDB *zone_db)
 	else
 		parent_page = nullptr;
 
+	// Subscriptions are collected on the first update, so a page still
+	// sharing its zones doesn't copy them here
+	update_generation = 0;
+
 	// Check for circular parent pointers
 	int count = 0;
 	Page *p = parent_page;
@@ -593,11 +615,38 @@ int Page::Init(ZoneDB *zone_db)
 	return 0;
 }
 
+/****
+ * Unshare:  A page made by Share() starts with no zones of its own and
+ *  reads them from the shared definition; the first use copies them, so a
+ *  terminal only pays for the pages it shows.  The copies hold this
+ *  terminal's state (active, selection, checks) like any other zone.
+ ****/
+int Page::Unshare()
+{
+    if (shared == nullptr)
+        return 0;
+
+    FnTrace("Page::Unshare()");
+    Page *definition = shared;
+    shared = nullptr;
+    for (Zone *z = definition->ZoneList(); z != nullptr; z = z->next)
+    {
+        auto zone_copy = std::unique_ptr<Zone>(z->Copy());
+        zone_copy->page = this;
+        zone_list.AddToTail(zone_copy.release());
+    }
+    static vt::StatCounter &copied = vt::Metrics().Counter(
+        "vt_zone_pages_copied_total", "Shared pages whose zones a terminal copied on first use");
+    copied.Add(1);
+    return 0;
+}
+
 int Page::Add(Zone *z)
 {
     FnTrace("Page::Add()");
     if (z == nullptr)
         return 1;
+    Unshare();
 
     // Index Tab buttons can only be added to Index pages
     if (z->Type() == ZONE_INDEX_TAB && type != PAGE_INDEX && type != PAGE_INDEX_WITH_TABS)
@@ -608,6 +657,7 @@ int Page::Add(Zone *z)
 
     z->page = this;
     zone_list.AddToTail(z);
+    ZonesChanged();
 
     // Bit of error checking
     if (z->JumpType() && z->JumpID())
@@ -627,9 +677,11 @@ int Page::AddFront(Zone *z)
     FnTrace("Page::AddFront()");
     if (z == nullptr)
         return 1;
+    Unshare();
 
     z->page = this;
     zone_list.AddToHead(z);
+    ZonesChanged();
 
     // Bit of error checking
     if (z->JumpType() && z->JumpID())
@@ -649,18 +701,32 @@ int Page::Remove(Zone *z)
     FnTrace("Page::Remove()");
     if (z == nullptr)
         return 1;
+    Unshare();
 
     zone_list.Remove(z);
     z->page = nullptr;
+    ZonesChanged();
     return 0;
 }
 
 int Page::Purge()
 {
+    shared = nullptr;
     zone_list.Purge();
+    ZonesChanged();
     return 0;
 }
 
+/****
+ * ZonesChanged:  Generations come from one counter so a page allocated
+ *  where a deleted one was can't pass for it in another page's hit_sources.
+ ****/
+void Page::ZonesChanged()
+{
+    static unsigned long last_generation = 0;
+    zone_generation = ++last_generation;
+}
+
 RenderResult Page::Render(Terminal *term, int update_flag, int no_parent)
 {
     FnTrace("Page::Render()");
@@ -1012,26 +1078,18 @@ SignalResult Page::Keyboard(Terminal *t, int key, int state)
     return sig;
 }
 
-Zone *Page::FindZone(Terminal *t, int x, int y)
+/****
+ * HitSources:  The pages FindZone() searches, in the order it searches
+ *  them: parents first, then this page, then the index tabs of an item page.
+ ****/
+void Page::HitSources(Terminal *t, std::vector<HitSource> &list, bool inherited)
 {
-    FnTrace("Page::FindZone()");
-    Zone *z;
     if (parent_page)
-    {
-        z = parent_page->FindZone(t, x, y);
-        if (z)
-            return z;
-    }
+        parent_page->HitSources(t, list, true);
 
-    z = zone_list.Head();
-    while (z)
-    {
-        if (z->behave != BEHAVE_MISS && z->active && z->IsPointIn(x, y))
-            return z;
-        z = z->next;
-    }
+    list.push_back({this, zone_generation, false, inherited});
 
-    // For Menu Item pages, also check Index Tab buttons from the corresponding Index page
+    // Menu Item pages also take touches on the Index Tab buttons of their Index page
     if ((type == PAGE_ITEM || type == PAGE_ITEM2) && t->zone_db)
     {
         Page *indexPage = t->zone_db->FindByType(PAGE_INDEX, index, t->size);
@@ -1039,107 +1097,67 @@ Zone *Page::FindZone(Terminal *t, int x, int y)
         {
             indexPage = t->zone_db->FindByType(PAGE_INDEX_WITH_TABS, index, t->size);
         }
-        
-        if (indexPage)
-        {
-            z = indexPage->ZoneList();
-            while (z)
-            {
-                if (z->Type() == ZONE_INDEX_TAB && z->behave != BEHAVE_MISS && z->active && z->IsPointIn(x, y))
-                    return z;
-                z = z->next;
-            }
-        }
+        list.push_back({indexPage, indexPage ? indexPage->zone_generation : 0, true, inherited});
     }
-
-    return nullptr;
 }
 
-Zone *Page::FindEditZone(Terminal *t, int x, int y)
+/****
+ * HitZones:  The grid of every zone FindZone() could return, rebuilt when
+ *  any of the pages it came from has changed or is no longer a source.
+ ****/
+vt::HitGrid<Page::HitZone> &Page::HitZones(Terminal *t)
 {
-    FnTrace("Page::FindEditZone()");
-    Zone *z;
-    if (parent_page)
-    {
-        z = parent_page->FindEditZone(t, x, y);
-        if (z)
-            return z;
-    }
-
-    z = zone_list.Head();
-    while (z)
-    {
-        if (z->IsPointIn(x, y) && z->CanSelect(t))
-            return z;
-        z = z->next;
-    }
+    hit_check.clear();
+    HitSources(t, hit_check, false);
+    if (hit_grid.Built() && hit_check == hit_sources)
+        return hit_grid;
 
-    // For Menu Item pages, also check Index Tab buttons from the corresponding Index page
-    // (but only allow selection, not editing, since they're inherited)
-    if ((type == PAGE_ITEM || type == PAGE_ITEM2) && t->zone_db)
+    std::vector<vt::HitGrid<HitZone>::Entry> entries;
+    for (HitSource &source : hit_check)
     {
-        Page *indexPage = t->zone_db->FindByType(PAGE_INDEX, index, t->size);
-        if (indexPage == nullptr)
-        {
-            indexPage = t->zone_db->FindByType(PAGE_INDEX_WITH_TABS, index, t->size);
-        }
-        
-        if (indexPage)
+        if (source.page == nullptr)
+            continue;
+        for (Zone *z = source.page->ZoneList(); z != nullptr; z = z->next)
         {
-            z = indexPage->ZoneList();
-            while (z)
-            {
-                if (z->Type() == ZONE_INDEX_TAB && z->IsPointIn(x, y) && z->CanSelect(t))
-                    return z;
-                z = z->next;
-            }
+            if (source.tabs && z->Type() != ZONE_INDEX_TAB)
+                continue;
+            entries.push_back({{z, source.inherited}, z->x, z->y, z->w, z->h});
         }
+        source.generation = source.page->zone_generation;  // ZoneList() may have copied shared zones
     }
+    hit_sources.swap(hit_check);
+    hit_grid.Build(std::move(entries));
 
-    return nullptr;
+    static vt::StatCounter &builds = vt::Metrics().Counter(
+        "vt_zone_hit_grid_builds_total", "Touch lookup grids built for a page and its parents");
+    builds.Add(1);
+    return hit_grid;
 }
 
-Zone *Page::FindTranslateZone(Terminal *t, int x, int y)
+Zone *Page::FindZone(Terminal *t, int x, int y)
 {
-    FnTrace("Page::FindTranslateZone()");
-    Zone *z;
-    if (parent_page)
-    {
-        z = parent_page->FindEditZone(t, x, y);
-        if (z)
-            return z;
-    }
-
-    z = zone_list.Head();
-    while (z)
-    {
-        if (z->IsPointIn(x, y))
-            return z;
-        z = z->next;
-    }
+    FnTrace("Page::FindZone()");
+    return HitZones(t).Find(x, y, [](const HitZone &hz) {
+        return hz.zone->behave != BEHAVE_MISS && hz.zone->active;
+    }).zone;
+}
 
-    // For Menu Item pages, also check Index Tab buttons from the corresponding Index page
-    if ((type == PAGE_ITEM || type == PAGE_ITEM2) && t->zone_db)
-    {
-        Page *indexPage = t->zone_db->FindByType(PAGE_INDEX, index, t->size);
-        if (indexPage == nullptr)
-        {
-            indexPage = t->zone_db->FindByType(PAGE_INDEX_WITH_TABS, index, t->size);
-        }
-        
-        if (indexPage)
-        {
-            z = indexPage->ZoneList();
-            while (z)
-            {
-                if (z->Type() == ZONE_INDEX_TAB && z->IsPointIn(x, y))
-                    return z;
-                z = z->next;
-            }
-        }
-    }
+Zone *Page::FindEditZone(Terminal *t, int x, int y)
+{
+    FnTrace("Page::FindEditZone()");
+    // Index Tab buttons are inherited too: selectable, not editable
+    return HitZones(t).Find(x, y, [t](const HitZone &hz) {
+        return hz.zone->CanSelect(t) != 0;
+    }).zone;
+}
 
-    return nullptr;
+Zone *Page::FindTranslateZone(Terminal *t, int x, int y)
+{
+    FnTrace("Page::FindTranslateZone()");
+    // parent zones are looked up as for editing
+    return HitZones(t).Find(x, y, [t](const HitZone &hz) {
+        return !hz.inherited || hz.zone->CanSelect(t) != 0;
+    }).zone;
 }
 
 int Page::IsZoneOnPage(Zone *z)
@@ -1160,23 +1178,75 @@ int Page::IsZoneOnPage(Zone *z)
     return 0;  // False
 }
 
+/****
+ * Subscribe:  Collects the zones that take update messages and the
+ *  per-page flags UpdateSystemCB() asks for.  Rebuilt whenever a zone is
+ *  added, removed or moved, or the page is initialized again.
+ ****/
+void Page::Subscribe()
+{
+    FnTrace("Page::Subscribe()");
+    update_zones.clear();
+    update_mask = 0;
+    video_report = false;
+    for (Zone *z = ZoneList(); z != nullptr; z = z->next)
+    {
+        int mask = z->UpdateMask();
+        if (mask)
+        {
+            update_zones.push_back({z, mask});
+            update_mask |= mask;
+        }
+
+        // A check report on a video target blinks its late orders
+        int *rt = z->ReportType();
+        if (z->Type() == ZONE_REPORT && rt && *rt == REPORT_CHECK)
+        {
+            int *vt = z->VideoTarget();
+            int *cdn = z->CheckDisplayNum();
+            if ((vt && *vt != PRINTER_DEFAULT) || (cdn && *cdn != 0))
+                video_report = true;
+        }
+    }
+    update_generation = zone_generation;
+}
+
 int Page::Update(Terminal *t, int update_message, const genericChar* value)
 {
     FnTrace("Page::Update()");
+    static vt::StatCounter &dispatched = vt::Metrics().Counter(
+        "vt_zone_updates_total", "Update messages passed to zones by Page::Update()");
     Page *p = this;
     while (p)
     {
-        Zone *z = p->ZoneList();
-        while (z)
+        if (p->update_generation != p->zone_generation)
+            p->Subscribe();
+        if (p->update_mask & update_message)
         {
-            z->Update(t, update_message, value);
-            z = z->next;
+            const unsigned long generation = p->zone_generation;
+            for (size_t i = 0; i < p->update_zones.size(); ++i)
+            {
+                if ((p->update_zones[i].mask & update_message) == 0)
+                    continue;
+                dispatched.Add(1);
+                p->update_zones[i].zone->Update(t, update_message, value);
+                if (p->zone_generation != generation)
+                    break;  // the zone changed the page; the rest may be gone
+            }
         }
         p = p->parent_page;
     }
     return 0;
 }
 
+int Page::HasVideoReport()
+{
+    FnTrace("Page::HasVideoReport()");
+    if (update_generation != zone_generation)
+        Subscribe();
+    return video_report;
+}
+
 int Page::Class()
 {
     FnTrace("Page::Class()");
@@ -1292,18 +1362,37 @@ int ZoneDB::Init()
     return 0;
 }
 
-int ZoneDB::Load(const char* filename)
+/****
+ * ZoneFileKey:  Names a zone file's contents and the build reading it, so
+ *  a cached tape is only used for the exact file and code it came from.
+ *  Returns 0 if the file can't be read.
+ ****/
+static uint64_t ZoneFileKey(const char* filename)
 {
-    FnTrace("ZoneDB::Load()");
+    FnTrace("ZoneFileKey()");
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return 0;
+    const std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
 
-    // Load Pages
-    int version = 0;
-    InputDataFile infile;
-    if (infile.Open(filename, version))
-        return 1;
+    vt::ContentHash hash;
+    hash.Add("zone tape").AddValue(ZONE_VERSION);
+    hash.Add(viewtouch::get_version_long()).Add(viewtouch::get_version_timestamp());
+    hash.Add(contents);
+    return hash.Value() == 0 ? 1 : hash.Value();
+}
 
+/****
+ * ReadPages:  Reads a zone file's pages into pages, then the global
+ *  defaults.  Pages read before an error are left in pages.  Marks each
+ *  page's values on record, or checks them against replay's marks.
+ ****/
+int ZoneDB::ReadPages(InputDataFile &infile, int version, const char* filename,
+                      std::vector<Page *> &pages, vt::DataTape *record,
+                      const vt::DataTape *replay)
+{
+    FnTrace("ZoneDB::ReadPages()");
     genericChar str[STRLENGTH];
-    fprintf(stderr, "ZoneDB::Load: File version=%d, ZONE_VERSION=%d\n", version, ZONE_VERSION);
     if (version < 17 || version > ZONE_VERSION)
     {
         vt_safe_string::safe_format(str, STRLENGTH, "Unknown ZoneDB file version %d", version);
@@ -1315,6 +1404,7 @@ int ZoneDB::Load(const char* filename)
     int p_count = -1;
     infile.Read(p_count);
 
+    size_t span = 0;
     for (int i = 0; i < p_count; ++i)
     {
         if (infile.end_of_file)
@@ -1327,6 +1417,7 @@ int ZoneDB::Load(const char* filename)
         Page *currPage = NewPosPage();
         if (currPage)
 		{
+            const uint32_t first = infile.TapePosition();
 			if (currPage->Read(infile, version))
 			{
 				vt_safe_string::safe_format(str, STRLENGTH, "Error in page %d '%s' of file '%s'",
@@ -1336,18 +1427,28 @@ int ZoneDB::Load(const char* filename)
 				delete currPage;
 				return 1;  // Error;
 			}
+            if (record)
+                record->AddPage(currPage->id, currPage->size, first, infile.TapePosition());
+            if (replay)
+            {
+                const auto &marks = replay->Pages();
+                if (span >= marks.size() || marks[span].id != currPage->id ||
+                    marks[span].size != currPage->size || marks[span].first != first ||
+                    marks[span].end != infile.TapePosition() || infile.ReplayFailed())
+                {
+                    delete currPage;
+                    return 1;
+                }
+                ++span;
+            }
             if (currPage->id > 100000)
             {
                 vt::cpp23::format_to_buffer(str, STRLENGTH, "Bad Page ID:  {}", currPage->id);
                 ReportError(str);
                 delete currPage;
             }
-			else if (Add(currPage))
-			{
-				ReportError("Error adding page to ZoneDB");
-				delete currPage;
-				return 1;  // Error;
-			}
+            else
+                pages.push_back(currPage);
 		}
     }
 
@@ -1366,10 +1467,90 @@ int ZoneDB::Load(const char* filename)
     	infile.Read(default_title_color);
     	infile.Read(default_size);
 	}
-	
+
+    if (replay && (infile.ReplayFailed() || span != replay->Pages().size() ||
+                   infile.TapePosition() != replay->Count()))
+        return 1;
+    return 0;
+}
+
+// Adds pages in order, stopping (and deleting the rest) at one Add() refuses
+int ZoneDB::AddPages(std::vector<Page *> &pages)
+{
+    FnTrace("ZoneDB::AddPages()");
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        if (Add(pages[i]))
+        {
+            ReportError("Error adding page to ZoneDB");
+            for (size_t j = i; j < pages.size(); ++j)
+                delete pages[j];
+            pages.clear();
+            return 1;  // Error
+        }
+    }
+    pages.clear();
     return 0;
 }
 
+/****
+ * Load:  Reads a zone file.  A tape of the values read from it is cached
+ *  beside it as <filename>.vtz; when the tape's key still matches the
+ *  file, the pages are read back from the tape instead of parsed.  A tape
+ *  that doesn't read back cleanly is ignored and the file is parsed.
+ ****/
+int ZoneDB::Load(const char* filename)
+{
+    FnTrace("ZoneDB::Load()");
+    const int64_t start_ns = vt::MetricsNowNs();
+    static vt::LatencyHistogram &binary_load = vt::Metrics().Histogram(
+        "vt_zone_db_load_seconds", "Time to load a zone database file",
+        vt::MetricLabel("source", "binary"));
+    static vt::LatencyHistogram &text_load = vt::Metrics().Histogram(
+        "vt_zone_db_load_seconds", "Time to load a zone database file",
+        vt::MetricLabel("source", "text"));
+
+    int version = 0;
+    InputDataFile infile;
+    const std::string cache_path = std::string(filename) + ".vtz";
+    const uint64_t key = ZoneFileKey(filename);
+    vt::DataTape tape;
+    std::vector<Page *> pages;
+    if (key != 0 && tape.Load(cache_path, key) == 0)
+    {
+        infile.Open(tape, version);
+        if (ReadPages(infile, version, filename, pages, nullptr, &tape) == 0)
+        {
+            const int error = AddPages(pages);
+            binary_load.Record(vt::MetricsNowNs() - start_ns);
+            return error;
+        }
+        for (Page *page : pages)
+            delete page;
+        pages.clear();
+        infile.Close();
+        ReportError("Ignoring stale zone cache '" + cache_path + "'");
+    }
+
+    // Load Pages
+    if (infile.Open(filename, version))
+        return 1;
+    fprintf(stderr, "ZoneDB::Load: File version=%d, ZONE_VERSION=%d\n", version, ZONE_VERSION);
+
+    tape.Clear();
+    tape.key = key;
+    tape.version = version;
+    if (key != 0)
+        infile.Record(&tape);
+    int error = ReadPages(infile, version, filename, pages, (key != 0) ? &tape : nullptr, nullptr);
+    if (AddPages(pages))
+        error = 1;
+    if (error == 0 && key != 0 && !tape.Spoiled() && tape.Save(cache_path))
+        ReportError("Unable to write zone cache '" + cache_path + "'");
+    text_load.Record(vt::MetricsNowNs() - start_ns);
+    return error;
+}
+
 int ZoneDB::Save(const char* filename, int page_class)
 {
     FnTrace("ZoneDB::Save()");
@@ -1586,6 +1767,7 @@ int ZoneDB::Add(Page *p)
         ptr = ptr->fore;
 
     // Insert p after ptr
+    page_index.Clear();
     return page_list.AddAfterNode(ptr, p);
 }
 
@@ -1623,54 +1805,43 @@ int ZoneDB::AddUnique(Page *page)
 int ZoneDB::Remove(Page *p)
 {
     FnTrace("ZoneDB::Remove()");
+    page_index.Clear();
     return page_list.Remove(p);
 }
 
 int ZoneDB::Purge()
 {
     FnTrace("ZoneDB::Purge()");
+    page_index.Clear();
     page_list.Purge();
     return 0;
 }
 
+/****
+ * Index:  Lookup tables for FindByID() and FindByType(), built on the
+ *  first call after Add(), Remove(), Purge() or PagesChanged().
+ ****/
+vt::PageIndex<Page> &ZoneDB::Index()
+{
+    if (!page_index.Built())
+        page_index.Build(page_list.Head());
+    return page_index;
+}
+
 Page *ZoneDB::FindByID(int id, int max_size)
 {
     FnTrace("ZoneDB::FindByID()");
 	if (id == 0)
 		return nullptr;
 
-    Page *retPage = nullptr;
-	Page *currPage = page_list.Head();
-	while ((retPage == nullptr) && (currPage != nullptr))
-	{
-		if (currPage->id == id && currPage->size <= max_size)
-			retPage = currPage;
-        else
-            currPage = currPage->next;
-	}
-	return retPage;
+    return Index().FindByID(id, max_size);
 }
 
 Page *ZoneDB::FindByType(int type, int period, int max_size)
 {
     FnTrace("ZoneDB::FindByType()");
-    Page *thisPage = page_list.Head();
-    while (thisPage)
-    {
-        if ((thisPage->type == type) && 
-            (thisPage->index == period || period == INDEX_ANY) &&
-            (thisPage->size <= max_size) && 
-            (thisPage->id != 0))
-        {
-            return thisPage;
-        }
-        if (thisPage == page_list.Tail()) {
-        	return nullptr;
-        } else {
-            thisPage = thisPage->next;
-        }
-    }
-    return nullptr;
+    static_assert(INDEX_ANY == vt::PageIndex<Page>::AnyIndex);
+    return Index().FindByType(type, period, max_size);
 }
 
 Page *ZoneDB::FindByTerminal(int term_type, int period, int max_size)
@@ -1750,14 +1921,7 @@ int ZoneDB::IsPageDefined(int my_page_id, int size)
     if (my_page_id == 0)
         return 0;   // FALSE
 
-    Page *p = page_list.Head();
-    while (p)
-    {
-        if (p->id == my_page_id && p->size == size)
-            return 1; // TRUE
-        p = p->next;
-    }
-    return 0;     // FALSE
+    return Index().IsDefined(my_page_id, size) ? 1 : 0;
 }
 
 int ZoneDB::ClearEdit(Terminal *t)
@@ -2091,22 +2255,65 @@ std::unique_ptr<ZoneDB> ZoneDB::Copy()
         p = p->next;
     }
 
-    new_db->table_pages = table_pages;
-    new_db->default_font = default_font;
-    new_db->default_shadow = default_shadow;
-    new_db->default_spacing = default_spacing;
-    new_db->default_image = default_image;
-    new_db->default_title_color = default_title_color;
-    new_db->default_size = default_size;
-    for (int i=0; i<3; i++) {
-    	new_db->default_frame[i] = default_frame[i];
-    	new_db->default_texture[i] = default_texture[i];
-    	new_db->default_color[i] = default_color[i];
+    CopyDefaults(*new_db);
+    return new_db;
+}
+
+/****
+ * Share:  Terminals used to get a full Copy() of the master ZoneDB each,
+ *  every Page and Zone duplicated, and again after every edit.  A shared
+ *  ZoneDB has its own Page objects (so page lists, parent pages and page
+ *  state stay per terminal) but each one copies its zones from base only
+ *  when first used; see Page::Unshare().  Saving an edit replaces
+ *  Control::zone_db rather than changing it, so base stays as it was for
+ *  terminals that haven't reloaded; ChangeItemName() is the exception
+ *  and is meant to reach them.
+ ****/
+std::unique_ptr<ZoneDB> ZoneDB::Share(const std::shared_ptr<ZoneDB> &base)
+{
+    FnTrace("ZoneDB::Share()");
+    if (base == nullptr)
+        return nullptr;
+
+    auto new_db = std::make_unique<ZoneDB>();
+    new_db->shared_base = base;
+    for (Page *p = base->PageList(); p != nullptr; p = p->next)
+    {
+        auto page_copy = std::unique_ptr<Page>(p->Share());
+        new_db->Add(page_copy.release());
     }
 
+    base->CopyDefaults(*new_db);
     return new_db;
 }
 
+int ZoneDB::SharedPages()
+{
+    int count = 0;
+    for (Page *p = page_list.Head(); p != nullptr; p = p->next)
+    {
+        if (p->IsShared())
+            ++count;
+    }
+    return count;
+}
+
+void ZoneDB::CopyDefaults(ZoneDB &target) const
+{
+    target.table_pages = table_pages;
+    target.default_font = default_font;
+    target.default_shadow = default_shadow;
+    target.default_spacing = default_spacing;
+    target.default_image = default_image;
+    target.default_title_color = default_title_color;
+    target.default_size = default_size;
+    for (int i=0; i<3; i++) {
+    	target.default_frame[i] = default_frame[i];
+    	target.default_texture[i] = default_texture[i];
+    	target.default_color[i] = default_color[i];
+    }
+}
+
 int ZoneDB::References(Page *page, int *list, int my_max, int &count)
 {
     FnTrace("ZoneDB::References()");
@@ -2215,6 +2422,12 @@ int ZoneDB::ChangeItemName(const char* old_name, const genericChar* new_name)
 	Page *thisPage = page_list.Head();
 	while (thisPage)
 	{
+		// Shared zones are renamed with Control::zone_db
+		if (thisPage->IsShared())
+		{
+			thisPage = thisPage->next;
+			continue;
+		}
 		for (Zone *z = thisPage->ZoneList(); z != nullptr; z = z->next)
 		{
 			if (z->ItemName() &&
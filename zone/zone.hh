@@ -11,7 +11,10 @@
 
 #include "utility.hh"
 #include "list_utility.hh"
+#include "page_index.hh"
+#include "hit_grid.hh"
 #include <memory>
+#include <vector>
 
 
 /**** Definitions ****/
@@ -116,6 +119,7 @@ class ItemDB;
 class Report;
 class InputDataFile;
 class OutputDataFile;
+namespace vt { class DataTape; }
 class Check;
 
 class Zone : public RegionInfo
@@ -175,6 +179,7 @@ public:
     virtual SignalResult Touch(Terminal *t, int tx, int ty);
     virtual SignalResult Mouse(Terminal *t, int action, int mx, int my);
     virtual int          Update(Terminal *t, int update_message, const genericChar* value);
+    virtual int          UpdateMask() { return 0; }  // UPDATE_* messages Update() acts on
     virtual int          ShadowVal(Terminal *t);
     virtual const genericChar* TranslateString(Terminal *t);
     virtual int          SetSize(Terminal *t, int width, int height);
@@ -203,6 +208,9 @@ public:
     // boolean - can zone be copied/moved/deleted?
 
     virtual int ZoneStates() { return 2; }
+    virtual const genericChar* PressText(Terminal *t) { return nullptr; }
+    // label vt_term may draw with the selected look on a touch (nullptr if
+    // the zone draws more than its frame and label, see SendPressLooks())
     virtual SalesItem *Item(ItemDB *db) { return nullptr; }
 
     // Interface for zone settings (FIX - should be moved to pos_zone module)
@@ -235,10 +243,43 @@ class Page
 {
 	DList<Zone> zone_list;
 
+	// Touch lookup over this page's zones plus its parents' and index tabs'
+	struct HitZone {
+		Zone *zone = nullptr;
+		bool  inherited = false;  // from a parent page
+	};
+	struct HitSource {
+		Page *page;
+		unsigned long generation;
+		bool  tabs;               // only the page's index tab buttons
+		bool  inherited;
+		bool operator==(const HitSource &) const = default;
+	};
+	unsigned long zone_generation;  // changes whenever a zone is added, removed or moved
+	vt::HitGrid<HitZone> hit_grid;
+	std::vector<HitSource> hit_sources;  // what hit_grid was built from
+	std::vector<HitSource> hit_check;
+
+	void HitSources(Terminal *t, std::vector<HitSource> &list, bool inherited);
+	vt::HitGrid<HitZone> &HitZones(Terminal *t);
+
+	// Zones Update() passes messages to, see Zone::UpdateMask()
+	struct UpdateSubscriber {
+		Zone *zone;
+		int   mask;
+	};
+	std::vector<UpdateSubscriber> update_zones;
+	int   update_mask;                  // every mask in update_zones
+	bool  video_report;                 // has a check report on a kitchen video target
+	unsigned long update_generation;    // zone_generation update_zones was built for
+
+	void Subscribe();
+
 public:
 	// Calculated/State Variables
 	Page *next, *fore;    // Linked list pointers
 	Page *parent_page;    // All parent zones become part of this page
+	Page *shared;         // definition to copy zones from on first use, see Unshare()
 	short width, height;
 	int   changed;
 	TimeInfo last_update; // time page was last updated
@@ -266,9 +307,15 @@ public:
 	virtual ~Page() = default;
 
 	// Member Functions
-	Zone *ZoneList()    { return zone_list.Head(); }
-	Zone *ZoneListEnd() { return zone_list.Tail(); }
-	int   ZoneCount()   { return zone_list.Count(); }
+	Zone *ZoneList()    { Unshare(); return zone_list.Head(); }
+	Zone *ZoneListEnd() { Unshare(); return zone_list.Tail(); }
+	int   ZoneCount()   { return shared ? shared->ZoneCount() : zone_list.Count(); }
+	int   IsShared()    { return shared != nullptr; }
+
+	int Unshare();
+	// Gives the page its own copies of the shared definition's zones
+	void ZonesChanged();
+	// Drops the touch lookup of this page and every page inheriting from it
 
 	int Init(ZoneDB *zone_db);
 	// Initializes page data
@@ -298,7 +345,9 @@ public:
 	SignalResult Keyboard(Terminal *t, int key, int state);
 	// Passes keypress to all zones on page
 	int Update(Terminal *t, int update_message, const genericChar* value);
-	// Passes update message to all zones on page
+	// Passes update message to the zones on page that take it
+	int HasVideoReport();
+	// Boolean - does page show a check on a kitchen video target?
 	int Class();
 	// returns page class (see definitions above)
     int IsStartPage();
@@ -310,6 +359,8 @@ public:
 	// Virtual Functions
 	virtual std::unique_ptr<Page> Copy() = 0;
 	// Returns copy of page and all its zones
+	virtual std::unique_ptr<Page> Share() = 0;
+	// Returns copy of page that copies the zones when first used
 	virtual int Read(InputDataFile &df, int version) { return 1; }
 	// Reads page data from file
 	virtual int Write(OutputDataFile &df, int version) { return 1; }
@@ -319,6 +370,16 @@ public:
 class ZoneDB
 {
     DList<Page> page_list;
+    std::shared_ptr<ZoneDB> shared_base;  // keeps shared pages' definitions alive
+    vt::PageIndex<Page> page_index;       // rebuilt on first lookup after a change
+
+    vt::PageIndex<Page> &Index();
+
+    void CopyDefaults(ZoneDB &target) const;
+    int  ReadPages(InputDataFile &infile, int version, const char* filename,
+                   std::vector<Page *> &pages, vt::DataTape *record,
+                   const vt::DataTape *replay);
+    int  AddPages(std::vector<Page *> &pages);
 
 public:
     int   table_pages;
@@ -344,6 +405,10 @@ public:
 
     std::unique_ptr<ZoneDB> Copy();
     // Returns copy of ZoneDB with all pages
+    static std::unique_ptr<ZoneDB> Share(const std::shared_ptr<ZoneDB> &base);
+    // Returns ZoneDB whose pages copy their zones from base when first used
+    int SharedPages();
+    // Number of pages still using base's zones
     int Init();
     int Load(const char* filename);
     int Save(const char* filename, int section);
@@ -357,6 +422,8 @@ public:
     int Remove(Page *p);
     int Purge();
     int ChangePageID(Page *p, int new_id);
+    void PagesChanged() { page_index.Clear(); }
+    // Call after changing a listed page's id, type, index or size directly
     int IsPageDefined(int page_id, int size);
     int ClearEdit(Terminal *t);
     // Unmarks all zones
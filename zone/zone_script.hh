@@ -0,0 +1,178 @@
+/*
+ * Copyright ViewTouch, Inc., 1995, 1996, 1997, 1998, 2025, 2026
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * zone_script.hh - Compiled button expressions and modifier scripts
+ * No zone dependencies; ConditionalZone and Terminal::RunScript() use them
+ */
+
+#ifndef VT_ZONE_SCRIPT_HH
+#define VT_ZONE_SCRIPT_HH
+
+#include <array>
+#include <cctype>
+#include <climits>
+#include <string>
+#include <string_view>
+
+namespace vt {
+
+namespace script_detail {
+
+inline bool IsSpace(char c) noexcept
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// sscanf("%255s"): the next word, at most max_len characters of it
+inline std::string_view Word(std::string_view &text, size_t max_len = 255) noexcept
+{
+    size_t start = 0;
+    while (start < text.size() && IsSpace(text[start]))
+        ++start;
+    size_t end = start;
+    while (end < text.size() && end - start < max_len && !IsSpace(text[end]))
+        ++end;
+    std::string_view word = text.substr(start, end - start);
+    text.remove_prefix(end);
+    return word;
+}
+
+// sscanf("%d"): an optionally signed decimal after any white space, read
+// as a long that sticks at LONG_MIN/LONG_MAX and then narrowed like glibc
+inline bool Int(std::string_view &text, int &value) noexcept
+{
+    size_t pos = 0;
+    while (pos < text.size() && IsSpace(text[pos]))
+        ++pos;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+        negative = (text[pos++] == '-');
+    if (pos >= text.size() || !std::isdigit(static_cast<unsigned char>(text[pos])))
+        return false;
+
+    unsigned long magnitude = 0;
+    bool overflow = false;
+    for (; pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])); ++pos)
+    {
+        const unsigned long digit = static_cast<unsigned long>(text[pos] - '0');
+        if (magnitude > (ULONG_MAX - digit) / 10)
+            overflow = true;
+        else
+            magnitude = magnitude * 10 + digit;
+    }
+    long result = 0;
+    if (negative)
+        result = (overflow || magnitude > static_cast<unsigned long>(LONG_MAX) + 1) ? LONG_MIN
+                 : static_cast<long>(0UL - magnitude);
+    else
+        result = (overflow || magnitude > static_cast<unsigned long>(LONG_MAX)) ? LONG_MAX
+                 : static_cast<long>(magnitude);
+    value = static_cast<int>(result);
+    text.remove_prefix(pos);
+    return true;
+}
+
+// CompareList(): case-insensitive index in a nullptr-ended list, or -1
+inline int Lookup(std::string_view word, const char* const list[]) noexcept
+{
+    for (int i = 0; list[i] != nullptr; ++i)
+    {
+        const std::string_view entry = list[i];
+        if (entry.size() != word.size())
+            continue;
+        bool same = true;
+        for (size_t c = 0; same && c < word.size(); ++c)
+            same = std::tolower(static_cast<unsigned char>(word[c])) ==
+                   std::tolower(static_cast<unsigned char>(entry[c]));
+        if (same)
+            return i;
+    }
+    return -1;
+}
+
+} // namespace script_detail
+
+/**
+ * @brief A ConditionalZone expression, "<keyword> <operator> <value>",
+ *  resolved to indexes in the zone's keyword and operator lists.
+ *
+ * Compile() reads an expression the way the zone's sscanf() parse did,
+ * so a bad one resolves to -1 the same way; it just only does it when
+ * the text changes rather than on every render of a zone it can't parse.
+ */
+class Condition {
+public:
+    int keyword = -1;
+    int op      = -1;
+    int value   = 0;
+
+    [[nodiscard]] bool Compiled(std::string_view expression) const noexcept
+    {
+        return compiled && expression == source;
+    }
+
+    void Compile(std::string_view expression, const char* const keywords[],
+                 const char* const operators[])
+    {
+        source.assign(expression);
+        compiled = true;
+        std::string_view text = expression;
+        const std::string_view word1 = script_detail::Word(text);
+        const std::string_view word2 = script_detail::Word(text);
+        keyword = script_detail::Lookup(word1, keywords);
+        op      = script_detail::Lookup(word2, operators);
+        value   = 0;
+        script_detail::Int(text, value);
+    }
+
+private:
+    std::string source;
+    bool compiled = false;
+};
+
+/**
+ * @brief A modifier script: the page ids Terminal::RunScript() pushes, in
+ *  order, read like its sscanf() of up to MaxPages integers did.
+ */
+class PageScript {
+public:
+    static constexpr int MaxPages = 16;
+
+    std::array<int, MaxPages> pages{};
+    int count = 0;
+
+    [[nodiscard]] bool Compiled(std::string_view script) const noexcept
+    {
+        return compiled && script == source;
+    }
+
+    void Compile(std::string_view script)
+    {
+        source.assign(script);
+        compiled = true;
+        count = 0;
+        while (count < MaxPages && script_detail::Int(script, pages[static_cast<size_t>(count)]))
+            ++count;
+    }
+
+private:
+    std::string source;
+    bool compiled = false;
+};
+
+} // namespace vt
+
+#endif // VT_ZONE_SCRIPT_HH